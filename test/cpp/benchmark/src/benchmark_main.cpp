@@ -0,0 +1,115 @@
+#include "benchmark_support.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <catch2/catch_session.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+
+static std::atomic<uint64_t> allocationCount{0};
+
+// NOTE: Count every heap allocation in the process for the allocations per op
+// column. The replacements forward to malloc/free.
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* result = std::malloc(size ? size : 1))
+        return result;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* result = std::malloc(size ? size : 1))
+        return result;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+    std::mutex                                descriptionsMutex;
+    std::map<std::string, bench::Description> descriptionsByName;
+    std::string                               jsonOutputPath = "service_node_rewards_benchmarks.json";
+}
+
+uint64_t bench::allocations() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void bench::describe(const std::string& name, uint64_t itemsPerOp, double allocationsPerOp) {
+    std::lock_guard lock{descriptionsMutex};
+    descriptionsByName[name] = Description{itemsPerOp, allocationsPerOp};
+}
+
+const std::map<std::string, bench::Description>& bench::descriptions() {
+    return descriptionsByName;
+}
+
+// Collects every benchmark's timings and writes them, joined with the
+// allocation counts and item counts from `bench::describe`, as JSON when the
+// run finishes.
+class BenchmarkJsonListener : public Catch::EventListenerBase {
+public:
+    using Catch::EventListenerBase::EventListenerBase;
+
+    void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override {
+        const double meanNs   = stats.mean.point.count();
+        nlohmann::json result = {
+            {"name", stats.info.name},
+            {"mean_ns", meanNs},
+            {"stddev_ns", stats.standardDeviation.point.count()},
+            {"samples", stats.samples.size()},
+            {"iterations_per_sample", stats.info.iterations},
+        };
+
+        auto it = bench::descriptions().find(stats.info.name);
+        if (it != bench::descriptions().end()) {
+            const bench::Description& description = it->second;
+            result["items_per_op"]       = description.itemsPerOp;
+            result["allocations_per_op"] = description.allocationsPerOp;
+            if (meanNs > 0)
+                result["items_per_second"] = static_cast<double>(description.itemsPerOp) * 1e9 / meanNs;
+        }
+        results.push_back(std::move(result));
+    }
+
+    void testRunEnded(Catch::TestRunStats const&) override {
+        if (jsonOutputPath.empty())
+            return;
+        std::ofstream file(jsonOutputPath, std::ios::trunc);
+        file << nlohmann::json{{"benchmarks", results}}.dump(2) << "\n";
+    }
+
+private:
+    std::vector<nlohmann::json> results;
+};
+
+CATCH_REGISTER_LISTENER(BenchmarkJsonListener)
+
+int main(int argc, char* argv[]) {
+    Catch::Session session;
+
+    // NOTE: The largest cases sign with 10k nodes per op, Catch2's default of
+    // 100 samples would take hours. Still overridable on the command line.
+    session.configData().benchmarkSamples    = 10;
+    session.configData().benchmarkWarmupTime = 100;
+
+    using namespace Catch::Clara;
+    session.cli(session.cli() | Opt(jsonOutputPath, "path")["--json-output"]("where to write the JSON report, empty to disable"));
+
+    if (int result = session.applyCommandLine(argc, argv); result != 0)
+        return result;
+    return session.run();
+}
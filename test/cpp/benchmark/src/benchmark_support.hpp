@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Shared between the benchmarks and the JSON report written by benchmark_main.cpp
+namespace bench
+{
+    struct Description {
+        uint64_t itemsPerOp;       // Units of work one iteration does, e.g. nodes signed
+        double   allocationsPerOp; // Heap allocations made by one iteration
+    };
+
+    // Number of `operator new` calls made by the process so far
+    uint64_t allocations();
+
+    void                                      describe(const std::string& name, uint64_t itemsPerOp, double allocationsPerOp);
+    const std::map<std::string, Description>& descriptions();
+
+    // Run `op` once to count its allocations and record it under `name`.
+    // Call before the BENCHMARK of the same name so the report can show
+    // allocations per op and throughput next to Catch2's timings.
+    template <typename Func>
+    void describe(const std::string& name, uint64_t itemsPerOp, Func&& op) {
+        const uint64_t before = allocations();
+        op();
+        describe(name, itemsPerOp, static_cast<double>(allocations() - before));
+    }
+
+// END
+}
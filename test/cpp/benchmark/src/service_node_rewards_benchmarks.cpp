@@ -0,0 +1,218 @@
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark_support.hpp"
+
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/bls_context.hpp"
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/provider_backend.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+#include "service_node_rewards/service_node_table.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+// NOTE: Sizes of the service node list the list and calldata benchmarks run over
+static const std::vector<size_t> LIST_SIZES = {10, 1'000, 10'000};
+
+static const uint32_t    CHAIN_ID         = 31337;
+static const std::string CONTRACT_ADDRESS = "0x5FbDB2315678afecb367f032d93F642f64180aa3";
+static const std::string RECIPIENT        = "0x70997970C51812dc3A010C7d01b50e0d17dc79C8";
+
+// The calldata builders never talk to the chain, this backend makes sure of it
+class OfflineProviderBackend : public ProviderBackend {
+public:
+    std::string callReadFunction(const ReadCallData&, std::string_view) override { throw std::logic_error("Benchmarks run offline"); }
+    std::string callReadFunction(const ReadCallData&, uint64_t) override { throw std::logic_error("Benchmarks run offline"); }
+    std::vector<LogEntry> getLogs(uint64_t, uint64_t, const std::string&) override { throw std::logic_error("Benchmarks run offline"); }
+    uint64_t getLatestHeight() override { throw std::logic_error("Benchmarks run offline"); }
+};
+
+// Lists are expensive to generate at 10k nodes, build each size once and share it
+static ServiceNodeList& serviceNodeList(size_t size) {
+    static std::map<size_t, std::unique_ptr<ServiceNodeList>> lists;
+    auto& result = lists[size];
+    if (!result)
+        result = std::make_unique<ServiceNodeList>(size);
+    return *result;
+}
+
+static std::vector<uint64_t> allServiceNodeIDs(const ServiceNodeList& snl) {
+    std::vector<uint64_t> result;
+    result.reserve(snl.nodes.size());
+    for (const auto& node : snl.nodes)
+        result.push_back(node.service_node_id);
+    return result;
+}
+
+TEST_CASE( "Benchmark BLS encoding helpers", "[benchmark][ec_utils]" ) {
+    ServiceNodeList    snl(1);
+    bls::PublicKey     publicKey    = snl.nodes[0].getPublicKey();
+    const std::string  publicKeyHex = utils::BLSPublicKeyToHex(publicKey);
+    const auto         hash         = utils::HashModulus("benchmark");
+    bls::Signature     signature    = snl.nodes[0].signHash(hash);
+
+    auto toHex = [&] { return utils::BLSPublicKeyToHex(publicKey); };
+    bench::describe("BLSPublicKeyToHex", 1, toHex);
+    BENCHMARK("BLSPublicKeyToHex") { return toHex(); };
+
+    auto fromHex = [&] { return utils::HexToBLSPublicKey(publicKeyHex); };
+    bench::describe("HexToBLSPublicKey", 1, fromHex);
+    BENCHMARK("HexToBLSPublicKey") { return fromHex(); };
+
+    auto signatureToHex = [&] { return utils::SignatureToHex(signature); };
+    bench::describe("SignatureToHex", 1, signatureToHex);
+    BENCHMARK("SignatureToHex") { return signatureToHex(); };
+
+    const std::string message = utils::getFunctionSignature("updateRewardsBalance(address,uint256)") + std::string(128, 'a');
+    auto hashModulus = [&] { return utils::HashModulus(message); };
+    bench::describe("HashModulus", 1, hashModulus);
+    BENCHMARK("HashModulus") { return hashModulus(); };
+}
+
+TEST_CASE( "Benchmark public key derivation", "[benchmark][ec_utils]" ) {
+    BLSContext::get();
+
+    std::vector<bls::SecretKey> secretKeys(LIST_SIZES[1]);
+    for (bls::SecretKey& secretKey : secretKeys)
+        secretKey.init();
+
+    auto generic = [&] {
+        bls::PublicKey result;
+        secretKeys[0].getPublicKey(result);
+        return result;
+    };
+    bench::describe("SecretKey::getPublicKey", 1, generic);
+    BENCHMARK("SecretKey::getPublicKey") { return generic(); };
+
+    auto fixedBase = [&] { return utils::DerivePublicKey(secretKeys[0]); };
+    bench::describe("DerivePublicKey", 1, fixedBase);
+    BENCHMARK("DerivePublicKey") { return fixedBase(); };
+
+    const std::string suffix = "/" + std::to_string(secretKeys.size());
+    auto batch = [&] { return utils::DerivePublicKeys(secretKeys); };
+    bench::describe("DerivePublicKeys" + suffix, secretKeys.size(), batch);
+    BENCHMARK(std::string("DerivePublicKeys" + suffix)) { return batch(); };
+}
+
+TEST_CASE( "Benchmark service node list aggregation and signing", "[benchmark][service_node_list]" ) {
+    for (size_t size : LIST_SIZES) {
+        ServiceNodeList&            snl     = serviceNodeList(size);
+        const std::vector<uint64_t> signers = allServiceNodeIDs(snl);
+        const std::string           suffix  = "/" + std::to_string(size);
+
+        auto aggregate = [&] { return snl.aggregatePubkeyHex(); };
+        bench::describe("aggregatePubkeyHex" + suffix, size, aggregate);
+        BENCHMARK(std::string("aggregatePubkeyHex" + suffix)) { return aggregate(); };
+
+        // NOTE: Every signer signs the message and the signatures are summed
+        auto signOne = [&] { return snl.updateRewardsBalance(RECIPIENT, 1'000'000, CHAIN_ID, CONTRACT_ADDRESS, signers); };
+        bench::describe("updateRewardsBalance" + suffix, size, signOne);
+        BENCHMARK(std::string("updateRewardsBalance" + suffix)) { return signOne(); };
+
+        // NOTE: One update per node signed by the whole list, items are signatures
+        std::vector<RewardUpdate> updates;
+        for (size_t index = 0; index < size; index++)
+            updates.push_back(RewardUpdate{RECIPIENT, 1'000'000 + index});
+        auto signBatch = [&] { return snl.updateRewardsBalances(updates, CHAIN_ID, CONTRACT_ADDRESS, signers); };
+        bench::describe("updateRewardsBalances" + suffix, size, signBatch);
+        BENCHMARK(std::string("updateRewardsBalances" + suffix)) { return signBatch(); };
+    }
+}
+
+TEST_CASE( "Benchmark service node rewards calldata", "[benchmark][calldata]" ) {
+    ServiceNodeRewardsContract contract(CONTRACT_ADDRESS, std::make_shared<OfflineProviderBackend>());
+
+    {
+        ServiceNodeList&  snl       = serviceNodeList(LIST_SIZES.front());
+        const std::string pubkey    = snl.nodes[0].getPublicKeyHex();
+        const std::string signature = snl.nodes[0].proofOfPossession(CHAIN_ID, CONTRACT_ADDRESS, RECIPIENT, "pubkey");
+        auto addKey = [&] { return contract.addBLSPublicKey(pubkey, signature, "pubkey", "sig", 0); };
+        bench::describe("addBLSPublicKey", 1, addKey);
+        BENCHMARK("addBLSPublicKey") { return addKey(); };
+    }
+
+    for (size_t size : LIST_SIZES) {
+        ServiceNodeList&  snl    = serviceNodeList(size);
+        const std::string suffix = "/" + std::to_string(size);
+
+        // NOTE: Worst case for the non-signer list, every node is listed
+        const std::vector<uint64_t> nonSigners = allServiceNodeIDs(snl);
+        const std::string           signature  = snl.updateRewardsBalance(RECIPIENT, 1'000'000, CHAIN_ID, CONTRACT_ADDRESS, {nonSigners.front()});
+        auto reward = [&] { return contract.updateRewardsBalance(RECIPIENT, 1'000'000, signature, nonSigners); };
+        bench::describe("updateRewardsBalance calldata" + suffix, size, reward);
+        BENCHMARK(std::string("updateRewardsBalance calldata" + suffix)) { return reward(); };
+
+        auto liquidate = [&] { return contract.liquidateBLSPublicKeyWithSignature(nonSigners.front(), snl.nodes[0].getPublicKeyHex(), signature, nonSigners); };
+        bench::describe("liquidateBLSPublicKeyWithSignature calldata" + suffix, size, liquidate);
+        BENCHMARK(std::string("liquidateBLSPublicKeyWithSignature calldata" + suffix)) { return liquidate(); };
+
+        std::vector<std::string> pubkeys;
+        for (const auto& node : snl.nodes)
+            pubkeys.push_back(node.getPublicKeyHex());
+        const std::vector<uint64_t> amounts(size, ServiceNodeRewardsContract::STAKING_REQUIREMENT);
+        auto seed = [&] { return contract.seedPublicKeyList(pubkeys, amounts); };
+        bench::describe("seedPublicKeyList calldata" + suffix, size, seed);
+        BENCHMARK(std::string("seedPublicKeyList calldata" + suffix)) { return seed(); };
+    }
+}
+
+TEST_CASE( "Benchmark service node table scans", "[benchmark][service_node_table]" ) {
+    // NOTE: A mainnet sized mirror, far more than the other benchmarks' lists
+    const size_t     NODES = 100'000;
+    ServiceNodeList& snl   = serviceNodeList(NODES);
+
+    std::unordered_map<uint64_t, ContractServiceNode> nodes;
+    for (size_t index = 0; index < snl.nodes.size(); index++) {
+        ContractServiceNode node = {};
+        node.recipient.fill(static_cast<unsigned char>(index % 251));
+        node.pubkey              = snl.nodes[index].getPublicKey();
+        node.deposit             = utils::padTo32Bytes(utils::decimalToHex(ServiceNodeRewardsContract::STAKING_REQUIREMENT));
+        nodes[snl.nodes[index].service_node_id] = node;
+    }
+    const ServiceNodeTable table = ServiceNodeTable::fromNodes(nodes);
+    const std::string      suffix = "/" + std::to_string(NODES);
+
+    std::array<unsigned char, 20> recipient;
+    recipient.fill(7);
+
+    // NOTE: The same scans over the map of whole nodes the mirror keeps
+    auto mapRecipient = [&] {
+        std::vector<uint64_t> result;
+        for (const auto& [serviceNodeID, node] : nodes) {
+            if (node.recipient == recipient)
+                result.push_back(serviceNodeID);
+        }
+        return result;
+    };
+    bench::describe("recipient scan, map" + suffix, NODES, mapRecipient);
+    BENCHMARK(std::string("recipient scan, map" + suffix)) { return mapRecipient(); };
+
+    auto tableRecipient = [&] { return table.serviceNodeIDsForRecipient(recipient); };
+    bench::describe("recipient scan, table" + suffix, NODES, tableRecipient);
+    BENCHMARK(std::string("recipient scan, table" + suffix)) { return tableRecipient(); };
+
+    auto mapAggregate = [&] {
+        bls::PublicKey result;
+        result.clear();
+        for (const auto& [serviceNodeID, node] : nodes)
+            result.add(node.pubkey);
+        return result;
+    };
+    bench::describe("aggregate pubkey, map" + suffix, NODES, mapAggregate);
+    BENCHMARK(std::string("aggregate pubkey, map" + suffix)) { return mapAggregate(); };
+
+    auto tableAggregate = [&] { return table.aggregatePubkey(); };
+    bench::describe("aggregate pubkey, table" + suffix, NODES, tableAggregate);
+    BENCHMARK(std::string("aggregate pubkey, table" + suffix)) { return tableAggregate(); };
+
+    auto tableDeposit = [&] { return table.totalDeposit(); };
+    bench::describe("total deposit, table" + suffix, NODES, tableDeposit);
+    BENCHMARK(std::string("total deposit, table" + suffix)) { return tableDeposit(); };
+}
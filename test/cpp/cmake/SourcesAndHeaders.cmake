@@ -4,6 +4,27 @@ set(sources
     src/service_node_rewards_contract.cpp
     src/service_node_list.cpp
     src/ec_utils.cpp
+    src/service_node_rewards_events.cpp
+    src/service_node_rewards_indexer.cpp
+    src/contract_read_cache.cpp
+    src/transaction_queue.cpp
+    src/json_rpc.cpp
+    src/receipt_tracker.cpp
+    src/provider_backend.cpp
+    src/uint256.cpp
+    src/reward_rate_pool.cpp
+    src/metrics.cpp
+    src/tracing.cpp
+    src/service_node_rewards_model.cpp
+    src/hedged_provider_backend.cpp
+    src/service_node_contribution_contract.cpp
+    src/service_node_contribution_events.cpp
+    src/service_node_contribution_scanner.cpp
+    src/bls_context.cpp
+    src/service_node_table.cpp
+    src/crypto_counters.cpp
+    src/rewards_ledger.cpp
+    src/signing_daemon.cpp
 )
 
 set(headers
@@ -13,10 +34,69 @@ set(headers
     include/service_node_rewards/erc20_contract.hpp
     include/service_node_rewards/service_node_rewards_contract.hpp
     include/service_node_rewards/service_node_list.hpp
+    include/service_node_rewards/service_node_rewards_events.hpp
+    include/service_node_rewards/service_node_rewards_indexer.hpp
+    include/service_node_rewards/contract_read_cache.hpp
+    include/service_node_rewards/transaction_queue.hpp
+    include/service_node_rewards/json_rpc.hpp
+    include/service_node_rewards/receipt_tracker.hpp
+    include/service_node_rewards/provider_backend.hpp
+    include/service_node_rewards/single_flight.hpp
+    include/service_node_rewards/uint256.hpp
+    include/service_node_rewards/reward_rate_pool.hpp
+    include/service_node_rewards/metrics.hpp
+    include/service_node_rewards/tracing.hpp
+    include/service_node_rewards/service_node_rewards_model.hpp
+    include/service_node_rewards/hedged_provider_backend.hpp
+    include/service_node_rewards/service_node_contribution_contract.hpp
+    include/service_node_rewards/service_node_contribution_events.hpp
+    include/service_node_rewards/service_node_contribution_scanner.hpp
+    include/service_node_rewards/bls_context.hpp
+    include/service_node_rewards/service_node_table.hpp
+    include/service_node_rewards/crypto_counters.hpp
+    include/service_node_rewards/rewards_ledger.hpp
+    include/service_node_rewards/signing_daemon.hpp
+)
+
+# NOTE: Only built with ${PROJECT_NAME}_ENABLE_COROUTINES
+set(coroutine_sources
+    src/async_rpc.cpp
+)
+
+set(coroutine_headers
+    include/service_node_rewards/async_rpc.hpp
 )
 
 set(test_sources
   src/basic.cpp
   src/basic_ethereum.cpp
   src/rewards_contract.cpp
+  src/contract_read_cache.cpp
+  src/reward_rate_pool.cpp
+  src/service_node_rewards_model.cpp
+  src/ec_utils.cpp
+  src/hedged_provider_backend.cpp
+  src/service_node_contribution.cpp
+  src/bls_context.cpp
+  src/service_node_table.cpp
+  src/crypto_counters.cpp
+  src/rewards_ledger.cpp
+  src/signing_daemon.cpp
+  src/service_node_list.cpp
+)
+
+set(coroutine_test_sources
+  src/async_rpc.cpp
+)
+
+set(benchmark_sources
+  src/benchmark_main.cpp
+  src/service_node_rewards_benchmarks.cpp
+)
+
+set(tool_sources
+  src/gas_profile.cpp
+  src/network_simulator.cpp
+  src/reward_epoch_pipeline.cpp
+  src/signing_daemon.cpp
 )
@@ -21,6 +21,20 @@ Include(FetchContent)
 option(${PROJECT_NAME}_ENABLE_UNIT_TESTING "Enable unit tests for the projects (from the `test` subfolder)." ON)
 option(${PROJECT_NAME}_USE_CATCH2 "Use the Catch2 project for creating unit tests." ON)
 
+#
+# Benchmarking
+#
+# Uses Catch2's BENCHMARK, results are also written as JSON.
+
+option(${PROJECT_NAME}_ENABLE_BENCHMARKS "Build the benchmark suite (from the `benchmark` subfolder)." OFF)
+
+#
+# Tools
+#
+# Executables that drive the library against a node, e.g. gas profiling.
+
+option(${PROJECT_NAME}_BUILD_TOOLS "Build the tools (from the `tools` subfolder)." OFF)
+
 #
 # Static analyzers
 #
@@ -65,6 +79,18 @@ if(CCACHE_FOUND)
   set_property(GLOBAL PROPERTY RULE_LAUNCH_LINK ccache)
 endif()
 
+option(${PROJECT_NAME}_ENABLE_TRACING "Compile in the Chrome trace spans, see include/service_node_rewards/tracing.hpp." OFF)
+if(${PROJECT_NAME}_ENABLE_TRACING)
+    add_compile_definitions(SERVICE_NODE_REWARDS_TRACING)
+endif()
+
+option(${PROJECT_NAME}_ENABLE_CRYPTO_COUNTERS "Compile in the elliptic curve operation counters, see include/service_node_rewards/crypto_counters.hpp." OFF)
+if(${PROJECT_NAME}_ENABLE_CRYPTO_COUNTERS)
+    add_compile_definitions(SERVICE_NODE_REWARDS_CRYPTO_COUNTERS)
+endif()
+
+option(${PROJECT_NAME}_ENABLE_COROUTINES "Build the awaitable contract API in include/service_node_rewards/async_rpc.hpp, requires C++20." OFF)
+
 option(${PROJECT_NAME}_ENABLE_ASAN "Enable Address Sanitize to detect memory error." OFF)
 if(${PROJECT_NAME}_ENABLE_ASAN)
     add_compile_options(-fsanitize=address)
@@ -0,0 +1,281 @@
+#pragma once
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ethyl/provider.hpp"
+#include "ethyl/signer.hpp"
+#include "ethyl/transaction.hpp"
+
+#include "service_node_rewards/json_rpc.hpp"
+#include "service_node_rewards/receipt_tracker.hpp"
+
+// Awaitable counterparts of the blocking RPCs, for keeping hundreds of reads
+// and submissions in flight from a single thread. Only built with
+// service-node-rewards_ENABLE_COROUTINES (C++20).
+//
+//   EventLoop          loop;
+//   auto               rpc = std::make_shared<AsyncJsonRpcClient>(loop, url);
+//   rewards_contract.setAsyncClient(rpc);
+//
+//   Task<void> check(ServiceNodeRewardsContract& contract, uint64_t id) {
+//       ContractServiceNode node = co_await contract.serviceNodesAsync(id);
+//       ...
+//   }
+//
+//   for (uint64_t id : ids)
+//       loop.spawn(check(rewards_contract, id));
+//   loop.run();
+//
+// Nothing here is thread safe, a loop and everything awaiting on it belong to
+// the thread that calls `run`.
+
+template <typename T>
+class Task;
+
+namespace detail {
+struct TaskPromiseBase {
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            // NOTE: Symmetric transfer back to the awaiting coroutine so long
+            // chains of awaits don't grow the stack.
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter        final_suspend() const noexcept { return {}; }
+    void                unhandled_exception() { exception = std::current_exception(); }
+
+    std::coroutine_handle<> continuation;
+    std::exception_ptr      exception;
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    void return_value(T result) { value.emplace(std::move(result)); }
+    T    result() {
+        if (exception)
+            std::rethrow_exception(exception);
+        return std::move(*value);
+    }
+
+    std::optional<T> value;
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    void return_void() const noexcept {}
+    void result() const {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+};
+}  // namespace detail
+
+// Lazily started coroutine returning a `T`. Starts when awaited (or handed to
+// an EventLoop) and resumes its awaiter when it finishes, rethrowing anything
+// the body threw.
+template <typename T = void>
+class [[nodiscard]] Task {
+public:
+    struct promise_type : detail::TaskPromise<T> {
+        Task get_return_object() { return Task{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+    };
+
+    Task() = default;
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    Task(const Task&)            = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle)
+            handle.destroy();
+    }
+
+    bool done() const { return !handle || handle.done(); }
+
+    bool                    await_ready() const noexcept { return done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    T await_resume() { return handle.promise().result(); }
+
+private:
+    friend class EventLoop;
+    explicit Task(std::coroutine_handle<promise_type> _handle) : handle(_handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+struct HttpResponse {
+    long        status = 0;
+    std::string body;
+};
+
+// Single threaded event loop over libcurl's multi interface. HTTP transfers
+// and timers suspend the awaiting coroutine until curl reports the transfer
+// done or the timer is due. Connections to the same host are kept alive and
+// shared, up to `maxHostConnections` at once (further transfers queue inside
+// curl); HTTP/2 endpoints multiplex every transfer over one connection.
+class EventLoop {
+public:
+    class HttpTransfer;
+
+    struct HttpAwaiter {
+        HttpAwaiter(EventLoop& loop, const std::string& url, std::string body);
+        HttpAwaiter(HttpAwaiter&&) noexcept;
+        ~HttpAwaiter();
+
+        bool         await_ready() const noexcept { return false; }
+        void         await_suspend(std::coroutine_handle<> awaiting);
+        HttpResponse await_resume();
+
+        std::unique_ptr<HttpTransfer> transfer;
+    };
+
+    struct SleepAwaiter {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> awaiting) { loop.schedule(deadline, awaiting); }
+        void await_resume() const noexcept {}
+
+        EventLoop&                            loop;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    EventLoop(long maxHostConnections = 64);
+    ~EventLoop();
+
+    EventLoop(const EventLoop&)            = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    // POST `body` as JSON to `url`. Transport errors throw from the co_await,
+    // HTTP error statuses are returned for the caller to judge.
+    HttpAwaiter post(const std::string& url, std::string body) { return HttpAwaiter(*this, url, std::move(body)); }
+
+    SleepAwaiter sleep(std::chrono::steady_clock::duration duration) { return SleepAwaiter{*this, std::chrono::steady_clock::now() + duration}; }
+
+    // Run `task` in the background, starting on the next step of the loop. An
+    // exception escaping it is rethrown from `run()`.
+    void spawn(Task<void> task);
+
+    // Drive every spawned task to completion
+    void run();
+
+    // Drive the loop until `task` completes and return its result. Spawned
+    // tasks make progress in the meantime but are not waited on.
+    template <typename T>
+    T run(Task<T> task) {
+        ready.push_back(task.handle);
+        while (!task.done())
+            step();
+        return task.handle.promise().result();
+    }
+
+    size_t transfersInFlight() const { return transfers; }
+
+private:
+    struct Timer {
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t                              sequence; // Timers due at the same time fire in the order they were set
+        std::coroutine_handle<>               handle;
+
+        bool operator>(const Timer& other) const { return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence; }
+    };
+
+    void schedule(std::chrono::steady_clock::time_point deadline, std::coroutine_handle<> handle);
+    void add(HttpTransfer* transfer);
+    void remove(HttpTransfer* transfer);
+
+    // Resume everything that is ready, waiting on the network or the next
+    // timer if nothing is. Throws if there is nothing left to wait on.
+    void step();
+    void reap();
+
+    void*                                                          multi;         // CURLM
+    size_t                                                         transfers = 0; // In the multi handle
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers;
+    uint64_t                                                       nextTimerSequence = 0;
+    std::vector<std::coroutine_handle<>>                           ready;         // To resume on the next step
+    std::vector<Task<void>>                                        spawned;
+    std::exception_ptr                                             failure;       // First exception to escape a spawned task
+};
+
+// JSON-RPC 2.0 over an EventLoop, the awaitable counterpart of JsonRpcClient
+class AsyncJsonRpcClient {
+public:
+    AsyncJsonRpcClient(EventLoop& loop, std::string url);
+
+    // Returns the "result" member, throws std::runtime_error on transport
+    // errors and JsonRpcError on an RPC "error".
+    Task<nlohmann::json> call(std::string method, nlohmann::json params);
+
+    // eth_call `callData` at `blockNumber` ("latest" or a block tag), returns the result hex
+    Task<std::string> callReadFunction(ReadCallData callData, std::string blockNumber = "latest");
+    Task<std::string> callReadFunction(ReadCallData callData, uint64_t blockNumber);
+
+    EventLoop&         loop() { return eventLoop; }
+    const std::string& url() const { return endpoint; }
+
+private:
+    EventLoop&  eventLoop;
+    std::string endpoint;
+    uint64_t    nextId = 0;
+};
+
+// Signs and broadcasts transactions through an AsyncJsonRpcClient. Like
+// TransactionQueue, nonces are allocated locally per sender (seeded from the
+// node's pending count) so any number of submissions can be awaited at once.
+//
+//   std::string       hash   = co_await sender.submit(tx, seckey);
+//   TransactionResult result = co_await sender.waitForReceipt(hash);
+//
+// A failed broadcast hands its nonce back if it was the last one allocated,
+// otherwise the sender's nonce is re-read from the node on its next
+// submission.
+class AsyncTransactionSender {
+public:
+    AsyncTransactionSender(std::shared_ptr<AsyncJsonRpcClient> client, Signer& signer);
+
+    // Fill in the chain ID, nonce and fees of `tx`, sign it with `seckey` and
+    // broadcast it. Returns the transaction hash, throws if the node rejects it.
+    Task<std::string> submit(Transaction tx, std::vector<unsigned char> seckey);
+
+    // Poll for the receipt of `hash` every `interval`, throws after `timeout`
+    Task<TransactionResult> waitForReceipt(std::string hash, std::chrono::milliseconds timeout = std::chrono::minutes(5), std::chrono::milliseconds interval = std::chrono::milliseconds(250));
+
+    // Submit and wait for the receipt
+    Task<TransactionResult> submitAndWait(Transaction tx, std::vector<unsigned char> seckey);
+
+private:
+    Task<void> populate(Transaction& tx);
+
+    std::shared_ptr<AsyncJsonRpcClient>       client;
+    Signer&                                   signer;
+    std::optional<uint64_t>                   chainId;
+    std::optional<FeeData>                    feeData;   // Refreshed while waiting on receipts
+    std::unordered_map<std::string, uint64_t> nextNonce; // Keyed by sender address
+};
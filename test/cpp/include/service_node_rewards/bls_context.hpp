@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+
+#include "service_node_rewards/ec_utils.hpp"
+
+// Process-wide set up of the BLS library for the contract's curve and
+// hashing, and the precomputation shared by every key in the process.
+//
+// bls::init, the map-to mode and the public key generator are global state in
+// the library. `BLSContext::get()` sets them up once, the first time it is
+// called from any thread, after which they are never touched again so keys can
+// be created, signed with and verified from any number of threads. Anything
+// that uses bls must call it first; ServiceNode, ServiceNodeList and the
+// ec_utils key functions do so themselves.
+class BLSContext {
+public:
+    static const BLSContext& get();
+
+    BLSContext(const BLSContext&)            = delete;
+    BLSContext& operator=(const BLSContext&) = delete;
+
+    // Generator of the public key group, G1 mapped from 1 like the contract's
+    const bls::PublicKey& generator() const { return publicKeyGenerator; }
+
+    // `result` = `scalar` times the generator from a table of its precomputed
+    // multiples, one mixed addition per non-zero byte of the scalar instead of
+    // a generic double-and-add over its 254 bits. `result` is left projective.
+    // Not constant time, for test and simulation keys.
+    void multiplyGenerator(mcl::bn::G1& result, const mcl::bn::Fr& scalar) const;
+
+private:
+    BLSContext();
+
+    static constexpr size_t WINDOW_BITS = 8;
+    static constexpr size_t WINDOWS     = 256 / WINDOW_BITS;
+    static constexpr size_t MULTIPLES   = (size_t(1) << WINDOW_BITS) - 1;
+
+    bls::PublicKey           publicKeyGenerator;
+    // Every multiple 1..255 of 2^(8 * window) times the generator, affine:
+    // [window * MULTIPLES + multiple - 1]
+    std::vector<mcl::bn::G1> generatorTable;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "service_node_rewards/service_node_rewards_events.hpp"
+
+struct IndexerSyncResult;
+
+// Cache of eth_call results for a contract, keyed by (call data, block number).
+//
+// Each entry remembers the block it was read at and stays valid for every
+// later block up to the cache's head, until an event that could change its
+// result arrives. Reads of state that can change without an event (any call
+// the cache doesn't know the invalidating events of) are only kept for the
+// block they were read at. Advancing the head without the events in between
+// drops everything. The cache can be persisted to disk so that a restarted process
+// only has to replay the events since the saved head to start warm.
+// All methods are safe to call concurrently.
+class ContractReadCache {
+public:
+    // `path` is the on-disk store, empty to keep the cache in memory only.
+    ContractReadCache(const std::string& contractAddress, std::string path = "");
+
+    // Block the cache is valid up to, reads should be pinned to this block.
+    // 0 until the cache is first advanced (or loaded), when it holds nothing.
+    uint64_t blockNumber() const;
+
+    std::optional<std::string> get(const std::string& callData, uint64_t blockNumber) const;
+    void                       put(const std::string& callData, uint64_t blockNumber, std::string result);
+
+    // Move the head to `blockNumber`. `events` must be every event emitted by
+    // the contract after the current head up to and including `blockNumber`.
+    void advance(uint64_t blockNumber, const std::vector<ServiceNodeRewardsEvent>& events);
+    // Move the head without knowing what changed, drops all entries.
+    void advance(uint64_t blockNumber);
+    // Move the head using the events an indexer reported in a sync.
+    void advance(const IndexerSyncResult& sync);
+
+    void   invalidate(const ServiceNodeRewardsEvent& event);
+    void   clear();
+    size_t size() const;
+
+    // Read/write the on-disk store. `load` returns false (leaving the cache
+    // empty) if there is no store or it belongs to a different contract.
+    bool load();
+    void save() const;
+
+private:
+    struct Entry {
+        uint64_t    blockNumber; // Block the result was read at
+        std::string result;
+    };
+
+    // Callers must hold `mutex`
+    void advanceLocked(uint64_t blockNumber, const std::vector<ServiceNodeRewardsEvent>& events);
+    void invalidateLocked(const ServiceNodeRewardsEvent& event);
+
+    std::string                            contractAddress;
+    std::string                            path;
+    uint64_t                               head = 0;
+    std::unordered_map<std::string, Entry> entries; // Keyed by call data
+    mutable std::mutex                     mutex;
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Counts of the elliptic curve operations the library performs, to pin down
+// the cost profile of an operation in a test or benchmark:
+//
+//   crypto_counters::Capture capture;
+//   snl.updateRewardsBalance(...);
+//   REQUIRE(capture.counts()[crypto_counters::Op::G2ScalarMul] == signers.size());
+//
+// The counters in the library are compiled in only when building with
+// -D<project>_ENABLE_CRYPTO_COUNTERS=ON (which defines
+// SERVICE_NODE_REWARDS_CRYPTO_COUNTERS), otherwise every count is zero and
+// `enabled` is false. Each thread counts into its own counters without
+// locking and a capture sums every thread's, so a capture also sees the
+// operations of other threads running at the same time.
+namespace crypto_counters
+{
+#if defined(SERVICE_NODE_REWARDS_CRYPTO_COUNTERS)
+    constexpr inline bool enabled = true;
+#else
+    constexpr inline bool enabled = false;
+#endif
+
+    enum class Op : size_t {
+        G1ScalarMul, // Public key derivation
+        G2ScalarMul, // Signing, the hashed message times the secret key
+        G1Add,       // Public key aggregation
+        G2Add,       // Signature aggregation
+        HashToG2,    // Message hash mapped onto the curve
+        Normalize,   // Points converted to affine, a batch counts every point
+        Inversion,   // Field inversions, one per normalized batch
+        Count,
+    };
+
+    const char* toString(Op op);
+
+    struct Counts {
+        std::array<uint64_t, static_cast<size_t>(Op::Count)> values = {};
+
+        uint64_t operator[](Op op) const { return values[static_cast<size_t>(op)]; }
+        Counts   operator-(const Counts& rhs) const;
+        // "G1ScalarMul=1 G2ScalarMul=0 ..."
+        std::string toString() const;
+    };
+
+    // NOTE: Only the owning thread writes its counters, `total` reads them
+    // from other threads
+    struct ThreadCounters {
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(Op::Count)> values = {};
+    };
+
+    // Allocate and register the calling thread's counters
+    ThreadCounters* registerThread();
+    inline thread_local ThreadCounters* threadCounters = nullptr;
+
+    inline void add(Op op, uint64_t count = 1) {
+        if (!threadCounters)
+            threadCounters = registerThread();
+        std::atomic<uint64_t>& value = threadCounters->values[static_cast<size_t>(op)];
+        value.store(value.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+
+    // Count the conversion of `point` to affine, if it has one to do. Call
+    // before normalizing it.
+    template <typename Point>
+    void addNormalize(const Point& point) {
+        if (!point.z.isOne() && !point.z.isZero()) {
+            add(Op::Normalize);
+            add(Op::Inversion);
+        }
+    }
+
+    // Sum of every thread's counters since the process started
+    Counts total();
+
+    // Operations counted between its construction and `counts()`
+    class Capture {
+    public:
+        Capture() : start(total()) {}
+        Counts counts() const { return total() - start; }
+
+    private:
+        Counts start;
+    };
+}
+
+#if defined(SERVICE_NODE_REWARDS_CRYPTO_COUNTERS)
+#define CRYPTO_COUNT(op) crypto_counters::add(crypto_counters::Op::op)
+#define CRYPTO_COUNT_NORMALIZE(point) crypto_counters::addNormalize(point)
+#else
+#define CRYPTO_COUNT(op) do {} while (0)
+#define CRYPTO_COUNT_NORMALIZE(point) do {} while (0)
+#endif
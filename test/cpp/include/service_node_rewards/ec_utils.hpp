@@ -1,4 +1,8 @@
 #pragma once
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #define BLS_ETH
 #define MCLBN_FP_UNIT_SIZE 4
@@ -20,4 +24,16 @@ namespace utils
     bls::PublicKey                HexToBLSPublicKey(std::string_view hex);
     std::string                   SignatureToHex(bls::Signature sig);
     std::array<unsigned char, 32> HashModulus(std::string message);
+
+    // Public key of `secretKey` from the generator table in BLSContext,
+    // several times faster than SecretKey::getPublicKey. Not constant time,
+    // for test and simulation keys.
+    bls::PublicKey                DerivePublicKey(const bls::SecretKey& secretKey);
+    // DerivePublicKey for every key, normalized together with one inversion
+    std::vector<bls::PublicKey>   DerivePublicKeys(const std::vector<bls::SecretKey>& secretKeys);
+    // Convert the keys to affine coordinates with one inversion for all of
+    // them, after which serializing or adding them skips the per-key inversion
+    void                          NormalizePublicKeys(std::vector<bls::PublicKey>& publicKeys);
+    // As NormalizePublicKeys for `count` points in place
+    void                          NormalizeG1(mcl::bn::G1* points, size_t count);
 }
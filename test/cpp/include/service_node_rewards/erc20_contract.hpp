@@ -6,15 +6,39 @@
 #include "ethyl/provider.hpp"
 #include "ethyl/transaction.hpp"
 
+#include "service_node_rewards/metrics.hpp"
+#include "service_node_rewards/provider_backend.hpp"
+
+#if defined(SERVICE_NODE_REWARDS_COROUTINES)
+#include "service_node_rewards/async_rpc.hpp"
+#endif
+
 class ERC20Contract {
 public:
     ERC20Contract(const std::string& contractAddress, std::shared_ptr<Provider> provider);
+    ERC20Contract(const std::string& contractAddress, std::shared_ptr<ProviderBackend> backend);
+
+    // See ServiceNodeRewardsContract::setMetrics. Not safe to call while reads are running.
+    void setMetrics(std::shared_ptr<ContractMetrics> metrics);
 
     // Function to call the 'approve' method of the ERC20 token contract
     Transaction approve(const std::string& spender, uint64_t amount);
     uint64_t balanceOf(const std::string& address);
 
+#if defined(SERVICE_NODE_REWARDS_COROUTINES)
+    // See ServiceNodeRewardsContract::setAsyncClient. Not safe to call while reads are running.
+    void           setAsyncClient(std::shared_ptr<AsyncJsonRpcClient> client);
+    Task<uint64_t> balanceOfAsync(std::string address);
+#endif
+
 private:
+    ReadCallData    balanceOfCall(const std::string& address) const;
+    static uint64_t decodeBalance(const std::string& hex);
+
     std::string contractAddress;
-    std::shared_ptr<Provider> provider;
+    std::shared_ptr<ProviderBackend> backend;
+    std::shared_ptr<ContractMetrics> metrics;
+#if defined(SERVICE_NODE_REWARDS_COROUTINES)
+    std::shared_ptr<AsyncJsonRpcClient> asyncClient;
+#endif
 };
@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "service_node_rewards/metrics.hpp"
+#include "service_node_rewards/provider_backend.hpp"
+
+struct HedgedProviderOptions {
+    // Before an endpoint has `minSamples` timed responses its hedge delay is
+    // `initialHedgeDelay`, afterwards the p95 of its response times, clamped
+    // to [minHedgeDelay, maxHedgeDelay].
+    std::chrono::milliseconds initialHedgeDelay = std::chrono::milliseconds(250);
+    std::chrono::milliseconds minHedgeDelay     = std::chrono::milliseconds(5);
+    std::chrono::milliseconds maxHedgeDelay     = std::chrono::seconds(2);
+    uint64_t                  minSamples        = 20;
+    double                    hedgePercentile   = 0.95;
+
+    // Hedges are paid for out of a budget that grows by `hedgeBudget` per
+    // request (up to `hedgeBurst` at once), capping the extra load at that
+    // fraction of requests however slow the endpoints get. Failovers after an
+    // error are not budgeted.
+    double hedgeBudget = 0.1;
+    double hedgeBurst  = 10;
+
+    // An endpoint that fails `ejectAfterFailures` times in a row is skipped
+    // for `ejectionTime`, doubling on every ejection that follows without a
+    // success in between up to `maxEjectionTime`.
+    uint64_t                  ejectAfterFailures = 3;
+    std::chrono::milliseconds ejectionTime       = std::chrono::seconds(5);
+    std::chrono::milliseconds maxEjectionTime    = std::chrono::minutes(5);
+
+    // Threads making requests, bounds the requests in flight across endpoints.
+    // Hedges and failovers run on `hedgeThreads` of their own so they never
+    // queue behind the slow primaries they are meant to overtake.
+    size_t workerThreads = 16;
+    size_t hedgeThreads  = 4;
+};
+
+struct HedgedEndpointStats {
+    uint64_t                 requests;            // Sent to the endpoint, primary or hedge
+    uint64_t                 hedges;              // Of `requests`, sent as a hedge or failover
+    uint64_t                 wins;                // Answered first
+    uint64_t                 failures;
+    bool                     ejected;
+    std::chrono::nanoseconds hedgeDelay;          // Current delay before hedging a request to it
+    LatencyHistogramSnapshot latency;             // Successful responses, including ones that lost
+};
+
+// Serves reads from an ordered set of endpoints, the first healthy one being
+// the primary. Endpoints with a high recent error rate drop behind the
+// others and ones that keep failing are ejected for a while, see
+// HedgedProviderOptions. A read that the primary hasn't answered within its p95
+// response time is hedged: a duplicate goes to the healthiest other endpoint
+// and whichever answers first is returned. A read that fails is retried on
+// the next endpoint straight away and only throws once every healthy
+// endpoint has failed it. A read the node rejects for good (a revert, a log
+// range too large, see JsonRpcError::isFinal) is an answer: it is thrown
+// straight away and does not count against the endpoint. Other errors, such
+// as a rate limit or a block the node hasn't seen yet, fail over like any
+// other failure.
+//
+//   std::vector<std::shared_ptr<ProviderBackend>> endpoints;
+//   for (const std::string& url : urls)
+//       endpoints.push_back(std::make_shared<LiveProviderBackend>(std::make_shared<Provider>("Client", url)));
+//   auto backend = std::make_shared<HedgedProviderBackend>(endpoints);
+//   ServiceNodeRewardsContract rewards_contract(contract_address, backend);
+//
+// Requests run on the backend's own worker threads, the calling thread only
+// waits for the first answer. All methods are safe to call concurrently.
+class HedgedProviderBackend : public ProviderBackend {
+public:
+    HedgedProviderBackend(std::vector<std::shared_ptr<ProviderBackend>> endpoints, HedgedProviderOptions options = {});
+    ~HedgedProviderBackend() override;
+
+    // A LiveProviderBackend per URL, in order
+    static std::shared_ptr<HedgedProviderBackend> fromUrls(const std::vector<std::string>& urls, HedgedProviderOptions options = {});
+
+    std::string           callReadFunction(const ReadCallData& callData, std::string_view blockNumber = "latest") override;
+    std::string           callReadFunction(const ReadCallData& callData, uint64_t blockNumber) override;
+    std::vector<LogEntry> getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) override;
+    uint64_t              getLatestHeight() override;
+
+    // In endpoint order
+    std::vector<HedgedEndpointStats> stats() const;
+
+private:
+    struct Endpoint {
+        std::shared_ptr<ProviderBackend> backend;
+        LatencyHistogram                 latency;
+        std::atomic<int64_t>             hedgeDelayNs;
+        std::atomic<uint64_t>            requests  = 0;
+        std::atomic<uint64_t>            hedges    = 0;
+        std::atomic<uint64_t>            wins      = 0;
+        std::atomic<uint64_t>            failures  = 0;
+        std::atomic<uint64_t>            successes = 0;
+
+        // Guarded by `healthMutex`
+        uint64_t                              consecutiveFailures = 0;
+        std::chrono::milliseconds             ejectionTime        = {};
+        std::chrono::steady_clock::time_point ejectedUntil        = {};
+        double                                errorRate           = 0; // EWMA of failures per request, as of `errorRateUpdated`
+        std::chrono::steady_clock::time_point errorRateUpdated    = {};
+    };
+
+    template <typename T>
+    T hedge(std::function<T(ProviderBackend&)> request);
+
+    // Endpoints best first: healthy ones (and ones just back from an
+    // ejection) in the configured order, then those whose recent error rate
+    // is high, then ejected ones (still tried once everything else has failed
+    // the request)
+    std::vector<size_t>      ranked() const;
+    // Callers must hold `healthMutex`
+    static double            errorRate(const Endpoint& endpoint, std::chrono::steady_clock::time_point now);
+    std::chrono::nanoseconds hedgeDelay(const Endpoint& endpoint) const;
+    bool                     takeHedgeToken();
+    void                     recordSuccess(Endpoint& endpoint, std::chrono::nanoseconds elapsed);
+    void                     recordFailure(Endpoint& endpoint);
+
+    struct JobQueue {
+        std::deque<std::function<void()>> jobs;
+        std::condition_variable           condition;
+    };
+
+    void post(JobQueue& queue, std::function<void()> job);
+    void work(JobQueue& queue);
+
+    HedgedProviderOptions                  options;
+    std::vector<std::unique_ptr<Endpoint>> endpoints;
+    mutable std::mutex                     healthMutex;
+    double                                 hedgeTokens;      // Guarded by `healthMutex`
+
+    std::vector<std::thread> workers;
+    JobQueue                 primaryJobs;
+    JobQueue                 hedgeJobs;   // Hedges and failovers
+    bool                     stopping = false;
+    std::mutex               jobsMutex;   // Guards both queues and `stopping`
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+// The node answered a request with a JSON-RPC error, e.g. a reverted eth_call,
+// a getLogs range larger than it serves or a rate limit. Only some of them
+// are about the request rather than the node, see `isFinal`.
+class JsonRpcError : public std::runtime_error {
+public:
+    // `error` is the response's "error" object, its "code" and "message" are
+    // kept (0 and empty when missing)
+    JsonRpcError(const std::string& what, const nlohmann::json& error);
+
+    // The error object in `text`, the message of an exception that quoted
+    // it, e.g. from `Provider`. Only an object at the top level of `text`
+    // with an integer "code" and a "message" counts, nullopt if there is none.
+    static std::optional<JsonRpcError> fromMessage(std::string_view text);
+
+    // Whether any other node would reject the request the same: a revert
+    // (code 3, or -32000 "execution reverted") or a getLogs range too large
+    // to serve. Rate limits and a lagging node's missing block or header are
+    // not, another node may well answer those.
+    bool isFinal() const;
+
+    int64_t            code() const { return errorCode; }
+    const std::string& errorMessage() const { return message; }
+
+private:
+    int64_t     errorCode = 0;
+    std::string message;
+};
+
+// Minimal JSON-RPC 2.0 client over HTTP for requests that `Provider` does not
+// expose, most importantly batches: many calls in a single round trip.
+class JsonRpcClient {
+public:
+    // Batches of more than `maxBatchSize` requests are sent as several, nodes
+    // reject batches past their limit (commonly 100 to 1000) as a whole.
+    JsonRpcClient(std::string url, size_t maxBatchSize = 100);
+
+    // Returns the "result" member, throws std::runtime_error on transport
+    // errors and JsonRpcError on an RPC "error".
+    nlohmann::json call(const std::string& method, const nlohmann::json& params);
+
+    // Send all `requests` (method, params) batched, in as few round trips of
+    // up to `maxBatchSize` as possible. Results are returned in request order;
+    // a request that failed has its "error" object in place of the result
+    // rather than throwing for the whole batch.
+    std::vector<nlohmann::json> batch(const std::vector<std::pair<std::string, nlohmann::json>>& requests);
+
+    const std::string& url() const { return endpoint; }
+
+private:
+    nlohmann::json post(const nlohmann::json& body);
+    void           batchChunk(const std::pair<std::string, nlohmann::json>* requests, size_t count, nlohmann::json* results);
+
+    std::string endpoint;
+    size_t      maxBatchSize;
+    uint64_t    nextId = 0;
+};
@@ -0,0 +1,148 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct LatencyHistogramSnapshot {
+    struct Bucket {
+        uint64_t upperNs; // Inclusive upper bound of the bucket
+        uint64_t count;
+    };
+
+    uint64_t            count = 0;
+    uint64_t            sumNs = 0;
+    uint64_t            maxNs = 0;
+    std::vector<Bucket> buckets; // Non-empty buckets only, ascending
+
+    // Upper bound of the bucket holding the `quantile` (0 to 1) sample, 0 if empty
+    uint64_t percentile(double quantile) const;
+};
+
+// Log-linear latency histogram in the style of HdrHistogram. Every power of
+// two range is split into 16 buckets so a recorded value is off by at most
+// 1/16th (6.25%) at any magnitude, from nanoseconds to hours, in a fixed 8KB.
+// Recording is a handful of relaxed atomic adds and safe from any thread.
+class LatencyHistogram {
+public:
+    static constexpr inline size_t SUB_BUCKET_BITS = 4;
+    static constexpr inline size_t SUB_BUCKETS     = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr inline size_t BUCKETS         = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(std::chrono::nanoseconds duration);
+
+    LatencyHistogramSnapshot snapshot() const;
+
+    static size_t   bucketIndex(uint64_t ns);
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> counts = {};
+    std::atomic<uint64_t>                      count  = 0;
+    std::atomic<uint64_t>                      sumNs  = 0;
+    std::atomic<uint64_t>                      maxNs  = 0;
+};
+
+// Counters for one contract method (or one RPC the transaction queue makes).
+// The byte counts are of the hex decoded call data and result, not the HTTP
+// framing around them.
+struct MethodMetrics {
+    std::atomic<uint64_t> calls         = 0;
+    std::atomic<uint64_t> errors        = 0; // Calls that ended in an exception
+    std::atomic<uint64_t> bytesSent     = 0;
+    std::atomic<uint64_t> bytesReceived = 0;
+    LatencyHistogram      network;          // Waiting on the node
+    LatencyHistogram      decode;           // Decoding the result
+    LatencyHistogram      receipt;          // Broadcast until the receipt was seen
+};
+
+struct MethodMetricsSnapshot {
+    std::string              method;
+    uint64_t                 calls;
+    uint64_t                 errors;
+    uint64_t                 bytesSent;
+    uint64_t                 bytesReceived;
+    LatencyHistogramSnapshot network;
+    LatencyHistogramSnapshot decode;
+    LatencyHistogramSnapshot receipt;
+};
+
+// Registry of MethodMetrics by method name, shared by the contract clients
+// and transaction queues it is attached to with `setMetrics`. Clients without
+// a registry skip all timing, so instrumentation costs a null check when off.
+//
+//   auto metrics = std::make_shared<ContractMetrics>();
+//   rewards_contract.setMetrics(metrics);
+//   ... drive the contract ...
+//   std::cout << metrics->prometheus();
+class ContractMetrics {
+public:
+    // The counters for `method`, created on first use. The reference stays
+    // valid for the lifetime of the registry.
+    MethodMetrics& method(std::string_view name);
+
+    // Every method's counters, sorted by method name
+    std::vector<MethodMetricsSnapshot> snapshot() const;
+
+    // Prometheus text exposition format. Histograms are in seconds and only
+    // list their non-empty buckets.
+    std::string prometheus(std::string_view prefix = "service_node_rewards") const;
+    // The snapshot as JSON, histograms summarised as count/mean/p50/p90/p99/p999/max in ns.
+    std::string json() const;
+
+private:
+    std::map<std::string, std::unique_ptr<MethodMetrics>, std::less<>> methods;
+    mutable std::mutex                                                 mutex;
+};
+
+// Instruments one call of a contract method. Counts the call on construction
+// and, if the scope is left by an exception, the error. Wrap the RPC in
+// `network` and the result parsing in `decode` to time the two phases. With a
+// null registry every member is a no-op.
+class MethodCall {
+public:
+    MethodCall(std::shared_ptr<ContractMetrics> registry, std::string_view method);
+    ~MethodCall();
+
+    MethodCall(const MethodCall&)            = delete;
+    MethodCall& operator=(const MethodCall&) = delete;
+
+    // Run the RPC `func`, which sends `request` (hex) and returns the result (hex)
+    template <typename Func>
+    std::string network(std::string_view request, Func&& func) {
+        if (!metrics)
+            return func();
+        const auto  start  = std::chrono::steady_clock::now();
+        std::string result = func();
+        networkDone(start, request, result);
+        return result;
+    }
+
+    // For RPCs that can't be wrapped in `network`, such as awaited ones: take
+    // `networkStart` before sending and pass it to `networkDone` with the result.
+    std::chrono::steady_clock::time_point networkStart() const;
+    void                                  networkDone(std::chrono::steady_clock::time_point start, std::string_view request, std::string_view result);
+
+    template <typename Func>
+    auto decode(Func&& func) -> decltype(func()) {
+        if (!metrics)
+            return func();
+        const auto start  = std::chrono::steady_clock::now();
+        auto       result = func();
+        metrics->decode.record(std::chrono::steady_clock::now() - start);
+        return result;
+    }
+
+private:
+    static uint64_t hexBytes(std::string_view hex);
+
+    std::shared_ptr<ContractMetrics> registry; // Keeps `metrics` alive
+    MethodMetrics*                   metrics = nullptr;
+    int                              uncaughtExceptions;
+};
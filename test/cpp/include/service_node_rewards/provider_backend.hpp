@@ -0,0 +1,107 @@
+#pragma once
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ethyl/provider.hpp"
+#include "service_node_rewards/json_rpc.hpp"
+
+// The read side of `Provider` used by the contract clients and the indexer.
+// Implementations decide where the answers come from: a live node, a live
+// node with every exchange recorded, or a recording played back in process.
+// They throw JsonRpcError when the node rejected the request and
+// std::runtime_error when it could not be reached.
+class ProviderBackend {
+public:
+    virtual ~ProviderBackend() = default;
+
+    virtual std::string           callReadFunction(const ReadCallData& callData, std::string_view blockNumber = "latest") = 0;
+    virtual std::string           callReadFunction(const ReadCallData& callData, uint64_t blockNumber) = 0;
+    virtual std::vector<LogEntry> getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) = 0;
+    virtual uint64_t              getLatestHeight() = 0;
+};
+
+// Forwards every request to a node over HTTP through `Provider`. Requests are
+// serialised as `Provider` reuses a single HTTP session.
+class LiveProviderBackend : public ProviderBackend {
+public:
+    LiveProviderBackend(std::shared_ptr<Provider> provider);
+
+    std::string           callReadFunction(const ReadCallData& callData, std::string_view blockNumber = "latest") override;
+    std::string           callReadFunction(const ReadCallData& callData, uint64_t blockNumber) override;
+    std::vector<LogEntry> getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) override;
+    uint64_t              getLatestHeight() override;
+
+private:
+    std::shared_ptr<Provider> provider;
+    std::mutex                mutex;
+};
+
+// Forwards requests to `inner` and records each request/response pair
+// (including errors) so a session can be replayed with ReplayProviderBackend.
+//
+//   auto live     = std::make_shared<LiveProviderBackend>(provider);
+//   auto recorder = std::make_shared<RecordingProviderBackend>(live);
+//   ServiceNodeRewardsContract rewards_contract(contract_address, recorder);
+//   ... drive the contract against anvil ...
+//   recorder->save("session.rpc");
+class RecordingProviderBackend : public ProviderBackend {
+public:
+    RecordingProviderBackend(std::shared_ptr<ProviderBackend> inner);
+
+    std::string           callReadFunction(const ReadCallData& callData, std::string_view blockNumber = "latest") override;
+    std::string           callReadFunction(const ReadCallData& callData, uint64_t blockNumber) override;
+    std::vector<LogEntry> getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) override;
+    uint64_t              getLatestHeight() override;
+
+    // Write the recording to `path`, one exchange per line in the order they happened
+    void   save(const std::string& path) const;
+    size_t size() const;
+
+private:
+    template <typename Func>
+    auto record(std::string request, Func&& func) -> decltype(func());
+
+    std::shared_ptr<ProviderBackend>                 inner;
+    std::vector<std::pair<std::string, std::string>> exchanges; // (request, response)
+    mutable std::mutex                               mutex;
+};
+
+// Serves a recording made by RecordingProviderBackend without a node. A
+// request that was made several times is answered with its recorded
+// responses in order, repeating the last one once they run out. Each call
+// sleeps for `latency` (plus up to `jitter` more, uniformly random) to model
+// the round trip. Throws if a request was never recorded.
+class ReplayProviderBackend : public ProviderBackend {
+public:
+    ReplayProviderBackend(const std::string& path,
+                          std::chrono::microseconds latency = std::chrono::microseconds(0),
+                          std::chrono::microseconds jitter  = std::chrono::microseconds(0));
+
+    std::string           callReadFunction(const ReadCallData& callData, std::string_view blockNumber = "latest") override;
+    std::string           callReadFunction(const ReadCallData& callData, uint64_t blockNumber) override;
+    std::vector<LogEntry> getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) override;
+    uint64_t              getLatestHeight() override;
+
+    void   setLatency(std::chrono::microseconds latency, std::chrono::microseconds jitter = std::chrono::microseconds(0));
+    size_t size() const;
+
+private:
+    struct Responses {
+        std::deque<std::string> pending;
+        std::string             last;
+    };
+
+    std::string respond(const std::string& request);
+
+    std::map<std::string, Responses> responses;
+    std::chrono::microseconds        latency;
+    std::chrono::microseconds        jitter;
+    uint64_t                         rngState;
+    mutable std::mutex               mutex;
+};
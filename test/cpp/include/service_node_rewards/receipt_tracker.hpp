@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "service_node_rewards/json_rpc.hpp"
+
+struct TransactionResult {
+    std::string hash;        // Hash of the transaction that was mined (may be a replacement)
+    uint64_t    nonce;
+    uint64_t    blockNumber;
+    uint64_t    gasUsed;
+    bool        success;     // Receipt status, false if the transaction reverted
+};
+
+using TransactionFuture = std::shared_future<TransactionResult>;
+
+// Parse an eth_getTransactionReceipt result, nullopt if the transaction has not been mined
+std::optional<TransactionResult> transactionResultFromReceipt(const nlohmann::json& receipt);
+
+// Waits for receipts of many transactions at once. A background thread
+// watches for new blocks and on each one fetches the receipts of every pending
+// hash in a single JSON-RPC batch, so the RPC load is one batch per block no
+// matter how many transactions are in flight.
+//
+// New blocks come from an `eth_subscribe("newHeads")` subscription when a
+// `ws://` URL is given, otherwise (or whenever the subscription can't be
+// established) the block number is polled over HTTP every `pollInterval`.
+// The subscription counts once the node answers with its ID, and is dropped
+// for polling when the chain moves on without a new head for a few intervals.
+class ReceiptTracker {
+public:
+    ReceiptTracker(std::string rpcUrl, std::string webSocketUrl = "", std::chrono::milliseconds pollInterval = std::chrono::seconds(1));
+    ~ReceiptTracker();
+
+    ReceiptTracker(const ReceiptTracker&)            = delete;
+    ReceiptTracker& operator=(const ReceiptTracker&) = delete;
+
+    // Complete the returned future once `hash` has a receipt. Tracking the
+    // same hash twice returns the same future.
+    TransactionFuture track(const std::string& hash);
+
+    // Fetch the receipts of `hashes` in one batch, nullopt for any that are
+    // not mined yet. The result is in the same order as `hashes`.
+    std::vector<std::optional<TransactionResult>> fetchReceipts(const std::vector<std::string>& hashes);
+
+    size_t   pending() const;
+    uint64_t headHeight() const { return head; }
+    // True while new heads are arriving through the WebSocket subscription
+    bool     subscribed() const { return subscriptionActive; }
+
+private:
+    struct Waiting {
+        std::promise<TransactionResult> promise;
+        TransactionFuture               future;
+    };
+
+    void     run();
+    // Follow newHeads until the socket closes or heads stop arriving while the
+    // chain moves on. False if the subscription was never established.
+    bool     runSubscription();
+    uint64_t latestHeight();
+    void     onNewHead(uint64_t height);
+    void     checkReceipts(bool freshOnly);
+
+    JsonRpcClient                            rpc;
+    std::mutex                               rpcMutex;
+    std::string                              webSocketUrl;
+    std::chrono::milliseconds                pollInterval;
+
+    mutable std::mutex                       mutex;
+    std::condition_variable                  wakeup;
+    std::unordered_map<std::string, Waiting> waiting;
+    std::vector<std::string>                 fresh; // Tracked since the last check
+    bool                                     stopping = false;
+
+    std::atomic<uint64_t>                    head{0};
+    std::atomic<bool>                        subscriptionActive{false};
+    std::thread                              worker;
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "service_node_rewards/provider_backend.hpp"
+#include "service_node_rewards/uint256.hpp"
+#include "ethyl/provider.hpp"
+#include "ethyl/transaction.hpp"
+
+// The storage of RewardRatePool.sol that its emission math depends on
+struct RewardRatePoolState {
+    Uint256  balance;         // SENT held by the pool, `SENT.balanceOf(pool)`
+    Uint256  totalPaidOut;
+    uint64_t lastPaidOutTime; // Unix timestamp of the last `payoutReleased`
+};
+
+// Local evaluation of RewardRatePool.sol's view functions with the same
+// uint256 arithmetic, so emission curves can be computed without an eth_call
+// per timestamp. Where the contract would revert (e.g. a timestamp before
+// `lastPaidOutTime`) the model throws std::overflow_error.
+class RewardRatePool {
+public:
+    static constexpr inline uint64_t ANNUAL_INTEREST_RATE = 145;  // 14.5% in tenths of a percent
+    static constexpr inline uint64_t BASIS_POINTS         = 1000;
+    static constexpr inline uint64_t SECONDS_PER_YEAR     = 365 * 24 * 60 * 60;
+    static constexpr inline uint64_t BLOCK_TIME           = 2 * 60; // Period of a `rewardRate`
+
+    RewardRatePool(RewardRatePoolState state);
+
+    const RewardRatePoolState& state() const { return poolState; }
+
+    static Uint256 calculateInterestAmount(const Uint256& balance, const Uint256& timeElapsed);
+    Uint256        calculateTotalDeposited() const;
+    Uint256        calculateReleasedAmount(uint64_t timestamp) const;
+    Uint256        rewardRate(uint64_t timestamp) const;
+
+    // Batch forms of the above, one result per input in the same order. The
+    // per-call invariants (balance * rate, the deposited total) are computed
+    // once, each element then costs a 64 bit multiply and a short division.
+    static std::vector<Uint256> calculateInterestAmounts(const std::vector<Uint256>& balances, uint64_t timeElapsed);
+    std::vector<Uint256>        calculateReleasedAmounts(const std::vector<uint64_t>& timestamps) const;
+    std::vector<Uint256>        rewardRates(const std::vector<uint64_t>& timestamps) const;
+
+    // Apply `payoutReleased()` mined at `timestamp`, returns the amount released
+    Uint256 payoutReleased(uint64_t timestamp);
+
+private:
+    RewardRatePoolState poolState;
+};
+
+// Reads RewardRatePool.sol's state and view functions from the chain
+class RewardRatePoolContract {
+public:
+    RewardRatePoolContract(const std::string& contractAddress, std::shared_ptr<Provider> provider);
+    RewardRatePoolContract(const std::string& contractAddress, std::shared_ptr<ProviderBackend> backend);
+
+    std::string sent();
+    Uint256     totalPaidOut();
+    uint64_t    lastPaidOutTime();
+    Uint256     calculateTotalDeposited();
+    Uint256     calculateReleasedAmount(uint64_t timestamp);
+    Uint256     calculateInterestAmount(const Uint256& balance, const Uint256& timeElapsed);
+    Uint256     rewardRate(uint64_t timestamp);
+
+    // Snapshot of the storage the local model needs
+    RewardRatePoolState state();
+
+    Transaction payoutReleased();
+
+private:
+    Uint256 readUint256(const std::string& signature, const std::string& arguments = "");
+
+    std::string                      contractAddress;
+    std::shared_ptr<ProviderBackend> backend;
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "service_node_rewards/json_rpc.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+#include "service_node_rewards/uint256.hpp"
+
+struct RewardsLedgerUpdate {
+    std::string address; // "0x" and lower case
+    Uint256     amount;  // New cumulative total to sign and send
+    Uint256     onChain; // The contract's total as last known to the ledger
+};
+
+struct RewardsLedgerDiff {
+    // Recipients the contract is behind on, most owed (amount - onChain) first
+    std::vector<RewardsLedgerUpdate> updates;
+    // Recipients whose epoch total is below the contract's. The contract
+    // rejects a total that does not increase, these need looking into rather
+    // than sending.
+    std::vector<RewardsLedgerUpdate> regressed;
+    // Recipients already up to date
+    size_t                           unchanged = 0;
+
+    // `updates` for ServiceNodeList::updateRewardsBalances, which signs
+    // uint64_t amounts. Throws std::overflow_error if an amount does not fit.
+    std::vector<RewardUpdate> rewardUpdates() const;
+};
+
+// Local copy of each recipient's cumulative rewards and claimed amounts on the
+// rewards contract, so an epoch's totals can be turned into only the updates
+// that change something. Every recipient is otherwise re-signed and re-sent
+// each epoch although most totals are the same as the epoch before.
+//
+//   RewardsLedger ledger;
+//   ledger.reconcile(rpc, contract_address, recipients); // Once, or after a restart
+//   RewardsLedgerDiff diff = ledger.diff(epochTotals);
+//   for (Transaction& tx : rewards_contract.updateRewardsBalances(snl, diff.rewardUpdates(), chainID, signers))
+//       ... submit, and ledger.confirm(update.address, update.amount) once mined
+//
+// Amounts are uint256 like on the contract. The ledger only knows what it is
+// told: recipients it has never seen are taken to be at zero, reconcile them
+// first if they may have been paid before.
+class RewardsLedger {
+public:
+    // Read `recipients(address)` for every one of `addresses` at `block`, in
+    // JSON-RPC batches of `batchSize`, and overwrite what the ledger holds.
+    // Returns the addresses whose balance differed from the ledger's.
+    std::vector<std::string> reconcile(JsonRpcClient& rpc, const std::string& contractAddress, const std::vector<std::string>& addresses, const std::string& block = "latest", size_t batchSize = 500);
+
+    // Record the contract's balance of `address`, e.g. from viewRecipientBalance
+    void set(const std::string& address, const RecipientBalance& balance);
+    // Record that an update of `address` to `rewards` was mined. Totals only
+    // go up, confirming a lower total than the ledger's is ignored.
+    void confirm(const std::string& address, const Uint256& rewards);
+
+    // Compare an epoch's cumulative totals to the ledger. At most `limit`
+    // updates are returned, the ones owed the most, the rest wait for the
+    // next epoch. Throws std::invalid_argument on a malformed or repeated
+    // address.
+    RewardsLedgerDiff diff(const std::vector<std::pair<std::string, Uint256>>& totals, size_t limit = std::numeric_limits<size_t>::max()) const;
+
+    // Zero for recipients the ledger has not seen
+    RecipientBalance balance(const std::string& address) const;
+    size_t           size() const { return recipients.size(); }
+
+    // "0x" and lower case, throws std::invalid_argument if `address` is not 20 bytes of hex
+    static std::string normalizeAddress(std::string_view address);
+
+private:
+    std::unordered_map<std::string, RecipientBalance> recipients; // Keyed by normalized address
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "service_node_rewards/metrics.hpp"
+#include "service_node_rewards/provider_backend.hpp"
+#include "service_node_rewards/uint256.hpp"
+#include "ethyl/provider.hpp"
+#include "ethyl/transaction.hpp"
+
+// Binding for a ServiceNodeContribution.sol instance: a single pending
+// service node that contributors stake into until the staking requirement is
+// met and the node is registered with the rewards contract.
+//
+// Reads go through `backend` one eth_call at a time, see
+// ServiceNodeContributionScanner to read many contracts at once.
+class ServiceNodeContributionContract {
+public:
+    ServiceNodeContributionContract(const std::string& contractAddress, std::shared_ptr<Provider> provider);
+    ServiceNodeContributionContract(const std::string& contractAddress, std::shared_ptr<ProviderBackend> backend);
+
+    // See ServiceNodeRewardsContract::setMetrics. Not safe to call while reads are running.
+    void setMetrics(std::shared_ptr<ContractMetrics> metrics);
+
+    // `blsSignature` is the 128 byte proof of possession as hex, see ServiceNode::proofOfPossession
+    Transaction contributeOperatorFunds(const Uint256& amount, const std::string& blsSignature);
+    Transaction contributeFunds(const Uint256& amount);
+    Transaction withdrawStake();
+    Transaction cancelNode();
+    Transaction resetContract(const Uint256& amount);
+    Transaction rescueERC20(const std::string& tokenAddress);
+
+    Uint256     contributions(const std::string& address);
+    uint64_t    contributionTimestamp(const std::string& address);
+    std::string contributorAddresses(uint64_t index);
+    std::string operatorAddress();
+    std::string serviceNodePubkey(); // 32 byte hex
+    Uint256     stakingRequirement();
+    Uint256     operatorContribution();
+    Uint256     totalContribution();
+    Uint256     minimumContribution();
+    uint64_t    numberContributors();
+    uint64_t    maxContributors();
+    bool        finalized();
+    bool        cancelled();
+
+    // Call data of the reads above so they can be batched by the caller
+    ReadCallData contributionsCall(const std::string& address) const;
+    ReadCallData contributionTimestampCall(const std::string& address) const;
+    ReadCallData readCall(std::string_view signature) const;
+
+    // Decoders for the results of the calls above
+    static Uint256     decodeUint256(std::string_view hex);
+    static std::string decodeAddress(std::string_view hex);    // 20 byte hex without "0x"
+    static std::string decodeFirstWord(std::string_view hex);  // 32 byte hex without "0x"
+
+    const std::string& address() const { return contractAddress; }
+
+private:
+    std::string read(const ReadCallData& callData, MethodCall& call);
+    Uint256     readUint256(std::string_view method, std::string_view signature);
+
+    std::string                      contractAddress;
+    std::shared_ptr<ProviderBackend> backend;
+    std::shared_ptr<ContractMetrics> metrics;
+};
+
+// Binding for ServiceNodeContributionFactory.sol which deploys a
+// ServiceNodeContribution contract per pending node and announces it with
+// `NewServiceNodeContributionContract`.
+class ServiceNodeContributionFactoryContract {
+public:
+    // Deploying a contribution contract writes its parameters and the BLS key
+    // into fresh storage, well beyond the 3M used for the other transactions.
+    static constexpr inline uint64_t DEPLOY_CONTRIBUTION_CONTRACT_GAS = 5'000'000;
+
+    ServiceNodeContributionFactoryContract(const std::string& contractAddress, std::shared_ptr<Provider> provider);
+    ServiceNodeContributionFactoryContract(const std::string& contractAddress, std::shared_ptr<ProviderBackend> backend);
+
+    // Arguments as for ServiceNodeRewardsContract::addBLSPublicKey
+    Transaction deployContributionContract(const std::string& blsPubkey, const std::string& serviceNodePubkey, const std::string& serviceNodeSignature, uint64_t fee);
+
+    uint64_t    maxContributors();
+    std::string stakingRewardsContract(); // 20 byte hex without "0x"
+
+    const std::string& address() const { return contractAddress; }
+
+private:
+    std::string readLatest(std::string_view signature);
+
+    std::string                      contractAddress;
+    std::shared_ptr<ProviderBackend> backend;
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <array>
+#include <optional>
+#include <string>
+#include <variant>
+
+#include "service_node_rewards/service_node_rewards_events.hpp"
+#include "service_node_rewards/uint256.hpp"
+#include "ethyl/provider.hpp"
+
+// Typed records for the events emitted by ServiceNodeContribution.sol and its
+// factory. Unlike the ServiceNodeRewards events amounts are kept as full
+// uint256s, contributions are summed and compared against the staking
+// requirement.
+
+// Emitted by the factory for every contribution contract it deploys
+struct NewServiceNodeContributionContractEvent {
+    EventLocation                 location;
+    std::array<unsigned char, 20> contributionContract;
+    std::string                   serviceNodePubkey; // 32 byte hex
+};
+
+// The remaining events are emitted by a contribution contract, `contract` is
+// the address of the contract that emitted it.
+struct NewContributionEvent {
+    EventLocation                 location;
+    std::array<unsigned char, 20> contract;
+    std::array<unsigned char, 20> contributor;
+    Uint256                       amount;
+};
+
+struct StakeWithdrawnEvent {
+    EventLocation                 location;
+    std::array<unsigned char, 20> contract;
+    std::array<unsigned char, 20> contributor;
+    Uint256                       amount;
+};
+
+struct ContributionFinalizedEvent {
+    EventLocation                 location;
+    std::array<unsigned char, 20> contract;
+    std::string                   serviceNodePubkey; // 32 byte hex
+};
+
+struct ContributionCancelledEvent {
+    EventLocation                 location;
+    std::array<unsigned char, 20> contract;
+    std::string                   serviceNodePubkey; // 32 byte hex
+};
+
+using ServiceNodeContributionEvent = std::variant<NewServiceNodeContributionContractEvent,
+                                                  NewContributionEvent,
+                                                  StakeWithdrawnEvent,
+                                                  ContributionFinalizedEvent,
+                                                  ContributionCancelledEvent>;
+
+namespace contribution_events
+{
+    // Topic 0 for each event, see events::newServiceNodeTopic
+    const std::string& newServiceNodeContributionContractTopic();
+    const std::string& newContributionTopic();
+    const std::string& stakeWithdrawnTopic();
+    const std::string& finalizedTopic();
+    const std::string& cancelledTopic();
+
+    // Decode a raw log into a typed event, nullopt for logs that are not one
+    // of the events above. Throws if the log matches a known topic but is
+    // malformed.
+    std::optional<ServiceNodeContributionEvent> decode(const LogEntry& log);
+
+    const EventLocation& location(const ServiceNodeContributionEvent& event);
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "service_node_rewards/json_rpc.hpp"
+#include "service_node_rewards/service_node_contribution_contract.hpp"
+#include "service_node_rewards/service_node_contribution_events.hpp"
+#include "service_node_rewards/uint256.hpp"
+
+struct ContributorBalance {
+    std::string address;   // 20 byte lowercase hex without "0x"
+    Uint256     amount;    // `contributions(address)`
+    uint64_t    timestamp; // `contributionTimestamp(address)`, of the last contribution
+};
+
+// A contribution contract's state as read at `blockNumber`
+struct ContributionContractState {
+    std::string                     address;           // 20 byte lowercase hex without "0x"
+    std::string                     serviceNodePubkey; // 32 byte hex
+    std::string                     operatorAddress;   // 20 byte lowercase hex without "0x"
+    uint64_t                        deployedBlock = 0; // Block of the factory event, 0 for contracts given to `track`
+    uint64_t                        blockNumber   = 0;
+    bool                            finalized     = false;
+    bool                            cancelled     = false;
+    Uint256                         stakingRequirement;
+    Uint256                         operatorContribution;
+    Uint256                         totalContribution;
+    uint64_t                        numberContributors = 0;
+    // Every address that has contributed and still has a balance, in the
+    // order they first contributed
+    std::vector<ContributorBalance> contributors;
+};
+
+struct ContributionScanResult {
+    uint64_t                                  height = 0;
+    std::vector<ServiceNodeContributionEvent> events;     // Applied in this scan, chain order
+    std::vector<std::string>                  discovered; // Contracts first seen in this scan
+    std::vector<std::string>                  refreshed;  // Contracts whose state was re-read
+};
+
+// Tracks the state of every contribution contract deployed by a factory.
+//
+// Each scan makes one `eth_getLogs` pass over the new blocks for the factory
+// (to discover contracts) and then for all tracked contracts at once, the
+// addresses going in the filter rather than a request per contract. Only the
+// contracts with a `NewContribution`, `StakeWithdrawn`, `Finalized` or
+// `Cancelled` event in those blocks are re-read, with every eth_call for them
+// sent in JSON-RPC batches pinned to the scanned height so a contract's
+// fields and balances are always from the same block.
+//
+// Events only say which contracts changed, the state is always read back
+// from the contract: not every change has an event (`cancelNode` refunds the
+// operator silently, `resetContract` clears the contributor list) and
+// `contributionTimestamp` is not in the logs at all. Contributors are learnt
+// from `NewContribution` events as the contract has no way to list them.
+//
+// Scans stop `confirmations` blocks short of the head, the scanner does not
+// roll back a reorg. A scan that throws leaves the scanner at the height it
+// was, the next one scans the same blocks again.
+class ServiceNodeContributionScanner {
+public:
+    ServiceNodeContributionScanner(std::string rpcUrl, std::string factoryAddress, uint64_t startBlock = 0, uint64_t confirmations = 12, uint64_t chunkSize = 2000, size_t batchSize = 500);
+
+    // Follow a contribution contract not deployed by the factory. Its events
+    // from `startBlock` on are fetched on the next scan.
+    void track(const std::string& contractAddress);
+
+    // Scan up to the current head less `confirmations`
+    ContributionScanResult sync();
+    ContributionScanResult syncTo(uint64_t height);
+
+    // Re-read every tracked contract at `height`, e.g. for a full snapshot
+    // rather than just the contracts that changed
+    ContributionScanResult refreshAll(uint64_t height);
+
+    // Keyed by contract address, 20 byte lowercase hex without "0x"
+    const std::map<std::string, ContributionContractState>& contracts() const { return states; }
+    uint64_t                                                height() const { return nextBlock ? nextBlock - 1 : 0; }
+
+    // Parse an eth_getLogs result entry
+    static LogEntry logFromJson(const nlohmann::json& log);
+
+private:
+    struct Tracked {
+        std::vector<std::string> contributors; // Every contributor seen, in first contribution order
+        std::set<std::string>    seen;
+    };
+
+    std::vector<LogEntry>       fetchLogs(uint64_t fromBlock, uint64_t toBlock, const std::vector<std::string>& addresses);
+    std::vector<nlohmann::json> batch(const std::vector<std::pair<std::string, nlohmann::json>>& requests);
+    void                        apply(std::vector<LogEntry> logs, std::set<std::string>& changed, ContributionScanResult& result);
+    void                        refresh(const std::set<std::string>& addresses, uint64_t height, ContributionScanResult& result);
+
+    JsonRpcClient                                    rpc;
+    std::string                                      factoryAddress;
+    uint64_t                                         startBlock;
+    uint64_t                                         nextBlock;
+    uint64_t                                         confirmations;
+    uint64_t                                         chunkSize;
+    size_t                                           batchSize;
+    std::map<std::string, Tracked>                   tracked;
+    std::map<std::string, ContributionContractState> states;
+    std::vector<std::string>                         pending; // Given to `track`, not scanned yet
+    std::set<std::string>                            stale;   // Changed in scanned blocks, not refreshed yet
+};
@@ -19,9 +19,16 @@
 
 constexpr inline uint64_t SERVICE_NODE_LIST_SENTINEL = 0;
 
+struct RewardUpdate {
+    std::string address; // Recipient, with or without "0x"
+    uint64_t    amount;  // New total rewards balance of the recipient
+};
+
 class ServiceNode {
 private:
+    friend class ServiceNodeList;
     bls::SecretKey secretKey;
+    bls::PublicKey publicKey; // Derived once from `secretKey`, normalized
 public:
     uint64_t service_node_id = SERVICE_NODE_LIST_SENTINEL;
     ServiceNode() = default;
@@ -38,8 +45,13 @@ public:
     uint64_t                 next_service_node_id = SERVICE_NODE_LIST_SENTINEL + 1;
 
     ServiceNodeList(size_t numNodes);
+    // Restore a list saved with `secretKeys`, the nodes are given IDs from 1 in order
+    ServiceNodeList(const std::vector<std::string>& secretKeys);
     ~ServiceNodeList();
 
+    // Every node's secret key as hex, in list order
+    std::vector<std::string> secretKeys() const;
+
     void addNode();
     void deleteNode(uint64_t serviceNodeID);
     std::string getLatestNodePubkey();
@@ -52,6 +64,24 @@ public:
     std::pair<std::string, std::string> removeNodeFromIndices(uint64_t nodeID, uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& indices);
     std::string updateRewardsBalance(const std::string& address, const uint64_t amount, const uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids);
 
+    // Sign every reward update with the same set of signers, returning one
+    // signature per update in order. The signers' secret keys are summed once
+    // so each message costs a single hash-to-G2 and scalar multiply rather
+    // than one per signer. Messages are split across `threads` (0 for one per
+    // hardware thread).
+    std::vector<std::string> updateRewardsBalances(const std::vector<RewardUpdate>& updates, const uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids, size_t threads = 0);
+
+    // Sum of the secret keys of `service_node_ids`. A hash signed with it is
+    // the aggregate of every one of those nodes' signatures over it. Throws
+    // if a node is not in the list.
+    bls::SecretKey aggregateSecretKey(const std::vector<uint64_t>& service_node_ids);
+
+    // Hashes of the messages the contract checks the aggregate signature of,
+    // for callers that collect the signatures from each node themselves.
+    static std::array<unsigned char, 32> rewardMessageHash(const std::string& address, const uint64_t amount, const uint32_t chainID, const std::string& contractAddress);
+    static std::array<unsigned char, 32> removalMessageHash(const std::string& pubkey, const uint32_t chainID, const std::string& contractAddress);
+    static std::array<unsigned char, 32> liquidationMessageHash(const std::string& pubkey, const uint32_t chainID, const std::string& contractAddress);
+
     std::vector<uint64_t> findNonSigners(const std::vector<uint64_t>& indices);
     std::vector<uint64_t> randomSigners(const size_t numOfRandomIndices);
     int64_t findNodeIndex(uint64_t service_node_id);
@@ -1,13 +1,25 @@
 #pragma once
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <memory>
 
+#include "service_node_rewards/contract_read_cache.hpp"
 #include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/metrics.hpp"
+#include "service_node_rewards/provider_backend.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/single_flight.hpp"
+#include "service_node_rewards/transaction_queue.hpp"
+#include "service_node_rewards/uint256.hpp"
 #include "ethyl/provider.hpp"
 #include "ethyl/transaction.hpp"
 
+#if defined(SERVICE_NODE_REWARDS_COROUTINES)
+#include "service_node_rewards/async_rpc.hpp"
+#endif
+
 struct Recipient {
     uint64_t rewards;
     uint64_t claimed;
@@ -16,6 +28,12 @@ struct Recipient {
     Recipient(uint64_t _rewards, uint64_t _claimed) : rewards(_rewards), claimed(_claimed) {}
 };
 
+// `recipients(address)` at full width, see RewardsLedger
+struct RecipientBalance {
+    Uint256 rewards; // Cumulative rewards, the latest `updateRewardsBalance` amount
+    Uint256 claimed;
+};
+
 struct ContractServiceNode {
     uint64_t                      next;
     uint64_t                      prev;
@@ -25,34 +43,128 @@ struct ContractServiceNode {
     std::string                   deposit;
 };
 
+// Read methods are safe to call from several threads at once. Identical reads
+// that overlap share a single eth_call, each caller decodes the result itself.
 class ServiceNodeRewardsContract {
 public:
     // TODO: Taken from scripts/deploy-local-test.js and hardcoded
     static constexpr inline uint64_t STAKING_REQUIREMENT = 100'000'000'000;
 
+    // Upper bound on the gas `seedPublicKeyList` spends per call and per key
+    // seeded. A key writes ~6 fresh storage slots, re-links its neighbour and
+    // folds itself into the aggregate key (~140k gas measured on anvil).
+    static constexpr inline uint64_t SEED_PUBLIC_KEY_LIST_BASE_GAS    = 100'000;
+    static constexpr inline uint64_t SEED_PUBLIC_KEY_LIST_GAS_PER_KEY = 160'000;
+
     // Constructor
     ServiceNodeRewardsContract(const std::string& _contractAddress, std::shared_ptr<Provider> _provider);
+    ServiceNodeRewardsContract(const std::string& _contractAddress, std::shared_ptr<ProviderBackend> _backend);
+
+    // Serve reads through `cache`, pinned to the cache's block. The owner is
+    // responsible for advancing the cache as the chain moves, see
+    // ContractReadCache::advance, reads go to "latest" uncached until it is
+    // first advanced. Pass nullptr to read "latest" uncached.
+    // isActive() always reads "latest" uncached, start() emits no event.
+    void setCache(std::shared_ptr<ContractReadCache> cache);
+
+    // Record per-method call counts, bytes and network/decode latencies of the
+    // read methods into `metrics`. Pass nullptr (the default) to turn it off.
+    void setMetrics(std::shared_ptr<ContractMetrics> metrics);
+
+    // Reads so far that shared an identical read already in flight rather
+    // than making their own eth_call
+    uint64_t coalescedReads() const { return reads.coalesced(); }
 
     // Method for creating a transaction to add a public key
     Transaction addBLSPublicKey(const std::string& publicKey, const std::string& sig, const std::string& serviceNodePubkey, const std::string& serviceNodeSignature, uint64_t fee);
 
+    // Method for creating a transaction to seed the list with `pubkeys` (hex, as
+    // from ServiceNode::getPublicKeyHex) and their deposits. Owner only.
+    Transaction seedPublicKeyList(const std::vector<std::string>& pubkeys, const std::vector<uint64_t>& amounts);
+
+    // Seed every node in `snl` with a `deposit` each, split over as many
+    // seedPublicKeyList transactions as needed to fit in `blockGasLimit`. The
+    // transactions are submitted back to back through `queue` and waited on,
+    // then the contract's length and aggregate key are checked against `snl`.
+    // Throws if a transaction reverts or the contract state does not match.
+    // Returns the number of transactions sent.
+    size_t seedServiceNodeList(TransactionQueue& queue, const std::vector<unsigned char>& seckey, const ServiceNodeList& snl, uint64_t deposit = STAKING_REQUIREMENT, uint64_t blockGasLimit = 30'000'000);
+
     ContractServiceNode serviceNodes(uint64_t index);
     uint64_t            serviceNodeIDs(const bls::PublicKey& pKey);
     uint64_t            serviceNodesLength();
     std::string         designatedToken();
+    std::string         foundationPool();
+    uint64_t            stakingRequirement();
     std::string         aggregatePubkeyString();
     bls::PublicKey      aggregatePubkey();
+    // Throws std::overflow_error if either amount does not fit in a uint64_t,
+    // viewRecipientBalance reads them whole
     Recipient           viewRecipientData(const std::string& address);
+    RecipientBalance    viewRecipientBalance(const std::string& address);
+    bool                isActive();
+    uint64_t            nextServiceNodeID();
+    uint64_t            totalNodes();
+    uint64_t            blsNonSignerThreshold();
+    uint64_t            blsNonSignerThresholdMax();
+    uint64_t            liquidatorRewardRatio();
+    uint64_t            poolShareOfLiquidationRatio();
+    uint64_t            recipientRatio();
+
+#if defined(SERVICE_NODE_REWARDS_COROUTINES)
+    // Send the `*Async` reads through `client`, see async_rpc.hpp. They follow
+    // `setCache` and `setMetrics` like the blocking reads but run on the
+    // client's event loop, so identical reads in flight are not coalesced.
+    void setAsyncClient(std::shared_ptr<AsyncJsonRpcClient> client);
+
+    Task<ContractServiceNode> serviceNodesAsync(uint64_t index);
+    Task<uint64_t>            serviceNodeIDsAsync(bls::PublicKey pKey);
+    Task<uint64_t>            serviceNodesLengthAsync();
+    Task<bls::PublicKey>      aggregatePubkeyAsync();
+    Task<Recipient>           viewRecipientDataAsync(std::string address);
+#endif
 
     Transaction liquidateBLSPublicKeyWithSignature(const uint64_t service_node_id, const std::string& pubkey, const std::string& sig, const std::vector<uint64_t>& non_signer_indices);
     Transaction initiateRemoveBLSPublicKey(const uint64_t service_node_id);
     Transaction removeBLSPublicKeyAfterWaitTime(const uint64_t service_node_id);
     Transaction removeBLSPublicKeyWithSignature(const uint64_t service_node_id, const std::string& pubkey, const std::string& sig, const std::vector<uint64_t>& non_signer_indices);
     Transaction updateRewardsBalance(const std::string& address, const uint64_t amount, const std::string& sig, const std::vector<uint64_t>& non_signer_indices);
+    // Sign every update in `updates` with `signers` (see ServiceNodeList::updateRewardsBalances)
+    // and build the transactions, ready to submit, in the same order.
+    std::vector<Transaction> updateRewardsBalances(ServiceNodeList& snl, const std::vector<RewardUpdate>& updates, const uint32_t chainID, const std::vector<uint64_t>& signers, size_t threads = 0);
     Transaction claimRewards();
     Transaction start();
 
+    // Call data and decoding of `recipients(address)` for callers batching
+    // the reads themselves, as RewardsLedger::reconcile does
+    ReadCallData            recipientsCall(const std::string& address) const;
+    static RecipientBalance decodeRecipientBalance(std::string_view hex);
+
 private:
+    MethodCall          instrument(std::string_view method);
+    std::string         callReadFunction(const ReadCallData& callData, MethodCall& call);
+    ContractServiceNode readServiceNode(uint64_t index, MethodCall& call);
+    uint64_t            readUint64(std::string_view method, const std::string& signature);
+
+    // Call data and result decoding shared by the blocking and async reads
+    ReadCallData               serviceNodesCall(uint64_t index) const;
+    ReadCallData               serviceNodeIDsCall(const bls::PublicKey& pKey) const;
+    static ContractServiceNode decodeServiceNode(std::string_view hex);
+    static Recipient           decodeRecipient(const std::string& hex);
+
+#if defined(SERVICE_NODE_REWARDS_COROUTINES)
+    Task<std::string> callReadFunctionAsync(ReadCallData callData, MethodCall& call);
+    Task<uint64_t>    readUint64Async(std::string_view method, std::string signature);
+#endif
+
     std::string contractAddress;
-    std::shared_ptr<Provider> provider;
+    std::shared_ptr<ProviderBackend> backend;
+    std::shared_ptr<ContractReadCache> cache;
+    std::shared_ptr<ContractMetrics> metrics;
+#if defined(SERVICE_NODE_REWARDS_COROUTINES)
+    std::shared_ptr<AsyncJsonRpcClient> asyncClient;
+#endif
+    std::mutex cacheMutex; // Guards `cache`, `metrics` and `asyncClient`
+
+    SingleFlight<std::string, std::string> reads; // Keyed by block and call data
 };
@@ -0,0 +1,113 @@
+#pragma once
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "service_node_rewards/ec_utils.hpp"
+#include "ethyl/provider.hpp"
+
+// Typed records for the events emitted by ServiceNodeRewards.sol. Amounts are
+// uint256 on the contract, like `Recipient` we assume they fit into a uint64_t
+// except for the deposit, which is summed in full and kept as 32 byte hex.
+
+// Where in the chain an event was observed. Used to order events and to detect
+// logs that have been dropped by a reorg.
+struct EventLocation {
+    uint64_t    blockNumber = 0;
+    uint32_t    logIndex    = 0;
+    std::string blockHash;
+    std::string transactionHash;
+};
+
+struct NewServiceNodeEvent {
+    EventLocation                 location;
+    uint64_t                      serviceNodeID;
+    std::array<unsigned char, 20> recipient;
+    bls::PublicKey                pubkey;
+    std::string                   deposit; // 32 byte hex, sum of the contributors stake
+};
+
+struct NewSeededServiceNodeEvent {
+    EventLocation  location;
+    uint64_t       serviceNodeID;
+    bls::PublicKey pubkey;
+};
+
+struct ServiceNodeRemovalRequestEvent {
+    EventLocation                 location;
+    uint64_t                      serviceNodeID;
+    std::array<unsigned char, 20> recipient;
+    bls::PublicKey                pubkey;
+};
+
+struct ServiceNodeRemovalEvent {
+    EventLocation                 location;
+    uint64_t                      serviceNodeID;
+    std::array<unsigned char, 20> recipient;
+    uint64_t                      returnedAmount;
+    bls::PublicKey                pubkey;
+};
+
+struct ServiceNodeLiquidatedEvent {
+    EventLocation                 location;
+    uint64_t                      serviceNodeID;
+    std::array<unsigned char, 20> recipient;
+    bls::PublicKey                pubkey;
+};
+
+struct RewardsBalanceUpdatedEvent {
+    EventLocation                 location;
+    std::array<unsigned char, 20> recipient;
+    uint64_t                      amount;
+    uint64_t                      previousBalance;
+};
+
+struct RewardsClaimedEvent {
+    EventLocation                 location;
+    std::array<unsigned char, 20> recipient;
+    uint64_t                      amount;
+};
+
+struct StakingRequirementUpdatedEvent {
+    EventLocation location;
+    std::string   newRequirement; // 32 byte hex
+};
+
+struct BLSNonSignerThresholdMaxUpdatedEvent {
+    EventLocation location;
+    uint64_t      newMax;
+};
+
+using ServiceNodeRewardsEvent = std::variant<NewServiceNodeEvent,
+                                             NewSeededServiceNodeEvent,
+                                             ServiceNodeRemovalRequestEvent,
+                                             ServiceNodeRemovalEvent,
+                                             ServiceNodeLiquidatedEvent,
+                                             RewardsBalanceUpdatedEvent,
+                                             RewardsClaimedEvent,
+                                             StakingRequirementUpdatedEvent,
+                                             BLSNonSignerThresholdMaxUpdatedEvent>;
+
+namespace events
+{
+    // Topic 0 (keccak of the canonical event signature) for each event, "0x" prefixed lowercase hex
+    const std::string& newServiceNodeTopic();
+    const std::string& newSeededServiceNodeTopic();
+    const std::string& serviceNodeRemovalRequestTopic();
+    const std::string& serviceNodeRemovalTopic();
+    const std::string& serviceNodeLiquidatedTopic();
+    const std::string& rewardsBalanceUpdatedTopic();
+    const std::string& rewardsClaimedTopic();
+    const std::string& stakingRequirementUpdatedTopic();
+    const std::string& blsNonSignerThresholdMaxUpdatedTopic();
+
+    // Decode a raw log into a typed event. Returns nullopt for logs that are
+    // not one of the events above (e.g. Ownable/Pausable events). Throws if
+    // the log matches a known topic but is malformed.
+    std::optional<ServiceNodeRewardsEvent> decode(const LogEntry& log);
+
+    const EventLocation& location(const ServiceNodeRewardsEvent& event);
+}
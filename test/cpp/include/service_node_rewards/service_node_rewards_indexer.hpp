@@ -0,0 +1,70 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+#include "service_node_rewards/service_node_rewards_events.hpp"
+#include "ethyl/provider.hpp"
+
+// Local copy of the contract's service node linked list and recipients, built
+// purely from the events the contract emits.
+struct ServiceNodeRewardsMirror {
+    // Keyed by service node ID, includes the sentinel at SERVICE_NODE_LIST_SENTINEL.
+    std::unordered_map<uint64_t, ContractServiceNode> nodes;
+    // Block the leave request was made in, the event does not carry the
+    // timestamp that the contract stores in `leaveRequestTimestamp`.
+    std::unordered_map<uint64_t, uint64_t>            leaveRequestBlocks;
+    // Keyed by the 20 byte recipient address as lowercase hex without "0x"
+    std::unordered_map<std::string, Recipient>        recipients;
+    // Highest block whose events have been applied
+    uint64_t                                          height = 0;
+
+    ServiceNodeRewardsMirror();
+
+    void                  apply(const ServiceNodeRewardsEvent& event);
+    size_t                size() const; // Number of service nodes, excluding the sentinel
+    std::vector<uint64_t> serviceNodeIDs() const; // Linked list order
+    bls::PublicKey        aggregatePubkey() const;
+};
+
+struct IndexerSyncResult {
+    uint64_t                             confirmedHeight = 0;
+    uint64_t                             headHeight      = 0;
+    // Events that became final in this sync and were applied to `confirmed()`
+    std::vector<ServiceNodeRewardsEvent> confirmed;
+    // Events within `confirmations` of the head, applied only to `latest()`
+    std::vector<ServiceNodeRewardsEvent> tentative;
+    // True if events reported as tentative by the previous sync are no longer on chain
+    bool                                 reorged = false;
+};
+
+// Follows the contract with `eth_getLogs` and keeps a `ServiceNodeRewardsMirror`
+// in sync. Logs older than `confirmations` blocks are applied permanently,
+// everything newer is re-queried and re-applied on top of the confirmed state
+// each sync, which rolls back any reorg within the confirmation depth.
+class ServiceNodeRewardsIndexer {
+public:
+    ServiceNodeRewardsIndexer(const std::string& contractAddress, std::shared_ptr<Provider> provider, uint64_t startBlock = 0, uint64_t confirmations = 12, uint64_t chunkSize = 2000);
+    ServiceNodeRewardsIndexer(const std::string& contractAddress, std::shared_ptr<ProviderBackend> backend, uint64_t startBlock = 0, uint64_t confirmations = 12, uint64_t chunkSize = 2000);
+
+    // Sync up to the current chain head
+    IndexerSyncResult sync();
+    IndexerSyncResult syncTo(uint64_t headHeight);
+
+    const ServiceNodeRewardsMirror& confirmed() const { return confirmedMirror; }
+    const ServiceNodeRewardsMirror& latest() const { return latestMirror; }
+
+private:
+    std::vector<ServiceNodeRewardsEvent> fetchEvents(uint64_t fromBlock, uint64_t toBlock);
+
+    std::string                          contractAddress;
+    std::shared_ptr<ProviderBackend>     backend;
+    uint64_t                             nextBlock;
+    uint64_t                             confirmations;
+    uint64_t                             chunkSize;
+    ServiceNodeRewardsMirror             confirmedMirror;
+    ServiceNodeRewardsMirror             latestMirror;
+    std::vector<ServiceNodeRewardsEvent> tentativeEvents;
+};
@@ -0,0 +1,122 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+
+// Reasons a ServiceNodeRewards.sol transaction reverts, named after the
+// contract's custom errors
+enum class ServiceNodeRewardsError {
+    None,
+    ArrayLengthMismatch,
+    BLSPubkeyAlreadyExists,
+    BLSPubkeyDoesNotMatch,
+    ContractNotActive,
+    EarlierLeaveRequestMade,
+    InsufficientBLSSignatures,
+    LeaveRequestTooEarly,
+    NullRecipient,
+    RecipientAddressDoesNotMatch,
+    RecipientRewardsTooLow,
+};
+
+const char* toString(ServiceNodeRewardsError error);
+
+// Outcome of applying one transaction to the model
+struct ServiceNodeRewardsOutcome {
+    ServiceNodeRewardsError error         = ServiceNodeRewardsError::None;
+    uint64_t                serviceNodeID = 0; // Node added, removed or liquidated
+    uint64_t                amount        = 0; // Claimed, or the deposit returned to the operator on a removal or liquidation
+
+    explicit operator bool() const { return error == ServiceNodeRewardsError::None; }
+};
+
+struct ServiceNodeRewardsParams {
+    uint64_t stakingRequirement          = ServiceNodeRewardsContract::STAKING_REQUIREMENT;
+    uint64_t liquidatorRewardRatio       = 0;
+    uint64_t poolShareOfLiquidationRatio = 0;
+    uint64_t recipientRatio              = 1;
+    uint64_t blsNonSignerThresholdMax    = 300;
+};
+
+struct ServiceNodeRewardsModelNode {
+    uint64_t       next;
+    uint64_t       prev;
+    std::string    recipient;             // Operator, "0x" and lower case, zero address for seeded nodes
+    std::string    pubkey;                // Hex as from ServiceNode::getPublicKeyHex, lower case
+    bls::PublicKey blsPubkey;
+    uint64_t       leaveRequestTimestamp;
+    uint64_t       deposit;
+};
+
+// In-process model of the ServiceNodeRewards.sol state machine: the linked
+// list, `serviceNodeIDs`, the aggregate key, the non-signer threshold,
+// recipient balances and the removal and liquidation rules. Each operation
+// takes the same arguments as the transaction ServiceNodeRewardsContract
+// builds (plus the sender and block timestamp where the contract reads them)
+// and either applies it or, where the contract would revert, leaves the state
+// untouched and returns the error. Operations are O(1) bar a point addition
+// per node, so a plan of thousands of transactions can be dry run before
+// sending only the ones that will succeed.
+//
+// NOTE: BLS signatures and proofs of possession are assumed to be valid for
+// the signers given, as they are when built with ServiceNodeList. Owner
+// checks, pausing and the token transfers are not modelled. Like
+// RewardRatePool, arithmetic the contract would panic on throws
+// std::overflow_error.
+class ServiceNodeRewardsModel {
+public:
+    static constexpr inline uint64_t LIST_SENTINEL                      = 0;
+    static constexpr inline uint64_t MAX_SERVICE_NODE_REMOVAL_WAIT_TIME = 30 * 24 * 60 * 60;
+
+    ServiceNodeRewardsModel(ServiceNodeRewardsParams params = {});
+
+    // Load the state of the deployed contract, walking the list one node at a
+    // time. Recipients can't be enumerated on chain so only the `recipients`
+    // given are loaded, the rest start at zero. Attach a ContractReadCache to
+    // `contract` first to read everything from the same block.
+    static ServiceNodeRewardsModel fromContract(ServiceNodeRewardsContract& contract, const std::vector<std::string>& recipients = {});
+
+    ServiceNodeRewardsOutcome start();
+    ServiceNodeRewardsOutcome seedPublicKeyList(const std::vector<std::string>& pubkeys, const std::vector<uint64_t>& amounts);
+    ServiceNodeRewardsOutcome addBLSPublicKey(const std::string& sender, const std::string& pubkey);
+    ServiceNodeRewardsOutcome initiateRemoveBLSPublicKey(const std::string& sender, uint64_t serviceNodeID, uint64_t timestamp);
+    ServiceNodeRewardsOutcome removeBLSPublicKeyAfterWaitTime(uint64_t serviceNodeID, uint64_t timestamp);
+    ServiceNodeRewardsOutcome removeBLSPublicKeyWithSignature(uint64_t serviceNodeID, const std::string& pubkey, const std::vector<uint64_t>& nonSigners);
+    ServiceNodeRewardsOutcome liquidateBLSPublicKeyWithSignature(uint64_t serviceNodeID, const std::string& pubkey, const std::vector<uint64_t>& nonSigners);
+    ServiceNodeRewardsOutcome updateRewardsBalance(const std::string& address, uint64_t amount, const std::vector<uint64_t>& nonSigners);
+    ServiceNodeRewardsOutcome claimRewards(const std::string& sender);
+
+    bool                               isActive() const { return active; }
+    const ServiceNodeRewardsParams&    params() const { return contractParams; }
+    uint64_t                           nextServiceNodeID() const { return nextID; }
+    uint64_t                           serviceNodesLength() const { return totalNodes; }
+    uint64_t                           blsNonSignerThreshold() const { return nonSignerThreshold; }
+    const bls::PublicKey&              aggregatePubkey() const { return aggregate; }
+    // Null if there is no node with the ID
+    const ServiceNodeRewardsModelNode* serviceNodes(uint64_t serviceNodeID) const;
+    // 0 if the key is not in the list
+    uint64_t                           serviceNodeIDs(const std::string& pubkey) const;
+    Recipient                          viewRecipientData(const std::string& address) const;
+    // Node IDs from the head of the list to the tail
+    std::vector<uint64_t>              serviceNodeIDsInOrder() const;
+
+private:
+    ServiceNodeRewardsError checkNonSigners(const std::vector<uint64_t>& nonSigners) const;
+    uint64_t                serviceNodeAdd(const std::string& pubkey, bls::PublicKey blsPubkey);
+    void                    serviceNodeDelete(uint64_t serviceNodeID);
+    void                    updateBLSNonSignerThreshold();
+
+    ServiceNodeRewardsParams                                  contractParams;
+    bool                                                      active             = false;
+    uint64_t                                                  nextID             = LIST_SENTINEL + 1;
+    uint64_t                                                  totalNodes         = 0;
+    uint64_t                                                  nonSignerThreshold = 0;
+    bls::PublicKey                                            aggregate;
+    std::unordered_map<uint64_t, ServiceNodeRewardsModelNode> nodes;         // Includes the sentinel
+    std::unordered_map<std::string, uint64_t>                 pubkeyToID;
+    std::unordered_map<std::string, Recipient>                recipients;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+#include "service_node_rewards/uint256.hpp"
+
+// Public key in affine coordinates, the point at infinity is (0, 0)
+struct G1Affine {
+    mcl::bn::Fp x;
+    mcl::bn::Fp y;
+};
+
+// Mirror of the contract's service node table stored column by column: each
+// field of every node is in its own contiguous array, row `i` of each array
+// being the same node. A scan over one field (every recipient, every key)
+// only reads that field, at ~20 bytes a node for recipients and 64 for keys,
+// instead of pulling whole ContractServiceNodes (Jacobian key, heap allocated
+// deposit) through the cache. Keys are kept affine so summing them takes the
+// cheaper mixed addition and no normalization.
+//
+// The contract hands out IDs sequentially from 1, so the ID to row index is a
+// plain array indexed by ID rather than a hash map. Rows are not in list
+// order; erasing a node moves the last row into its place.
+//
+// The sentinel (SERVICE_NODE_LIST_SENTINEL) is not a row, inserting it only
+// records the head and tail of the linked list.
+class ServiceNodeTable {
+public:
+    static constexpr inline uint32_t NO_ROW = UINT32_MAX;
+
+    ServiceNodeTable() = default;
+
+    // Every node of `nodes` keyed by ID, the sentinel included if present, as
+    // in ServiceNodeRewardsMirror::nodes. The keys are converted to affine
+    // with a single inversion.
+    static ServiceNodeTable fromNodes(const std::unordered_map<uint64_t, ContractServiceNode>& nodes);
+
+    // Throws std::invalid_argument if the ID is already in the table
+    void                               insert(uint64_t serviceNodeID, const ContractServiceNode& node);
+    // Throws std::invalid_argument if the ID is not in the table
+    void                               erase(uint64_t serviceNodeID);
+    void                               reserve(size_t count);
+    void                               clear();
+
+    size_t                             size() const { return ids.size(); }
+    // Row of the node in the columns, NO_ROW if there is no node with the ID
+    uint32_t                           row(uint64_t serviceNodeID) const;
+    bool                               contains(uint64_t serviceNodeID) const { return row(serviceNodeID) != NO_ROW; }
+    // The node gathered back from the columns, nullopt if there is no node
+    // with the ID. The sentinel is always there.
+    std::optional<ContractServiceNode> serviceNodes(uint64_t serviceNodeID) const;
+
+    // IDs of the nodes paid to `recipient`, in row order
+    std::vector<uint64_t>              serviceNodeIDsForRecipient(const std::array<unsigned char, 20>& recipient) const;
+    // Node IDs from the head of the list to the tail
+    std::vector<uint64_t>              serviceNodeIDsInOrder() const;
+    bls::PublicKey                     aggregatePubkey() const;
+    Uint256                            totalDeposit() const;
+    // Bytes allocated for the columns and the ID index
+    size_t                             memoryUsage() const;
+
+    const std::vector<uint64_t>&                      serviceNodeIDs() const { return ids; }
+    const std::vector<uint64_t>&                      nextIDs() const { return next; }
+    const std::vector<uint64_t>&                      prevIDs() const { return prev; }
+    const std::vector<std::array<unsigned char, 20>>& recipients() const { return recipient; }
+    const std::vector<G1Affine>&                      pubkeys() const { return pubkey; }
+    const std::vector<uint64_t>&                      leaveRequestTimestamps() const { return leaveRequestTimestamp; }
+    const std::vector<Uint256>&                       deposits() const { return deposit; }
+
+private:
+    void append(uint64_t serviceNodeID, const ContractServiceNode& node, const G1Affine& affine);
+
+    uint64_t                                   head = SERVICE_NODE_LIST_SENTINEL; // The sentinel's `next`
+    uint64_t                                   tail = SERVICE_NODE_LIST_SENTINEL; // The sentinel's `prev`
+    std::vector<uint32_t>                      rowByID;                            // Indexed by ID
+
+    std::vector<uint64_t>                      ids;
+    std::vector<uint64_t>                      next;
+    std::vector<uint64_t>                      prev;
+    std::vector<std::array<unsigned char, 20>> recipient;
+    std::vector<G1Affine>                      pubkey;
+    std::vector<uint64_t>                      leaveRequestTimestamp;
+    std::vector<Uint256>                       deposit;
+};
@@ -0,0 +1,205 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/single_flight.hpp"
+
+// Signing over a local Unix socket from a long running process that holds the
+// service node keys, so short lived tools don't each restore the keys and set
+// up BLS before signing a handful of messages.
+//
+//   ./signing_daemon --keys keys.json --socket /tmp/sn-signer.sock &
+//
+//   SigningDaemonClient signer("/tmp/sn-signer.sock");
+//   std::string sig = signer.updateRewardsBalance(address, amount, chainID, contractAddress, signers);
+//
+// The client's methods match ServiceNodeList's and return the same hex.
+//
+// Wire format, every integer big endian. Each message is a frame of a u32
+// body length followed by the body:
+//
+//   request  = u8 type | u32 id | fields of the type
+//     ProofOfPossession  u64 node | u32 chain | 20 contract | 20 sender | u16 length | pubkey bytes
+//     Reward             u32 chain | 20 contract | 20 recipient | u64 amount | signers
+//     Removal            u64 node | u32 chain | 20 contract | signers
+//     Liquidation        u64 node | u32 chain | 20 contract | signers
+//     Aggregate          32 hash | signers
+//   signers  = u32 count | u64 service node ID * count, a count of 0 for every node
+//
+//   response = u8 status | u32 id, then
+//     ok (0)     u8 has pubkey | 64 pubkey if it has one | 128 signature
+//     error (1)  u16 length | message
+//
+// Removal, Liquidation and Aggregate answer with the public key as well, the
+// removed node's or the signers' aggregate. A connection is served one request
+// at a time in the order sent, open several for concurrency.
+namespace signing_daemon {
+
+enum class RequestType : uint8_t {
+    ProofOfPossession = 1,
+    Reward            = 2,
+    Removal           = 3,
+    Liquidation       = 4,
+    Aggregate         = 5,
+};
+
+constexpr inline size_t MAX_FRAME_SIZE = 4 * 1024 * 1024;
+
+struct Request {
+    RequestType                   type          = RequestType::Aggregate;
+    uint32_t                      id            = 0;
+    uint64_t                      serviceNodeID = 0; // Signer of a proof of possession, the node removed or liquidated
+    uint32_t                      chainID       = 0;
+    std::string                   contractAddress;   // Hex, with or without "0x"
+    std::string                   senderAddress;     // ProofOfPossession
+    std::string                   serviceNodePubkey; // ProofOfPossession, raw bytes as given to ServiceNode::proofOfPossession
+    std::string                   recipient;         // Reward
+    uint64_t                      amount        = 0; // Reward
+    std::array<unsigned char, 32> hash          = {}; // Aggregate
+    std::vector<uint64_t>         signers;           // Empty for every node
+};
+
+struct Response {
+    uint32_t    id = 0;
+    std::string error;     // Empty on success
+    std::string publicKey; // Hex, empty for the requests that don't return one
+    std::string signature; // Hex
+
+    bool ok() const { return error.empty(); }
+};
+
+// Frames, including the length prefix. Throw std::invalid_argument on a field
+// that does not fit the format.
+std::string encodeRequest(const Request& request);
+std::string encodeResponse(const Response& response);
+
+// Bodies, without the length prefix. Throw std::runtime_error on a truncated
+// or malformed body.
+Request  decodeRequest(std::string_view body);
+Response decodeResponse(std::string_view body);
+
+} // namespace signing_daemon
+
+// Answers signing requests from a service node list kept in memory.
+//
+// Signatures are made with the sum of the signers' secret keys, one hash-to-G2
+// and scalar multiply however many signers there are, and the summed key of
+// each signer set is cached. Concurrent requests for the same message and
+// signer set are coalesced into one signature shared by all of them.
+// Thread safe.
+class SigningService {
+public:
+    explicit SigningService(ServiceNodeList snl, size_t keyCacheSize = 64);
+
+    // Never throws for a bad request, the error is returned in the response
+    signing_daemon::Response handle(const signing_daemon::Request& request);
+
+    // Signatures computed, fewer than the requests answered when concurrent
+    // requests were coalesced
+    uint64_t signaturesComputed() const { return signatures; }
+    // Requests so far that shared a signature already being computed
+    uint64_t coalescedRequests() const { return signing.coalesced(); }
+    size_t   size() const { return snl.nodes.size(); }
+
+    // Run `hook` before each signature is computed, while the requests for the
+    // same signature coalesce behind it. For tests, pass nullptr to clear it.
+    void setSignHook(std::function<void()> hook);
+
+private:
+    struct Signed {
+        std::string publicKey;
+        std::string signature;
+    };
+    struct SignerSet {
+        bls::SecretKey secretKey;
+        std::string    publicKey; // Hex
+    };
+
+    std::shared_ptr<const SignerSet> signerSet(const std::vector<uint64_t>& signers);
+    Signed                           sign(const std::string& key, const std::array<unsigned char, 32>& hash, const std::vector<uint64_t>& signers);
+    size_t                           nodeIndex(uint64_t serviceNodeID) const;
+
+    ServiceNodeList                                                   snl;
+    std::unordered_map<uint64_t, size_t>                              indexByID;
+    std::vector<std::string>                                          publicKeys;   // Hex, in list order
+    std::shared_ptr<const SignerSet>                                  everyNode;
+    size_t                                                            keyCacheSize;
+    std::unordered_map<std::string, std::shared_ptr<const SignerSet>> keyCache;     // Keyed by the sorted signer IDs
+    std::mutex                                                        keyCacheMutex;
+    SingleFlight<std::string, Signed>                                 signing;      // Keyed by message and signer set
+    std::atomic<uint64_t>                                             signatures = 0;
+    std::function<void()>                                             signHook;
+    std::mutex                                                        signHookMutex;
+};
+
+// Serves a SigningService on a Unix domain socket, a thread per connection.
+class SigningDaemon {
+public:
+    // Removes a stale socket at `socketPath` and listens on it, only the
+    // daemon's user may connect. Throws std::runtime_error if it can't or
+    // something other than a socket is at the path.
+    SigningDaemon(SigningService& service, std::string socketPath);
+    ~SigningDaemon();
+
+    SigningDaemon(const SigningDaemon&)            = delete;
+    SigningDaemon& operator=(const SigningDaemon&) = delete;
+
+    // Close every connection, stop listening and remove the socket file
+    void               stop();
+    const std::string& path() const { return socketPath; }
+
+private:
+    struct Connection {
+        int               fd = -1;
+        std::thread       thread;
+        std::atomic<bool> done = false;
+    };
+
+    void acceptLoop();
+    void serve(Connection& connection);
+
+    SigningService&                          service;
+    std::string                              socketPath;
+    int                                      listenFd = -1;
+    std::atomic<bool>                        stopping = false;
+    std::mutex                               connectionsMutex;
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::thread                              acceptThread;
+};
+
+// Blocking client of a SigningDaemon, one request at a time per client. Throws
+// std::runtime_error if the daemon can't be reached or answers with an error.
+class SigningDaemonClient {
+public:
+    explicit SigningDaemonClient(const std::string& socketPath);
+    ~SigningDaemonClient();
+
+    SigningDaemonClient(const SigningDaemonClient&)            = delete;
+    SigningDaemonClient& operator=(const SigningDaemonClient&) = delete;
+
+    std::string                         proofOfPossession(uint64_t serviceNodeID, uint32_t chainID, const std::string& contractAddress, const std::string& senderEthAddress, const std::string& serviceNodePubkey);
+    std::string                         updateRewardsBalance(const std::string& address, uint64_t amount, uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids);
+    std::pair<std::string, std::string> removeNodeFromIndices(uint64_t nodeID, uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids);
+    std::pair<std::string, std::string> liquidateNodeFromIndices(uint64_t nodeID, uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids);
+    // Aggregate public key of the signers and their aggregate signature of `hash`
+    std::pair<std::string, std::string> aggregate(const std::array<unsigned char, 32>& hash, const std::vector<uint64_t>& service_node_ids);
+
+    // Send `request` with the next request ID and wait for its response
+    signing_daemon::Response call(signing_daemon::Request request);
+
+private:
+    int        fd     = -1;
+    uint32_t   nextID = 1;
+    std::mutex mutex;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
+// Coalesces concurrent calls for the same key: the first caller runs the
+// function, everyone who asks for that key while it is running waits for and
+// shares its result (or exception). Nothing is kept once the call finishes,
+// the next request for the key runs the function again.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class SingleFlight {
+public:
+    template <typename Func>
+    Value run(const Key& key, Func&& func) {
+        std::promise<Value>       promise;
+        std::shared_future<Value> future;
+        bool                      leader = false;
+        {
+            std::lock_guard lock{mutex};
+            auto it = inflight.find(key);
+            if (it != inflight.end()) {
+                future = it->second;
+                coalescedCalls++;
+            } else {
+                future = promise.get_future().share();
+                leader = true;
+                inflight.emplace(key, future);
+            }
+        }
+
+        // NOTE: A follower just waits on the leader's future
+        if (!leader)
+            return future.get();
+
+        try {
+            promise.set_value(func());
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+
+        {
+            std::lock_guard lock{mutex};
+            inflight.erase(key);
+        }
+        return future.get();
+    }
+
+    // Number of distinct keys with a call running
+    size_t inFlight() const {
+        std::lock_guard lock{mutex};
+        return inflight.size();
+    }
+
+    // Callers so far that shared another caller's call instead of running
+    // their own
+    uint64_t coalesced() const {
+        std::lock_guard lock{mutex};
+        return coalescedCalls;
+    }
+
+private:
+    std::unordered_map<Key, std::shared_future<Value>, Hash> inflight;
+    uint64_t                                                  coalescedCalls = 0;
+    mutable std::mutex                                        mutex;
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Scoped spans over the sign -> encode -> submit -> confirm pipeline, written
+// out as Chrome `trace_event` JSON (open it in Perfetto or chrome://tracing).
+//
+// The spans in the library are compiled in only when building with
+// -D<project>_ENABLE_TRACING=ON (which defines SERVICE_NODE_REWARDS_TRACING),
+// and then only record between `tracing::start()` and `tracing::stop()`. Each
+// thread records into its own fixed size ring buffer without locking, the
+// oldest events are overwritten once it is full.
+//
+//   tracing::start();
+//   ... run a rewards round ...
+//   tracing::stop();
+//   tracing::write("rewards_round.json");
+namespace tracing
+{
+    // NOTE: Read on every span, defined here so the check inlines
+    inline std::atomic<bool> recording = false;
+
+    // Drop any previous events and start recording, keeping the last
+    // `eventsPerThread` spans of each thread.
+    void start(size_t eventsPerThread = 1 << 16);
+    void stop();
+
+    // Every buffered span as trace_event JSON. Call once the traced threads
+    // are idle, spans still being written may be torn.
+    std::string json();
+    void        write(const std::string& path);
+
+    // Nanoseconds since the process started tracing
+    uint64_t now();
+    // `category` and `name` must outlive the trace, i.e. string literals
+    void record(const char* category, const char* name, uint64_t startNs, uint64_t endNs);
+
+    class Span {
+    public:
+        Span(const char* _category, const char* _name) : category(_category), name(_name), active(recording.load(std::memory_order_relaxed)) {
+            if (active)
+                startNs = now();
+        }
+        ~Span() {
+            if (active)
+                record(category, name, startNs, now());
+        }
+
+        Span(const Span&)            = delete;
+        Span& operator=(const Span&) = delete;
+
+    private:
+        const char* category;
+        const char* name;
+        bool        active;
+        uint64_t    startNs = 0;
+    };
+}
+
+#define SERVICE_NODE_REWARDS_TRACE_CONCAT2(a, b) a##b
+#define SERVICE_NODE_REWARDS_TRACE_CONCAT(a, b) SERVICE_NODE_REWARDS_TRACE_CONCAT2(a, b)
+
+#if defined(SERVICE_NODE_REWARDS_TRACING)
+#define TRACE_SPAN(category, name) tracing::Span SERVICE_NODE_REWARDS_TRACE_CONCAT(traceSpan, __LINE__)(category, name)
+#else
+#define TRACE_SPAN(category, name) do {} while (0)
+#endif
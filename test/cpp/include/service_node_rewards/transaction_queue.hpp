@@ -0,0 +1,103 @@
+#pragma once
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ethyl/provider.hpp"
+#include "ethyl/signer.hpp"
+#include "ethyl/transaction.hpp"
+
+#include "service_node_rewards/metrics.hpp"
+#include "service_node_rewards/receipt_tracker.hpp"
+
+// Signs and broadcasts transactions back to back without waiting for each one
+// to be mined. Nonces are allocated locally per sender (seeded from the node's
+// pending count) so many transactions can be in the mempool at once. Receipts
+// are correlated as they arrive through `poll`, completing the future returned
+// by `submit`.
+//
+//   TransactionQueue queue(provider, signer);
+//   std::vector<TransactionFuture> results;
+//   for (auto& node : snl.nodes)
+//       results.push_back(queue.submit(rewards_contract.addBLSPublicKey(...), seckey));
+//   queue.waitAll();
+//
+// If a broadcast fails the nonce is handed back so the next submission fills
+// the gap. A nonce that cannot be handed back (later nonces are already in
+// flight) is filled with a zero value self transfer so the sender is not
+// stuck. A broadcast rejected with "nonce too low" instead discards the
+// sender's local nonces, the next submission re-reads them from the node.
+// Stuck transactions can be re-broadcast with higher fees with `replace`.
+// Broadcasts are made without holding the queue's lock, so submissions from
+// several threads and `poll` don't wait on each other's round trips.
+class TransactionQueue {
+public:
+    TransactionQueue(std::shared_ptr<Provider> provider, Signer& signer);
+
+    // Sign and broadcast `tx` with the next nonce for the sender of `seckey`.
+    // The chain ID, nonce and fees are filled in. Throws if the node rejects
+    // the transaction.
+    TransactionFuture submit(Transaction tx, const std::vector<unsigned char>& seckey);
+
+    // Re-broadcast the in-flight transaction `hash` at the same nonce with its
+    // fees bumped by `feeBumpPercent` (nodes require at least 10%). The future
+    // from the original `submit` completes with whichever version is mined.
+    // Returns the hash of the replacement.
+    std::string replace(const std::string& hash, const std::vector<unsigned char>& seckey, uint64_t feeBumpPercent = 15);
+
+    // Fetch receipts for in-flight transactions, completing any that were
+    // mined. Returns the number of transactions still in flight.
+    size_t poll();
+
+    // Poll until every submitted transaction has a receipt. Returns false on timeout.
+    bool waitAll(std::chrono::milliseconds timeout = std::chrono::minutes(5), std::chrono::milliseconds interval = std::chrono::milliseconds(250));
+
+    // Fetch receipts in a single batch through `tracker` instead of one
+    // request per in-flight transaction.
+    void setReceiptTracker(std::shared_ptr<ReceiptTracker> tracker);
+
+    // Record broadcasts into `metrics` under "sendTransaction": the broadcast
+    // round trip as the network phase and the time until `poll` saw the
+    // receipt as the receipt phase. Pass nullptr to turn it off.
+    void setMetrics(std::shared_ptr<ContractMetrics> metrics);
+
+    // Discard the local nonce for `senderAddress` and re-read it from the node.
+    void resyncNonce(const std::string& senderAddress);
+
+    size_t inFlight() const;
+
+private:
+    struct Sender {
+        uint64_t              nextNonce;
+        std::vector<uint64_t> gaps; // Released nonces that could not be handed back
+    };
+
+    struct InFlight {
+        Transaction                     tx;
+        std::string                     sender;
+        std::vector<std::string>        hashes; // Original followed by any replacements
+        std::promise<TransactionResult> promise;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    Sender&     sender(const std::string& address);
+    void        populate(Transaction& tx);
+    std::string broadcast(Transaction& tx, const std::vector<unsigned char>& seckey);
+
+    std::shared_ptr<Provider>                         provider;
+    Signer&                                           signer;
+    std::shared_ptr<ReceiptTracker>                   receiptTracker;
+    std::shared_ptr<ContractMetrics>                  metrics;
+    std::optional<uint64_t>                           chainId;
+    std::optional<FeeData>                            feeData;
+    std::unordered_map<std::string, Sender>           senders;
+    std::unordered_map<uint64_t, InFlight>            inflight;      // Keyed by a local ticket ID
+    std::unordered_map<std::string, uint64_t>         hashToTicket;
+    uint64_t                                          nextTicket = 0;
+    mutable std::mutex                                mutex;
+};
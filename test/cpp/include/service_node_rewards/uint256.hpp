@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Unsigned 256 bit integer with the semantics of a Solidity `uint256` under
+// checked arithmetic: addition, subtraction and multiplication that would wrap
+// throw std::overflow_error (where the EVM would revert with a panic) and
+// division by zero throws std::domain_error.
+class Uint256 {
+public:
+    // Little endian, limbs[0] holds the least significant 64 bits
+    std::array<uint64_t, 4> limbs = {};
+
+    constexpr Uint256() = default;
+    constexpr Uint256(uint64_t value) : limbs{value, 0, 0, 0} {}
+
+    // Parse big endian hex as returned by eth_call, with or without "0x".
+    // Throws if there are no digits or the value does not fit in 256 bits.
+    static Uint256 fromHex(std::string_view hex);
+
+    // 64 character big endian hex without "0x", i.e. one ABI encoded word
+    std::string toHex() const;
+    // Base 10
+    std::string toString() const;
+
+    bool     isZero() const { return (limbs[0] | limbs[1] | limbs[2] | limbs[3]) == 0; }
+    bool     fitsUint64() const { return (limbs[1] | limbs[2] | limbs[3]) == 0; }
+    uint64_t low64() const { return limbs[0]; }
+    // Number of bits needed to represent the value, 0 for zero
+    size_t   bitWidth() const;
+
+    Uint256& operator+=(const Uint256& rhs);
+    Uint256& operator-=(const Uint256& rhs);
+    Uint256& operator*=(const Uint256& rhs);
+    Uint256& operator/=(const Uint256& rhs);
+    Uint256& operator%=(const Uint256& rhs);
+    Uint256& operator<<=(size_t shift);
+    Uint256& operator>>=(size_t shift);
+
+    // Faster paths for a 64 bit right hand side
+    Uint256& operator*=(uint64_t rhs);
+    Uint256& operator/=(uint64_t rhs);
+
+    friend Uint256 operator+(Uint256 lhs, const Uint256& rhs) { return lhs += rhs; }
+    friend Uint256 operator-(Uint256 lhs, const Uint256& rhs) { return lhs -= rhs; }
+    friend Uint256 operator*(Uint256 lhs, const Uint256& rhs) { return lhs *= rhs; }
+    friend Uint256 operator/(Uint256 lhs, const Uint256& rhs) { return lhs /= rhs; }
+    friend Uint256 operator%(Uint256 lhs, const Uint256& rhs) { return lhs %= rhs; }
+    friend Uint256 operator*(Uint256 lhs, uint64_t rhs) { return lhs *= rhs; }
+    friend Uint256 operator/(Uint256 lhs, uint64_t rhs) { return lhs /= rhs; }
+    friend Uint256 operator<<(Uint256 lhs, size_t shift) { return lhs <<= shift; }
+    friend Uint256 operator>>(Uint256 lhs, size_t shift) { return lhs >>= shift; }
+
+    friend bool operator==(const Uint256& lhs, const Uint256& rhs) { return lhs.limbs == rhs.limbs; }
+    friend bool operator!=(const Uint256& lhs, const Uint256& rhs) { return lhs.limbs != rhs.limbs; }
+    friend bool operator<(const Uint256& lhs, const Uint256& rhs) {
+        for (size_t index = lhs.limbs.size(); index-- > 0;) {
+            if (lhs.limbs[index] != rhs.limbs[index])
+                return lhs.limbs[index] < rhs.limbs[index];
+        }
+        return false;
+    }
+    friend bool operator>(const Uint256& lhs, const Uint256& rhs) { return rhs < lhs; }
+    friend bool operator<=(const Uint256& lhs, const Uint256& rhs) { return !(rhs < lhs); }
+    friend bool operator>=(const Uint256& lhs, const Uint256& rhs) { return !(lhs < rhs); }
+
+    // Quotient and remainder in one pass
+    static void divmod(const Uint256& numerator, const Uint256& denominator, Uint256& quotient, Uint256& remainder);
+};
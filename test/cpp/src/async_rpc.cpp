@@ -0,0 +1,295 @@
+#include "service_node_rewards/async_rpc.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+#include <curl/curl.h>
+
+#include "ethyl/utils.hpp"
+
+class EventLoop::HttpTransfer {
+public:
+    HttpTransfer(EventLoop& _loop, const std::string& _url, std::string body) : loop(_loop), request(std::move(body)), url(_url) {
+        easy = curl_easy_init();
+        if (!easy)
+            throw std::runtime_error("Failed to create a HTTP transfer to '" + url + "'");
+        headers = curl_slist_append(headers, "Content-Type: application/json");
+        curl_easy_setopt(easy, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.data());
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.size()));
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, &HttpTransfer::write);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &response.body);
+        curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, errorBuffer);
+        curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(easy, CURLOPT_TIMEOUT, 60L);
+    }
+
+    ~HttpTransfer() {
+        if (added)
+            loop.remove(this);
+        curl_easy_cleanup(easy);
+        curl_slist_free_all(headers);
+    }
+
+    static size_t write(char* data, size_t size, size_t count, void* userdata) {
+        static_cast<std::string*>(userdata)->append(data, size * count);
+        return size * count;
+    }
+
+    EventLoop&              loop;
+    CURL*                   easy    = nullptr;
+    curl_slist*             headers = nullptr;
+    std::string             request;
+    std::string             url;
+    HttpResponse            response;
+    char                    errorBuffer[CURL_ERROR_SIZE] = {};
+    CURLcode                result = CURLE_OK;
+    std::coroutine_handle<> awaiting;
+    bool                    added = false;
+};
+
+EventLoop::HttpAwaiter::HttpAwaiter(EventLoop& loop, const std::string& url, std::string body)
+        : transfer(std::make_unique<HttpTransfer>(loop, url, std::move(body))) {}
+
+EventLoop::HttpAwaiter::HttpAwaiter(HttpAwaiter&&) noexcept = default;
+EventLoop::HttpAwaiter::~HttpAwaiter()                      = default;
+
+void EventLoop::HttpAwaiter::await_suspend(std::coroutine_handle<> awaiting) {
+    transfer->awaiting = awaiting;
+    transfer->loop.add(transfer.get());
+}
+
+HttpResponse EventLoop::HttpAwaiter::await_resume() {
+    if (transfer->result != CURLE_OK) {
+        std::stringstream stream;
+        stream << "HTTP request to '" << transfer->url << "' failed: " << (transfer->errorBuffer[0] ? transfer->errorBuffer : curl_easy_strerror(transfer->result));
+        throw std::runtime_error(stream.str());
+    }
+    curl_easy_getinfo(transfer->easy, CURLINFO_RESPONSE_CODE, &transfer->response.status);
+    return std::move(transfer->response);
+}
+
+EventLoop::EventLoop(long maxHostConnections) {
+    multi = curl_multi_init();
+    if (!multi)
+        throw std::runtime_error("Failed to create the event loop's curl multi handle");
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, maxHostConnections);
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+}
+
+EventLoop::~EventLoop() {
+    // NOTE: Destroying the suspended tasks runs their awaiters' destructors,
+    // which take their transfers back out of the multi handle.
+    spawned.clear();
+    curl_multi_cleanup(multi);
+}
+
+void EventLoop::spawn(Task<void> task) {
+    ready.push_back(task.handle);
+    spawned.push_back(std::move(task));
+}
+
+void EventLoop::run() {
+    while (!spawned.empty()) {
+        step();
+        if (failure)
+            std::rethrow_exception(std::exchange(failure, nullptr));
+    }
+}
+
+void EventLoop::schedule(std::chrono::steady_clock::time_point deadline, std::coroutine_handle<> handle) {
+    timers.push(Timer{deadline, nextTimerSequence++, handle});
+}
+
+void EventLoop::add(HttpTransfer* transfer) {
+    curl_easy_setopt(transfer->easy, CURLOPT_PRIVATE, transfer);
+    CURLMcode code = curl_multi_add_handle(multi, transfer->easy);
+    if (code != CURLM_OK)
+        throw std::runtime_error(std::string("Failed to start HTTP request: ") + curl_multi_strerror(code));
+    transfer->added = true;
+    transfers++;
+}
+
+void EventLoop::remove(HttpTransfer* transfer) {
+    curl_multi_remove_handle(multi, transfer->easy);
+    transfer->added = false;
+    transfers--;
+}
+
+void EventLoop::step() {
+    int running = 0;
+    curl_multi_perform(multi, &running);
+
+    // NOTE: Collect everything that is ready before resuming any of it, a
+    // resumed coroutine may start new transfers or set new timers.
+    int queued = 0;
+    while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+        if (message->msg != CURLMSG_DONE)
+            continue;
+        char* privateData = nullptr;
+        curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &privateData);
+        HttpTransfer* transfer = reinterpret_cast<HttpTransfer*>(privateData);
+        transfer->result       = message->data.result;
+        remove(transfer);
+        ready.push_back(transfer->awaiting);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    while (!timers.empty() && timers.top().deadline <= now) {
+        ready.push_back(timers.top().handle);
+        timers.pop();
+    }
+
+    if (ready.empty()) {
+        if (transfers == 0 && timers.empty())
+            throw std::runtime_error("Event loop has nothing left to wait on but tasks are still suspended");
+
+        // NOTE: Sleep until there is network activity, curl needs servicing
+        // or the next timer is due.
+        long timeoutMs = 1000;
+        long curlTimeoutMs = -1;
+        curl_multi_timeout(multi, &curlTimeoutMs);
+        if (curlTimeoutMs >= 0)
+            timeoutMs = std::min(timeoutMs, curlTimeoutMs);
+        if (!timers.empty()) {
+            auto untilTimer = std::chrono::duration_cast<std::chrono::milliseconds>(timers.top().deadline - now).count() + 1;
+            timeoutMs       = std::min<long>(timeoutMs, static_cast<long>(untilTimer));
+        }
+        if (transfers > 0)
+            curl_multi_poll(multi, nullptr, 0, static_cast<int>(timeoutMs), nullptr);
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+        return;
+    }
+
+    std::vector<std::coroutine_handle<>> resuming;
+    resuming.swap(ready);
+    for (std::coroutine_handle<> handle : resuming)
+        handle.resume();
+    reap();
+}
+
+void EventLoop::reap() {
+    for (size_t index = 0; index < spawned.size();) {
+        if (!spawned[index].done()) {
+            index++;
+            continue;
+        }
+
+        Task<void> task = std::move(spawned[index]);
+        spawned[index]  = std::move(spawned.back());
+        spawned.pop_back();
+        if (task.handle.promise().exception && !failure)
+            failure = task.handle.promise().exception;
+    }
+}
+
+AsyncJsonRpcClient::AsyncJsonRpcClient(EventLoop& loop, std::string url) : eventLoop(loop), endpoint(std::move(url)) {}
+
+Task<nlohmann::json> AsyncJsonRpcClient::call(std::string method, nlohmann::json params) {
+    nlohmann::json request  = {{"jsonrpc", "2.0"}, {"id", nextId++}, {"method", method}, {"params", std::move(params)}};
+    HttpResponse   response = co_await eventLoop.post(endpoint, request.dump());
+    if (response.status != 200)
+        throw std::runtime_error("JSON-RPC request to '" + endpoint + "' failed with HTTP status " + std::to_string(response.status) + ": " + response.body);
+
+    nlohmann::json body = nlohmann::json::parse(response.body);
+    if (body.contains("error"))
+        throw JsonRpcError("JSON-RPC '" + method + "' returned an error: " + body["error"].dump(), body["error"]);
+    co_return std::move(body["result"]);
+}
+
+Task<std::string> AsyncJsonRpcClient::callReadFunction(ReadCallData callData, std::string blockNumber) {
+    nlohmann::json params = nlohmann::json::array();
+    params.push_back({{"to", callData.contractAddress}, {"data", callData.data}});
+    params.push_back(std::move(blockNumber));
+    nlohmann::json result = co_await call("eth_call", std::move(params));
+    co_return result.get<std::string>();
+}
+
+Task<std::string> AsyncJsonRpcClient::callReadFunction(ReadCallData callData, uint64_t blockNumber) {
+    return callReadFunction(std::move(callData), "0x" + utils::decimalToHex(blockNumber));
+}
+
+AsyncTransactionSender::AsyncTransactionSender(std::shared_ptr<AsyncJsonRpcClient> _client, Signer& _signer)
+        : client(std::move(_client)), signer(_signer) {}
+
+Task<void> AsyncTransactionSender::populate(Transaction& tx) {
+    if (!chainId) {
+        nlohmann::json result = co_await client->call("eth_chainId", nlohmann::json::array());
+        chainId               = utils::fromHexStringToUint64(result.get<std::string>());
+    }
+    if (!feeData) {
+        // NOTE: Same rule as ethers: room for the base fee to double before
+        // the transaction is priced out, plus the suggested tip.
+        nlohmann::json params = nlohmann::json::array({"latest", false});
+        nlohmann::json block  = co_await client->call("eth_getBlockByNumber", std::move(params));
+        nlohmann::json tip    = co_await client->call("eth_maxPriorityFeePerGas", nlohmann::json::array());
+        FeeData        fees   = {};
+        fees.maxPriorityFeePerGas = utils::fromHexStringToUint64(tip.get<std::string>());
+        fees.maxFeePerGas         = utils::fromHexStringToUint64(block.value("baseFeePerGas", "0x0")) * 2 + fees.maxPriorityFeePerGas;
+        feeData                   = fees;
+    }
+    tx.chainId              = *chainId;
+    tx.maxFeePerGas         = feeData->maxFeePerGas;
+    tx.maxPriorityFeePerGas = feeData->maxPriorityFeePerGas;
+}
+
+Task<std::string> AsyncTransactionSender::submit(Transaction tx, std::vector<unsigned char> seckey) {
+    const std::string address = signer.secretKeyToAddressString(seckey);
+    co_await populate(tx);
+
+    // NOTE: Submissions for the same sender may overlap the first nonce read,
+    // the first to finish seeds the counter and the rest count on from it.
+    if (nextNonce.find(address) == nextNonce.end()) {
+        nlohmann::json params = nlohmann::json::array({address, "pending"});
+        nlohmann::json count  = co_await client->call("eth_getTransactionCount", std::move(params));
+        nextNonce.try_emplace(address, utils::fromHexStringToUint64(count.get<std::string>()));
+    }
+    tx.nonce = nextNonce[address]++;
+
+    std::string raw = signer.signTransaction(tx, seckey);
+    if (raw.substr(0, 2) != "0x")
+        raw = "0x" + raw;
+
+    try {
+        nlohmann::json params = nlohmann::json::array({raw});
+        nlohmann::json hash   = co_await client->call("eth_sendRawTransaction", std::move(params));
+        co_return hash.get<std::string>();
+    } catch (const std::exception&) {
+        // NOTE: Later nonces may already be in flight and the gap can't be
+        // filled from here, re-read the nonce from the node next time.
+        auto it = nextNonce.find(address);
+        if (it != nextNonce.end() && it->second == tx.nonce + 1)
+            it->second--;
+        else
+            nextNonce.erase(address);
+        throw;
+    }
+}
+
+Task<TransactionResult> AsyncTransactionSender::waitForReceipt(std::string hash, std::chrono::milliseconds timeout, std::chrono::milliseconds interval) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        nlohmann::json params  = nlohmann::json::array({hash});
+        nlohmann::json receipt = co_await client->call("eth_getTransactionReceipt", std::move(params));
+        if (std::optional<TransactionResult> result = transactionResultFromReceipt(receipt))
+            co_return std::move(*result);
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            std::stringstream stream;
+            stream << "Timed out after " << timeout.count() << "ms waiting for the receipt of transaction " << hash;
+            throw std::runtime_error(stream.str());
+        }
+
+        // NOTE: Pick up the current fees for the next submissions
+        feeData.reset();
+        co_await client->loop().sleep(interval);
+    }
+}
+
+Task<TransactionResult> AsyncTransactionSender::submitAndWait(Transaction tx, std::vector<unsigned char> seckey) {
+    std::string hash = co_await submit(std::move(tx), std::move(seckey));
+    co_return co_await waitForReceipt(std::move(hash));
+}
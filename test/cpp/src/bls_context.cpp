@@ -0,0 +1,57 @@
+#include "service_node_rewards/bls_context.hpp"
+#include "service_node_rewards/crypto_counters.hpp"
+#include "service_node_rewards/tracing.hpp"
+
+#include <array>
+#include <stdexcept>
+
+const BLSContext& BLSContext::get() {
+    // NOTE: A function local static is initialised exactly once even when
+    // several threads get here together, the others wait for the first, as
+    // with std::call_once.
+    static const BLSContext context;
+    return context;
+}
+
+BLSContext::BLSContext() {
+    TRACE_SPAN("bls_context", "initialise");
+    bls::init(mclBn_CurveSNARK1);
+    mclBn_setMapToMode(MCL_MAP_TO_MODE_TRY_AND_INC);
+
+    mcl::bn::G1 gen;
+    bool        ok;
+    mcl::bn::mapToG1(&ok, gen, 1);
+    if (!ok)
+        throw std::runtime_error("Failed to map 1 to G1 for the BLS public key generator");
+
+    blsPublicKey rawGenerator;
+    rawGenerator.v = *reinterpret_cast<const mclBnG1*>(&gen); // Cast gen to mclBnG1 and assign it to publicKey.v
+    blsSetGeneratorOfPublicKey(&rawGenerator);
+    blsGetGeneratorOfPublicKey(const_cast<blsPublicKey*>(publicKeyGenerator.getPtr()));
+
+    TRACE_SPAN("bls_context", "build fixed-base table");
+    generatorTable.resize(WINDOWS * MULTIPLES);
+    mcl::bn::G1 base = gen;
+    for (size_t window = 0; window < WINDOWS; window++) {
+        mcl::bn::G1* row = generatorTable.data() + window * MULTIPLES;
+        row[0]           = base;
+        for (size_t multiple = 1; multiple < MULTIPLES; multiple++)
+            mcl::bn::G1::add(row[multiple], row[multiple - 1], base);
+        mcl::bn::G1::add(base, row[MULTIPLES - 1], base);
+    }
+    utils::NormalizeG1(generatorTable.data(), generatorTable.size());
+}
+
+void BLSContext::multiplyGenerator(mcl::bn::G1& result, const mcl::bn::Fr& scalar) const {
+    std::array<unsigned char, 32> bytes = {};
+    if (scalar.serialize(bytes.data(), bytes.size(), mcl::IoSerialize | mcl::IoBigEndian) != bytes.size())
+        throw std::runtime_error("Failed to serialize a BLS secret key");
+
+    CRYPTO_COUNT(G1ScalarMul);
+    result.clear();
+    for (size_t window = 0; window < WINDOWS; window++) {
+        const unsigned char byte = bytes[bytes.size() - 1 - window];
+        if (byte)
+            mcl::bn::G1::add(result, result, generatorTable[window * MULTIPLES + byte - 1]);
+    }
+}
@@ -0,0 +1,254 @@
+#include "service_node_rewards/contract_read_cache.hpp"
+#include "service_node_rewards/service_node_rewards_indexer.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <type_traits>
+
+static const char CACHE_FILE_MAGIC[] = "service-node-rewards-read-cache-v1";
+
+// What kind of state a read depends on, decides which events invalidate it
+enum class ReadDependency {
+    Immutable,     // Set at initialisation, never invalidated by events
+    NodeList,      // Changes whenever a node is added or removed
+    ServiceNode,   // serviceNodes(id), also changes when a leave request is made
+    Recipient,     // recipients(address)
+    StakingRequirement,
+    NonSignerThresholdMax,
+    Unknown,       // May change without an event, only valid at the block it was read at
+};
+
+static std::string toLower(std::string_view src) {
+    std::string result(src);
+    std::transform(result.begin(), result.end(), result.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+static ReadDependency readDependency(std::string_view callData) {
+    struct Selector {
+        std::string    hex;
+        ReadDependency dependency;
+    };
+
+    static const std::vector<Selector> SELECTORS = [] {
+        std::vector<Selector> result = {
+                {utils::getFunctionSignature("designatedToken()"),             ReadDependency::Immutable},
+                {utils::getFunctionSignature("foundationPool()"),              ReadDependency::Immutable},
+                {utils::getFunctionSignature("proofOfPossessionTag()"),        ReadDependency::Immutable},
+                {utils::getFunctionSignature("rewardTag()"),                   ReadDependency::Immutable},
+                {utils::getFunctionSignature("removalTag()"),                  ReadDependency::Immutable},
+                {utils::getFunctionSignature("liquidateTag()"),                ReadDependency::Immutable},
+                {utils::getFunctionSignature("liquidatorRewardRatio()"),       ReadDependency::Immutable},
+                {utils::getFunctionSignature("poolShareOfLiquidationRatio()"), ReadDependency::Immutable},
+                {utils::getFunctionSignature("recipientRatio()"),              ReadDependency::Immutable},
+                {utils::getFunctionSignature("serviceNodesLength()"),          ReadDependency::NodeList},
+                {utils::getFunctionSignature("aggregatePubkey()"),             ReadDependency::NodeList},
+                {utils::getFunctionSignature("serviceNodeIDs(bytes)"),         ReadDependency::NodeList},
+                {utils::getFunctionSignature("totalNodes()"),                  ReadDependency::NodeList},
+                {utils::getFunctionSignature("nextServiceNodeID()"),           ReadDependency::NodeList},
+                {utils::getFunctionSignature("blsNonSignerThreshold()"),       ReadDependency::NodeList},
+                {utils::getFunctionSignature("serviceNodes(uint64)"),          ReadDependency::ServiceNode},
+                {utils::getFunctionSignature("recipients(address)"),           ReadDependency::Recipient},
+                {utils::getFunctionSignature("stakingRequirement()"),          ReadDependency::StakingRequirement},
+                {utils::getFunctionSignature("blsNonSignerThresholdMax()"),    ReadDependency::NonSignerThresholdMax},
+        };
+        for (Selector& selector : result)
+            selector.hex = toLower(selector.hex);
+        return result;
+    }();
+
+    for (const Selector& selector : SELECTORS) {
+        if (callData.substr(0, selector.hex.size()) == selector.hex)
+            return selector.dependency;
+    }
+    return ReadDependency::Unknown;
+}
+
+// The ABI encoded argument of a single argument read, e.g. the ID in serviceNodes(id)
+static std::string_view readArgument(std::string_view callData) {
+    const size_t SELECTOR_HEX_SIZE = 2 /*0x*/ + 4 * 2;
+    return callData.size() > SELECTOR_HEX_SIZE ? callData.substr(SELECTOR_HEX_SIZE) : std::string_view{};
+}
+
+ContractReadCache::ContractReadCache(const std::string& _contractAddress, std::string _path)
+        : contractAddress(toLower(_contractAddress)), path(std::move(_path)) {}
+
+uint64_t ContractReadCache::blockNumber() const {
+    std::lock_guard lock{mutex};
+    return head;
+}
+
+size_t ContractReadCache::size() const {
+    std::lock_guard lock{mutex};
+    return entries.size();
+}
+
+std::optional<std::string> ContractReadCache::get(const std::string& callData, uint64_t blockNumber) const {
+    std::lock_guard lock{mutex};
+    const std::string key = toLower(callData);
+    auto              it  = entries.find(key);
+    if (it == entries.end() || blockNumber < it->second.blockNumber || blockNumber > head)
+        return std::nullopt;
+    // NOTE: Without a known invalidating event a read can't be carried to a
+    // later block, e.g. IsActive() which start() flips without emitting one
+    if (blockNumber != it->second.blockNumber && readDependency(key) == ReadDependency::Unknown)
+        return std::nullopt;
+    return it->second.result;
+}
+
+void ContractReadCache::put(const std::string& callData, uint64_t blockNumber, std::string result) {
+    // NOTE: Only results read at the head can be carried forward by later events
+    std::lock_guard lock{mutex};
+    if (blockNumber != head)
+        return;
+    entries[toLower(callData)] = Entry{blockNumber, std::move(result)};
+}
+
+void ContractReadCache::invalidate(const ServiceNodeRewardsEvent& event) {
+    std::lock_guard lock{mutex};
+    invalidateLocked(event);
+}
+
+void ContractReadCache::invalidateLocked(const ServiceNodeRewardsEvent& event) {
+    auto invalidates = [&event](std::string_view callData) {
+        const ReadDependency dependency = readDependency(callData);
+        return std::visit([&](const auto& item) {
+            using T = std::decay_t<decltype(item)>;
+            if (dependency == ReadDependency::Unknown)
+                return true;
+
+            if constexpr (std::is_same_v<T, NewServiceNodeEvent> || std::is_same_v<T, NewSeededServiceNodeEvent> || std::is_same_v<T, ServiceNodeRemovalEvent>) {
+                // NOTE: Adding/removing relinks the neighbours so every
+                // serviceNodes(id) read is affected, not just this ID.
+                return dependency == ReadDependency::NodeList || dependency == ReadDependency::ServiceNode;
+            } else if constexpr (std::is_same_v<T, ServiceNodeRemovalRequestEvent>) {
+                return dependency == ReadDependency::ServiceNode &&
+                       utils::fromHexStringToUint64(readArgument(callData)) == item.serviceNodeID;
+            } else if constexpr (std::is_same_v<T, RewardsBalanceUpdatedEvent> || std::is_same_v<T, RewardsClaimedEvent>) {
+                return dependency == ReadDependency::Recipient &&
+                       readArgument(callData) == utils::padTo32Bytes(utils::toHexString(item.recipient), utils::PaddingDirection::LEFT);
+            } else if constexpr (std::is_same_v<T, StakingRequirementUpdatedEvent>) {
+                return dependency == ReadDependency::StakingRequirement;
+            } else if constexpr (std::is_same_v<T, BLSNonSignerThresholdMaxUpdatedEvent>) {
+                return dependency == ReadDependency::NonSignerThresholdMax || dependency == ReadDependency::NodeList;
+            } else {
+                // NOTE: Liquidations are followed by a removal event
+                return false;
+            }
+        }, event);
+    };
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (invalidates(it->first))
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+}
+
+void ContractReadCache::advance(uint64_t blockNumber, const std::vector<ServiceNodeRewardsEvent>& events) {
+    std::lock_guard lock{mutex};
+    advanceLocked(blockNumber, events);
+}
+
+void ContractReadCache::advanceLocked(uint64_t blockNumber, const std::vector<ServiceNodeRewardsEvent>& events) {
+    if (blockNumber < head) {
+        // NOTE: The chain went backwards, entries read after `blockNumber` may
+        // not exist on the new chain.
+        entries.clear();
+        head = blockNumber;
+        return;
+    }
+
+    if (blockNumber > head) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (readDependency(it->first) == ReadDependency::Unknown)
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    for (const ServiceNodeRewardsEvent& event : events) {
+        if (events::location(event).blockNumber > head)
+            invalidateLocked(event);
+    }
+    head = blockNumber;
+}
+
+void ContractReadCache::advance(uint64_t blockNumber) {
+    std::lock_guard lock{mutex};
+    if (blockNumber != head)
+        entries.clear();
+    head = blockNumber;
+}
+
+void ContractReadCache::advance(const IndexerSyncResult& sync) {
+    std::lock_guard lock{mutex};
+    if (sync.reorged) {
+        entries.clear();
+        head = sync.headHeight;
+        return;
+    }
+
+    std::vector<ServiceNodeRewardsEvent> events;
+    events.reserve(sync.confirmed.size() + sync.tentative.size());
+    events.insert(events.end(), sync.confirmed.begin(), sync.confirmed.end());
+    events.insert(events.end(), sync.tentative.begin(), sync.tentative.end());
+    advanceLocked(sync.headHeight, events);
+}
+
+void ContractReadCache::clear() {
+    std::lock_guard lock{mutex};
+    entries.clear();
+}
+
+bool ContractReadCache::load() {
+    if (path.empty())
+        return false;
+
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    std::string magic, address;
+    uint64_t    savedHead = 0;
+    if (!(file >> magic >> address >> savedHead) || magic != CACHE_FILE_MAGIC || address != contractAddress)
+        return false;
+
+    std::unordered_map<std::string, Entry> loaded;
+    uint64_t                               blockNumber = 0;
+    std::string                            callData, result;
+    while (file >> blockNumber >> callData >> result)
+        loaded[callData] = Entry{blockNumber, std::move(result)};
+
+    std::lock_guard lock{mutex};
+    entries = std::move(loaded);
+    head    = savedHead;
+    return true;
+}
+
+void ContractReadCache::save() const {
+    if (path.empty())
+        return;
+
+    // NOTE: Write to a temporary and rename over the store so a crash
+    // mid-write never leaves a truncated cache behind.
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::trunc);
+        if (!file)
+            throw std::runtime_error("Failed to open read cache '" + tmpPath + "' for writing");
+        std::lock_guard lock{mutex};
+        file << CACHE_FILE_MAGIC << ' ' << contractAddress << ' ' << head << '\n';
+        for (const auto& [callData, entry] : entries)
+            file << entry.blockNumber << ' ' << callData << ' ' << entry.result << '\n';
+        if (!file.flush())
+            throw std::runtime_error("Failed to write read cache '" + tmpPath + "'");
+    }
+
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("Failed to move read cache '" + tmpPath + "' to '" + path + "'");
+}
@@ -0,0 +1,56 @@
+#include "service_node_rewards/crypto_counters.hpp"
+
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+    // NOTE: Counters outlive their thread so `total` keeps what it counted
+    std::mutex                                                    registryMutex;
+    std::vector<std::unique_ptr<crypto_counters::ThreadCounters>> registry;
+}
+
+const char* crypto_counters::toString(Op op) {
+    switch (op) {
+        case Op::G1ScalarMul: return "G1ScalarMul";
+        case Op::G2ScalarMul: return "G2ScalarMul";
+        case Op::G1Add:       return "G1Add";
+        case Op::G2Add:       return "G2Add";
+        case Op::HashToG2:    return "HashToG2";
+        case Op::Normalize:   return "Normalize";
+        case Op::Inversion:   return "Inversion";
+        case Op::Count:       break;
+    }
+    return "Unknown";
+}
+
+crypto_counters::Counts crypto_counters::Counts::operator-(const Counts& rhs) const {
+    Counts result;
+    for (size_t index = 0; index < values.size(); index++)
+        result.values[index] = values[index] - rhs.values[index];
+    return result;
+}
+
+std::string crypto_counters::Counts::toString() const {
+    std::stringstream stream;
+    for (size_t index = 0; index < values.size(); index++)
+        stream << (index ? " " : "") << crypto_counters::toString(static_cast<Op>(index)) << "=" << values[index];
+    return stream.str();
+}
+
+crypto_counters::ThreadCounters* crypto_counters::registerThread() {
+    std::lock_guard lock{registryMutex};
+    registry.push_back(std::make_unique<ThreadCounters>());
+    return registry.back().get();
+}
+
+crypto_counters::Counts crypto_counters::total() {
+    Counts          result;
+    std::lock_guard lock{registryMutex};
+    for (const std::unique_ptr<ThreadCounters>& counters : registry) {
+        for (size_t index = 0; index < result.values.size(); index++)
+            result.values[index] += counters->values[index].load(std::memory_order_relaxed);
+    }
+    return result;
+}
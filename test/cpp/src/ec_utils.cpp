@@ -1,15 +1,20 @@
 #include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/bls_context.hpp"
+#include "service_node_rewards/crypto_counters.hpp"
+#include "service_node_rewards/tracing.hpp"
 #include "ethyl/utils.hpp"
 
 #include <cstring>
 
 std::string utils::SignatureToHex(bls::Signature sig) {
+    TRACE_SPAN("ec_utils", "SignatureToHex");
     mclSize serializedSignatureSize = 32;
     std::vector<unsigned char> serialized_signature(serializedSignatureSize*4);
     uint8_t *dst = serialized_signature.data();
     const blsSignature* blssig = sig.getPtr();  
     const mcl::bn::G2* g2Point = reinterpret_cast<const mcl::bn::G2*>(&blssig->v);
     mcl::bn::G2 g2Point2 = *g2Point;
+    CRYPTO_COUNT_NORMALIZE(g2Point2);
     g2Point2.normalize();
     if (g2Point2.x.a.serialize(dst, serializedSignatureSize, mcl::IoSerialize | mcl::IoBigEndian) == 0)
         throw std::runtime_error("size of x.a is zero");
@@ -23,6 +28,7 @@ std::string utils::SignatureToHex(bls::Signature sig) {
 }
 
 std::string utils::BLSPublicKeyToHex(const bls::PublicKey& publicKey) {
+    TRACE_SPAN("ec_utils", "BLSPublicKeyToHex");
     const mclSize                                     KEY_SIZE         = 32;
     std::array<char, KEY_SIZE * 2 /*X, Y component*/> serializedKeyHex = {};
 
@@ -39,6 +45,7 @@ std::string utils::BLSPublicKeyToHex(const bls::PublicKey& publicKey) {
     std::memcpy(const_cast<uint64_t*>(g1Point.x.getUnit()), rawKey->v.x.d, sizeof(rawKey->v.x.d));
     std::memcpy(const_cast<uint64_t*>(g1Point.y.getUnit()), rawKey->v.y.d, sizeof(rawKey->v.y.d));
     std::memcpy(const_cast<uint64_t*>(g1Point.z.getUnit()), rawKey->v.z.d, sizeof(rawKey->v.z.d));
+    CRYPTO_COUNT_NORMALIZE(g1Point);
     g1Point.normalize();
 
     if (g1Point.x.serialize(dst, KEY_SIZE, mcl::IoSerialize | mcl::IoBigEndian) == 0)
@@ -51,6 +58,8 @@ std::string utils::BLSPublicKeyToHex(const bls::PublicKey& publicKey) {
 }
 
 bls::PublicKey utils::HexToBLSPublicKey(std::string_view hex) {
+    TRACE_SPAN("ec_utils", "HexToBLSPublicKey");
+    BLSContext::get();
     const size_t BLS_PKEY_COMPONENT_HEX_SIZE = 32 * 2;
     const size_t BLS_PKEY_HEX_SIZE           = BLS_PKEY_COMPONENT_HEX_SIZE * 2;
     hex                                      = utils::trimPrefix(hex, "0x");
@@ -122,6 +131,8 @@ bls::PublicKey utils::HexToBLSPublicKey(std::string_view hex) {
 }
 
 std::array<unsigned char, 32> utils::HashModulus(std::string message) {
+    TRACE_SPAN("ec_utils", "HashModulus");
+    BLSContext::get();
     std::array<unsigned char, 32> hash = utils::hash(message);
     mcl::bn::Fp x;
     x.clear();
@@ -133,3 +144,97 @@ std::array<unsigned char, 32> utils::HashModulus(std::string message) {
         throw std::runtime_error("size of x is zero");
     return serialized_hash;
 }
+
+namespace {
+    // NOTE: bls keys wrap the mcl points/scalars with the same layout, as in
+    // SignatureToHex. const_cast is legal because the keys are never const.
+    mcl::bn::G1& toG1(bls::PublicKey& publicKey) {
+        return *reinterpret_cast<mcl::bn::G1*>(&const_cast<blsPublicKey*>(publicKey.getPtr())->v);
+    }
+
+    const mcl::bn::Fr& toFr(const bls::SecretKey& secretKey) {
+        return *reinterpret_cast<const mcl::bn::Fr*>(&secretKey.getPtr()->v);
+    }
+}
+
+bls::PublicKey utils::DerivePublicKey(const bls::SecretKey& secretKey) {
+    TRACE_SPAN("ec_utils", "DerivePublicKey");
+    bls::PublicKey result;
+    BLSContext::get().multiplyGenerator(toG1(result), toFr(secretKey));
+    CRYPTO_COUNT_NORMALIZE(toG1(result));
+    toG1(result).normalize();
+    return result;
+}
+
+std::vector<bls::PublicKey> utils::DerivePublicKeys(const std::vector<bls::SecretKey>& secretKeys) {
+    TRACE_SPAN("ec_utils", "DerivePublicKeys");
+    const BLSContext& context = BLSContext::get();
+
+    std::vector<bls::PublicKey> result(secretKeys.size());
+    for (size_t index = 0; index < secretKeys.size(); index++)
+        context.multiplyGenerator(toG1(result[index]), toFr(secretKeys[index]));
+    NormalizePublicKeys(result);
+    return result;
+}
+
+void utils::NormalizePublicKeys(std::vector<bls::PublicKey>& publicKeys) {
+    TRACE_SPAN("ec_utils", "NormalizePublicKeys");
+    static_assert(sizeof(bls::PublicKey) == sizeof(mcl::bn::G1), "The keys are normalized in place as an array of G1 points");
+    if (!publicKeys.empty())
+        NormalizeG1(&toG1(publicKeys[0]), publicKeys.size());
+}
+
+void utils::NormalizeG1(mcl::bn::G1* points, size_t count) {
+    const bool jacobi = mcl::bn::G1::mode_ == mcl::ec::Jacobi;
+    if (!jacobi && mcl::bn::G1::mode_ != mcl::ec::Proj) {
+        for (size_t index = 0; index < count; index++) {
+            CRYPTO_COUNT_NORMALIZE(points[index]);
+            points[index].normalize();
+        }
+        return;
+    }
+
+    // NOTE: prefix[i] is the product of every Z up to and including i,
+    // points at infinity (Z = 0) and already affine ones (Z = 1) are skipped
+    // and left as is
+    std::vector<mcl::bn::Fp> prefix(count);
+    mcl::bn::Fp              product    = 1;
+    size_t                   projective = 0;
+    for (size_t index = 0; index < count; index++) {
+        const mcl::bn::Fp& z = points[index].z;
+        if (!z.isZero() && !z.isOne()) {
+            mcl::bn::Fp::mul(product, product, z);
+            projective++;
+        }
+        prefix[index] = product;
+    }
+    if (projective == 0)
+        return;
+
+    mcl::bn::Fp inverse;
+    mcl::bn::Fp::inv(inverse, product);
+    CRYPTO_COUNT(Inversion);
+    for (size_t index = count; index-- > 0;) {
+        mcl::bn::G1& point = points[index];
+        if (point.z.isZero() || point.z.isOne())
+            continue;
+        CRYPTO_COUNT(Normalize);
+
+        mcl::bn::Fp zInverse = index > 0 ? prefix[index - 1] : mcl::bn::Fp(1);
+        mcl::bn::Fp::mul(zInverse, zInverse, inverse);
+        mcl::bn::Fp::mul(inverse, inverse, point.z);
+
+        if (jacobi) {
+            mcl::bn::Fp zInverse2;
+            mcl::bn::Fp::sqr(zInverse2, zInverse);
+            mcl::bn::Fp::mul(point.x, point.x, zInverse2);
+            mcl::bn::Fp::mul(zInverse2, zInverse2, zInverse);
+            mcl::bn::Fp::mul(point.y, point.y, zInverse2);
+        } else {
+            mcl::bn::Fp::mul(point.x, point.x, zInverse);
+            mcl::bn::Fp::mul(point.y, point.y, zInverse);
+        }
+        point.z = 1;
+    }
+}
+
@@ -4,7 +4,14 @@
 
 // Constructor
 ERC20Contract::ERC20Contract(const std::string& _contractAddress, std::shared_ptr<Provider> _provider)
-    : contractAddress(_contractAddress), provider(_provider) {}
+    : contractAddress(_contractAddress), backend(std::make_shared<LiveProviderBackend>(_provider)) {}
+
+ERC20Contract::ERC20Contract(const std::string& _contractAddress, std::shared_ptr<ProviderBackend> _backend)
+    : contractAddress(_contractAddress), backend(std::move(_backend)) {}
+
+void ERC20Contract::setMetrics(std::shared_ptr<ContractMetrics> _metrics) {
+    metrics = std::move(_metrics);
+}
 
 // Function to call 'approve' method of ERC20 token contract
 Transaction ERC20Contract::approve(const std::string& spender, uint64_t amount) {
@@ -24,8 +31,7 @@ Transaction ERC20Contract::approve(const std::string& spender, uint64_t amount)
     return tx;
 }
 
-// Function to call 'balanceOf' method of ERC20 token contract
-uint64_t ERC20Contract::balanceOf(const std::string& address) {
+ReadCallData ERC20Contract::balanceOfCall(const std::string& address) const {
     ReadCallData callData;
     callData.contractAddress = contractAddress;
 
@@ -37,10 +43,37 @@ uint64_t ERC20Contract::balanceOf(const std::string& address) {
     }
     std::string address_padded = utils::padTo32Bytes(addressOutput, utils::PaddingDirection::LEFT);
     callData.data = functionSelector + address_padded;
-    std::string result = provider->callReadFunction(callData);
+    return callData;
+}
 
+uint64_t ERC20Contract::decodeBalance(const std::string& result) {
     // Parse the result into a uint64_t
     // Assuming the result is returned as a 32-byte hexadecimal string that fits into uint64_t
     return std::stoull(result.substr(2 + 64 - 8, 8), nullptr, 16);
 }
 
+// Function to call 'balanceOf' method of ERC20 token contract
+uint64_t ERC20Contract::balanceOf(const std::string& address) {
+    MethodCall   call(metrics, "balanceOf");
+    ReadCallData callData = balanceOfCall(address);
+    std::string  result   = call.network(callData.data, [&] { return backend->callReadFunction(callData); });
+    return call.decode([&] { return decodeBalance(result); });
+}
+
+#if defined(SERVICE_NODE_REWARDS_COROUTINES)
+void ERC20Contract::setAsyncClient(std::shared_ptr<AsyncJsonRpcClient> client) {
+    asyncClient = std::move(client);
+}
+
+Task<uint64_t> ERC20Contract::balanceOfAsync(std::string address) {
+    if (!asyncClient)
+        throw std::runtime_error("Contract " + contractAddress + " has no async client to read with, see setAsyncClient");
+
+    MethodCall   call(metrics, "balanceOf");
+    ReadCallData callData = balanceOfCall(address);
+    const auto   start    = call.networkStart();
+    std::string  result   = co_await asyncClient->callReadFunction(callData);
+    call.networkDone(start, callData.data, result);
+    co_return call.decode([&] { return decodeBalance(result); });
+}
+#endif
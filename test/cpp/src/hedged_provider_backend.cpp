@@ -0,0 +1,297 @@
+#include "service_node_rewards/hedged_provider_backend.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+
+namespace {
+    // NOTE: Endpoints failing more often than this rank behind the others
+    // even before they are ejected.
+    const double DEGRADED_ERROR_RATE = 0.25;
+    const double ERROR_RATE_WEIGHT   = 0.1;
+
+    // NOTE: The error rate also decays with time so an endpoint that gets no
+    // traffic while degraded is given another chance.
+    const auto ERROR_RATE_HALF_LIFE = std::chrono::seconds(30);
+
+    // NOTE: Recomputing the percentile walks the whole histogram, only do it
+    // every so many samples.
+    const uint64_t HEDGE_DELAY_REFRESH_SAMPLES = 32;
+}
+
+HedgedProviderBackend::HedgedProviderBackend(std::vector<std::shared_ptr<ProviderBackend>> _endpoints, HedgedProviderOptions _options)
+        : options(_options), hedgeTokens(_options.hedgeBurst) {
+    if (_endpoints.empty())
+        throw std::invalid_argument("Hedged provider needs at least one endpoint");
+    if (options.workerThreads == 0 || options.hedgeThreads == 0)
+        throw std::invalid_argument("Hedged provider needs at least one worker and one hedge thread");
+
+    for (std::shared_ptr<ProviderBackend>& backend : _endpoints) {
+        auto endpoint          = std::make_unique<Endpoint>();
+        endpoint->backend      = std::move(backend);
+        endpoint->hedgeDelayNs = std::chrono::nanoseconds(options.initialHedgeDelay).count();
+        endpoints.push_back(std::move(endpoint));
+    }
+
+    workers.reserve(options.workerThreads + options.hedgeThreads);
+    for (size_t index = 0; index < options.workerThreads; index++)
+        workers.emplace_back([this] { work(primaryJobs); });
+    for (size_t index = 0; index < options.hedgeThreads; index++)
+        workers.emplace_back([this] { work(hedgeJobs); });
+}
+
+HedgedProviderBackend::~HedgedProviderBackend() {
+    {
+        std::lock_guard lock{jobsMutex};
+        stopping = true;
+    }
+    primaryJobs.condition.notify_all();
+    hedgeJobs.condition.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+std::shared_ptr<HedgedProviderBackend> HedgedProviderBackend::fromUrls(const std::vector<std::string>& urls, HedgedProviderOptions options) {
+    std::vector<std::shared_ptr<ProviderBackend>> backends;
+    backends.reserve(urls.size());
+    for (const std::string& url : urls)
+        backends.push_back(std::make_shared<LiveProviderBackend>(std::make_shared<Provider>("Client", url)));
+    return std::make_shared<HedgedProviderBackend>(std::move(backends), options);
+}
+
+void HedgedProviderBackend::post(JobQueue& queue, std::function<void()> job) {
+    {
+        std::lock_guard lock{jobsMutex};
+        queue.jobs.push_back(std::move(job));
+    }
+    queue.condition.notify_one();
+}
+
+void HedgedProviderBackend::work(JobQueue& queue) {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock lock{jobsMutex};
+            queue.condition.wait(lock, [&] { return stopping || !queue.jobs.empty(); });
+            // NOTE: Drain the queue before stopping, queued jobs point back at us
+            if (queue.jobs.empty())
+                return;
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+        job();
+    }
+}
+
+std::vector<size_t> HedgedProviderBackend::ranked() const {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::pair<int, size_t>> tiers;
+    tiers.reserve(endpoints.size());
+    {
+        std::lock_guard lock{healthMutex};
+        for (size_t index = 0; index < endpoints.size(); index++) {
+            // NOTE: An endpoint back from an ejection gets its place back to
+            // be probed, the failures that got it ejected would otherwise
+            // keep it degraded.
+            const Endpoint& endpoint  = *endpoints[index];
+            const bool      probation = endpoint.ejectionTime.count() > 0;
+            const int       tier      = endpoint.ejectedUntil > now                                    ? 2
+                                      : !probation && errorRate(endpoint, now) > DEGRADED_ERROR_RATE ? 1
+                                                                                                     : 0;
+            tiers.emplace_back(tier, index);
+        }
+    }
+    std::stable_sort(tiers.begin(), tiers.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    std::vector<size_t> result;
+    result.reserve(tiers.size());
+    for (const auto& [tier, index] : tiers)
+        result.push_back(index);
+    return result;
+}
+
+double HedgedProviderBackend::errorRate(const Endpoint& endpoint, std::chrono::steady_clock::time_point now) {
+    const std::chrono::duration<double> age = now - endpoint.errorRateUpdated;
+    return endpoint.errorRate * std::exp2(-age / std::chrono::duration<double>(ERROR_RATE_HALF_LIFE));
+}
+
+std::chrono::nanoseconds HedgedProviderBackend::hedgeDelay(const Endpoint& endpoint) const {
+    return std::chrono::nanoseconds(endpoint.hedgeDelayNs.load(std::memory_order_relaxed));
+}
+
+bool HedgedProviderBackend::takeHedgeToken() {
+    std::lock_guard lock{healthMutex};
+    if (hedgeTokens < 1)
+        return false;
+    hedgeTokens -= 1;
+    return true;
+}
+
+void HedgedProviderBackend::recordSuccess(Endpoint& endpoint, std::chrono::nanoseconds elapsed) {
+    endpoint.latency.record(elapsed);
+    const uint64_t samples = endpoint.successes.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (samples >= options.minSamples && samples % HEDGE_DELAY_REFRESH_SAMPLES == 0) {
+        const auto percentile = std::chrono::nanoseconds(endpoint.latency.snapshot().percentile(options.hedgePercentile));
+        const auto delay      = std::clamp<std::chrono::nanoseconds>(percentile, options.minHedgeDelay, options.maxHedgeDelay);
+        endpoint.hedgeDelayNs.store(delay.count(), std::memory_order_relaxed);
+    }
+
+    const auto      now = std::chrono::steady_clock::now();
+    std::lock_guard lock{healthMutex};
+    endpoint.consecutiveFailures = 0;
+    endpoint.ejectionTime        = {};
+    endpoint.errorRate           = errorRate(endpoint, now) * (1 - ERROR_RATE_WEIGHT);
+    endpoint.errorRateUpdated    = now;
+}
+
+void HedgedProviderBackend::recordFailure(Endpoint& endpoint) {
+    endpoint.failures.fetch_add(1, std::memory_order_relaxed);
+
+    const auto      now = std::chrono::steady_clock::now();
+    std::lock_guard lock{healthMutex};
+    endpoint.errorRate        = errorRate(endpoint, now) * (1 - ERROR_RATE_WEIGHT) + ERROR_RATE_WEIGHT;
+    endpoint.errorRateUpdated = now;
+
+    // NOTE: An endpoint back from an ejection is on probation until it
+    // succeeds, a single failure sends it back out for twice as long.
+    const bool probation = endpoint.ejectionTime.count() > 0;
+    if (!probation && ++endpoint.consecutiveFailures < options.ejectAfterFailures)
+        return;
+    endpoint.ejectionTime        = probation ? std::min(endpoint.ejectionTime * 2, options.maxEjectionTime) : options.ejectionTime;
+    endpoint.ejectedUntil        = now + endpoint.ejectionTime;
+    endpoint.consecutiveFailures = 0;
+}
+
+template <typename T>
+T HedgedProviderBackend::hedge(std::function<T(ProviderBackend&)> request) {
+    struct State {
+        std::mutex              mutex;
+        std::condition_variable condition;
+        std::optional<T>        result;
+        std::exception_ptr      rejection;   // A final JsonRpcError answered before any result
+        std::exception_ptr      error;       // Of the last attempt to fail
+        size_t                  outstanding = 0;
+    };
+
+    auto                      state = std::make_shared<State>();
+    const std::vector<size_t> order = ranked();
+    {
+        std::lock_guard lock{healthMutex};
+        hedgeTokens = std::min(options.hedgeBurst, hedgeTokens + options.hedgeBudget);
+    }
+
+    // NOTE: Attempts run on the workers and report back through `state`,
+    // which outlives this call if the losing attempt is still running.
+    size_t next = 0;
+    auto launch = [&](bool isHedge) {
+        const size_t index    = order[next++];
+        Endpoint&    endpoint = *endpoints[index];
+        endpoint.requests.fetch_add(1, std::memory_order_relaxed);
+        if (isHedge)
+            endpoint.hedges.fetch_add(1, std::memory_order_relaxed);
+        state->outstanding++;
+        post(isHedge ? hedgeJobs : primaryJobs, [this, state, request, &endpoint] {
+            const auto start = std::chrono::steady_clock::now();
+            auto       fail  = [&] {
+                recordFailure(endpoint);
+                std::lock_guard lock{state->mutex};
+                state->outstanding--;
+                state->error = std::current_exception();
+            };
+            try {
+                T result = request(*endpoint.backend);
+                recordSuccess(endpoint, std::chrono::steady_clock::now() - start);
+                std::lock_guard lock{state->mutex};
+                state->outstanding--;
+                if (!state->result) {
+                    state->result = std::move(result);
+                    endpoint.wins.fetch_add(1, std::memory_order_relaxed);
+                }
+            } catch (const JsonRpcError& e) {
+                if (e.isFinal()) {
+                    // NOTE: The endpoint is fine, it answered. Any other would
+                    // reject the request the same, so don't fail over.
+                    std::lock_guard lock{state->mutex};
+                    state->outstanding--;
+                    if (!state->result && !state->rejection)
+                        state->rejection = std::current_exception();
+                } else {
+                    fail();
+                }
+            } catch (...) {
+                fail();
+            }
+            state->condition.notify_all();
+        });
+        return std::chrono::steady_clock::now() + hedgeDelay(endpoint);
+    };
+
+    std::unique_lock lock{state->mutex};
+    auto deadline = launch(false);
+    bool hedging  = true;
+    for (;;) {
+        if (state->result)
+            return std::move(*state->result);
+        if (state->rejection)
+            std::rethrow_exception(state->rejection);
+
+        const bool more = next < order.size();
+        if (state->outstanding == 0) {
+            // NOTE: Everything sent so far failed, fail over without waiting
+            if (!more)
+                std::rethrow_exception(state->error);
+            deadline = launch(true);
+            continue;
+        }
+
+        if (!more || !hedging) {
+            state->condition.wait(lock);
+            continue;
+        }
+
+        if (state->condition.wait_until(lock, deadline) == std::cv_status::timeout && !state->result && state->outstanding > 0) {
+            if (takeHedgeToken())
+                deadline = launch(true);
+            else
+                hedging = false;
+        }
+    }
+}
+
+std::string HedgedProviderBackend::callReadFunction(const ReadCallData& callData, std::string_view blockNumber) {
+    return hedge<std::string>([callData, block = std::string(blockNumber)](ProviderBackend& backend) { return backend.callReadFunction(callData, block); });
+}
+
+std::string HedgedProviderBackend::callReadFunction(const ReadCallData& callData, uint64_t blockNumber) {
+    return hedge<std::string>([callData, blockNumber](ProviderBackend& backend) { return backend.callReadFunction(callData, blockNumber); });
+}
+
+std::vector<LogEntry> HedgedProviderBackend::getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) {
+    return hedge<std::vector<LogEntry>>([fromBlock, toBlock, address](ProviderBackend& backend) { return backend.getLogs(fromBlock, toBlock, address); });
+}
+
+uint64_t HedgedProviderBackend::getLatestHeight() {
+    return hedge<uint64_t>([](ProviderBackend& backend) { return backend.getLatestHeight(); });
+}
+
+std::vector<HedgedEndpointStats> HedgedProviderBackend::stats() const {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<HedgedEndpointStats> result;
+    result.reserve(endpoints.size());
+    for (const std::unique_ptr<Endpoint>& endpoint : endpoints) {
+        HedgedEndpointStats item = {};
+        item.requests            = endpoint->requests.load(std::memory_order_relaxed);
+        item.hedges              = endpoint->hedges.load(std::memory_order_relaxed);
+        item.wins                = endpoint->wins.load(std::memory_order_relaxed);
+        item.failures            = endpoint->failures.load(std::memory_order_relaxed);
+        item.hedgeDelay          = hedgeDelay(*endpoint);
+        item.latency             = endpoint->latency.snapshot();
+        {
+            std::lock_guard lock{healthMutex};
+            item.ejected = endpoint->ejectedUntil > now;
+        }
+        result.push_back(std::move(item));
+    }
+    return result;
+}
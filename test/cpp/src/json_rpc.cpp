@@ -0,0 +1,126 @@
+#include "service_node_rewards/json_rpc.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+#include <cpr/cpr.h>
+
+JsonRpcError::JsonRpcError(const std::string& what, const nlohmann::json& error) : std::runtime_error(what) {
+    if (!error.is_object())
+        return;
+    if (auto it = error.find("code"); it != error.end() && it->is_number_integer())
+        errorCode = it->get<int64_t>();
+    if (auto it = error.find("message"); it != error.end() && it->is_string())
+        message = it->get<std::string>();
+}
+
+std::optional<JsonRpcError> JsonRpcError::fromMessage(std::string_view text) {
+    for (size_t begin = text.find('{'); begin != std::string_view::npos; begin = text.find('{', begin)) {
+        // NOTE: Find the end of the object, skipping over braces in strings
+        size_t end      = begin;
+        size_t depth    = 0;
+        bool   inString = false;
+        for (; end < text.size(); end++) {
+            const char ch = text[end];
+            if (inString) {
+                if (ch == '\\')
+                    end++;
+                else if (ch == '"')
+                    inString = false;
+            } else if (ch == '"') {
+                inString = true;
+            } else if (ch == '{') {
+                depth++;
+            } else if (ch == '}' && --depth == 0) {
+                break;
+            }
+        }
+        if (end >= text.size())
+            return std::nullopt;
+
+        nlohmann::json error = nlohmann::json::parse(text.substr(begin, end - begin + 1), nullptr, false /*allow_exceptions*/);
+        if (error.is_object() && error.contains("code") && error["code"].is_number_integer() && error.contains("message"))
+            return JsonRpcError(std::string(text), error);
+        begin = end + 1;
+    }
+    return std::nullopt;
+}
+
+bool JsonRpcError::isFinal() const {
+    std::string text = message;
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    if (errorCode == 3 || (errorCode == -32000 && text.find("execution reverted") != std::string::npos))
+        return true;
+
+    // NOTE: Providers word the getLogs limits differently, Infura even shares
+    // its rate limit code (-32005) with "query returned more than 10000 results"
+    static constexpr std::string_view LOG_RANGE_ERRORS[] = {
+        "query returned more than",
+        "block range",
+        "range too large",
+        "range is too large",
+        "too many blocks",
+        "response size exceeded",
+        "response size should not",
+    };
+    for (std::string_view phrase : LOG_RANGE_ERRORS) {
+        if (text.find(phrase) != std::string::npos)
+            return true;
+    }
+    return false;
+}
+
+JsonRpcClient::JsonRpcClient(std::string url, size_t _maxBatchSize) : endpoint(std::move(url)), maxBatchSize(_maxBatchSize) {
+    if (maxBatchSize == 0)
+        throw std::invalid_argument("JSON-RPC client needs a non-zero batch size");
+}
+
+nlohmann::json JsonRpcClient::post(const nlohmann::json& body) {
+    cpr::Response response = cpr::Post(cpr::Url{endpoint},
+                                       cpr::Body{body.dump()},
+                                       cpr::Header{{"Content-Type", "application/json"}});
+    if (response.error)
+        throw std::runtime_error("JSON-RPC request to '" + endpoint + "' failed: " + response.error.message);
+    if (response.status_code != 200)
+        throw std::runtime_error("JSON-RPC request to '" + endpoint + "' failed with HTTP status " + std::to_string(response.status_code) + ": " + response.text);
+    return nlohmann::json::parse(response.text);
+}
+
+nlohmann::json JsonRpcClient::call(const std::string& method, const nlohmann::json& params) {
+    nlohmann::json request = {{"jsonrpc", "2.0"}, {"id", nextId++}, {"method", method}, {"params", params}};
+    nlohmann::json response = post(request);
+    if (response.contains("error"))
+        throw JsonRpcError("JSON-RPC '" + method + "' returned an error: " + response["error"].dump(), response["error"]);
+    return response["result"];
+}
+
+std::vector<nlohmann::json> JsonRpcClient::batch(const std::vector<std::pair<std::string, nlohmann::json>>& requests) {
+    std::vector<nlohmann::json> result(requests.size());
+    for (size_t begin = 0; begin < requests.size(); begin += maxBatchSize)
+        batchChunk(requests.data() + begin, std::min(maxBatchSize, requests.size() - begin), result.data() + begin);
+    return result;
+}
+
+void JsonRpcClient::batchChunk(const std::pair<std::string, nlohmann::json>* requests, size_t count, nlohmann::json* results) {
+    // NOTE: Responses to a batch may come back in any order, match them up
+    // with the request they answer by ID.
+    const uint64_t firstId = nextId;
+    nlohmann::json body    = nlohmann::json::array();
+    for (size_t index = 0; index < count; index++)
+        body.push_back({{"jsonrpc", "2.0"}, {"id", nextId++}, {"method", requests[index].first}, {"params", requests[index].second}});
+
+    nlohmann::json response = post(body);
+    if (!response.is_array()) {
+        // NOTE: Nodes answer with a single error object if they reject the batch as a whole
+        throw std::runtime_error("JSON-RPC batch of " + std::to_string(count) + " requests to '" + endpoint + "' was rejected: " + response.dump());
+    }
+
+    for (const nlohmann::json& item : response) {
+        if (!item.contains("id") || !item["id"].is_number_unsigned())
+            continue;
+        uint64_t index = item["id"].get<uint64_t>() - firstId;
+        if (index >= count)
+            continue;
+        results[index] = item.contains("error") ? item["error"] : item["result"];
+    }
+}
@@ -0,0 +1,205 @@
+#include "service_node_rewards/metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+    size_t highestBit(uint64_t value) {
+        size_t result = 0;
+        while (value >>= 1)
+            result++;
+        return result;
+    }
+
+    nlohmann::json histogramJson(const LatencyHistogramSnapshot& histogram) {
+        nlohmann::json result = {
+            {"count", histogram.count},
+            {"mean_ns", histogram.count ? histogram.sumNs / histogram.count : 0},
+            {"p50_ns", histogram.percentile(0.5)},
+            {"p90_ns", histogram.percentile(0.9)},
+            {"p99_ns", histogram.percentile(0.99)},
+            {"p999_ns", histogram.percentile(0.999)},
+            {"max_ns", histogram.maxNs},
+        };
+        return result;
+    }
+}
+
+uint64_t LatencyHistogramSnapshot::percentile(double quantile) const {
+    if (count == 0)
+        return 0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(count))));
+    uint64_t       seen = 0;
+    for (const Bucket& bucket : buckets) {
+        seen += bucket.count;
+        if (seen >= rank)
+            return std::min(bucket.upperNs, maxNs);
+    }
+    return maxNs;
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t ns) {
+    // NOTE: Values below SUB_BUCKETS are exact. Above that the exponent picks
+    // a row of SUB_BUCKETS and the next SUB_BUCKET_BITS bits the column.
+    if (ns < SUB_BUCKETS)
+        return ns;
+    const size_t exponent = highestBit(ns);
+    const size_t column   = (ns >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + column;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS)
+        return index;
+    const size_t   exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    const size_t   shift    = exponent - SUB_BUCKET_BITS;
+    const uint64_t lower    = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration) {
+    const uint64_t ns = static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(duration.count(), 0));
+    counts[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sumNs.fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t max = maxNs.load(std::memory_order_relaxed);
+    while (ns > max && !maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+}
+
+LatencyHistogramSnapshot LatencyHistogram::snapshot() const {
+    // NOTE: Not an atomic snapshot, a sample recorded concurrently may be in
+    // the buckets but not yet the totals. The count is taken from the
+    // buckets so percentiles stay self consistent.
+    LatencyHistogramSnapshot result = {};
+    for (size_t index = 0; index < BUCKETS; index++) {
+        const uint64_t bucketCount = counts[index].load(std::memory_order_relaxed);
+        if (bucketCount == 0)
+            continue;
+        result.buckets.push_back({bucketUpperBound(index), bucketCount});
+        result.count += bucketCount;
+    }
+    result.sumNs = sumNs.load(std::memory_order_relaxed);
+    result.maxNs = maxNs.load(std::memory_order_relaxed);
+    return result;
+}
+
+MethodMetrics& ContractMetrics::method(std::string_view name) {
+    std::lock_guard lock{mutex};
+    auto it = methods.find(name);
+    if (it == methods.end())
+        it = methods.emplace(std::string(name), std::make_unique<MethodMetrics>()).first;
+    return *it->second;
+}
+
+std::vector<MethodMetricsSnapshot> ContractMetrics::snapshot() const {
+    std::lock_guard lock{mutex};
+    std::vector<MethodMetricsSnapshot> result;
+    result.reserve(methods.size());
+    for (const auto& [name, metrics] : methods) {
+        MethodMetricsSnapshot item = {};
+        item.method                = name;
+        item.calls                 = metrics->calls.load(std::memory_order_relaxed);
+        item.errors                = metrics->errors.load(std::memory_order_relaxed);
+        item.bytesSent             = metrics->bytesSent.load(std::memory_order_relaxed);
+        item.bytesReceived         = metrics->bytesReceived.load(std::memory_order_relaxed);
+        item.network               = metrics->network.snapshot();
+        item.decode                = metrics->decode.snapshot();
+        item.receipt               = metrics->receipt.snapshot();
+        result.push_back(std::move(item));
+    }
+    return result;
+}
+
+std::string ContractMetrics::prometheus(std::string_view prefix) const {
+    const std::vector<MethodMetricsSnapshot> methodSnapshots = snapshot();
+    std::stringstream                        stream;
+    stream << std::setprecision(12);
+
+    auto counter = [&](const char* name, const char* help, uint64_t MethodMetricsSnapshot::*field) {
+        stream << "# HELP " << prefix << "_" << name << " " << help << "\n";
+        stream << "# TYPE " << prefix << "_" << name << " counter\n";
+        for (const MethodMetricsSnapshot& item : methodSnapshots)
+            stream << prefix << "_" << name << "{method=\"" << item.method << "\"} " << item.*field << "\n";
+    };
+    counter("calls_total", "Contract method calls.", &MethodMetricsSnapshot::calls);
+    counter("errors_total", "Contract method calls that threw.", &MethodMetricsSnapshot::errors);
+    counter("sent_bytes_total", "Call data bytes sent to the node.", &MethodMetricsSnapshot::bytesSent);
+    counter("received_bytes_total", "Result bytes received from the node.", &MethodMetricsSnapshot::bytesReceived);
+
+    stream << "# HELP " << prefix << "_latency_seconds Time spent in each phase of a contract method call.\n";
+    stream << "# TYPE " << prefix << "_latency_seconds histogram\n";
+    for (const MethodMetricsSnapshot& item : methodSnapshots) {
+        const std::pair<const char*, const LatencyHistogramSnapshot*> phases[] = {
+            {"network", &item.network},
+            {"decode", &item.decode},
+            {"receipt", &item.receipt},
+        };
+        for (const auto& [phase, histogram] : phases) {
+            if (histogram->count == 0)
+                continue;
+            const std::string labels = "method=\"" + item.method + "\",phase=\"" + phase + "\"";
+            uint64_t          cumulative = 0;
+            for (const LatencyHistogramSnapshot::Bucket& bucket : histogram->buckets) {
+                cumulative += bucket.count;
+                stream << prefix << "_latency_seconds_bucket{" << labels << ",le=\"" << static_cast<double>(bucket.upperNs) / 1e9 << "\"} " << cumulative << "\n";
+            }
+            stream << prefix << "_latency_seconds_bucket{" << labels << ",le=\"+Inf\"} " << histogram->count << "\n";
+            stream << prefix << "_latency_seconds_sum{" << labels << "} " << static_cast<double>(histogram->sumNs) / 1e9 << "\n";
+            stream << prefix << "_latency_seconds_count{" << labels << "} " << histogram->count << "\n";
+        }
+    }
+    return stream.str();
+}
+
+std::string ContractMetrics::json() const {
+    nlohmann::json result = nlohmann::json::array();
+    for (const MethodMetricsSnapshot& item : snapshot()) {
+        result.push_back({
+            {"method", item.method},
+            {"calls", item.calls},
+            {"errors", item.errors},
+            {"bytes_sent", item.bytesSent},
+            {"bytes_received", item.bytesReceived},
+            {"network", histogramJson(item.network)},
+            {"decode", histogramJson(item.decode)},
+            {"receipt", histogramJson(item.receipt)},
+        });
+    }
+    return result.dump();
+}
+
+MethodCall::MethodCall(std::shared_ptr<ContractMetrics> _registry, std::string_view method)
+        : registry(std::move(_registry)), uncaughtExceptions(std::uncaught_exceptions()) {
+    if (!registry)
+        return;
+    metrics = &registry->method(method);
+    metrics->calls.fetch_add(1, std::memory_order_relaxed);
+}
+
+MethodCall::~MethodCall() {
+    if (metrics && std::uncaught_exceptions() > uncaughtExceptions)
+        metrics->errors.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::chrono::steady_clock::time_point MethodCall::networkStart() const {
+    return metrics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+}
+
+void MethodCall::networkDone(std::chrono::steady_clock::time_point start, std::string_view request, std::string_view result) {
+    if (!metrics)
+        return;
+    metrics->network.record(std::chrono::steady_clock::now() - start);
+    metrics->bytesSent.fetch_add(hexBytes(request), std::memory_order_relaxed);
+    metrics->bytesReceived.fetch_add(hexBytes(result), std::memory_order_relaxed);
+}
+
+uint64_t MethodCall::hexBytes(std::string_view hex) {
+    if (hex.substr(0, 2) == "0x")
+        hex.remove_prefix(2);
+    return hex.size() / 2;
+}
@@ -0,0 +1,267 @@
+#include "service_node_rewards/provider_backend.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+    const std::string RECORDING_HEADER = "service-node-rewards-rpc-recording-v1";
+
+    // NOTE: Responses are prefixed with '=' on success, '!' when the request
+    // threw and '#' when the node rejected it with a JsonRpcError, in which
+    // case the rest of the line is the error message.
+    const char RESPONSE_OK       = '=';
+    const char RESPONSE_ERROR    = '!';
+    const char RESPONSE_REJECTED = '#';
+
+    // NOTE: Provider throws std::runtime_error for transport failures and
+    // error responses alike, only the latter quote the node's error object
+    // in the message.
+    template <typename Func>
+    auto classifyErrors(Func&& func) -> decltype(func()) {
+        try {
+            return func();
+        } catch (const JsonRpcError&) {
+            throw;
+        } catch (const std::runtime_error& e) {
+            if (std::optional<JsonRpcError> error = JsonRpcError::fromMessage(e.what()))
+                throw *error;
+            throw;
+        }
+    }
+
+    std::string callRequest(const ReadCallData& callData, std::string_view blockNumber) {
+        std::string result = "eth_call ";
+        result += callData.contractAddress;
+        result += ' ';
+        result += blockNumber;
+        result += ' ';
+        result += callData.data;
+        return result;
+    }
+
+    std::string logsRequest(uint64_t fromBlock, uint64_t toBlock, const std::string& address) {
+        std::stringstream stream;
+        stream << "eth_getLogs " << address << " " << fromBlock << " " << toBlock;
+        return stream.str();
+    }
+
+    const std::string HEIGHT_REQUEST = "eth_blockNumber";
+
+    std::string singleLine(std::string_view text) {
+        std::string result(text);
+        for (char& ch : result) {
+            if (ch == '\n' || ch == '\r' || ch == '\t')
+                ch = ' ';
+        }
+        return result;
+    }
+
+    std::string serialiseLogs(const std::vector<LogEntry>& logs) {
+        nlohmann::json result = nlohmann::json::array();
+        for (const LogEntry& log : logs) {
+            nlohmann::json item = {{"address", log.address}, {"topics", log.topics}, {"data", log.data}, {"removed", log.removed}};
+            if (log.blockNumber)      item["blockNumber"]      = *log.blockNumber;
+            if (log.transactionHash)  item["transactionHash"]  = *log.transactionHash;
+            if (log.transactionIndex) item["transactionIndex"] = *log.transactionIndex;
+            if (log.blockHash)        item["blockHash"]        = *log.blockHash;
+            if (log.logIndex)         item["logIndex"]         = *log.logIndex;
+            result.push_back(std::move(item));
+        }
+        return result.dump();
+    }
+
+    std::vector<LogEntry> deserialiseLogs(const std::string& text) {
+        std::vector<LogEntry> result;
+        for (const nlohmann::json& item : nlohmann::json::parse(text)) {
+            LogEntry log = {};
+            log.address  = item.at("address").get<std::string>();
+            log.topics   = item.at("topics").get<std::vector<std::string>>();
+            log.data     = item.at("data").get<std::string>();
+            log.removed  = item.value("removed", false);
+            if (item.contains("blockNumber"))      log.blockNumber      = item["blockNumber"].get<uint64_t>();
+            if (item.contains("transactionHash"))  log.transactionHash  = item["transactionHash"].get<std::string>();
+            if (item.contains("transactionIndex")) log.transactionIndex = item["transactionIndex"].get<uint32_t>();
+            if (item.contains("blockHash"))        log.blockHash        = item["blockHash"].get<std::string>();
+            if (item.contains("logIndex"))         log.logIndex         = item["logIndex"].get<uint32_t>();
+            result.push_back(std::move(log));
+        }
+        return result;
+    }
+}
+
+LiveProviderBackend::LiveProviderBackend(std::shared_ptr<Provider> _provider) : provider(std::move(_provider)) {}
+
+std::string LiveProviderBackend::callReadFunction(const ReadCallData& callData, std::string_view blockNumber) {
+    std::lock_guard lock{mutex};
+    return classifyErrors([&] { return provider->callReadFunction(callData, blockNumber); });
+}
+
+std::string LiveProviderBackend::callReadFunction(const ReadCallData& callData, uint64_t blockNumber) {
+    std::lock_guard lock{mutex};
+    return classifyErrors([&] { return provider->callReadFunction(callData, blockNumber); });
+}
+
+std::vector<LogEntry> LiveProviderBackend::getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) {
+    std::lock_guard lock{mutex};
+    return classifyErrors([&] { return provider->getLogs(fromBlock, toBlock, address); });
+}
+
+uint64_t LiveProviderBackend::getLatestHeight() {
+    std::lock_guard lock{mutex};
+    return classifyErrors([&] { return provider->getLatestHeight(); });
+}
+
+RecordingProviderBackend::RecordingProviderBackend(std::shared_ptr<ProviderBackend> _inner) : inner(std::move(_inner)) {}
+
+template <typename Func>
+auto RecordingProviderBackend::record(std::string request, Func&& func) -> decltype(func()) {
+    std::string response;
+    try {
+        auto result = func();
+        if constexpr (std::is_same_v<decltype(result), std::vector<LogEntry>>)
+            response = RESPONSE_OK + serialiseLogs(result);
+        else if constexpr (std::is_same_v<decltype(result), uint64_t>)
+            response = RESPONSE_OK + std::to_string(result);
+        else
+            response = RESPONSE_OK + result;
+
+        std::lock_guard lock{mutex};
+        exchanges.emplace_back(std::move(request), std::move(response));
+        return result;
+    } catch (const JsonRpcError& e) {
+        std::lock_guard lock{mutex};
+        exchanges.emplace_back(std::move(request), RESPONSE_REJECTED + singleLine(e.what()));
+        throw;
+    } catch (const std::exception& e) {
+        std::lock_guard lock{mutex};
+        exchanges.emplace_back(std::move(request), RESPONSE_ERROR + singleLine(e.what()));
+        throw;
+    }
+}
+
+std::string RecordingProviderBackend::callReadFunction(const ReadCallData& callData, std::string_view blockNumber) {
+    return record(callRequest(callData, blockNumber), [&] { return inner->callReadFunction(callData, blockNumber); });
+}
+
+std::string RecordingProviderBackend::callReadFunction(const ReadCallData& callData, uint64_t blockNumber) {
+    return record(callRequest(callData, std::to_string(blockNumber)), [&] { return inner->callReadFunction(callData, blockNumber); });
+}
+
+std::vector<LogEntry> RecordingProviderBackend::getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) {
+    return record(logsRequest(fromBlock, toBlock, address), [&] { return inner->getLogs(fromBlock, toBlock, address); });
+}
+
+uint64_t RecordingProviderBackend::getLatestHeight() {
+    return record(HEIGHT_REQUEST, [&] { return inner->getLatestHeight(); });
+}
+
+void RecordingProviderBackend::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("Failed to save RPC recording: could not open '" + path + "' for writing");
+
+    std::lock_guard lock{mutex};
+    file << RECORDING_HEADER << "\n";
+    for (const auto& [request, response] : exchanges)
+        file << request << "\t" << response << "\n";
+    if (!file)
+        throw std::runtime_error("Failed to save RPC recording: could not write to '" + path + "'");
+}
+
+size_t RecordingProviderBackend::size() const {
+    std::lock_guard lock{mutex};
+    return exchanges.size();
+}
+
+ReplayProviderBackend::ReplayProviderBackend(const std::string& path, std::chrono::microseconds _latency, std::chrono::microseconds _jitter)
+        : latency(_latency), jitter(_jitter), rngState(0x9E3779B97F4A7C15ULL) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("Failed to load RPC recording: could not open '" + path + "'");
+
+    std::string line;
+    if (!std::getline(file, line) || line != RECORDING_HEADER) {
+        std::stringstream stream;
+        stream << "Failed to load RPC recording '" << path << "': expected header '" << RECORDING_HEADER << "' but got '" << line << "'";
+        throw std::runtime_error(stream.str());
+    }
+
+    for (size_t lineNumber = 2; std::getline(file, line); lineNumber++) {
+        size_t separator = line.find('\t');
+        if (separator == std::string::npos || separator + 1 >= line.size()) {
+            std::stringstream stream;
+            stream << "Failed to load RPC recording '" << path << "': line " << lineNumber << " is not a request/response pair";
+            throw std::runtime_error(stream.str());
+        }
+        responses[line.substr(0, separator)].pending.push_back(line.substr(separator + 1));
+    }
+}
+
+void ReplayProviderBackend::setLatency(std::chrono::microseconds _latency, std::chrono::microseconds _jitter) {
+    std::lock_guard lock{mutex};
+    latency = _latency;
+    jitter  = _jitter;
+}
+
+size_t ReplayProviderBackend::size() const {
+    std::lock_guard lock{mutex};
+    return responses.size();
+}
+
+std::string ReplayProviderBackend::respond(const std::string& request) {
+    std::string               response;
+    std::chrono::microseconds delay;
+    {
+        std::lock_guard lock{mutex};
+        auto it = responses.find(request);
+        if (it == responses.end())
+            throw std::runtime_error("RPC request '" + request + "' was not recorded");
+
+        Responses& entry = it->second;
+        if (!entry.pending.empty()) {
+            entry.last = std::move(entry.pending.front());
+            entry.pending.pop_front();
+        }
+        response = entry.last;
+
+        // NOTE: xorshift64, reproducible jitter without a shared std engine
+        delay = latency;
+        if (jitter.count() > 0) {
+            rngState ^= rngState << 13;
+            rngState ^= rngState >> 7;
+            rngState ^= rngState << 17;
+            delay += std::chrono::microseconds(static_cast<int64_t>(rngState % static_cast<uint64_t>(jitter.count() + 1)));
+        }
+    }
+
+    if (delay.count() > 0)
+        std::this_thread::sleep_for(delay);
+
+    if (response.front() == RESPONSE_ERROR)
+        throw std::runtime_error(response.substr(1));
+    if (response.front() == RESPONSE_REJECTED) {
+        if (std::optional<JsonRpcError> error = JsonRpcError::fromMessage(std::string_view(response).substr(1)))
+            throw *error;
+        throw JsonRpcError(response.substr(1), nlohmann::json::object());
+    }
+    return response.substr(1);
+}
+
+std::string ReplayProviderBackend::callReadFunction(const ReadCallData& callData, std::string_view blockNumber) {
+    return respond(callRequest(callData, blockNumber));
+}
+
+std::string ReplayProviderBackend::callReadFunction(const ReadCallData& callData, uint64_t blockNumber) {
+    return respond(callRequest(callData, std::to_string(blockNumber)));
+}
+
+std::vector<LogEntry> ReplayProviderBackend::getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) {
+    return deserialiseLogs(respond(logsRequest(fromBlock, toBlock, address)));
+}
+
+uint64_t ReplayProviderBackend::getLatestHeight() {
+    return std::stoull(respond(HEIGHT_REQUEST));
+}
@@ -0,0 +1,447 @@
+#include "service_node_rewards/receipt_tracker.hpp"
+#include "service_node_rewards/tracing.hpp"
+
+#include "ethyl/utils.hpp"
+
+#include <array>
+#include <cstring>
+#include <random>
+
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+std::optional<TransactionResult> transactionResultFromReceipt(const nlohmann::json& receipt) {
+    if (!receipt.is_object() || !receipt.contains("blockNumber") || receipt["blockNumber"].is_null())
+        return std::nullopt;
+
+    TransactionResult result = {};
+    result.hash              = receipt.value("transactionHash", "");
+    result.blockNumber       = utils::fromHexStringToUint64(receipt["blockNumber"].get<std::string>());
+    result.gasUsed           = utils::fromHexStringToUint64(receipt.value("gasUsed", "0x0"));
+    result.success           = receipt.value("status", "0x0") == "0x1";
+    return result;
+}
+
+namespace {
+    // Just enough of RFC 6455 to hold an eth_subscribe subscription open
+    // against a plain ws:// endpoint such as a local anvil/hardhat node.
+    class WebSocket {
+    public:
+        ~WebSocket() { close(); }
+
+        // Connect and complete the opening handshake, false on any failure
+        bool connect(std::string_view url, std::chrono::milliseconds timeout) {
+            if (url.substr(0, 5) != "ws://")
+                return false;
+            url.remove_prefix(5);
+
+            std::string_view hostPort = url.substr(0, url.find('/'));
+            std::string      path     = hostPort.size() < url.size() ? std::string(url.substr(hostPort.size())) : "/";
+            std::string_view host     = hostPort.substr(0, hostPort.rfind(':'));
+            std::string      port     = host.size() < hostPort.size() ? std::string(hostPort.substr(host.size() + 1)) : "80";
+
+            addrinfo  hints  = {};
+            addrinfo* result = nullptr;
+            hints.ai_family   = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            if (getaddrinfo(std::string(host).c_str(), port.c_str(), &hints, &result) != 0)
+                return false;
+            for (addrinfo* it = result; it && fd < 0; it = it->ai_next) {
+                fd = ::socket(it->ai_family, it->ai_socktype, it->ai_protocol);
+                if (fd >= 0 && ::connect(fd, it->ai_addr, it->ai_addrlen) != 0)
+                    close();
+            }
+            freeaddrinfo(result);
+            if (fd < 0)
+                return false;
+
+            std::array<unsigned char, 16> nonce = {};
+            std::random_device            rng;
+            for (unsigned char& byte : nonce)
+                byte = static_cast<unsigned char>(rng());
+
+            std::string request = "GET " + path + " HTTP/1.1\r\n"
+                                  "Host: " + std::string(hostPort) + "\r\n"
+                                  "Upgrade: websocket\r\n"
+                                  "Connection: Upgrade\r\n"
+                                  "Sec-WebSocket-Key: " + base64(nonce) + "\r\n"
+                                  "Sec-WebSocket-Version: 13\r\n\r\n";
+            if (!sendAll(request))
+                return false;
+
+            // NOTE: Read the response headers, anything past them is already frame data
+            size_t headerEnd = std::string::npos;
+            while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+                if (!fill(timeout))
+                    return false;
+            }
+            bool upgraded = buffer.compare(0, 12, "HTTP/1.1 101") == 0;
+            buffer.erase(0, headerEnd + 4);
+            return upgraded;
+        }
+
+        bool sendText(std::string_view payload) { return sendFrame(0x1, payload); }
+
+        // Read the next text message. Returns nullopt on timeout (the
+        // connection is still usable) and sets `closed` if the connection dropped.
+        std::optional<std::string> readText(std::chrono::milliseconds timeout, bool& closed) {
+            closed = false;
+            std::string message;
+            for (;;) {
+                if (buffer.size() < 2 && !fill(timeout)) {
+                    closed = fd < 0;
+                    return std::nullopt;
+                }
+                if (buffer.size() < 2)
+                    continue;
+
+                const auto  b0      = static_cast<unsigned char>(buffer[0]);
+                const auto  b1      = static_cast<unsigned char>(buffer[1]);
+                const bool  fin     = b0 & 0x80;
+                const int   opcode  = b0 & 0x0F;
+                const bool  masked  = b1 & 0x80;
+                uint64_t    length  = b1 & 0x7F;
+                size_t      header  = 2;
+                if (length == 126)
+                    header += 2;
+                else if (length == 127)
+                    header += 8;
+                if (masked)
+                    header += 4;
+
+                while (buffer.size() < header) {
+                    if (!fill(timeout)) {
+                        closed = fd < 0;
+                        return std::nullopt;
+                    }
+                }
+                if (length >= 126) {
+                    const size_t bytes = length == 126 ? 2 : 8;
+                    length             = 0;
+                    for (size_t i = 0; i < bytes; i++)
+                        length = (length << 8) | static_cast<unsigned char>(buffer[2 + i]);
+                }
+                while (buffer.size() < header + length) {
+                    if (!fill(timeout)) {
+                        closed = fd < 0;
+                        return std::nullopt;
+                    }
+                }
+
+                std::string payload = buffer.substr(header, length);
+                if (masked) {
+                    const size_t maskOffset = header - 4;
+                    for (size_t i = 0; i < payload.size(); i++)
+                        payload[i] = static_cast<char>(payload[i] ^ buffer[maskOffset + (i % 4)]);
+                }
+                buffer.erase(0, header + length);
+
+                if (opcode == 0x8) { // close
+                    close();
+                    closed = true;
+                    return std::nullopt;
+                }
+                if (opcode == 0x9) { // ping
+                    sendFrame(0xA, payload);
+                    continue;
+                }
+                if (opcode == 0xA) // pong
+                    continue;
+
+                message += payload;
+                if (fin)
+                    return message;
+            }
+        }
+
+        void close() {
+            if (fd >= 0)
+                ::close(fd);
+            fd = -1;
+        }
+
+    private:
+        static std::string base64(const std::array<unsigned char, 16>& bytes) {
+            static const char TABLE[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            std::string       result;
+            for (size_t i = 0; i < bytes.size(); i += 3) {
+                uint32_t chunk = static_cast<uint32_t>(bytes[i]) << 16;
+                if (i + 1 < bytes.size()) chunk |= static_cast<uint32_t>(bytes[i + 1]) << 8;
+                if (i + 2 < bytes.size()) chunk |= bytes[i + 2];
+                result += TABLE[(chunk >> 18) & 0x3F];
+                result += TABLE[(chunk >> 12) & 0x3F];
+                result += i + 1 < bytes.size() ? TABLE[(chunk >> 6) & 0x3F] : '=';
+                result += i + 2 < bytes.size() ? TABLE[chunk & 0x3F] : '=';
+            }
+            return result;
+        }
+
+        bool sendFrame(int opcode, std::string_view payload) {
+            // NOTE: Client to server frames must be masked
+            std::string frame;
+            frame += static_cast<char>(0x80 | opcode);
+            if (payload.size() < 126) {
+                frame += static_cast<char>(0x80 | payload.size());
+            } else if (payload.size() <= 0xFFFF) {
+                frame += static_cast<char>(0x80 | 126);
+                frame += static_cast<char>((payload.size() >> 8) & 0xFF);
+                frame += static_cast<char>(payload.size() & 0xFF);
+            } else {
+                frame += static_cast<char>(0x80 | 127);
+                for (int shift = 56; shift >= 0; shift -= 8)
+                    frame += static_cast<char>((payload.size() >> shift) & 0xFF);
+            }
+
+            std::random_device      rng;
+            std::array<char, 4>     mask = {};
+            for (char& byte : mask)
+                byte = static_cast<char>(rng());
+            frame.append(mask.data(), mask.size());
+            for (size_t i = 0; i < payload.size(); i++)
+                frame += static_cast<char>(payload[i] ^ mask[i % 4]);
+            return sendAll(frame);
+        }
+
+        bool sendAll(std::string_view data) {
+            while (fd >= 0 && !data.empty()) {
+                ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+                if (sent <= 0) {
+                    close();
+                    return false;
+                }
+                data.remove_prefix(static_cast<size_t>(sent));
+            }
+            return fd >= 0;
+        }
+
+        // Read whatever is available into the buffer, false on timeout or disconnect
+        bool fill(std::chrono::milliseconds timeout) {
+            if (fd < 0)
+                return false;
+            pollfd pfd = {fd, POLLIN, 0};
+            if (::poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0)
+                return false;
+
+            std::array<char, 4096> chunk = {};
+            ssize_t                read  = ::recv(fd, chunk.data(), chunk.size(), 0);
+            if (read <= 0) {
+                close();
+                return false;
+            }
+            buffer.append(chunk.data(), static_cast<size_t>(read));
+            return true;
+        }
+
+        int         fd = -1;
+        std::string buffer;
+    };
+}
+
+ReceiptTracker::ReceiptTracker(std::string rpcUrl, std::string _webSocketUrl, std::chrono::milliseconds _pollInterval)
+        : rpc(std::move(rpcUrl)), webSocketUrl(std::move(_webSocketUrl)), pollInterval(_pollInterval) {
+    worker = std::thread([this] { run(); });
+}
+
+ReceiptTracker::~ReceiptTracker() {
+    {
+        std::lock_guard lock{mutex};
+        stopping = true;
+    }
+    wakeup.notify_all();
+    worker.join();
+
+    for (auto& [hash, entry] : waiting)
+        entry.promise.set_exception(std::make_exception_ptr(std::runtime_error("Receipt tracker stopped before '" + hash + "' was mined")));
+}
+
+TransactionFuture ReceiptTracker::track(const std::string& hash) {
+    std::lock_guard lock{mutex};
+    auto [it, inserted] = waiting.try_emplace(hash);
+    if (inserted) {
+        it->second.future = it->second.promise.get_future().share();
+        fresh.push_back(hash);
+        wakeup.notify_all();
+    }
+    return it->second.future;
+}
+
+size_t ReceiptTracker::pending() const {
+    std::lock_guard lock{mutex};
+    return waiting.size();
+}
+
+std::vector<std::optional<TransactionResult>> ReceiptTracker::fetchReceipts(const std::vector<std::string>& hashes) {
+    TRACE_SPAN("receipt_tracker", "eth_getTransactionReceipt batch");
+    std::vector<std::pair<std::string, nlohmann::json>> requests;
+    requests.reserve(hashes.size());
+    for (const std::string& hash : hashes)
+        requests.emplace_back("eth_getTransactionReceipt", nlohmann::json::array({hash}));
+
+    std::vector<nlohmann::json> receipts;
+    {
+        std::lock_guard lock{rpcMutex};
+        receipts = rpc.batch(requests);
+    }
+
+    std::vector<std::optional<TransactionResult>> result;
+    result.reserve(receipts.size());
+    for (const nlohmann::json& receipt : receipts)
+        result.push_back(transactionResultFromReceipt(receipt));
+    return result;
+}
+
+void ReceiptTracker::checkReceipts(bool freshOnly) {
+    std::vector<std::string> hashes;
+    {
+        std::lock_guard lock{mutex};
+        if (freshOnly) {
+            hashes.swap(fresh);
+        } else {
+            fresh.clear();
+            hashes.reserve(waiting.size());
+            for (const auto& [hash, entry] : waiting)
+                hashes.push_back(hash);
+        }
+    }
+    if (hashes.empty())
+        return;
+
+    std::vector<std::optional<TransactionResult>> results;
+    try {
+        results = fetchReceipts(hashes);
+    } catch (const std::exception&) {
+        // NOTE: Transient RPC failure, the hashes are retried on the next block
+        return;
+    }
+
+    std::lock_guard lock{mutex};
+    for (size_t index = 0; index < hashes.size(); index++) {
+        if (!results[index])
+            continue;
+        auto it = waiting.find(hashes[index]);
+        if (it == waiting.end())
+            continue;
+        it->second.promise.set_value(std::move(*results[index]));
+        waiting.erase(it);
+    }
+}
+
+void ReceiptTracker::onNewHead(uint64_t height) {
+    head = height;
+    checkReceipts(false /*freshOnly*/);
+}
+
+uint64_t ReceiptTracker::latestHeight() {
+    std::lock_guard lock{rpcMutex};
+    return utils::fromHexStringToUint64(rpc.call("eth_blockNumber", nlohmann::json::array()).get<std::string>());
+}
+
+bool ReceiptTracker::runSubscription() {
+    const auto READ_TIMEOUT = std::chrono::milliseconds(250);
+    // NOTE: How long without a new head before asking the node over HTTP
+    // whether the chain moved on without telling us
+    const auto HEAD_TIMEOUT = pollInterval * 3;
+    WebSocket  socket;
+    if (!socket.connect(webSocketUrl, pollInterval * 5))
+        return false;
+
+    nlohmann::json subscribe = {{"jsonrpc", "2.0"}, {"id", 1}, {"method", "eth_subscribe"}, {"params", {"newHeads"}}};
+    if (!socket.sendText(subscribe.dump()))
+        return false;
+
+    // NOTE: Not active until the node answers with a subscription ID, a node
+    // that answers with an error or not at all is polled over HTTP instead
+    bool active   = false;
+    auto deadline = std::chrono::steady_clock::now() + pollInterval * 5;
+    for (;;) {
+        {
+            std::lock_guard lock{mutex};
+            if (stopping)
+                break;
+        }
+
+        // NOTE: Hashes tracked after their block arrived (e.g. on an
+        // automining node) get checked once straight away.
+        if (active)
+            checkReceipts(true /*freshOnly*/);
+
+        if (std::chrono::steady_clock::now() >= deadline) {
+            if (!active)
+                break;
+            try {
+                const uint64_t height = latestHeight();
+                if (height != head) {
+                    onNewHead(height);
+                    break;
+                }
+            } catch (const std::exception&) {
+                // NOTE: Node unreachable, the subscription is no worse off
+            }
+            deadline = std::chrono::steady_clock::now() + HEAD_TIMEOUT;
+        }
+
+        bool                       closed  = false;
+        std::optional<std::string> message = socket.readText(READ_TIMEOUT, closed);
+        if (closed)
+            break;
+        if (!message)
+            continue;
+
+        nlohmann::json notification = nlohmann::json::parse(*message, nullptr, false /*allow_exceptions*/);
+        if (notification.is_discarded() || !notification.is_object())
+            continue;
+
+        if (!active && notification.contains("id") && notification["id"] == 1) {
+            if (!notification.contains("result") || !notification["result"].is_string())
+                break;
+            active             = true;
+            subscriptionActive = true;
+            deadline           = std::chrono::steady_clock::now() + HEAD_TIMEOUT;
+            continue;
+        }
+
+        if (!active || notification.value("method", "") != "eth_subscription")
+            continue;
+        const nlohmann::json& block = notification["params"]["result"];
+        if (block.contains("number")) {
+            onNewHead(utils::fromHexStringToUint64(block["number"].get<std::string>()));
+            deadline = std::chrono::steady_clock::now() + HEAD_TIMEOUT;
+        }
+    }
+    subscriptionActive = false;
+    return active;
+}
+
+void ReceiptTracker::run() {
+    // NOTE: How long to poll over HTTP before trying the subscription again
+    const auto RESUBSCRIBE_INTERVAL = std::chrono::seconds(30);
+    auto       nextSubscribe        = std::chrono::steady_clock::now();
+
+    for (;;) {
+        {
+            std::lock_guard lock{mutex};
+            if (stopping)
+                return;
+        }
+
+        if (!webSocketUrl.empty() && std::chrono::steady_clock::now() >= nextSubscribe) {
+            runSubscription();
+            nextSubscribe = std::chrono::steady_clock::now() + RESUBSCRIBE_INTERVAL;
+            continue;
+        }
+
+        try {
+            const uint64_t height = latestHeight();
+            if (height != head)
+                onNewHead(height);
+        } catch (const std::exception&) {
+            // NOTE: Node unreachable, try again next interval
+        }
+        checkReceipts(true /*freshOnly*/);
+
+        std::unique_lock lock{mutex};
+        wakeup.wait_for(lock, pollInterval, [this] { return stopping || !fresh.empty(); });
+    }
+}
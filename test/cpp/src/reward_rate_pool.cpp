@@ -0,0 +1,141 @@
+#include "service_node_rewards/reward_rate_pool.hpp"
+
+#include "ethyl/utils.hpp"
+
+namespace {
+    const uint64_t INTEREST_DENOMINATOR = RewardRatePool::BASIS_POINTS * RewardRatePool::SECONDS_PER_YEAR;
+
+    // NOTE: The contract computes `timestamp - lastPaidOutTime` in uint256 and
+    // reverts on underflow.
+    uint64_t timeElapsed(uint64_t timestamp, uint64_t lastPaidOutTime) {
+        if (timestamp < lastPaidOutTime)
+            throw std::overflow_error("RewardRatePool timestamp " + std::to_string(timestamp) + " is before the last payout at " + std::to_string(lastPaidOutTime));
+        return timestamp - lastPaidOutTime;
+    }
+}
+
+RewardRatePool::RewardRatePool(RewardRatePoolState state) : poolState(std::move(state)) {}
+
+Uint256 RewardRatePool::calculateInterestAmount(const Uint256& balance, const Uint256& timeElapsed) {
+    return balance * ANNUAL_INTEREST_RATE * timeElapsed / INTEREST_DENOMINATOR;
+}
+
+Uint256 RewardRatePool::calculateTotalDeposited() const {
+    return poolState.balance + poolState.totalPaidOut;
+}
+
+Uint256 RewardRatePool::calculateReleasedAmount(uint64_t timestamp) const {
+    return poolState.totalPaidOut + calculateInterestAmount(poolState.balance, timeElapsed(timestamp, poolState.lastPaidOutTime));
+}
+
+Uint256 RewardRatePool::rewardRate(uint64_t timestamp) const {
+    Uint256 alreadyReleased = calculateReleasedAmount(timestamp);
+    Uint256 totalDeposited  = calculateTotalDeposited();
+    return calculateInterestAmount(totalDeposited - alreadyReleased, BLOCK_TIME);
+}
+
+std::vector<Uint256> RewardRatePool::calculateInterestAmounts(const std::vector<Uint256>& balances, uint64_t timeElapsed) {
+    std::vector<Uint256> result;
+    result.reserve(balances.size());
+    for (const Uint256& balance : balances)
+        result.push_back(balance * ANNUAL_INTEREST_RATE * timeElapsed / INTEREST_DENOMINATOR);
+    return result;
+}
+
+std::vector<Uint256> RewardRatePool::calculateReleasedAmounts(const std::vector<uint64_t>& timestamps) const {
+    const Uint256 scaledBalance = poolState.balance * ANNUAL_INTEREST_RATE;
+
+    std::vector<Uint256> result;
+    result.reserve(timestamps.size());
+    for (uint64_t timestamp : timestamps)
+        result.push_back(poolState.totalPaidOut + scaledBalance * timeElapsed(timestamp, poolState.lastPaidOutTime) / INTEREST_DENOMINATOR);
+    return result;
+}
+
+std::vector<Uint256> RewardRatePool::rewardRates(const std::vector<uint64_t>& timestamps) const {
+    // NOTE: (x * RATE) * BLOCK_TIME overflows exactly when x * (RATE * BLOCK_TIME)
+    // does, so the two multiplies fold into one without changing when we throw.
+    const Uint256  totalDeposited = calculateTotalDeposited();
+    const uint64_t BLOCK_RATE     = ANNUAL_INTEREST_RATE * BLOCK_TIME;
+
+    std::vector<Uint256> result = calculateReleasedAmounts(timestamps);
+    for (Uint256& item : result)
+        item = (totalDeposited - item) * BLOCK_RATE / INTEREST_DENOMINATOR;
+    return result;
+}
+
+Uint256 RewardRatePool::payoutReleased(uint64_t timestamp) {
+    Uint256 newTotalPaidOut   = calculateReleasedAmount(timestamp);
+    Uint256 released          = newTotalPaidOut - poolState.totalPaidOut;
+    poolState.balance        -= released;
+    poolState.totalPaidOut    = newTotalPaidOut;
+    poolState.lastPaidOutTime = timestamp;
+    return released;
+}
+
+RewardRatePoolContract::RewardRatePoolContract(const std::string& _contractAddress, std::shared_ptr<Provider> _provider)
+        : contractAddress(_contractAddress), backend(std::make_shared<LiveProviderBackend>(_provider)) {}
+
+RewardRatePoolContract::RewardRatePoolContract(const std::string& _contractAddress, std::shared_ptr<ProviderBackend> _backend)
+        : contractAddress(_contractAddress), backend(std::move(_backend)) {}
+
+Uint256 RewardRatePoolContract::readUint256(const std::string& signature, const std::string& arguments) {
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature(signature) + arguments;
+    return Uint256::fromHex(backend->callReadFunction(callData));
+}
+
+std::string RewardRatePoolContract::sent() {
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature("SENT()");
+    return utils::trimAddress(backend->callReadFunction(callData));
+}
+
+Uint256 RewardRatePoolContract::totalPaidOut() {
+    return readUint256("totalPaidOut()");
+}
+
+uint64_t RewardRatePoolContract::lastPaidOutTime() {
+    return readUint256("lastPaidOutTime()").low64();
+}
+
+Uint256 RewardRatePoolContract::calculateTotalDeposited() {
+    return readUint256("calculateTotalDeposited()");
+}
+
+Uint256 RewardRatePoolContract::calculateReleasedAmount(uint64_t timestamp) {
+    return readUint256("calculateReleasedAmount(uint256)", Uint256(timestamp).toHex());
+}
+
+Uint256 RewardRatePoolContract::calculateInterestAmount(const Uint256& balance, const Uint256& timeElapsed) {
+    return readUint256("calculateInterestAmount(uint256,uint256)", balance.toHex() + timeElapsed.toHex());
+}
+
+Uint256 RewardRatePoolContract::rewardRate(uint64_t timestamp) {
+    return readUint256("rewardRate(uint256)", Uint256(timestamp).toHex());
+}
+
+RewardRatePoolState RewardRatePoolContract::state() {
+    // NOTE: Pin every read to one block so the snapshot is consistent
+    const uint64_t blockNumber = backend->getLatestHeight();
+    auto read = [&](const std::string& signature) {
+        ReadCallData callData    = {};
+        callData.contractAddress = contractAddress;
+        callData.data            = utils::getFunctionSignature(signature);
+        return Uint256::fromHex(backend->callReadFunction(callData, blockNumber));
+    };
+
+    RewardRatePoolState result = {};
+    result.totalPaidOut        = read("totalPaidOut()");
+    result.balance             = read("calculateTotalDeposited()") - result.totalPaidOut;
+    result.lastPaidOutTime     = read("lastPaidOutTime()").low64();
+    return result;
+}
+
+Transaction RewardRatePoolContract::payoutReleased() {
+    Transaction tx(contractAddress, 0, 3000000);
+    tx.data = utils::getFunctionSignature("payoutReleased()");
+    return tx;
+}
@@ -0,0 +1,130 @@
+#include "service_node_rewards/rewards_ledger.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "ethyl/utils.hpp"
+
+std::vector<RewardUpdate> RewardsLedgerDiff::rewardUpdates() const {
+    std::vector<RewardUpdate> result;
+    result.reserve(updates.size());
+    for (const RewardsLedgerUpdate& update : updates) {
+        if (!update.amount.fitsUint64()) {
+            std::stringstream stream;
+            stream << "Reward total " << update.amount.toString() << " of " << update.address << " does not fit in a uint64_t";
+            throw std::overflow_error(stream.str());
+        }
+        result.push_back(RewardUpdate{update.address, update.amount.low64()});
+    }
+    return result;
+}
+
+std::string RewardsLedger::normalizeAddress(std::string_view address) {
+    std::string_view hex = utils::trimPrefix(address, "0x");
+    if (hex.size() != 40 || hex.find_first_not_of("0123456789abcdefABCDEF") != std::string_view::npos) {
+        std::stringstream stream;
+        stream << "Recipient '" << address << "' is not a 20 byte hex address";
+        throw std::invalid_argument(stream.str());
+    }
+
+    std::string result = "0x";
+    result.reserve(2 + hex.size());
+    for (char ch : hex)
+        result.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+    return result;
+}
+
+std::vector<std::string> RewardsLedger::reconcile(JsonRpcClient& rpc, const std::string& contractAddress, const std::vector<std::string>& addresses, const std::string& block, size_t batchSize) {
+    if (batchSize == 0)
+        throw std::invalid_argument("Rewards ledger needs a non-zero batch size");
+
+    // NOTE: Only used to build call data, never reads through the backend
+    const ServiceNodeRewardsContract contract(contractAddress, std::shared_ptr<ProviderBackend>{});
+
+    std::vector<std::string> result;
+    for (size_t begin = 0; begin < addresses.size(); begin += batchSize) {
+        const size_t                                        end = std::min(addresses.size(), begin + batchSize);
+        std::vector<std::pair<std::string, nlohmann::json>> requests;
+        requests.reserve(end - begin);
+        for (size_t index = begin; index < end; index++) {
+            const ReadCallData callData = contract.recipientsCall(addresses[index]);
+            nlohmann::json     params   = nlohmann::json::array();
+            params.push_back({{"to", "0x" + std::string(utils::trimPrefix(callData.contractAddress, "0x"))}, {"data", callData.data}});
+            params.push_back(block);
+            requests.emplace_back("eth_call", std::move(params));
+        }
+
+        std::vector<nlohmann::json> responses = rpc.batch(requests);
+        for (size_t index = 0; index < requests.size(); index++) {
+            // NOTE: A failed request has its "error" object in place of the
+            // result, a missing response is left null
+            const nlohmann::json& response = index < responses.size() ? responses[index] : nlohmann::json();
+            if (!response.is_string()) {
+                std::stringstream stream;
+                stream << "Failed to read the rewards of " << addresses[begin + index] << " in a batch: " << response.dump();
+                throw std::runtime_error(stream.str());
+            }
+
+            const std::string      address = normalizeAddress(addresses[begin + index]);
+            const RecipientBalance balance = ServiceNodeRewardsContract::decodeRecipientBalance(response.get<std::string>());
+            const RecipientBalance known   = this->balance(address);
+            if (known.rewards != balance.rewards || known.claimed != balance.claimed)
+                result.push_back(address);
+            recipients[address] = balance;
+        }
+    }
+    return result;
+}
+
+void RewardsLedger::set(const std::string& address, const RecipientBalance& balance) {
+    recipients[normalizeAddress(address)] = balance;
+}
+
+void RewardsLedger::confirm(const std::string& address, const Uint256& rewards) {
+    RecipientBalance& balance = recipients[normalizeAddress(address)];
+    if (rewards > balance.rewards)
+        balance.rewards = rewards;
+}
+
+RecipientBalance RewardsLedger::balance(const std::string& address) const {
+    auto it = recipients.find(normalizeAddress(address));
+    return it == recipients.end() ? RecipientBalance{} : it->second;
+}
+
+RewardsLedgerDiff RewardsLedger::diff(const std::vector<std::pair<std::string, Uint256>>& totals, size_t limit) const {
+    RewardsLedgerDiff               result = {};
+    std::unordered_set<std::string> seen;
+    seen.reserve(totals.size());
+    for (const auto& [rawAddress, amount] : totals) {
+        std::string address = normalizeAddress(rawAddress);
+        if (!seen.insert(address).second)
+            throw std::invalid_argument("Recipient " + address + " is in the epoch twice");
+
+        auto          it      = recipients.find(address);
+        const Uint256 onChain = it == recipients.end() ? Uint256() : it->second.rewards;
+        if (amount == onChain)
+            result.unchanged++;
+        else if (amount > onChain)
+            result.updates.push_back(RewardsLedgerUpdate{std::move(address), amount, onChain});
+        else
+            result.regressed.push_back(RewardsLedgerUpdate{std::move(address), amount, onChain});
+    }
+
+    // NOTE: Most owed first, by address after that so the order is stable
+    // across runs
+    auto priority = [](const RewardsLedgerUpdate& lhs, const RewardsLedgerUpdate& rhs) {
+        const Uint256 lhsOwed = lhs.amount - lhs.onChain;
+        const Uint256 rhsOwed = rhs.amount - rhs.onChain;
+        return lhsOwed != rhsOwed ? lhsOwed > rhsOwed : lhs.address < rhs.address;
+    };
+    if (limit < result.updates.size()) {
+        std::partial_sort(result.updates.begin(), result.updates.begin() + static_cast<ptrdiff_t>(limit), result.updates.end(), priority);
+        result.updates.resize(limit);
+    } else {
+        std::sort(result.updates.begin(), result.updates.end(), priority);
+    }
+    return result;
+}
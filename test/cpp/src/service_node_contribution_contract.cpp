@@ -0,0 +1,215 @@
+#include "service_node_rewards/service_node_contribution_contract.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    const size_t WORD_HEX_SIZE        = 32 * 2;
+    const size_t ETH_ADDRESS_HEX_SIZE = 20 * 2;
+
+    std::string addressWord(const std::string& address) {
+        return utils::padTo32Bytes(std::string(utils::trimPrefix(address, "0x")), utils::PaddingDirection::LEFT);
+    }
+
+    std::string_view firstWord(std::string_view hex) {
+        hex = utils::trimPrefix(hex, "0x");
+        if (hex.size() < WORD_HEX_SIZE) {
+            std::stringstream stream;
+            stream << "Failed to decode call result '" << hex << "': expected at least one 32 byte word";
+            throw std::runtime_error(stream.str());
+        }
+        return hex.substr(0, WORD_HEX_SIZE);
+    }
+}
+
+ServiceNodeContributionContract::ServiceNodeContributionContract(const std::string& _contractAddress, std::shared_ptr<Provider> _provider)
+        : contractAddress(_contractAddress), backend(std::make_shared<LiveProviderBackend>(_provider)) {}
+
+ServiceNodeContributionContract::ServiceNodeContributionContract(const std::string& _contractAddress, std::shared_ptr<ProviderBackend> _backend)
+        : contractAddress(_contractAddress), backend(std::move(_backend)) {}
+
+void ServiceNodeContributionContract::setMetrics(std::shared_ptr<ContractMetrics> _metrics) {
+    metrics = std::move(_metrics);
+}
+
+Transaction ServiceNodeContributionContract::contributeOperatorFunds(const Uint256& amount, const std::string& blsSignature) {
+    Transaction tx(contractAddress, 0, 3000000);
+    std::string functionSelector = utils::getFunctionSignature("contributeOperatorFunds(uint256,(uint256,uint256,uint256,uint256))");
+    tx.data = functionSelector + amount.toHex() + std::string(utils::trimPrefix(blsSignature, "0x"));
+    return tx;
+}
+
+Transaction ServiceNodeContributionContract::contributeFunds(const Uint256& amount) {
+    Transaction tx(contractAddress, 0, 3000000);
+    std::string functionSelector = utils::getFunctionSignature("contributeFunds(uint256)");
+    tx.data = functionSelector + amount.toHex();
+    return tx;
+}
+
+Transaction ServiceNodeContributionContract::withdrawStake() {
+    Transaction tx(contractAddress, 0, 3000000);
+    tx.data = utils::getFunctionSignature("withdrawStake()");
+    return tx;
+}
+
+Transaction ServiceNodeContributionContract::cancelNode() {
+    Transaction tx(contractAddress, 0, 3000000);
+    tx.data = utils::getFunctionSignature("cancelNode()");
+    return tx;
+}
+
+Transaction ServiceNodeContributionContract::resetContract(const Uint256& amount) {
+    Transaction tx(contractAddress, 0, 3000000);
+    std::string functionSelector = utils::getFunctionSignature("resetContract(uint256)");
+    tx.data = functionSelector + amount.toHex();
+    return tx;
+}
+
+Transaction ServiceNodeContributionContract::rescueERC20(const std::string& tokenAddress) {
+    Transaction tx(contractAddress, 0, 3000000);
+    std::string functionSelector = utils::getFunctionSignature("rescueERC20(address)");
+    tx.data = functionSelector + addressWord(tokenAddress);
+    return tx;
+}
+
+ReadCallData ServiceNodeContributionContract::contributionsCall(const std::string& address) const {
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature("contributions(address)") + addressWord(address);
+    return callData;
+}
+
+ReadCallData ServiceNodeContributionContract::contributionTimestampCall(const std::string& address) const {
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature("contributionTimestamp(address)") + addressWord(address);
+    return callData;
+}
+
+ReadCallData ServiceNodeContributionContract::readCall(std::string_view signature) const {
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature(std::string(signature));
+    return callData;
+}
+
+Uint256 ServiceNodeContributionContract::decodeUint256(std::string_view hex) {
+    return Uint256::fromHex(firstWord(hex));
+}
+
+std::string ServiceNodeContributionContract::decodeAddress(std::string_view hex) {
+    return std::string(firstWord(hex).substr(WORD_HEX_SIZE - ETH_ADDRESS_HEX_SIZE));
+}
+
+std::string ServiceNodeContributionContract::decodeFirstWord(std::string_view hex) {
+    return std::string(firstWord(hex));
+}
+
+std::string ServiceNodeContributionContract::read(const ReadCallData& callData, MethodCall& call) {
+    return call.network(callData.data, [&] { return backend->callReadFunction(callData); });
+}
+
+Uint256 ServiceNodeContributionContract::readUint256(std::string_view method, std::string_view signature) {
+    MethodCall  call(metrics, method);
+    std::string result = read(readCall(signature), call);
+    return call.decode([&] { return decodeUint256(result); });
+}
+
+Uint256 ServiceNodeContributionContract::contributions(const std::string& address) {
+    MethodCall  call(metrics, "contributions");
+    std::string result = read(contributionsCall(address), call);
+    return call.decode([&] { return decodeUint256(result); });
+}
+
+uint64_t ServiceNodeContributionContract::contributionTimestamp(const std::string& address) {
+    MethodCall  call(metrics, "contributionTimestamp");
+    std::string result = read(contributionTimestampCall(address), call);
+    return call.decode([&] { return decodeUint256(result).low64(); });
+}
+
+std::string ServiceNodeContributionContract::contributorAddresses(uint64_t index) {
+    MethodCall   call(metrics, "contributorAddresses");
+    ReadCallData callData = readCall("contributorAddresses(uint256)");
+    callData.data += utils::padTo32Bytes(utils::decimalToHex(index), utils::PaddingDirection::LEFT);
+    std::string result = read(callData, call);
+    return call.decode([&] { return decodeAddress(result); });
+}
+
+std::string ServiceNodeContributionContract::operatorAddress() {
+    MethodCall  call(metrics, "operator");
+    std::string result = read(readCall("operator()"), call);
+    return call.decode([&] { return decodeAddress(result); });
+}
+
+std::string ServiceNodeContributionContract::serviceNodePubkey() {
+    // NOTE: The getter returns every member of ServiceNodeParams, the key is the first
+    MethodCall  call(metrics, "serviceNodeParams");
+    std::string result = read(readCall("serviceNodeParams()"), call);
+    return call.decode([&] { return decodeFirstWord(result); });
+}
+
+Uint256 ServiceNodeContributionContract::stakingRequirement() {
+    return readUint256("stakingRequirement", "stakingRequirement()");
+}
+
+Uint256 ServiceNodeContributionContract::operatorContribution() {
+    return readUint256("operatorContribution", "operatorContribution()");
+}
+
+Uint256 ServiceNodeContributionContract::totalContribution() {
+    return readUint256("totalContribution", "totalContribution()");
+}
+
+Uint256 ServiceNodeContributionContract::minimumContribution() {
+    return readUint256("minimumContribution", "minimumContribution()");
+}
+
+uint64_t ServiceNodeContributionContract::numberContributors() {
+    return readUint256("numberContributors", "numberContributors()").low64();
+}
+
+uint64_t ServiceNodeContributionContract::maxContributors() {
+    return readUint256("maxContributors", "maxContributors()").low64();
+}
+
+bool ServiceNodeContributionContract::finalized() {
+    return !readUint256("finalized", "finalized()").isZero();
+}
+
+bool ServiceNodeContributionContract::cancelled() {
+    return !readUint256("cancelled", "cancelled()").isZero();
+}
+
+ServiceNodeContributionFactoryContract::ServiceNodeContributionFactoryContract(const std::string& _contractAddress, std::shared_ptr<Provider> _provider)
+        : contractAddress(_contractAddress), backend(std::make_shared<LiveProviderBackend>(_provider)) {}
+
+ServiceNodeContributionFactoryContract::ServiceNodeContributionFactoryContract(const std::string& _contractAddress, std::shared_ptr<ProviderBackend> _backend)
+        : contractAddress(_contractAddress), backend(std::move(_backend)) {}
+
+Transaction ServiceNodeContributionFactoryContract::deployContributionContract(const std::string& blsPubkey, const std::string& serviceNodePubkey, const std::string& serviceNodeSignature, uint64_t fee) {
+    Transaction tx(contractAddress, 0, DEPLOY_CONTRIBUTION_CONTRACT_GAS);
+    std::string functionSelector = utils::getFunctionSignature("deployContributionContract((uint256,uint256),(uint256,uint256,uint256,uint16))");
+
+    const std::string serviceNodePubkeyPadded    = utils::padTo32Bytes(utils::toHexString(serviceNodePubkey), utils::PaddingDirection::LEFT);
+    const std::string serviceNodeSignaturePadded = utils::padToNBytes(utils::toHexString(serviceNodeSignature), 64, utils::PaddingDirection::LEFT);
+    const std::string feePadded                  = utils::padTo32Bytes(utils::decimalToHex(fee), utils::PaddingDirection::LEFT);
+
+    // NOTE: Both tuples are static, they are encoded in place
+    tx.data = functionSelector + std::string(utils::trimPrefix(blsPubkey, "0x")) + serviceNodePubkeyPadded + serviceNodeSignaturePadded + feePadded;
+    return tx;
+}
+
+std::string ServiceNodeContributionFactoryContract::readLatest(std::string_view signature) {
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature(std::string(signature));
+    return backend->callReadFunction(callData);
+}
+
+uint64_t ServiceNodeContributionFactoryContract::maxContributors() {
+    return ServiceNodeContributionContract::decodeUint256(readLatest("maxContributors()")).low64();
+}
+
+std::string ServiceNodeContributionFactoryContract::stakingRewardsContract() {
+    return ServiceNodeContributionContract::decodeAddress(readLatest("stakingRewardsContract()"));
+}
@@ -0,0 +1,131 @@
+#include "service_node_rewards/service_node_contribution_events.hpp"
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+static std::string eventTopic(std::string_view signature) {
+    return "0x" + utils::toHexString(utils::hash(signature));
+}
+
+const std::string& contribution_events::newServiceNodeContributionContractTopic() {
+    static const std::string topic = eventTopic("NewServiceNodeContributionContract(address,uint256)");
+    return topic;
+}
+
+const std::string& contribution_events::newContributionTopic() {
+    static const std::string topic = eventTopic("NewContribution(address,uint256)");
+    return topic;
+}
+
+const std::string& contribution_events::stakeWithdrawnTopic() {
+    static const std::string topic = eventTopic("StakeWithdrawn(address,uint256)");
+    return topic;
+}
+
+const std::string& contribution_events::finalizedTopic() {
+    static const std::string topic = eventTopic("Finalized(uint256)");
+    return topic;
+}
+
+const std::string& contribution_events::cancelledTopic() {
+    static const std::string topic = eventTopic("Cancelled(uint256)");
+    return topic;
+}
+
+namespace {
+    const size_t WORD_HEX_SIZE        = 32 * 2;
+    const size_t ETH_ADDRESS_HEX_SIZE = 20 * 2;
+
+    std::string_view wordAt(const LogEntry& log, std::string_view hex, size_t index) {
+        if ((index + 1) * WORD_HEX_SIZE > hex.size()) {
+            std::stringstream stream;
+            stream << "Failed to decode log for topic '" << log.topics[0] << "': data has " << hex.size() / WORD_HEX_SIZE
+                   << " words, tried to read word " << index;
+            throw std::runtime_error(stream.str());
+        }
+        return hex.substr(index * WORD_HEX_SIZE, WORD_HEX_SIZE);
+    }
+
+    std::string_view indexedTopic(const LogEntry& log, size_t index) {
+        if (log.topics.size() <= index) {
+            std::stringstream stream;
+            stream << "Failed to decode log for topic '" << log.topics[0] << "': expected at least " << index + 1
+                   << " topics, log had " << log.topics.size();
+            throw std::runtime_error(stream.str());
+        }
+        return utils::trimPrefix(log.topics[index], "0x");
+    }
+
+    std::array<unsigned char, 20> addressFromHex(std::string_view hex) {
+        hex = utils::trimPrefix(hex, "0x");
+        if (hex.size() < ETH_ADDRESS_HEX_SIZE)
+            throw std::runtime_error("Failed to decode address from '" + std::string(hex) + "': too short");
+        std::array<unsigned char, 20> result = {};
+        std::vector<unsigned char>    bytes  = utils::fromHexString(hex.substr(hex.size() - ETH_ADDRESS_HEX_SIZE));
+        std::memcpy(result.data(), bytes.data(), result.size());
+        return result;
+    }
+}
+
+std::optional<ServiceNodeContributionEvent> contribution_events::decode(const LogEntry& log) {
+    if (log.topics.empty())
+        return std::nullopt;
+
+    EventLocation location   = {};
+    location.blockNumber     = log.blockNumber.value_or(0);
+    location.logIndex        = log.logIndex.value_or(0);
+    location.blockHash       = log.blockHash.value_or("");
+    location.transactionHash = log.transactionHash.value_or("");
+
+    const std::string& topic = log.topics[0];
+    std::string_view   data  = utils::trimPrefix(log.data, "0x");
+
+    if (topic == newServiceNodeContributionContractTopic()) {
+        NewServiceNodeContributionContractEvent result = {};
+        result.location                                = std::move(location);
+        result.contributionContract                    = addressFromHex(indexedTopic(log, 1));
+        result.serviceNodePubkey                       = std::string(wordAt(log, data, 0));
+        return result;
+    }
+
+    if (topic == newContributionTopic()) {
+        NewContributionEvent result = {};
+        result.location             = std::move(location);
+        result.contract             = addressFromHex(log.address);
+        result.contributor          = addressFromHex(indexedTopic(log, 1));
+        result.amount               = Uint256::fromHex(wordAt(log, data, 0));
+        return result;
+    }
+
+    if (topic == stakeWithdrawnTopic()) {
+        StakeWithdrawnEvent result = {};
+        result.location            = std::move(location);
+        result.contract            = addressFromHex(log.address);
+        result.contributor         = addressFromHex(indexedTopic(log, 1));
+        result.amount              = Uint256::fromHex(wordAt(log, data, 0));
+        return result;
+    }
+
+    if (topic == finalizedTopic()) {
+        ContributionFinalizedEvent result = {};
+        result.location                   = std::move(location);
+        result.contract                   = addressFromHex(log.address);
+        result.serviceNodePubkey          = std::string(indexedTopic(log, 1));
+        return result;
+    }
+
+    if (topic == cancelledTopic()) {
+        ContributionCancelledEvent result = {};
+        result.location                   = std::move(location);
+        result.contract                   = addressFromHex(log.address);
+        result.serviceNodePubkey          = std::string(indexedTopic(log, 1));
+        return result;
+    }
+
+    return std::nullopt;
+}
+
+const EventLocation& contribution_events::location(const ServiceNodeContributionEvent& event) {
+    return std::visit([](const auto& item) -> const EventLocation& { return item.location; }, event);
+}
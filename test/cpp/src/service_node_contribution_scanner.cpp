@@ -0,0 +1,286 @@
+#include "service_node_rewards/service_node_contribution_scanner.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+    std::string normalise(std::string_view address) {
+        std::string result(utils::trimPrefix(address, "0x"));
+        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+        return result;
+    }
+
+    std::string quantity(uint64_t value) {
+        return "0x" + utils::decimalToHex(value);
+    }
+
+    std::string toHex(const std::array<unsigned char, 20>& address) {
+        return utils::toHexString(address);
+    }
+}
+
+ServiceNodeContributionScanner::ServiceNodeContributionScanner(std::string rpcUrl, std::string _factoryAddress, uint64_t _startBlock, uint64_t _confirmations, uint64_t _chunkSize, size_t _batchSize)
+        : rpc(std::move(rpcUrl)),
+          factoryAddress(normalise(_factoryAddress)),
+          startBlock(_startBlock),
+          nextBlock(_startBlock),
+          confirmations(_confirmations),
+          chunkSize(_chunkSize),
+          batchSize(_batchSize) {
+    if (chunkSize == 0 || batchSize == 0)
+        throw std::invalid_argument("Contribution scanner needs a non-zero chunk and batch size");
+}
+
+void ServiceNodeContributionScanner::track(const std::string& contractAddress) {
+    const std::string address = normalise(contractAddress);
+    if (tracked.count(address))
+        return;
+    tracked[address]        = {};
+    states[address].address = address;
+    pending.push_back(address);
+}
+
+LogEntry ServiceNodeContributionScanner::logFromJson(const nlohmann::json& log) {
+    LogEntry result = {};
+    result.address  = log.at("address").get<std::string>();
+    result.data     = log.at("data").get<std::string>();
+    for (const nlohmann::json& topic : log.at("topics"))
+        result.topics.push_back(topic.get<std::string>());
+    if (log.contains("blockNumber") && log["blockNumber"].is_string())
+        result.blockNumber = utils::fromHexStringToUint64(utils::trimPrefix(log["blockNumber"].get<std::string>(), "0x"));
+    if (log.contains("logIndex") && log["logIndex"].is_string())
+        result.logIndex = static_cast<uint32_t>(utils::fromHexStringToUint64(utils::trimPrefix(log["logIndex"].get<std::string>(), "0x")));
+    if (log.contains("transactionIndex") && log["transactionIndex"].is_string())
+        result.transactionIndex = static_cast<uint32_t>(utils::fromHexStringToUint64(utils::trimPrefix(log["transactionIndex"].get<std::string>(), "0x")));
+    if (log.contains("blockHash") && log["blockHash"].is_string())
+        result.blockHash = log["blockHash"].get<std::string>();
+    if (log.contains("transactionHash") && log["transactionHash"].is_string())
+        result.transactionHash = log["transactionHash"].get<std::string>();
+    result.removed = log.value("removed", false);
+    return result;
+}
+
+std::vector<nlohmann::json> ServiceNodeContributionScanner::batch(const std::vector<std::pair<std::string, nlohmann::json>>& requests) {
+    std::vector<nlohmann::json> result;
+    result.reserve(requests.size());
+    for (size_t begin = 0; begin < requests.size(); begin += batchSize) {
+        const size_t                                          end = std::min(requests.size(), begin + batchSize);
+        std::vector<std::pair<std::string, nlohmann::json>> group(requests.begin() + static_cast<ptrdiff_t>(begin), requests.begin() + static_cast<ptrdiff_t>(end));
+        std::vector<nlohmann::json>                           responses = rpc.batch(group);
+        for (size_t index = 0; index < responses.size(); index++) {
+            // NOTE: A failed request has its "error" object in place of the
+            // result, a missing response is left null
+            const nlohmann::json& response = responses[index];
+            if (response.is_null() || (response.is_object() && response.contains("code"))) {
+                std::stringstream stream;
+                stream << "JSON-RPC '" << group[index].first << "' " << group[index].second.dump() << " failed in a batch: " << response.dump();
+                throw std::runtime_error(stream.str());
+            }
+            result.push_back(std::move(responses[index]));
+        }
+    }
+    return result;
+}
+
+std::vector<LogEntry> ServiceNodeContributionScanner::fetchLogs(uint64_t fromBlock, uint64_t toBlock, const std::vector<std::string>& addresses) {
+    // NOTE: One eth_getLogs per block chunk and group of addresses, all of
+    // them in the same batches
+    std::vector<std::pair<std::string, nlohmann::json>> requests;
+    for (uint64_t chunkBegin = fromBlock; chunkBegin <= toBlock; chunkBegin += chunkSize) {
+        const uint64_t chunkEnd = std::min(toBlock, chunkBegin + chunkSize - 1);
+        for (size_t begin = 0; begin < addresses.size(); begin += batchSize) {
+            nlohmann::json filter = nlohmann::json::array();
+            for (size_t index = begin; index < std::min(addresses.size(), begin + batchSize); index++)
+                filter.push_back("0x" + addresses[index]);
+            nlohmann::json params = nlohmann::json::array();
+            params.push_back({{"fromBlock", quantity(chunkBegin)}, {"toBlock", quantity(chunkEnd)}, {"address", std::move(filter)}});
+            requests.emplace_back("eth_getLogs", std::move(params));
+        }
+        if (chunkEnd == toBlock)
+            break;
+    }
+
+    std::vector<LogEntry> result;
+    for (const nlohmann::json& logs : batch(requests)) {
+        if (!logs.is_array())
+            throw std::runtime_error("JSON-RPC 'eth_getLogs' returned a non-array result: " + logs.dump());
+        for (const nlohmann::json& log : logs) {
+            LogEntry entry = logFromJson(log);
+            if (!entry.removed)
+                result.push_back(std::move(entry));
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const LogEntry& lhs, const LogEntry& rhs) {
+        return lhs.blockNumber != rhs.blockNumber ? lhs.blockNumber < rhs.blockNumber : lhs.logIndex < rhs.logIndex;
+    });
+    return result;
+}
+
+void ServiceNodeContributionScanner::apply(std::vector<LogEntry> logs, std::set<std::string>& changed, ContributionScanResult& result) {
+    for (const LogEntry& log : logs) {
+        std::optional<ServiceNodeContributionEvent> event = contribution_events::decode(log);
+        if (!event)
+            continue;
+
+        std::visit([&](const auto& item) {
+            using T = std::decay_t<decltype(item)>;
+            if constexpr (std::is_same_v<T, NewServiceNodeContributionContractEvent>) {
+                // NOTE: Only the factory's own events announce contracts,
+                // anyone can emit a log with the same topic
+                if (normalise(log.address) != factoryAddress)
+                    return;
+                const std::string address = toHex(item.contributionContract);
+                if (tracked.count(address)) {
+                    // NOTE: Discovered by a scan that failed, report it again
+                    // as these blocks are scanned again
+                    if (changed.count(address) && states[address].deployedBlock == item.location.blockNumber)
+                        result.discovered.push_back(address);
+                    return;
+                }
+                tracked[address]                  = {};
+                ContributionContractState& state  = states[address];
+                state.address                     = address;
+                state.serviceNodePubkey           = item.serviceNodePubkey;
+                state.deployedBlock               = item.location.blockNumber;
+                result.discovered.push_back(address);
+                changed.insert(address);
+            } else {
+                const std::string address = toHex(item.contract);
+                auto              it      = tracked.find(address);
+                if (it == tracked.end())
+                    return;
+                if constexpr (std::is_same_v<T, NewContributionEvent>) {
+                    const std::string contributor = toHex(item.contributor);
+                    if (it->second.seen.insert(contributor).second)
+                        it->second.contributors.push_back(contributor);
+                }
+                changed.insert(address);
+            }
+        }, *event);
+        result.events.push_back(std::move(*event));
+    }
+}
+
+void ServiceNodeContributionScanner::refresh(const std::set<std::string>& addresses, uint64_t height, ContributionScanResult& result) {
+    // NOTE: The state fields in the order they are requested per contract,
+    // followed by contributions and contributionTimestamp per contributor
+    static const char* const FIELDS[] = {
+        "operator()",
+        "serviceNodeParams()",
+        "finalized()",
+        "cancelled()",
+        "stakingRequirement()",
+        "operatorContribution()",
+        "totalContribution()",
+        "numberContributors()",
+    };
+
+    const std::string                                   block = quantity(height);
+    std::vector<std::pair<std::string, nlohmann::json>> requests;
+    auto call = [&](const ReadCallData& callData) {
+        nlohmann::json params = nlohmann::json::array();
+        params.push_back({{"to", "0x" + std::string(utils::trimPrefix(callData.contractAddress, "0x"))}, {"data", callData.data}});
+        params.push_back(block);
+        requests.emplace_back("eth_call", std::move(params));
+    };
+
+    for (const std::string& address : addresses) {
+        // NOTE: Only used to build call data, never reads through the backend
+        ServiceNodeContributionContract contract(address, std::shared_ptr<ProviderBackend>{});
+        for (const char* field : FIELDS)
+            call(contract.readCall(field));
+        for (const std::string& contributor : tracked.at(address).contributors) {
+            call(contract.contributionsCall(contributor));
+            call(contract.contributionTimestampCall(contributor));
+        }
+    }
+
+    std::vector<nlohmann::json> responses = batch(requests);
+    size_t                      next      = 0;
+    auto                        take      = [&]() -> std::string { return responses[next++].get<std::string>(); };
+    for (const std::string& address : addresses) {
+        ContributionContractState& state = states[address];
+        state.address                    = address;
+        state.blockNumber                = height;
+        state.operatorAddress            = ServiceNodeContributionContract::decodeAddress(take());
+        state.serviceNodePubkey          = ServiceNodeContributionContract::decodeFirstWord(take());
+        state.finalized                  = !ServiceNodeContributionContract::decodeUint256(take()).isZero();
+        state.cancelled                  = !ServiceNodeContributionContract::decodeUint256(take()).isZero();
+        state.stakingRequirement         = ServiceNodeContributionContract::decodeUint256(take());
+        state.operatorContribution       = ServiceNodeContributionContract::decodeUint256(take());
+        state.totalContribution          = ServiceNodeContributionContract::decodeUint256(take());
+        state.numberContributors         = ServiceNodeContributionContract::decodeUint256(take()).low64();
+
+        state.contributors.clear();
+        for (const std::string& contributor : tracked.at(address).contributors) {
+            ContributorBalance balance = {};
+            balance.address            = contributor;
+            balance.amount             = ServiceNodeContributionContract::decodeUint256(take());
+            balance.timestamp          = ServiceNodeContributionContract::decodeUint256(take()).low64();
+            // NOTE: Withdrawn and refunded contributors read back as zero
+            if (!balance.amount.isZero())
+                state.contributors.push_back(std::move(balance));
+        }
+        result.refreshed.push_back(address);
+    }
+}
+
+ContributionScanResult ServiceNodeContributionScanner::sync() {
+    const uint64_t head = utils::fromHexStringToUint64(utils::trimPrefix(rpc.call("eth_blockNumber", nlohmann::json::array()).get<std::string>(), "0x"));
+    return syncTo(head > confirmations ? head - confirmations : 0);
+}
+
+ContributionScanResult ServiceNodeContributionScanner::syncTo(uint64_t height) {
+    ContributionScanResult result = {};
+    result.height                 = height;
+    if (height < nextBlock)
+        return result;
+
+    // NOTE: Contracts changed by a scan that then failed stay in `stale` and
+    // are refreshed by the next one, which scans the same blocks again
+
+    // NOTE: Contracts given to `track` since the last scan have missed the
+    // blocks already scanned, catch their events up first
+    if (!pending.empty()) {
+        if (nextBlock > startBlock)
+            apply(fetchLogs(startBlock, nextBlock - 1, pending), stale, result);
+        stale.insert(pending.begin(), pending.end());
+        pending.clear();
+    }
+
+    // NOTE: Discover first so contracts deployed in these blocks are in the
+    // filter for their own events
+    apply(fetchLogs(nextBlock, height, {factoryAddress}), stale, result);
+
+    std::vector<std::string> addresses;
+    addresses.reserve(tracked.size());
+    for (const auto& [address, item] : tracked)
+        addresses.push_back(address);
+    if (!addresses.empty())
+        apply(fetchLogs(nextBlock, height, addresses), stale, result);
+
+    refresh(stale, height, result);
+    stale.clear();
+    nextBlock = height + 1;
+
+    std::stable_sort(result.events.begin(), result.events.end(), [](const ServiceNodeContributionEvent& lhs, const ServiceNodeContributionEvent& rhs) {
+        const EventLocation& l = contribution_events::location(lhs);
+        const EventLocation& r = contribution_events::location(rhs);
+        return l.blockNumber != r.blockNumber ? l.blockNumber < r.blockNumber : l.logIndex < r.logIndex;
+    });
+    return result;
+}
+
+ContributionScanResult ServiceNodeContributionScanner::refreshAll(uint64_t height) {
+    ContributionScanResult result = {};
+    result.height                 = height;
+    std::set<std::string> all;
+    for (const auto& [address, item] : tracked)
+        all.insert(address);
+    refresh(all, height, result);
+    return result;
+}
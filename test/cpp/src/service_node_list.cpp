@@ -1,9 +1,13 @@
 #include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/bls_context.hpp"
+#include "service_node_rewards/crypto_counters.hpp"
 #include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/tracing.hpp"
 #include "ethyl/utils.hpp"
 
 #include <random>
 #include <algorithm>
+#include <thread>
 
 const std::string proofOfPossessionTag = "BLS_SIG_TRYANDINCREMENT_POP";
 const std::string rewardTag = "BLS_SIG_TRYANDINCREMENT_REWARD";
@@ -12,11 +16,14 @@ const std::string liquidateTag = "BLS_SIG_TRYANDINCREMENT_LIQUIDATE";
 
 ServiceNode::ServiceNode(uint64_t _service_node_id) {
     service_node_id = _service_node_id;
+    BLSContext::get();
     // This init function generates a secret key calling blsSecretKeySetByCSPRNG
     secretKey.init();
+    publicKey = utils::DerivePublicKey(secretKey);
 }
 
 std::string buildTag(const std::string& baseTag, uint32_t chainID, const std::string& contractAddress) {
+    TRACE_SPAN("service_node_list", "buildTag");
     // Check if contractAddress starts with "0x" prefix
     std::string contractAddressOutput = contractAddress;
     if (contractAddressOutput.substr(0, 2) == "0x")
@@ -25,8 +32,18 @@ std::string buildTag(const std::string& baseTag, uint32_t chainID, const std::st
     return utils::toHexString(utils::hash(concatenatedTag));
 }
 
+static std::string buildRewardMessage(const std::string& fullTag, const std::string& address, uint64_t amount) {
+    std::string rewardAddressOutput = address;
+    if (rewardAddressOutput.substr(0, 2) == "0x")
+        rewardAddressOutput = rewardAddressOutput.substr(2);  // remove "0x"
+    return "0x" + fullTag + utils::padToNBytes(rewardAddressOutput, 20, utils::PaddingDirection::LEFT) + utils::padTo32Bytes(utils::decimalToHex(amount), utils::PaddingDirection::LEFT);
+}
+
 bls::Signature ServiceNode::signHash(const std::array<unsigned char, 32>& hash) const {
+    TRACE_SPAN("service_node_list", "signHash");
     bls::Signature sig;
+    CRYPTO_COUNT(HashToG2);
+    CRYPTO_COUNT(G2ScalarMul);
     secretKey.signHash(sig, hash.data(), hash.size());
     return sig;
 }
@@ -39,37 +56,68 @@ std::string ServiceNode::proofOfPossession(uint32_t chainID, const std::string&
     std::string message = "0x" + fullTag + getPublicKeyHex() + senderAddressOutput + utils::padTo32Bytes(utils::toHexString(serviceNodePubkey), utils::PaddingDirection::LEFT);
     const std::array<unsigned char, 32> hash = utils::hash(message);
     bls::Signature sig;
+    CRYPTO_COUNT(HashToG2);
+    CRYPTO_COUNT(G2ScalarMul);
     secretKey.signHash(sig, hash.data(), hash.size());
     return utils::SignatureToHex(sig);
 }
 
 std::string ServiceNode::getPublicKeyHex() const {
-    bls::PublicKey publicKey;
-    secretKey.getPublicKey(publicKey);
     return utils::BLSPublicKeyToHex(publicKey);
 }
 
 bls::PublicKey ServiceNode::getPublicKey() const {
-    bls::PublicKey publicKey;
-    secretKey.getPublicKey(publicKey);
     return publicKey;
 }
 
 ServiceNodeList::ServiceNodeList(size_t numNodes) {
-    bls::init(mclBn_CurveSNARK1);
-    mclBn_setMapToMode(MCL_MAP_TO_MODE_TRY_AND_INC);
-    mcl::bn::G1 gen;
-    bool b;
-    mcl::bn::mapToG1(&b, gen, 1);
-    blsPublicKey publicKey;
-    publicKey.v = *reinterpret_cast<const mclBnG1*>(&gen); // Cast gen to mclBnG1 and assign it to publicKey.v
-
-    blsSetGeneratorOfPublicKey(&publicKey);
-    nodes.reserve(numNodes);
+    BLSContext::get();
+
+    // NOTE: Generate the secret keys first so the public keys can be derived
+    // and normalized as one batch
+    std::vector<bls::SecretKey> secretKeys(numNodes);
+    for (bls::SecretKey& secretKey : secretKeys)
+        secretKey.init();
+    std::vector<bls::PublicKey> publicKeys = utils::DerivePublicKeys(secretKeys);
+
+    nodes.resize(numNodes);
     for(size_t i = 0; i < numNodes; ++i) {
-        nodes.emplace_back(next_service_node_id); // construct new ServiceNode in-place
-        next_service_node_id++;
+        nodes[i].service_node_id = next_service_node_id++;
+        nodes[i].secretKey       = secretKeys[i];
+        nodes[i].publicKey       = publicKeys[i];
+    }
+}
+
+ServiceNodeList::ServiceNodeList(const std::vector<std::string>& secretKeys) {
+    BLSContext::get();
+
+    std::vector<bls::SecretKey> keys(secretKeys.size());
+    for (size_t index = 0; index < secretKeys.size(); index++) {
+        try {
+            keys[index].setStr(secretKeys[index], 16);
+        } catch (const std::exception& e) {
+            throw std::invalid_argument("Failed to restore the secret key of service node " + std::to_string(index) + ": " + e.what());
+        }
+    }
+    std::vector<bls::PublicKey> publicKeys = utils::DerivePublicKeys(keys);
+
+    nodes.resize(secretKeys.size());
+    for (size_t i = 0; i < secretKeys.size(); ++i) {
+        nodes[i].service_node_id = next_service_node_id++;
+        nodes[i].secretKey       = keys[i];
+        nodes[i].publicKey       = publicKeys[i];
+    }
+}
+
+std::vector<std::string> ServiceNodeList::secretKeys() const {
+    std::vector<std::string> result;
+    result.reserve(nodes.size());
+    for (const ServiceNode& node : nodes) {
+        std::string hex;
+        node.secretKey.getStr(hex, 16);
+        result.push_back(std::move(hex));
     }
+    return result;
 }
 
 ServiceNodeList::~ServiceNodeList() {
@@ -100,6 +148,7 @@ std::string ServiceNodeList::aggregatePubkeyHex() {
     bls::PublicKey aggregate_pubkey; 
     aggregate_pubkey.clear();
     for(auto& node : nodes) {
+        CRYPTO_COUNT(G1Add);
         aggregate_pubkey.add(node.getPublicKey());
     }
     return utils::BLSPublicKeyToHex(aggregate_pubkey);
@@ -110,6 +159,7 @@ std::string ServiceNodeList::aggregateSignatures(const std::string& message) {
     bls::Signature aggSig;
     aggSig.clear();
     for(auto& node : nodes) {
+        CRYPTO_COUNT(G2Add);
         aggSig.add(node.signHash(hash));
     }
     return utils::SignatureToHex(aggSig);
@@ -120,6 +170,7 @@ std::string ServiceNodeList::aggregateSignaturesFromIndices(const std::string& m
     bls::Signature aggSig;
     aggSig.clear();
     for(auto& index : indices) {
+        CRYPTO_COUNT(G2Add);
         aggSig.add(nodes[static_cast<size_t>(index)].signHash(hash));
     }
     return utils::SignatureToHex(aggSig);
@@ -168,14 +219,25 @@ uint64_t ServiceNodeList::randomServiceNodeID() {
     return serviceNodeIDs[0];
 }
 
+std::array<unsigned char, 32> ServiceNodeList::rewardMessageHash(const std::string& address, const uint64_t amount, const uint32_t chainID, const std::string& contractAddress) {
+    return utils::hash(buildRewardMessage(buildTag(rewardTag, chainID, contractAddress), address, amount));
+}
+
+std::array<unsigned char, 32> ServiceNodeList::removalMessageHash(const std::string& pubkey, const uint32_t chainID, const std::string& contractAddress) {
+    return utils::hash("0x" + buildTag(removalTag, chainID, contractAddress) + pubkey);
+}
+
+std::array<unsigned char, 32> ServiceNodeList::liquidationMessageHash(const std::string& pubkey, const uint32_t chainID, const std::string& contractAddress) {
+    return utils::hash("0x" + buildTag(liquidateTag, chainID, contractAddress) + pubkey);
+}
+
 std::pair<std::string, std::string> ServiceNodeList::liquidateNodeFromIndices(uint64_t nodeID, uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids) {
     std::string pubkey = nodes[static_cast<size_t>(findNodeIndex(nodeID))].getPublicKeyHex();
-    std::string fullTag = buildTag(liquidateTag, chainID, contractAddress);
-    std::string message = "0x" + fullTag + pubkey;
-    const std::array<unsigned char, 32> hash = utils::hash(message);
+    const std::array<unsigned char, 32> hash = liquidationMessageHash(pubkey, chainID, contractAddress);
     bls::Signature aggSig;
     aggSig.clear();
     for(auto& service_node_id: service_node_ids) {
+        CRYPTO_COUNT(G2Add);
         aggSig.add(nodes[static_cast<size_t>(findNodeIndex(service_node_id))].signHash(hash));
     }
     return std::make_pair(pubkey, utils::SignatureToHex(aggSig));
@@ -183,32 +245,102 @@ std::pair<std::string, std::string> ServiceNodeList::liquidateNodeFromIndices(ui
 
 std::pair<std::string, std::string> ServiceNodeList::removeNodeFromIndices(uint64_t nodeID, uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids) {
     std::string pubkey = nodes[static_cast<size_t>(findNodeIndex(nodeID))].getPublicKeyHex();
-    std::string fullTag = buildTag(removalTag, chainID, contractAddress);
-    std::string message = "0x" + fullTag + pubkey;
-    const std::array<unsigned char, 32> hash = utils::hash(message);
+    const std::array<unsigned char, 32> hash = removalMessageHash(pubkey, chainID, contractAddress);
     bls::Signature aggSig;
     aggSig.clear();
     for(auto& service_node_id: service_node_ids) {
+        CRYPTO_COUNT(G2Add);
         aggSig.add(nodes[static_cast<size_t>(findNodeIndex(service_node_id))].signHash(hash));
     }
     return std::make_pair(pubkey, utils::SignatureToHex(aggSig));
 }
 
 std::string ServiceNodeList::updateRewardsBalance(const std::string& address, const uint64_t amount, const uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids) {
-    std::string rewardAddressOutput = address;
-    if (rewardAddressOutput.substr(0, 2) == "0x")
-        rewardAddressOutput = rewardAddressOutput.substr(2);  // remove "0x"
+    TRACE_SPAN("service_node_list", "updateRewardsBalance");
     std::string fullTag = buildTag(rewardTag, chainID, contractAddress);
-    std::string message = "0x" + fullTag + utils::padToNBytes(rewardAddressOutput, 20, utils::PaddingDirection::LEFT) + utils::padTo32Bytes(std::to_string(amount), utils::PaddingDirection::LEFT);
-    const std::array<unsigned char, 32> hash = utils::hash(message);
+    std::string message = buildRewardMessage(fullTag, address, amount);
+    std::array<unsigned char, 32> hash;
+    {
+        TRACE_SPAN("service_node_list", "hash");
+        hash = utils::hash(message);
+    }
     bls::Signature aggSig;
     aggSig.clear();
-    for(auto& service_node_id: service_node_ids) {
-        aggSig.add(nodes[static_cast<size_t>(findNodeIndex(service_node_id))].signHash(hash));
+    {
+        TRACE_SPAN("service_node_list", "sign and aggregate");
+        for(auto& service_node_id: service_node_ids) {
+            CRYPTO_COUNT(G2Add);
+            aggSig.add(nodes[static_cast<size_t>(findNodeIndex(service_node_id))].signHash(hash));
+        }
     }
     return utils::SignatureToHex(aggSig);
 }
 
+std::vector<std::string> ServiceNodeList::updateRewardsBalances(const std::vector<RewardUpdate>& updates, const uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids, size_t threads) {
+    TRACE_SPAN("service_node_list", "updateRewardsBalances");
+
+    // NOTE: sum(sk_i * H(m)) == (sum sk_i) * H(m), aggregate the keys once
+    // instead of aggregating a signature per signer per message.
+    const bls::SecretKey aggregateKey = aggregateSecretKey(service_node_ids);
+
+    const std::string fullTag = buildTag(rewardTag, chainID, contractAddress);
+    std::vector<std::string> result(updates.size());
+    auto signRange = [&](size_t begin, size_t end) {
+        for (size_t index = begin; index < end; index++) {
+            TRACE_SPAN("service_node_list", "sign reward message");
+            const std::array<unsigned char, 32> hash = utils::hash(buildRewardMessage(fullTag, updates[index].address, updates[index].amount));
+            bls::Signature sig;
+            CRYPTO_COUNT(HashToG2);
+            CRYPTO_COUNT(G2ScalarMul);
+            aggregateKey.signHash(sig, hash.data(), hash.size());
+            result[index] = utils::SignatureToHex(sig);
+        }
+    };
+
+    if (threads == 0)
+        threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    threads = std::min(threads, std::max<size_t>(updates.size(), 1));
+    if (threads == 1) {
+        signRange(0, updates.size());
+        return result;
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    const size_t chunk = (updates.size() + threads - 1) / threads;
+    for (size_t worker = 0; worker < threads; worker++) {
+        const size_t begin = std::min(worker * chunk, updates.size());
+        const size_t end   = std::min(begin + chunk, updates.size());
+        workers.emplace_back([&, worker, begin, end] {
+            try {
+                signRange(begin, end);
+            } catch (...) {
+                errors[worker] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+    for (auto& error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+    return result;
+}
+
+bls::SecretKey ServiceNodeList::aggregateSecretKey(const std::vector<uint64_t>& service_node_ids) {
+    TRACE_SPAN("service_node_list", "aggregate secret keys");
+    bls::SecretKey result;
+    result.clear();
+    for (auto& service_node_id : service_node_ids) {
+        int64_t index = findNodeIndex(service_node_id);
+        if (index < 0)
+            throw std::invalid_argument("Signer " + std::to_string(service_node_id) + " is not in the service node list");
+        result.add(nodes[static_cast<size_t>(index)].secretKey);
+    }
+    return result;
+}
+
 int64_t ServiceNodeList::findNodeIndex(uint64_t service_node_id) {
     for (size_t i = 0; i < nodes.size(); ++i) {
         if (nodes[i].service_node_id == service_node_id) {
@@ -1,9 +1,66 @@
 #include "service_node_rewards/service_node_rewards_contract.hpp"
+#include "service_node_rewards/crypto_counters.hpp"
+#include "service_node_rewards/tracing.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 
 ServiceNodeRewardsContract::ServiceNodeRewardsContract(const std::string& _contractAddress, std::shared_ptr<Provider> _provider)
-        : contractAddress(_contractAddress), provider(_provider) {}
+        : contractAddress(_contractAddress), backend(std::make_shared<LiveProviderBackend>(_provider)) {}
+
+ServiceNodeRewardsContract::ServiceNodeRewardsContract(const std::string& _contractAddress, std::shared_ptr<ProviderBackend> _backend)
+        : contractAddress(_contractAddress), backend(std::move(_backend)) {}
+
+void ServiceNodeRewardsContract::setCache(std::shared_ptr<ContractReadCache> _cache) {
+    std::lock_guard lock{cacheMutex};
+    cache = std::move(_cache);
+}
+
+void ServiceNodeRewardsContract::setMetrics(std::shared_ptr<ContractMetrics> _metrics) {
+    std::lock_guard lock{cacheMutex};
+    metrics = std::move(_metrics);
+}
+
+MethodCall ServiceNodeRewardsContract::instrument(std::string_view method) {
+    std::shared_ptr<ContractMetrics> registry;
+    {
+        std::lock_guard lock{cacheMutex};
+        registry = metrics;
+    }
+    return MethodCall(std::move(registry), method);
+}
+
+std::string ServiceNodeRewardsContract::callReadFunction(const ReadCallData& callData, MethodCall& call) {
+    std::shared_ptr<ContractReadCache> readCache;
+    {
+        std::lock_guard lock{cacheMutex};
+        readCache = cache;
+    }
+
+    // NOTE: Only the caller that makes the eth_call records network time,
+    // cache hits and coalesced reads just count as a call. A cache that was
+    // never advanced has no block to pin to (block 0 predates the contract),
+    // read "latest" past it until it has.
+    const uint64_t blockNumber = readCache ? readCache->blockNumber() : 0;
+    if (blockNumber == 0)
+        return reads.run("latest " + callData.data, [&] {
+            TRACE_SPAN("contract", "eth_call");
+            return call.network(callData.data, [&] { return backend->callReadFunction(callData); });
+        });
+
+    // NOTE: Pin the read to the cache's block so the result can be reused
+    // until an event invalidates it.
+    if (std::optional<std::string> result = readCache->get(callData.data, blockNumber))
+        return *result;
+
+    return reads.run(std::to_string(blockNumber) + " " + callData.data, [&] {
+        TRACE_SPAN("contract", "eth_call");
+        std::string result = call.network(callData.data, [&] { return backend->callReadFunction(callData, blockNumber); });
+        readCache->put(callData.data, blockNumber, result);
+        return result;
+    });
+}
 
 Transaction ServiceNodeRewardsContract::addBLSPublicKey(const std::string& publicKey, const std::string& sig, const std::string& serviceNodePubkey, const std::string& serviceNodeSignature, const uint64_t fee) {
     Transaction tx(contractAddress, 0, 3000000);
@@ -23,15 +80,141 @@ Transaction ServiceNodeRewardsContract::addBLSPublicKey(const std::string& publi
     return tx;
 }
 
+Transaction ServiceNodeRewardsContract::seedPublicKeyList(const std::vector<std::string>& pubkeys, const std::vector<uint64_t>& amounts) {
+    if (pubkeys.size() != amounts.size()) {
+        std::stringstream stream;
+        stream << "Failed to seed public key list: " << pubkeys.size() << " keys were given with " << amounts.size() << " amounts";
+        throw std::invalid_argument(stream.str());
+    }
+
+    Transaction tx(contractAddress, 0, SEED_PUBLIC_KEY_LIST_BASE_GAS + SEED_PUBLIC_KEY_LIST_GAS_PER_KEY * pubkeys.size());
+    std::string functionSelector = utils::getFunctionSignature("seedPublicKeyList(uint256[],uint256[],uint256[])");
+
+    // NOTE: 3 dynamic arrays, the head holds their offsets followed by each
+    // array's length and elements in turn.
+    const size_t U256_HEX_SIZE   = 32 * 2;
+    const size_t arrayHeaderSize = 32 * (1 + pubkeys.size());
+    std::string  offsets;
+    offsets += utils::padTo32Bytes(utils::decimalToHex(3 * 32), utils::PaddingDirection::LEFT);
+    offsets += utils::padTo32Bytes(utils::decimalToHex(3 * 32 + arrayHeaderSize), utils::PaddingDirection::LEFT);
+    offsets += utils::padTo32Bytes(utils::decimalToHex(3 * 32 + 2 * arrayHeaderSize), utils::PaddingDirection::LEFT);
+
+    const std::string length = utils::padTo32Bytes(utils::decimalToHex(pubkeys.size()), utils::PaddingDirection::LEFT);
+    std::string pkX = length;
+    std::string pkY = length;
+    std::string deposits = length;
+    pkX.reserve(arrayHeaderSize * 2);
+    pkY.reserve(arrayHeaderSize * 2);
+    deposits.reserve(arrayHeaderSize * 2);
+    for (size_t index = 0; index < pubkeys.size(); index++) {
+        std::string_view pubkey = utils::trimPrefix(pubkeys[index], "0x");
+        if (pubkey.size() != U256_HEX_SIZE * 2) {
+            std::stringstream stream;
+            stream << "Failed to seed public key list: key " << index << " '" << pubkey << "' is not " << U256_HEX_SIZE * 2 << " hex characters";
+            throw std::invalid_argument(stream.str());
+        }
+        pkX += pubkey.substr(0, U256_HEX_SIZE);
+        pkY += pubkey.substr(U256_HEX_SIZE, U256_HEX_SIZE);
+        deposits += utils::padTo32Bytes(utils::decimalToHex(amounts[index]), utils::PaddingDirection::LEFT);
+    }
+
+    tx.data = functionSelector + offsets + pkX + pkY + deposits;
+    return tx;
+}
+
+size_t ServiceNodeRewardsContract::seedServiceNodeList(TransactionQueue& queue, const std::vector<unsigned char>& seckey, const ServiceNodeList& snl, uint64_t deposit, uint64_t blockGasLimit) {
+    if (blockGasLimit < SEED_PUBLIC_KEY_LIST_BASE_GAS + SEED_PUBLIC_KEY_LIST_GAS_PER_KEY) {
+        std::stringstream stream;
+        stream << "Failed to seed public key list: block gas limit " << blockGasLimit << " can not fit a single key";
+        throw std::invalid_argument(stream.str());
+    }
+
+    // NOTE: The seeding moves the chain past any cached block, verify against
+    // "latest" and leave it to the cache's owner to advance it afterwards.
+    MethodCall call       = instrument("seedServiceNodeList");
+    auto       readLatest = [&](const ReadCallData& callData) { return call.network(callData.data, [&] { return backend->callReadFunction(callData); }); };
+
+    ReadCallData lengthCall    = {};
+    lengthCall.contractAddress = contractAddress;
+    lengthCall.data            = utils::getFunctionSignature("serviceNodesLength()");
+    ReadCallData aggregateCall    = {};
+    aggregateCall.contractAddress = contractAddress;
+    aggregateCall.data            = utils::getFunctionSignature("aggregatePubkey()");
+
+    // NOTE: The contract's aggregate is the sum of its current keys and the
+    // seeded ones. An empty list stores the zero point which does not
+    // deserialise, start from the identity instead.
+    const uint64_t initialLength = utils::fromHexStringToUint64(readLatest(lengthCall));
+    bls::PublicKey expectedAggregate;
+    expectedAggregate.clear();
+    if (initialLength > 0)
+        expectedAggregate = utils::HexToBLSPublicKey(readLatest(aggregateCall));
+
+    const size_t keysPerCall = (blockGasLimit - SEED_PUBLIC_KEY_LIST_BASE_GAS) / SEED_PUBLIC_KEY_LIST_GAS_PER_KEY;
+    std::vector<TransactionFuture> results;
+    std::vector<std::string>       pubkeys;
+    pubkeys.reserve(keysPerCall);
+    for (size_t index = 0; index < snl.nodes.size(); index += keysPerCall) {
+        pubkeys.clear();
+        const size_t end = std::min(index + keysPerCall, snl.nodes.size());
+        for (size_t nodeIndex = index; nodeIndex < end; nodeIndex++) {
+            pubkeys.push_back(snl.nodes[nodeIndex].getPublicKeyHex());
+            CRYPTO_COUNT(G1Add);
+            expectedAggregate.add(snl.nodes[nodeIndex].getPublicKey());
+        }
+        const std::vector<uint64_t> amounts(pubkeys.size(), deposit);
+        results.push_back(queue.submit(seedPublicKeyList(pubkeys, amounts), seckey));
+    }
+
+    if (!queue.waitAll())
+        throw std::runtime_error("Failed to seed public key list: timed out waiting for the seeding transactions to be mined");
+    for (const TransactionFuture& result : results) {
+        if (!result.get().success) {
+            std::stringstream stream;
+            stream << "Failed to seed public key list: transaction " << result.get().hash << " reverted";
+            throw std::runtime_error(stream.str());
+        }
+    }
+
+    const uint64_t length = utils::fromHexStringToUint64(readLatest(lengthCall));
+    if (length != initialLength + snl.nodes.size()) {
+        std::stringstream stream;
+        stream << "Failed to seed public key list: contract has " << length << " nodes after seeding, expected " << initialLength + snl.nodes.size();
+        throw std::runtime_error(stream.str());
+    }
+    const std::string aggregate = readLatest(aggregateCall);
+    if (utils::trimPrefix(aggregate, "0x") != utils::trimPrefix(utils::BLSPublicKeyToHex(expectedAggregate), "0x")) {
+        std::stringstream stream;
+        stream << "Failed to seed public key list: contract aggregate key " << aggregate << " does not match the seeded keys";
+        throw std::runtime_error(stream.str());
+    }
+    return results.size();
+}
+
 ContractServiceNode ServiceNodeRewardsContract::serviceNodes(uint64_t index)
 {
-    ReadCallData callData            = {};
-    std::string  indexABI            = utils::padTo32Bytes(utils::decimalToHex(index), utils::PaddingDirection::LEFT);
-    callData.contractAddress         = contractAddress;
-    callData.data                    = utils::getFunctionSignature("serviceNodes(uint64)") + indexABI;
-    nlohmann::json     callResult    = provider->callReadFunctionJSON(callData);
-    const std::string& callResultHex = callResult.get_ref<nlohmann::json::string_t&>();
-    std::string_view   callResultIt  = utils::trimPrefix(callResultHex, "0x");
+    MethodCall call = instrument("serviceNodes");
+    return readServiceNode(index, call);
+}
+
+ReadCallData ServiceNodeRewardsContract::serviceNodesCall(uint64_t index) const
+{
+    ReadCallData callData    = {};
+    std::string  indexABI    = utils::padTo32Bytes(utils::decimalToHex(index), utils::PaddingDirection::LEFT);
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature("serviceNodes(uint64)") + indexABI;
+    return callData;
+}
+
+ContractServiceNode ServiceNodeRewardsContract::readServiceNode(uint64_t index, MethodCall& call)
+{
+    const std::string callResultHex = callReadFunction(serviceNodesCall(index), call);
+    return call.decode([&] { return decodeServiceNode(callResultHex); });
+}
+
+ContractServiceNode ServiceNodeRewardsContract::decodeServiceNode(std::string_view callResultHex)
+{
+    std::string_view    callResultIt  = utils::trimPrefix(callResultHex, "0x");
 
     const size_t        U256_HEX_SIZE                  = (256 / 8) * 2;
     const size_t        BLS_PKEY_XY_COMPONENT_HEX_SIZE = 32 * 2;
@@ -67,7 +250,7 @@ ContractServiceNode ServiceNodeRewardsContract::serviceNodes(uint64_t index)
     return result;
 }
 
-uint64_t ServiceNodeRewardsContract::serviceNodeIDs(const bls::PublicKey& pKey)
+ReadCallData ServiceNodeRewardsContract::serviceNodeIDsCall(const bls::PublicKey& pKey) const
 {
     // NOTE: Generate the ABI caller data
     std::string pKeyABI             = utils::BLSPublicKeyToHex(pKey);
@@ -85,43 +268,71 @@ uint64_t ServiceNodeRewardsContract::serviceNodeIDs(const bls::PublicKey& pKey)
     callData.data += offsetToPKeyDataABI;
     callData.data += bytesSizeABI;
     callData.data += pKeyABI;
+    return callData;
+}
+
+uint64_t ServiceNodeRewardsContract::serviceNodeIDs(const bls::PublicKey& pKey)
+{
+    MethodCall call = instrument("serviceNodeIDs");
 
     // NOTE: Call function
-    nlohmann::json     callResult = provider->callReadFunctionJSON(callData);
-    const std::string& resultHex  = callResult.get_ref<nlohmann::json::string_t&>();
-    uint64_t           result     = utils::fromHexStringToUint64(resultHex);
+    const std::string resultHex = callReadFunction(serviceNodeIDsCall(pKey), call);
+    uint64_t          result    = call.decode([&] { return utils::fromHexStringToUint64(resultHex); });
     return result;
 }
 
 uint64_t ServiceNodeRewardsContract::serviceNodesLength() {
+    MethodCall call = instrument("serviceNodesLength");
     ReadCallData callData;
     callData.contractAddress = contractAddress;
     callData.data = utils::getFunctionSignature("serviceNodesLength()");
-    std::string result = provider->callReadFunction(callData);
-    return utils::fromHexStringToUint64(result);
+    std::string result = callReadFunction(callData, call);
+    return call.decode([&] { return utils::fromHexStringToUint64(result); });
 }
 
 std::string ServiceNodeRewardsContract::designatedToken() {
+    MethodCall call = instrument("designatedToken");
     ReadCallData callData;
     callData.contractAddress = contractAddress;
     callData.data = utils::getFunctionSignature("designatedToken()");
-    return provider->callReadFunction(callData);
+    return callReadFunction(callData, call);
+}
+
+std::string ServiceNodeRewardsContract::foundationPool() {
+    MethodCall call = instrument("foundationPool");
+    ReadCallData callData;
+    callData.contractAddress = contractAddress;
+    callData.data = utils::getFunctionSignature("foundationPool()");
+    return callReadFunction(callData, call);
+}
+
+uint64_t ServiceNodeRewardsContract::stakingRequirement() {
+    MethodCall call = instrument("stakingRequirement");
+    ReadCallData callData;
+    callData.contractAddress = contractAddress;
+    callData.data = utils::getFunctionSignature("stakingRequirement()");
+    std::string result = callReadFunction(callData, call);
+    return call.decode([&] { return utils::fromHexStringToUint64(result); });
 }
 
 std::string ServiceNodeRewardsContract::aggregatePubkeyString() {
+    MethodCall   call        = instrument("aggregatePubkeyString");
     ReadCallData callData    = {};
     callData.contractAddress = contractAddress;
     callData.data            = utils::getFunctionSignature("aggregatePubkey()");
-    return provider->callReadFunction(callData);
+    return callReadFunction(callData, call);
 }
 
 bls::PublicKey ServiceNodeRewardsContract::aggregatePubkey() {
-    std::string    hex    = ServiceNodeRewardsContract::aggregatePubkeyString();
-    bls::PublicKey result = utils::HexToBLSPublicKey(hex);
-    return result;
+    MethodCall   call        = instrument("aggregatePubkey");
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature("aggregatePubkey()");
+    std::string hex          = callReadFunction(callData, call);
+    return call.decode([&] { return utils::HexToBLSPublicKey(hex); });
 }
 
-Recipient ServiceNodeRewardsContract::viewRecipientData(const std::string& address) {
+ReadCallData ServiceNodeRewardsContract::recipientsCall(const std::string& address) const {
     ReadCallData callData;
     callData.contractAddress = contractAddress;
 
@@ -130,21 +341,176 @@ Recipient ServiceNodeRewardsContract::viewRecipientData(const std::string& addre
         rewardAddressOutput = rewardAddressOutput.substr(2);  // remove "0x"
     rewardAddressOutput = utils::padTo32Bytes(rewardAddressOutput, utils::PaddingDirection::LEFT);
     callData.data = utils::getFunctionSignature("recipients(address)") + rewardAddressOutput;
+    return callData;
+}
 
-    std::string result = provider->callReadFunction(callData);
+Recipient ServiceNodeRewardsContract::viewRecipientData(const std::string& address) {
+    MethodCall call = instrument("viewRecipientData");
+    std::string result = callReadFunction(recipientsCall(address), call);
+    return call.decode([&] { return decodeRecipient(result); });
+}
+
+RecipientBalance ServiceNodeRewardsContract::viewRecipientBalance(const std::string& address) {
+    MethodCall call = instrument("viewRecipientBalance");
+    std::string result = callReadFunction(recipientsCall(address), call);
+    return call.decode([&] { return decodeRecipientBalance(result); });
+}
+
+RecipientBalance ServiceNodeRewardsContract::decodeRecipientBalance(std::string_view result) {
+    const size_t     U256_HEX_SIZE = 32 * 2;
+    std::string_view hex           = utils::trimPrefix(result, "0x");
+    if (hex.size() < U256_HEX_SIZE * 2) {
+        std::stringstream stream;
+        stream << "Failed to decode recipient '" << result << "': expected 2 words, got " << hex.size() << " hex characters";
+        throw std::runtime_error(stream.str());
+    }
+
+    RecipientBalance balance = {};
+    balance.rewards          = Uint256::fromHex(hex.substr(0, U256_HEX_SIZE));
+    balance.claimed          = Uint256::fromHex(hex.substr(U256_HEX_SIZE, U256_HEX_SIZE));
+    return balance;
+}
+
+Recipient ServiceNodeRewardsContract::decodeRecipient(const std::string& result) {
+    const RecipientBalance balance = decodeRecipientBalance(result);
+    if (!balance.rewards.fitsUint64() || !balance.claimed.fitsUint64()) {
+        std::stringstream stream;
+        stream << "Recipient rewards " << balance.rewards.toString() << " (claimed " << balance.claimed.toString() << ") do not fit in a uint64_t, read them with viewRecipientBalance";
+        throw std::overflow_error(stream.str());
+    }
+    return Recipient(balance.rewards.low64(), balance.claimed.low64());
+}
+
+uint64_t ServiceNodeRewardsContract::readUint64(std::string_view method, const std::string& signature) {
+    MethodCall   call        = instrument(method);
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature(signature);
+    std::string result       = callReadFunction(callData, call);
+    return call.decode([&] { return utils::fromHexStringToUint64(result); });
+}
+
+bool ServiceNodeRewardsContract::isActive() {
+    // NOTE: start() flips this without emitting an event, so the cache could
+    // never tell it changed. Always read it at "latest", bypassing the cache.
+    MethodCall   call        = instrument("isActive");
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature("IsActive()");
+    std::string result       = reads.run("latest " + callData.data, [&] {
+        TRACE_SPAN("contract", "eth_call");
+        return call.network(callData.data, [&] { return backend->callReadFunction(callData); });
+    });
+    return call.decode([&] { return utils::fromHexStringToUint64(result); }) != 0;
+}
+
+uint64_t ServiceNodeRewardsContract::nextServiceNodeID() {
+    return readUint64("nextServiceNodeID", "nextServiceNodeID()");
+}
+
+uint64_t ServiceNodeRewardsContract::totalNodes() {
+    return readUint64("totalNodes", "totalNodes()");
+}
+
+uint64_t ServiceNodeRewardsContract::blsNonSignerThreshold() {
+    return readUint64("blsNonSignerThreshold", "blsNonSignerThreshold()");
+}
+
+uint64_t ServiceNodeRewardsContract::blsNonSignerThresholdMax() {
+    return readUint64("blsNonSignerThresholdMax", "blsNonSignerThresholdMax()");
+}
+
+uint64_t ServiceNodeRewardsContract::liquidatorRewardRatio() {
+    return readUint64("liquidatorRewardRatio", "liquidatorRewardRatio()");
+}
 
-    // This assumes both the returned integers fit into a uint64_t but they are actually uint256 and dont have a good way of storing the 
-    // full amount. In tests this will just mean that we need to keep our numbers below the 64bit max.
-    std::string rewardsHex = result.substr(2 + 64-8, 8);
-    std::string claimedHex = result.substr(2 + 64 + 64-8, 8);
+uint64_t ServiceNodeRewardsContract::poolShareOfLiquidationRatio() {
+    return readUint64("poolShareOfLiquidationRatio", "poolShareOfLiquidationRatio()");
+}
+
+uint64_t ServiceNodeRewardsContract::recipientRatio() {
+    return readUint64("recipientRatio", "recipientRatio()");
+}
+
+#if defined(SERVICE_NODE_REWARDS_COROUTINES)
+void ServiceNodeRewardsContract::setAsyncClient(std::shared_ptr<AsyncJsonRpcClient> client) {
+    std::lock_guard lock{cacheMutex};
+    asyncClient = std::move(client);
+}
+
+Task<std::string> ServiceNodeRewardsContract::callReadFunctionAsync(ReadCallData callData, MethodCall& call) {
+    std::shared_ptr<ContractReadCache>  readCache;
+    std::shared_ptr<AsyncJsonRpcClient> client;
+    {
+        std::lock_guard lock{cacheMutex};
+        readCache = cache;
+        client    = asyncClient;
+    }
+    if (!client)
+        throw std::runtime_error("Contract " + contractAddress + " has no async client to read with, see setAsyncClient");
+
+    // NOTE: Pinned to the cache's block once it has one, as in callReadFunction
+    const uint64_t blockNumber = readCache ? readCache->blockNumber() : 0;
+    if (blockNumber == 0) {
+        const auto  start  = call.networkStart();
+        std::string result = co_await client->callReadFunction(callData);
+        call.networkDone(start, callData.data, result);
+        co_return result;
+    }
 
-    uint64_t rewards = std::stoull(rewardsHex, nullptr, 16);
-    uint64_t claimed = std::stoull(claimedHex, nullptr, 16);
+    if (std::optional<std::string> result = readCache->get(callData.data, blockNumber))
+        co_return std::move(*result);
 
-    return Recipient(rewards, claimed);
+    const auto  start  = call.networkStart();
+    std::string result = co_await client->callReadFunction(callData, blockNumber);
+    call.networkDone(start, callData.data, result);
+    readCache->put(callData.data, blockNumber, result);
+    co_return result;
 }
 
+Task<uint64_t> ServiceNodeRewardsContract::readUint64Async(std::string_view method, std::string signature) {
+    MethodCall   call        = instrument(method);
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature(signature);
+    std::string result       = co_await callReadFunctionAsync(std::move(callData), call);
+    co_return call.decode([&] { return utils::fromHexStringToUint64(result); });
+}
+
+Task<ContractServiceNode> ServiceNodeRewardsContract::serviceNodesAsync(uint64_t index) {
+    MethodCall  call   = instrument("serviceNodes");
+    std::string result = co_await callReadFunctionAsync(serviceNodesCall(index), call);
+    co_return call.decode([&] { return decodeServiceNode(result); });
+}
+
+Task<uint64_t> ServiceNodeRewardsContract::serviceNodeIDsAsync(bls::PublicKey pKey) {
+    MethodCall  call   = instrument("serviceNodeIDs");
+    std::string result = co_await callReadFunctionAsync(serviceNodeIDsCall(pKey), call);
+    co_return call.decode([&] { return utils::fromHexStringToUint64(result); });
+}
+
+Task<uint64_t> ServiceNodeRewardsContract::serviceNodesLengthAsync() {
+    return readUint64Async("serviceNodesLength", "serviceNodesLength()");
+}
+
+Task<bls::PublicKey> ServiceNodeRewardsContract::aggregatePubkeyAsync() {
+    MethodCall   call        = instrument("aggregatePubkey");
+    ReadCallData callData    = {};
+    callData.contractAddress = contractAddress;
+    callData.data            = utils::getFunctionSignature("aggregatePubkey()");
+    std::string result       = co_await callReadFunctionAsync(std::move(callData), call);
+    co_return call.decode([&] { return utils::HexToBLSPublicKey(result); });
+}
+
+Task<Recipient> ServiceNodeRewardsContract::viewRecipientDataAsync(std::string address) {
+    MethodCall  call   = instrument("viewRecipientData");
+    std::string result = co_await callReadFunctionAsync(recipientsCall(address), call);
+    co_return call.decode([&] { return decodeRecipient(result); });
+}
+#endif
+
 Transaction ServiceNodeRewardsContract::liquidateBLSPublicKeyWithSignature(const uint64_t service_node_id, const std::string& pubkey, const std::string& sig, const std::vector<uint64_t>& non_signer_indices) {
+    TRACE_SPAN("contract", "encode liquidateBLSPublicKeyWithSignature");
     Transaction tx(contractAddress, 0, 30000000);
     std::string functionSelector = utils::getFunctionSignature("liquidateBLSPublicKeyWithSignature(uint64,(uint256,uint256),(uint256,uint256,uint256,uint256),uint64[])");
     std::string node_id_padded = utils::padTo32Bytes(utils::decimalToHex(service_node_id), utils::PaddingDirection::LEFT);
@@ -191,6 +557,7 @@ Transaction ServiceNodeRewardsContract::removeBLSPublicKeyAfterWaitTime(const ui
 }
 
 Transaction ServiceNodeRewardsContract::updateRewardsBalance(const std::string& address, const uint64_t amount, const std::string& sig, const std::vector<uint64_t>& non_signer_indices) {
+    TRACE_SPAN("contract", "encode updateRewardsBalance");
     Transaction tx(contractAddress, 0, 30000000);
     std::string functionSelector = utils::getFunctionSignature("updateRewardsBalance(address,uint256,(uint256,uint256,uint256,uint256),uint64[])");
     std::string rewardAddressOutput = address;
@@ -209,6 +576,18 @@ Transaction ServiceNodeRewardsContract::updateRewardsBalance(const std::string&
     return tx;
 }
 
+std::vector<Transaction> ServiceNodeRewardsContract::updateRewardsBalances(ServiceNodeList& snl, const std::vector<RewardUpdate>& updates, const uint32_t chainID, const std::vector<uint64_t>& signers, size_t threads) {
+    TRACE_SPAN("contract", "updateRewardsBalances");
+    const std::vector<std::string> sigs        = snl.updateRewardsBalances(updates, chainID, contractAddress, signers, threads);
+    const std::vector<uint64_t>    non_signers = snl.findNonSigners(signers);
+
+    std::vector<Transaction> result;
+    result.reserve(updates.size());
+    for (size_t index = 0; index < updates.size(); index++)
+        result.push_back(updateRewardsBalance(updates[index].address, updates[index].amount, sigs[index], non_signers));
+    return result;
+}
+
 Transaction ServiceNodeRewardsContract::claimRewards() {
     Transaction tx(contractAddress, 0, 3000000);
     std::string functionSelector = utils::getFunctionSignature("claimRewards()");
@@ -0,0 +1,208 @@
+#include "service_node_rewards/service_node_rewards_events.hpp"
+
+#include <cstring>
+
+#include "service_node_rewards/uint256.hpp"
+
+static std::string eventTopic(std::string_view signature) {
+    return "0x" + utils::toHexString(utils::hash(signature));
+}
+
+const std::string& events::newServiceNodeTopic() {
+    static const std::string topic = eventTopic("NewServiceNode(uint64,address,(uint256,uint256),(uint256,uint256,uint256,uint16),(address,uint256)[])");
+    return topic;
+}
+
+const std::string& events::newSeededServiceNodeTopic() {
+    static const std::string topic = eventTopic("NewSeededServiceNode(uint64,(uint256,uint256))");
+    return topic;
+}
+
+const std::string& events::serviceNodeRemovalRequestTopic() {
+    static const std::string topic = eventTopic("ServiceNodeRemovalRequest(uint64,address,(uint256,uint256))");
+    return topic;
+}
+
+const std::string& events::serviceNodeRemovalTopic() {
+    static const std::string topic = eventTopic("ServiceNodeRemoval(uint64,address,uint256,(uint256,uint256))");
+    return topic;
+}
+
+const std::string& events::serviceNodeLiquidatedTopic() {
+    static const std::string topic = eventTopic("ServiceNodeLiquidated(uint64,address,(uint256,uint256))");
+    return topic;
+}
+
+const std::string& events::rewardsBalanceUpdatedTopic() {
+    static const std::string topic = eventTopic("RewardsBalanceUpdated(address,uint256,uint256)");
+    return topic;
+}
+
+const std::string& events::rewardsClaimedTopic() {
+    static const std::string topic = eventTopic("RewardsClaimed(address,uint256)");
+    return topic;
+}
+
+const std::string& events::stakingRequirementUpdatedTopic() {
+    static const std::string topic = eventTopic("StakingRequirementUpdated(uint256)");
+    return topic;
+}
+
+const std::string& events::blsNonSignerThresholdMaxUpdatedTopic() {
+    static const std::string topic = eventTopic("BLSNonSignerThresholdMaxUpdated(uint256)");
+    return topic;
+}
+
+namespace {
+    const size_t WORD_HEX_SIZE        = 32 * 2;
+    const size_t ETH_ADDRESS_HEX_SIZE = 20 * 2;
+
+    // Walks the ABI encoded, non-indexed data section of a log one 32 byte word at a time
+    struct LogData {
+        std::string_view hex;
+        std::string_view topic;
+
+        std::string_view word(size_t index, size_t count = 1) const {
+            if ((index + count) * WORD_HEX_SIZE > hex.size()) {
+                std::stringstream stream;
+                stream << "Failed to decode log for topic '" << topic << "': data has " << hex.size() / WORD_HEX_SIZE
+                       << " words, tried to read word " << index + count - 1;
+                throw std::runtime_error(stream.str());
+            }
+            return hex.substr(index * WORD_HEX_SIZE, count * WORD_HEX_SIZE);
+        }
+    };
+
+    std::array<unsigned char, 20> addressFromWord(std::string_view word) {
+        word = utils::trimPrefix(word, "0x");
+        std::array<unsigned char, 20> result = {};
+        std::vector<unsigned char> bytes = utils::fromHexString(word.substr(word.size() - ETH_ADDRESS_HEX_SIZE, ETH_ADDRESS_HEX_SIZE));
+        assert(bytes.size() == result.max_size());
+        std::memcpy(result.data(), bytes.data(), bytes.size());
+        return result;
+    }
+
+    // NOTE: uint256 amounts are truncated to their lower 64 bits, see `Recipient`
+    uint64_t uint64FromWord(std::string_view word) {
+        word = utils::trimPrefix(word, "0x");
+        return utils::fromHexStringToUint64(word.substr(word.size() - 16, 16));
+    }
+
+    const std::string& indexedTopic(const LogEntry& log, size_t index) {
+        if (log.topics.size() <= index) {
+            std::stringstream stream;
+            stream << "Failed to decode log for topic '" << log.topics[0] << "': expected at least " << index + 1
+                   << " topics, log had " << log.topics.size();
+            throw std::runtime_error(stream.str());
+        }
+        return log.topics[index];
+    }
+}
+
+std::optional<ServiceNodeRewardsEvent> events::decode(const LogEntry& log) {
+    if (log.topics.empty())
+        return std::nullopt;
+
+    EventLocation location   = {};
+    location.blockNumber     = log.blockNumber.value_or(0);
+    location.logIndex        = log.logIndex.value_or(0);
+    location.blockHash       = log.blockHash.value_or("");
+    location.transactionHash = log.transactionHash.value_or("");
+
+    const std::string& topic = log.topics[0];
+    LogData            data  = {utils::trimPrefix(log.data, "0x"), topic};
+
+    if (topic == newServiceNodeTopic()) {
+        // NOTE: (recipient, pubkey.X, pubkey.Y, 4x ServiceNodeParams, offset to contributors)
+        NewServiceNodeEvent result = {};
+        result.location            = std::move(location);
+        result.serviceNodeID       = utils::fromHexStringToUint64(indexedTopic(log, 1));
+        result.recipient           = addressFromWord(data.word(0));
+        result.pubkey              = utils::HexToBLSPublicKey(data.word(1, 2));
+
+        // NOTE: The contract emits the operator as the sole contributor
+        // staking the full requirement if none were given, so the deposit is
+        // always the sum over the contributors. Summed as uint256 like the
+        // contract so no stake is truncated.
+        const size_t contributorsWord = utils::fromHexStringToUint64(data.word(7)) / 32;
+        const size_t contributorsSize = utils::fromHexStringToUint64(data.word(contributorsWord));
+        Uint256      deposit          = 0;
+        for (size_t index = 0; index < contributorsSize; index++)
+            deposit += Uint256::fromHex(data.word(contributorsWord + 1 + (index * 2) + 1));
+        result.deposit = deposit.toHex();
+        return result;
+    }
+
+    if (topic == newSeededServiceNodeTopic()) {
+        NewSeededServiceNodeEvent result = {};
+        result.location                  = std::move(location);
+        result.serviceNodeID             = utils::fromHexStringToUint64(indexedTopic(log, 1));
+        result.pubkey                    = utils::HexToBLSPublicKey(data.word(0, 2));
+        return result;
+    }
+
+    if (topic == serviceNodeRemovalRequestTopic()) {
+        ServiceNodeRemovalRequestEvent result = {};
+        result.location                       = std::move(location);
+        result.serviceNodeID                  = utils::fromHexStringToUint64(indexedTopic(log, 1));
+        result.recipient                      = addressFromWord(data.word(0));
+        result.pubkey                         = utils::HexToBLSPublicKey(data.word(1, 2));
+        return result;
+    }
+
+    if (topic == serviceNodeRemovalTopic()) {
+        ServiceNodeRemovalEvent result = {};
+        result.location                = std::move(location);
+        result.serviceNodeID           = utils::fromHexStringToUint64(indexedTopic(log, 1));
+        result.recipient               = addressFromWord(data.word(0));
+        result.returnedAmount          = uint64FromWord(data.word(1));
+        result.pubkey                  = utils::HexToBLSPublicKey(data.word(2, 2));
+        return result;
+    }
+
+    if (topic == serviceNodeLiquidatedTopic()) {
+        ServiceNodeLiquidatedEvent result = {};
+        result.location                   = std::move(location);
+        result.serviceNodeID              = utils::fromHexStringToUint64(indexedTopic(log, 1));
+        result.recipient                  = addressFromWord(data.word(0));
+        result.pubkey                     = utils::HexToBLSPublicKey(data.word(1, 2));
+        return result;
+    }
+
+    if (topic == rewardsBalanceUpdatedTopic()) {
+        RewardsBalanceUpdatedEvent result = {};
+        result.location                   = std::move(location);
+        result.recipient                  = addressFromWord(indexedTopic(log, 1));
+        result.amount                     = uint64FromWord(data.word(0));
+        result.previousBalance            = uint64FromWord(data.word(1));
+        return result;
+    }
+
+    if (topic == rewardsClaimedTopic()) {
+        RewardsClaimedEvent result = {};
+        result.location            = std::move(location);
+        result.recipient           = addressFromWord(indexedTopic(log, 1));
+        result.amount              = uint64FromWord(data.word(0));
+        return result;
+    }
+
+    if (topic == stakingRequirementUpdatedTopic()) {
+        StakingRequirementUpdatedEvent result = {};
+        result.location                       = std::move(location);
+        result.newRequirement                 = std::string(data.word(0));
+        return result;
+    }
+
+    if (topic == blsNonSignerThresholdMaxUpdatedTopic()) {
+        BLSNonSignerThresholdMaxUpdatedEvent result = {};
+        result.location                             = std::move(location);
+        result.newMax                               = uint64FromWord(data.word(0));
+        return result;
+    }
+
+    return std::nullopt;
+}
+
+const EventLocation& events::location(const ServiceNodeRewardsEvent& event) {
+    return std::visit([](const auto& item) -> const EventLocation& { return item.location; }, event);
+}
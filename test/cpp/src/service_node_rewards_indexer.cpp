@@ -0,0 +1,189 @@
+#include "service_node_rewards/service_node_rewards_indexer.hpp"
+#include "service_node_rewards/crypto_counters.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+ServiceNodeRewardsMirror::ServiceNodeRewardsMirror() {
+    ContractServiceNode sentinel = {};
+    sentinel.next                = SERVICE_NODE_LIST_SENTINEL;
+    sentinel.prev                = SERVICE_NODE_LIST_SENTINEL;
+    sentinel.recipient           = {};
+    sentinel.pubkey.clear();
+    nodes[SERVICE_NODE_LIST_SENTINEL] = sentinel;
+}
+
+static void appendServiceNode(ServiceNodeRewardsMirror& mirror, uint64_t serviceNodeID, ContractServiceNode node) {
+    if (mirror.nodes.count(serviceNodeID)) {
+        std::stringstream stream;
+        stream << "Service node " << serviceNodeID << " was added to the mirror twice";
+        throw std::runtime_error(stream.str());
+    }
+
+    // NOTE: Mirror the insertion in `serviceNodeAdd`, the new node goes at the
+    // tail of the list, before the sentinel.
+    ContractServiceNode& sentinel = mirror.nodes[SERVICE_NODE_LIST_SENTINEL];
+    node.next                     = SERVICE_NODE_LIST_SENTINEL;
+    node.prev                     = sentinel.prev;
+    mirror.nodes[node.prev].next  = serviceNodeID;
+    sentinel.prev                 = serviceNodeID;
+    mirror.nodes[serviceNodeID]   = std::move(node);
+}
+
+void ServiceNodeRewardsMirror::apply(const ServiceNodeRewardsEvent& event) {
+    std::visit([this](const auto& item) {
+        using T = std::decay_t<decltype(item)>;
+        if constexpr (std::is_same_v<T, NewServiceNodeEvent>) {
+            ContractServiceNode node = {};
+            node.recipient           = item.recipient;
+            node.pubkey              = item.pubkey;
+            node.deposit             = item.deposit;
+            appendServiceNode(*this, item.serviceNodeID, std::move(node));
+        } else if constexpr (std::is_same_v<T, NewSeededServiceNodeEvent>) {
+            // NOTE: Seeded nodes have no recipient and the event does not
+            // carry the seeded amount, the deposit is left empty.
+            ContractServiceNode node = {};
+            node.recipient           = {};
+            node.pubkey              = item.pubkey;
+            appendServiceNode(*this, item.serviceNodeID, std::move(node));
+        } else if constexpr (std::is_same_v<T, ServiceNodeRemovalRequestEvent>) {
+            leaveRequestBlocks[item.serviceNodeID] = item.location.blockNumber;
+        } else if constexpr (std::is_same_v<T, ServiceNodeRemovalEvent>) {
+            // NOTE: Liquidations also emit a removal event, the list is only
+            // updated here.
+            auto it = nodes.find(item.serviceNodeID);
+            if (item.serviceNodeID == SERVICE_NODE_LIST_SENTINEL || it == nodes.end()) {
+                std::stringstream stream;
+                stream << "Service node " << item.serviceNodeID << " was removed but does not exist in the mirror";
+                throw std::runtime_error(stream.str());
+            }
+            const ContractServiceNode& node = it->second;
+            nodes[node.next].prev           = node.prev;
+            nodes[node.prev].next           = node.next;
+            nodes.erase(it);
+            leaveRequestBlocks.erase(item.serviceNodeID);
+        } else if constexpr (std::is_same_v<T, RewardsBalanceUpdatedEvent>) {
+            auto [it, inserted] = recipients.try_emplace(utils::toHexString(item.recipient), 0, 0);
+            it->second.rewards  = item.amount;
+        } else if constexpr (std::is_same_v<T, RewardsClaimedEvent>) {
+            auto [it, inserted] = recipients.try_emplace(utils::toHexString(item.recipient), 0, 0);
+            it->second.claimed += item.amount;
+        }
+        height = std::max(height, item.location.blockNumber);
+    }, event);
+}
+
+size_t ServiceNodeRewardsMirror::size() const {
+    return nodes.size() - 1 /*sentinel*/;
+}
+
+std::vector<uint64_t> ServiceNodeRewardsMirror::serviceNodeIDs() const {
+    std::vector<uint64_t> result;
+    result.reserve(size());
+    for (uint64_t it = nodes.at(SERVICE_NODE_LIST_SENTINEL).next; it != SERVICE_NODE_LIST_SENTINEL; it = nodes.at(it).next)
+        result.push_back(it);
+    return result;
+}
+
+bls::PublicKey ServiceNodeRewardsMirror::aggregatePubkey() const {
+    bls::PublicKey result;
+    result.clear();
+    for (const auto& [serviceNodeID, node] : nodes) {
+        if (serviceNodeID != SERVICE_NODE_LIST_SENTINEL) {
+            CRYPTO_COUNT(G1Add);
+            result.add(node.pubkey);
+        }
+    }
+    return result;
+}
+
+ServiceNodeRewardsIndexer::ServiceNodeRewardsIndexer(const std::string& _contractAddress, std::shared_ptr<Provider> _provider, uint64_t startBlock, uint64_t _confirmations, uint64_t _chunkSize)
+        : ServiceNodeRewardsIndexer(_contractAddress, std::make_shared<LiveProviderBackend>(_provider), startBlock, _confirmations, _chunkSize) {}
+
+ServiceNodeRewardsIndexer::ServiceNodeRewardsIndexer(const std::string& _contractAddress, std::shared_ptr<ProviderBackend> _backend, uint64_t startBlock, uint64_t _confirmations, uint64_t _chunkSize)
+        : contractAddress(_contractAddress), backend(std::move(_backend)), nextBlock(startBlock), confirmations(_confirmations), chunkSize(std::max<uint64_t>(_chunkSize, 1)) {
+    confirmedMirror.height = startBlock ? startBlock - 1 : 0;
+    latestMirror.height    = confirmedMirror.height;
+}
+
+std::vector<ServiceNodeRewardsEvent> ServiceNodeRewardsIndexer::fetchEvents(uint64_t fromBlock, uint64_t toBlock) {
+    std::vector<ServiceNodeRewardsEvent> result;
+    for (uint64_t chunkBegin = fromBlock; chunkBegin <= toBlock; chunkBegin += chunkSize) {
+        uint64_t              chunkEnd = std::min(toBlock, chunkBegin + chunkSize - 1);
+        std::vector<LogEntry> logs     = backend->getLogs(chunkBegin, chunkEnd, contractAddress);
+        for (const LogEntry& log : logs) {
+            if (log.removed)
+                continue;
+            if (std::optional<ServiceNodeRewardsEvent> event = events::decode(log))
+                result.push_back(std::move(*event));
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const ServiceNodeRewardsEvent& lhs, const ServiceNodeRewardsEvent& rhs) {
+        const EventLocation& l = events::location(lhs);
+        const EventLocation& r = events::location(rhs);
+        return l.blockNumber != r.blockNumber ? l.blockNumber < r.blockNumber : l.logIndex < r.logIndex;
+    });
+    return result;
+}
+
+IndexerSyncResult ServiceNodeRewardsIndexer::sync() {
+    return syncTo(backend->getLatestHeight());
+}
+
+IndexerSyncResult ServiceNodeRewardsIndexer::syncTo(uint64_t headHeight) {
+    IndexerSyncResult result = {};
+    result.headHeight        = headHeight;
+    result.confirmedHeight   = confirmedMirror.height;
+    if (headHeight < nextBlock)
+        return result;
+
+    // NOTE: Everything from the last confirmed block up to the head is
+    // re-queried, the unconfirmed tail may have changed since the last sync.
+    std::vector<ServiceNodeRewardsEvent> fetched         = fetchEvents(nextBlock, headHeight);
+    const uint64_t                       confirmedTarget = headHeight > confirmations ? headHeight - confirmations : 0;
+
+    // NOTE: Any event we previously handed out as tentative that is no longer
+    // in the chain has been reorged out.
+    for (const ServiceNodeRewardsEvent& previous : tentativeEvents) {
+        const EventLocation& prev = events::location(previous);
+        if (prev.blockNumber > headHeight) {
+            result.reorged = true;
+            break;
+        }
+        bool found = std::any_of(fetched.begin(), fetched.end(), [&prev](const ServiceNodeRewardsEvent& event) {
+            const EventLocation& loc = events::location(event);
+            return loc.blockNumber == prev.blockNumber && loc.logIndex == prev.logIndex && loc.blockHash == prev.blockHash;
+        });
+        if (!found) {
+            result.reorged = true;
+            break;
+        }
+    }
+
+    tentativeEvents.clear();
+    for (ServiceNodeRewardsEvent& event : fetched) {
+        if (events::location(event).blockNumber <= confirmedTarget) {
+            confirmedMirror.apply(event);
+            result.confirmed.push_back(std::move(event));
+        } else {
+            tentativeEvents.push_back(std::move(event));
+        }
+    }
+
+    if (confirmedTarget >= nextBlock) {
+        confirmedMirror.height = confirmedTarget;
+        nextBlock              = confirmedTarget + 1;
+    }
+
+    // NOTE: Roll back to the confirmed state and replay the unconfirmed tail
+    latestMirror = confirmedMirror;
+    for (const ServiceNodeRewardsEvent& event : tentativeEvents)
+        latestMirror.apply(event);
+    latestMirror.height = headHeight;
+
+    result.confirmedHeight = confirmedMirror.height;
+    result.tentative       = tentativeEvents;
+    return result;
+}
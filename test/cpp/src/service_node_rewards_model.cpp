@@ -0,0 +1,315 @@
+#include "service_node_rewards/service_node_rewards_model.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+#include "service_node_rewards/crypto_counters.hpp"
+#include "service_node_rewards/uint256.hpp"
+#include "ethyl/utils.hpp"
+
+namespace {
+    const std::string ZERO_ADDRESS = "0x" + std::string(40, '0');
+
+    std::string normalizeHex(std::string_view hex) {
+        std::string result(utils::trimPrefix(hex, "0x"));
+        std::transform(result.begin(), result.end(), result.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+        return result;
+    }
+
+    std::string normalizeAddress(std::string_view address) {
+        return "0x" + normalizeHex(address);
+    }
+}
+
+const char* toString(ServiceNodeRewardsError error) {
+    switch (error) {
+        case ServiceNodeRewardsError::None:                         return "None";
+        case ServiceNodeRewardsError::ArrayLengthMismatch:          return "ArrayLengthMismatch";
+        case ServiceNodeRewardsError::BLSPubkeyAlreadyExists:       return "BLSPubkeyAlreadyExists";
+        case ServiceNodeRewardsError::BLSPubkeyDoesNotMatch:        return "BLSPubkeyDoesNotMatch";
+        case ServiceNodeRewardsError::ContractNotActive:            return "ContractNotActive";
+        case ServiceNodeRewardsError::EarlierLeaveRequestMade:      return "EarlierLeaveRequestMade";
+        case ServiceNodeRewardsError::InsufficientBLSSignatures:    return "InsufficientBLSSignatures";
+        case ServiceNodeRewardsError::LeaveRequestTooEarly:         return "LeaveRequestTooEarly";
+        case ServiceNodeRewardsError::NullRecipient:                return "NullRecipient";
+        case ServiceNodeRewardsError::RecipientAddressDoesNotMatch: return "RecipientAddressDoesNotMatch";
+        case ServiceNodeRewardsError::RecipientRewardsTooLow:       return "RecipientRewardsTooLow";
+    }
+    return "Unknown";
+}
+
+ServiceNodeRewardsModel::ServiceNodeRewardsModel(ServiceNodeRewardsParams params) : contractParams(std::move(params)) {
+    aggregate.clear();
+    // NOTE: Doubly-linked list with a sentinel that points to itself
+    nodes[LIST_SENTINEL] = ServiceNodeRewardsModelNode{LIST_SENTINEL, LIST_SENTINEL, ZERO_ADDRESS, "", aggregate, 0, 0};
+}
+
+ServiceNodeRewardsModel ServiceNodeRewardsModel::fromContract(ServiceNodeRewardsContract& contract, const std::vector<std::string>& recipients) {
+    ServiceNodeRewardsParams params    = {};
+    params.stakingRequirement          = contract.stakingRequirement();
+    params.liquidatorRewardRatio       = contract.liquidatorRewardRatio();
+    params.poolShareOfLiquidationRatio = contract.poolShareOfLiquidationRatio();
+    params.recipientRatio              = contract.recipientRatio();
+    params.blsNonSignerThresholdMax    = contract.blsNonSignerThresholdMax();
+
+    ServiceNodeRewardsModel result(params);
+    result.active             = contract.isActive();
+    result.nextID             = contract.nextServiceNodeID();
+    result.totalNodes         = contract.totalNodes();
+    result.nonSignerThreshold = contract.blsNonSignerThreshold();
+    result.aggregate          = contract.aggregatePubkey();
+
+    const ContractServiceNode sentinel = contract.serviceNodes(LIST_SENTINEL);
+    result.nodes[LIST_SENTINEL].next   = sentinel.next;
+    result.nodes[LIST_SENTINEL].prev   = sentinel.prev;
+    for (uint64_t id = sentinel.next; id != LIST_SENTINEL;) {
+        const ContractServiceNode   node      = contract.serviceNodes(id);
+        ServiceNodeRewardsModelNode modelNode = {};
+        modelNode.next                        = node.next;
+        modelNode.prev                        = node.prev;
+        modelNode.recipient                   = normalizeAddress(utils::toHexString(node.recipient));
+        modelNode.pubkey                      = normalizeHex(utils::BLSPublicKeyToHex(node.pubkey));
+        modelNode.blsPubkey                   = node.pubkey;
+        modelNode.leaveRequestTimestamp       = node.leaveRequestTimestamp;
+        modelNode.deposit                     = Uint256::fromHex(node.deposit).low64();
+
+        result.pubkeyToID[modelNode.pubkey] = id;
+        result.nodes[id]                    = std::move(modelNode);
+        id                                  = node.next;
+    }
+
+    for (const std::string& address : recipients)
+        result.recipients.insert_or_assign(normalizeAddress(address), contract.viewRecipientData(address));
+    return result;
+}
+
+ServiceNodeRewardsOutcome ServiceNodeRewardsModel::start() {
+    active = true;
+    return {};
+}
+
+ServiceNodeRewardsOutcome ServiceNodeRewardsModel::seedPublicKeyList(const std::vector<std::string>& pubkeys, const std::vector<uint64_t>& amounts) {
+    ServiceNodeRewardsOutcome result = {};
+    if (pubkeys.size() != amounts.size()) {
+        result.error = ServiceNodeRewardsError::ArrayLengthMismatch;
+        return result;
+    }
+
+    // NOTE: Every key is checked up front so a duplicate reverts the whole batch
+    std::unordered_map<std::string, size_t> seen;
+    for (size_t index = 0; index < pubkeys.size(); index++) {
+        const std::string key = normalizeHex(pubkeys[index]);
+        if (pubkeyToID.count(key) || !seen.emplace(key, index).second) {
+            result.error = ServiceNodeRewardsError::BLSPubkeyAlreadyExists;
+            return result;
+        }
+    }
+
+    for (size_t index = 0; index < pubkeys.size(); index++) {
+        result.serviceNodeID                = serviceNodeAdd(normalizeHex(pubkeys[index]), utils::HexToBLSPublicKey(pubkeys[index]));
+        nodes[result.serviceNodeID].deposit = amounts[index];
+    }
+    updateBLSNonSignerThreshold();
+    return result;
+}
+
+ServiceNodeRewardsOutcome ServiceNodeRewardsModel::addBLSPublicKey(const std::string& sender, const std::string& pubkey) {
+    ServiceNodeRewardsOutcome result = {};
+    const std::string         key    = normalizeHex(pubkey);
+    if (!active)
+        result.error = ServiceNodeRewardsError::ContractNotActive;
+    else if (pubkeyToID.count(key))
+        result.error = ServiceNodeRewardsError::BLSPubkeyAlreadyExists;
+    if (!result)
+        return result;
+
+    result.serviceNodeID                  = serviceNodeAdd(key, utils::HexToBLSPublicKey(pubkey));
+    nodes[result.serviceNodeID].recipient = normalizeAddress(sender);
+    nodes[result.serviceNodeID].deposit   = contractParams.stakingRequirement;
+    updateBLSNonSignerThreshold();
+    return result;
+}
+
+ServiceNodeRewardsOutcome ServiceNodeRewardsModel::initiateRemoveBLSPublicKey(const std::string& sender, uint64_t serviceNodeID, uint64_t timestamp) {
+    ServiceNodeRewardsOutcome result = {};
+    result.serviceNodeID             = serviceNodeID;
+
+    // NOTE: A missing node reads as the zero struct on chain, its operator is
+    // the zero address which can't send a transaction
+    auto it = nodes.find(serviceNodeID);
+    if (!active)
+        result.error = ServiceNodeRewardsError::ContractNotActive;
+    else if (it == nodes.end() || it->second.recipient != normalizeAddress(sender))
+        result.error = ServiceNodeRewardsError::RecipientAddressDoesNotMatch;
+    else if (it->second.leaveRequestTimestamp != 0)
+        result.error = ServiceNodeRewardsError::EarlierLeaveRequestMade;
+    if (!result)
+        return result;
+
+    it->second.leaveRequestTimestamp = timestamp;
+    return result;
+}
+
+ServiceNodeRewardsOutcome ServiceNodeRewardsModel::removeBLSPublicKeyAfterWaitTime(uint64_t serviceNodeID, uint64_t timestamp) {
+    ServiceNodeRewardsOutcome result = {};
+    result.serviceNodeID             = serviceNodeID;
+
+    auto           it                    = nodes.find(serviceNodeID);
+    const uint64_t leaveRequestTimestamp = it == nodes.end() ? 0 : it->second.leaveRequestTimestamp;
+    if (!active)
+        result.error = ServiceNodeRewardsError::ContractNotActive;
+    else if (leaveRequestTimestamp == 0 || timestamp <= leaveRequestTimestamp + MAX_SERVICE_NODE_REMOVAL_WAIT_TIME)
+        result.error = ServiceNodeRewardsError::LeaveRequestTooEarly;
+    if (!result)
+        return result;
+
+    result.amount = it->second.deposit;
+    serviceNodeDelete(serviceNodeID);
+    updateBLSNonSignerThreshold();
+    return result;
+}
+
+ServiceNodeRewardsOutcome ServiceNodeRewardsModel::removeBLSPublicKeyWithSignature(uint64_t serviceNodeID, const std::string& pubkey, const std::vector<uint64_t>& nonSigners) {
+    ServiceNodeRewardsOutcome result = {};
+    result.serviceNodeID             = serviceNodeID;
+
+    auto it = nodes.find(serviceNodeID);
+    if (!active)
+        result.error = ServiceNodeRewardsError::ContractNotActive;
+    else
+        result.error = checkNonSigners(nonSigners);
+    if (result && (it == nodes.end() || serviceNodeID == LIST_SENTINEL || it->second.pubkey != normalizeHex(pubkey)))
+        result.error = ServiceNodeRewardsError::BLSPubkeyDoesNotMatch;
+    if (!result)
+        return result;
+
+    result.amount = it->second.deposit;
+    serviceNodeDelete(serviceNodeID);
+    updateBLSNonSignerThreshold();
+    return result;
+}
+
+ServiceNodeRewardsOutcome ServiceNodeRewardsModel::liquidateBLSPublicKeyWithSignature(uint64_t serviceNodeID, const std::string& pubkey, const std::vector<uint64_t>& nonSigners) {
+    ServiceNodeRewardsOutcome result = {};
+    result.serviceNodeID             = serviceNodeID;
+
+    auto it = nodes.find(serviceNodeID);
+    if (!active)
+        result.error = ServiceNodeRewardsError::ContractNotActive;
+    else
+        result.error = checkNonSigners(nonSigners);
+    if (result && (it == nodes.end() || serviceNodeID == LIST_SENTINEL || it->second.pubkey != normalizeHex(pubkey)))
+        result.error = ServiceNodeRewardsError::BLSPubkeyDoesNotMatch;
+    if (!result)
+        return result;
+
+    // NOTE: Mirrors the contract as written, including the pool amount
+    // expression which parses as `(deposit * poolShare == 0) ? 0 : (poolShare - 1) / ratioSum + 1`
+    // and so pays the pool 1 atomic unit whenever it has a share.
+    const Uint256 deposit          = it->second.deposit;
+    const Uint256 poolShare        = contractParams.poolShareOfLiquidationRatio;
+    const Uint256 ratioSum         = poolShare + Uint256(contractParams.liquidatorRewardRatio) + Uint256(contractParams.recipientRatio);
+    const Uint256 liquidatorAmount = deposit * contractParams.liquidatorRewardRatio / ratioSum;
+    const Uint256 poolAmount       = (deposit * poolShare).isZero() ? Uint256(0) : (poolShare - Uint256(1)) / ratioSum + Uint256(1);
+    const Uint256 returnedAmount   = deposit - liquidatorAmount - poolAmount;
+
+    result.amount = returnedAmount.low64();
+    serviceNodeDelete(serviceNodeID);
+    updateBLSNonSignerThreshold();
+    return result;
+}
+
+ServiceNodeRewardsOutcome ServiceNodeRewardsModel::updateRewardsBalance(const std::string& address, uint64_t amount, const std::vector<uint64_t>& nonSigners) {
+    ServiceNodeRewardsOutcome result    = {};
+    const std::string         recipient = normalizeAddress(address);
+    if (!active)
+        result.error = ServiceNodeRewardsError::ContractNotActive;
+    else if (recipient == ZERO_ADDRESS)
+        result.error = ServiceNodeRewardsError::NullRecipient;
+    else if (ServiceNodeRewardsError error = checkNonSigners(nonSigners); error != ServiceNodeRewardsError::None)
+        result.error = error;
+    else if (viewRecipientData(recipient).rewards >= amount)
+        result.error = ServiceNodeRewardsError::RecipientRewardsTooLow;
+    if (!result)
+        return result;
+
+    auto it = recipients.try_emplace(recipient, 0, 0).first;
+    it->second.rewards = amount;
+    return result;
+}
+
+ServiceNodeRewardsOutcome ServiceNodeRewardsModel::claimRewards(const std::string& sender) {
+    ServiceNodeRewardsOutcome result = {};
+    auto it = recipients.find(normalizeAddress(sender));
+    if (it == recipients.end())
+        return result;
+    result.amount      = it->second.rewards - it->second.claimed;
+    it->second.claimed = it->second.rewards;
+    return result;
+}
+
+const ServiceNodeRewardsModelNode* ServiceNodeRewardsModel::serviceNodes(uint64_t serviceNodeID) const {
+    if (serviceNodeID == LIST_SENTINEL)
+        return nullptr;
+    auto it = nodes.find(serviceNodeID);
+    return it == nodes.end() ? nullptr : &it->second;
+}
+
+uint64_t ServiceNodeRewardsModel::serviceNodeIDs(const std::string& pubkey) const {
+    auto it = pubkeyToID.find(normalizeHex(pubkey));
+    return it == pubkeyToID.end() ? LIST_SENTINEL : it->second;
+}
+
+Recipient ServiceNodeRewardsModel::viewRecipientData(const std::string& address) const {
+    auto it = recipients.find(normalizeAddress(address));
+    return it == recipients.end() ? Recipient(0, 0) : it->second;
+}
+
+std::vector<uint64_t> ServiceNodeRewardsModel::serviceNodeIDsInOrder() const {
+    std::vector<uint64_t> result;
+    result.reserve(totalNodes);
+    for (uint64_t id = nodes.at(LIST_SENTINEL).next; id != LIST_SENTINEL; id = nodes.at(id).next)
+        result.push_back(id);
+    return result;
+}
+
+ServiceNodeRewardsError ServiceNodeRewardsModel::checkNonSigners(const std::vector<uint64_t>& nonSigners) const {
+    return nonSigners.size() > nonSignerThreshold ? ServiceNodeRewardsError::InsufficientBLSSignatures : ServiceNodeRewardsError::None;
+}
+
+uint64_t ServiceNodeRewardsModel::serviceNodeAdd(const std::string& pubkey, bls::PublicKey blsPubkey) {
+    const uint64_t result = nextID++;
+    totalNodes++;
+
+    // NOTE: Append before the sentinel, i.e. at the tail
+    const uint64_t tail       = nodes[LIST_SENTINEL].prev;
+    nodes[result]             = ServiceNodeRewardsModelNode{LIST_SENTINEL, tail, ZERO_ADDRESS, pubkey, blsPubkey, 0, 0};
+    nodes[tail].next          = result;
+    nodes[LIST_SENTINEL].prev = result;
+
+    pubkeyToID[pubkey] = result;
+    if (totalNodes == 1) {
+        aggregate = blsPubkey;
+    } else {
+        CRYPTO_COUNT(G1Add);
+        aggregate.add(blsPubkey);
+    }
+    return result;
+}
+
+void ServiceNodeRewardsModel::serviceNodeDelete(uint64_t serviceNodeID) {
+    auto                              it   = nodes.find(serviceNodeID);
+    const ServiceNodeRewardsModelNode node = std::move(it->second);
+    nodes.erase(it);
+
+    nodes[node.next].prev = node.prev;
+    nodes[node.prev].next = node.next;
+    CRYPTO_COUNT(G1Add);
+    aggregate.sub(node.blsPubkey);
+    pubkeyToID.erase(node.pubkey);
+    totalNodes--;
+}
+
+void ServiceNodeRewardsModel::updateBLSNonSignerThreshold() {
+    nonSignerThreshold = std::min(totalNodes / 3, contractParams.blsNonSignerThresholdMax);
+}
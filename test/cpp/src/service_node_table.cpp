@@ -0,0 +1,249 @@
+#include "service_node_rewards/service_node_table.hpp"
+#include "service_node_rewards/crypto_counters.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    // NOTE: bls keys wrap the mcl points with the same layout, as in ec_utils
+    const mcl::bn::G1& toG1(const bls::PublicKey& publicKey) {
+        return *reinterpret_cast<const mcl::bn::G1*>(&publicKey.getPtr()->v);
+    }
+
+    mcl::bn::G1& toG1(bls::PublicKey& publicKey) {
+        return *reinterpret_cast<mcl::bn::G1*>(&const_cast<blsPublicKey*>(publicKey.getPtr())->v);
+    }
+
+    // `point` must already be normalized
+    G1Affine toAffine(const mcl::bn::G1& point) {
+        G1Affine result = {};
+        if (point.isZero()) {
+            result.x.clear();
+            result.y.clear();
+        } else {
+            result.x = point.x;
+            result.y = point.y;
+        }
+        return result;
+    }
+
+    // NOTE: The group has prime order so no point on it has y = 0, only
+    // the point at infinity is stored that way
+    void fromAffine(mcl::bn::G1& result, const G1Affine& point) {
+        if (point.y.isZero()) {
+            result.clear();
+            return;
+        }
+        result.x = point.x;
+        result.y = point.y;
+        result.z = 1;
+    }
+
+    void throwUnknownID(uint64_t serviceNodeID) {
+        std::stringstream stream;
+        stream << "Service node " << serviceNodeID << " is not in the table";
+        throw std::invalid_argument(stream.str());
+    }
+}
+
+ServiceNodeTable ServiceNodeTable::fromNodes(const std::unordered_map<uint64_t, ContractServiceNode>& nodes) {
+    std::vector<uint64_t>    serviceNodeIDs;
+    std::vector<mcl::bn::G1> points;
+    serviceNodeIDs.reserve(nodes.size());
+    points.reserve(nodes.size());
+    for (const auto& [serviceNodeID, node] : nodes) {
+        if (serviceNodeID == SERVICE_NODE_LIST_SENTINEL)
+            continue;
+        serviceNodeIDs.push_back(serviceNodeID);
+        points.push_back(toG1(node.pubkey));
+    }
+    utils::NormalizeG1(points.data(), points.size());
+
+    ServiceNodeTable result;
+    result.reserve(serviceNodeIDs.size());
+    if (auto sentinel = nodes.find(SERVICE_NODE_LIST_SENTINEL); sentinel != nodes.end())
+        result.insert(SERVICE_NODE_LIST_SENTINEL, sentinel->second);
+    for (size_t index = 0; index < serviceNodeIDs.size(); index++)
+        result.append(serviceNodeIDs[index], nodes.at(serviceNodeIDs[index]), toAffine(points[index]));
+    return result;
+}
+
+void ServiceNodeTable::insert(uint64_t serviceNodeID, const ContractServiceNode& node) {
+    if (serviceNodeID == SERVICE_NODE_LIST_SENTINEL) {
+        head = node.next;
+        tail = node.prev;
+        return;
+    }
+    if (contains(serviceNodeID)) {
+        std::stringstream stream;
+        stream << "Service node " << serviceNodeID << " is already in the table";
+        throw std::invalid_argument(stream.str());
+    }
+
+    mcl::bn::G1 point = toG1(node.pubkey);
+    CRYPTO_COUNT_NORMALIZE(point);
+    point.normalize();
+    append(serviceNodeID, node, toAffine(point));
+}
+
+void ServiceNodeTable::append(uint64_t serviceNodeID, const ContractServiceNode& node, const G1Affine& affine) {
+    // NOTE: The index is as long as the highest ID, which the contract
+    // assigns sequentially. Past 2^32 nodes it would be gigabytes.
+    if (serviceNodeID >= NO_ROW || ids.size() >= NO_ROW) {
+        std::stringstream stream;
+        stream << "Service node " << serviceNodeID << " does not fit in the table, IDs and rows are limited to " << NO_ROW;
+        throw std::invalid_argument(stream.str());
+    }
+    if (serviceNodeID >= rowByID.size())
+        rowByID.resize(serviceNodeID + 1, NO_ROW);
+    rowByID[serviceNodeID] = static_cast<uint32_t>(ids.size());
+
+    ids.push_back(serviceNodeID);
+    next.push_back(node.next);
+    prev.push_back(node.prev);
+    recipient.push_back(node.recipient);
+    pubkey.push_back(affine);
+    leaveRequestTimestamp.push_back(node.leaveRequestTimestamp);
+    // NOTE: The indexer's mirror leaves the deposit of the sentinel and of
+    // seeded nodes empty, the events don't carry one
+    deposit.push_back(node.deposit.empty() ? Uint256() : Uint256::fromHex(node.deposit));
+}
+
+void ServiceNodeTable::erase(uint64_t serviceNodeID) {
+    const uint32_t erased = row(serviceNodeID);
+    if (erased == NO_ROW)
+        throwUnknownID(serviceNodeID);
+
+    // NOTE: Move the last row into the hole so the columns stay dense
+    const uint32_t last = static_cast<uint32_t>(ids.size() - 1);
+    if (erased != last) {
+        ids[erased]                   = ids[last];
+        next[erased]                  = next[last];
+        prev[erased]                  = prev[last];
+        recipient[erased]             = recipient[last];
+        pubkey[erased]                = pubkey[last];
+        leaveRequestTimestamp[erased] = leaveRequestTimestamp[last];
+        deposit[erased]               = deposit[last];
+        rowByID[ids[erased]]          = erased;
+    }
+    rowByID[serviceNodeID] = NO_ROW;
+
+    ids.pop_back();
+    next.pop_back();
+    prev.pop_back();
+    recipient.pop_back();
+    pubkey.pop_back();
+    leaveRequestTimestamp.pop_back();
+    deposit.pop_back();
+}
+
+void ServiceNodeTable::reserve(size_t count) {
+    ids.reserve(count);
+    next.reserve(count);
+    prev.reserve(count);
+    recipient.reserve(count);
+    pubkey.reserve(count);
+    leaveRequestTimestamp.reserve(count);
+    deposit.reserve(count);
+}
+
+void ServiceNodeTable::clear() {
+    head = SERVICE_NODE_LIST_SENTINEL;
+    tail = SERVICE_NODE_LIST_SENTINEL;
+    rowByID.clear();
+    ids.clear();
+    next.clear();
+    prev.clear();
+    recipient.clear();
+    pubkey.clear();
+    leaveRequestTimestamp.clear();
+    deposit.clear();
+}
+
+uint32_t ServiceNodeTable::row(uint64_t serviceNodeID) const {
+    return serviceNodeID < rowByID.size() ? rowByID[serviceNodeID] : NO_ROW;
+}
+
+std::optional<ContractServiceNode> ServiceNodeTable::serviceNodes(uint64_t serviceNodeID) const {
+    if (serviceNodeID == SERVICE_NODE_LIST_SENTINEL) {
+        ContractServiceNode sentinel = {};
+        sentinel.next                = head;
+        sentinel.prev                = tail;
+        sentinel.pubkey.clear();
+        return sentinel;
+    }
+
+    const uint32_t index = row(serviceNodeID);
+    if (index == NO_ROW)
+        return std::nullopt;
+
+    ContractServiceNode result   = {};
+    result.next                  = next[index];
+    result.prev                  = prev[index];
+    result.recipient             = recipient[index];
+    fromAffine(toG1(result.pubkey), pubkey[index]);
+    result.leaveRequestTimestamp = leaveRequestTimestamp[index];
+    result.deposit               = deposit[index].toHex();
+    return result;
+}
+
+std::vector<uint64_t> ServiceNodeTable::serviceNodeIDsForRecipient(const std::array<unsigned char, 20>& address) const {
+    std::vector<uint64_t> result;
+    for (size_t index = 0; index < recipient.size(); index++) {
+        if (recipient[index] == address)
+            result.push_back(ids[index]);
+    }
+    return result;
+}
+
+std::vector<uint64_t> ServiceNodeTable::serviceNodeIDsInOrder() const {
+    std::vector<uint64_t> result;
+    result.reserve(ids.size());
+    for (uint64_t it = head; it != SERVICE_NODE_LIST_SENTINEL; it = next[row(it)]) {
+        if (!contains(it) || result.size() == ids.size()) {
+            std::stringstream stream;
+            stream << "Service node table's linked list is broken at node " << it;
+            throw std::runtime_error(stream.str());
+        }
+        result.push_back(it);
+    }
+    return result;
+}
+
+bls::PublicKey ServiceNodeTable::aggregatePubkey() const {
+    bls::PublicKey result;
+    result.clear();
+    mcl::bn::G1& sum = toG1(result);
+    mcl::bn::G1  point;
+    for (const G1Affine& item : pubkey) {
+        if (item.y.isZero())
+            continue;
+        // NOTE: z = 1 takes mcl's mixed addition
+        point.x = item.x;
+        point.y = item.y;
+        point.z = 1;
+        CRYPTO_COUNT(G1Add);
+        mcl::bn::G1::add(sum, sum, point);
+    }
+    CRYPTO_COUNT_NORMALIZE(sum);
+    sum.normalize();
+    return result;
+}
+
+Uint256 ServiceNodeTable::totalDeposit() const {
+    Uint256 result;
+    for (const Uint256& item : deposit)
+        result += item;
+    return result;
+}
+
+size_t ServiceNodeTable::memoryUsage() const {
+    return rowByID.capacity() * sizeof(uint32_t) +
+           ids.capacity() * sizeof(uint64_t) +
+           next.capacity() * sizeof(uint64_t) +
+           prev.capacity() * sizeof(uint64_t) +
+           recipient.capacity() * sizeof(std::array<unsigned char, 20>) +
+           pubkey.capacity() * sizeof(G1Affine) +
+           leaveRequestTimestamp.capacity() * sizeof(uint64_t) +
+           deposit.capacity() * sizeof(Uint256);
+}
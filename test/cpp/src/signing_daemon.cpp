@@ -0,0 +1,649 @@
+#include "service_node_rewards/signing_daemon.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/crypto_counters.hpp"
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/tracing.hpp"
+
+namespace signing_daemon {
+
+constexpr size_t ADDRESS_SIZE    = 20;
+constexpr size_t PUBLIC_KEY_SIZE = 64;
+constexpr size_t SIGNATURE_SIZE  = 128;
+
+namespace {
+class Writer {
+public:
+    void u8(uint8_t value) { buffer.push_back(static_cast<char>(value)); }
+    void u16(uint16_t value) { integer(value, 2); }
+    void u32(uint32_t value) { integer(value, 4); }
+    void u64(uint64_t value) { integer(value, 8); }
+    void bytes(const void* data, size_t size) { buffer.append(static_cast<const char*>(data), size); }
+
+    // `hex` (with or without "0x") as `size` bytes. Anything but exactly
+    // `size` bytes throws, a truncated address must not be signed for as a
+    // zero padded one.
+    void hex(std::string_view hex, size_t size, const char* field) {
+        hex = utils::trimPrefix(hex, "0x");
+        if (hex.size() != size * 2 || hex.find_first_not_of("0123456789abcdefABCDEF") != std::string_view::npos) {
+            std::stringstream stream;
+            stream << "Signing request " << field << " '" << hex << "' is not " << size << " bytes of hex";
+            throw std::invalid_argument(stream.str());
+        }
+        std::vector<unsigned char> raw = utils::fromHexString(std::string(hex));
+        bytes(raw.data(), raw.size());
+    }
+
+    void signers(const std::vector<uint64_t>& ids) {
+        if (ids.size() > (MAX_FRAME_SIZE / sizeof(uint64_t)))
+            throw std::invalid_argument("Signing request has too many signers for one frame");
+        u32(static_cast<uint32_t>(ids.size()));
+        for (uint64_t id : ids)
+            u64(id);
+    }
+
+    std::string frame() const {
+        if (buffer.size() > MAX_FRAME_SIZE)
+            throw std::invalid_argument("Signing daemon message of " + std::to_string(buffer.size()) + " bytes is larger than a frame");
+        Writer result;
+        result.u32(static_cast<uint32_t>(buffer.size()));
+        result.buffer += buffer;
+        return std::move(result.buffer);
+    }
+
+private:
+    void integer(uint64_t value, size_t size) {
+        for (size_t index = size; index-- > 0;)
+            buffer.push_back(static_cast<char>((value >> (index * 8)) & 0xFF));
+    }
+
+    std::string buffer;
+};
+
+class Reader {
+public:
+    explicit Reader(std::string_view _body) : body(_body) {}
+
+    uint8_t  u8() { return static_cast<uint8_t>(integer(1)); }
+    uint16_t u16() { return static_cast<uint16_t>(integer(2)); }
+    uint32_t u32() { return static_cast<uint32_t>(integer(4)); }
+    uint64_t u64() { return integer(8); }
+
+    std::string_view bytes(size_t size) {
+        if (body.size() - offset < size) {
+            std::stringstream stream;
+            stream << "Signing daemon message of " << body.size() << " bytes is truncated, reading " << size << " bytes at " << offset;
+            throw std::runtime_error(stream.str());
+        }
+        std::string_view result = body.substr(offset, size);
+        offset += size;
+        return result;
+    }
+
+    std::string hex(size_t size) { return "0x" + utils::toHexString(bytes(size)); }
+
+    std::vector<uint64_t> signers() {
+        const uint32_t count = u32();
+        if (count > (body.size() - offset) / sizeof(uint64_t))
+            throw std::runtime_error("Signing daemon message has more signers than bytes");
+        std::vector<uint64_t> result(count);
+        for (uint64_t& id : result)
+            id = u64();
+        return result;
+    }
+
+    void finish() const {
+        if (offset != body.size()) {
+            std::stringstream stream;
+            stream << "Signing daemon message has " << (body.size() - offset) << " trailing bytes";
+            throw std::runtime_error(stream.str());
+        }
+    }
+
+private:
+    uint64_t integer(size_t size) {
+        uint64_t result = 0;
+        for (char ch : bytes(size))
+            result = (result << 8) | static_cast<unsigned char>(ch);
+        return result;
+    }
+
+    std::string_view body;
+    size_t           offset = 0;
+};
+} // namespace
+
+std::string encodeRequest(const Request& request) {
+    Writer writer;
+    writer.u8(static_cast<uint8_t>(request.type));
+    writer.u32(request.id);
+    switch (request.type) {
+        case RequestType::ProofOfPossession: {
+            if (request.serviceNodePubkey.size() > UINT16_MAX)
+                throw std::invalid_argument("Signing request service node pubkey is longer than 65535 bytes");
+            writer.u64(request.serviceNodeID);
+            writer.u32(request.chainID);
+            writer.hex(request.contractAddress, ADDRESS_SIZE, "contract address");
+            writer.hex(request.senderAddress, ADDRESS_SIZE, "sender address");
+            writer.u16(static_cast<uint16_t>(request.serviceNodePubkey.size()));
+            writer.bytes(request.serviceNodePubkey.data(), request.serviceNodePubkey.size());
+        } break;
+        case RequestType::Reward: {
+            writer.u32(request.chainID);
+            writer.hex(request.contractAddress, ADDRESS_SIZE, "contract address");
+            writer.hex(request.recipient, ADDRESS_SIZE, "recipient");
+            writer.u64(request.amount);
+            writer.signers(request.signers);
+        } break;
+        case RequestType::Removal:
+        case RequestType::Liquidation: {
+            writer.u64(request.serviceNodeID);
+            writer.u32(request.chainID);
+            writer.hex(request.contractAddress, ADDRESS_SIZE, "contract address");
+            writer.signers(request.signers);
+        } break;
+        case RequestType::Aggregate: {
+            writer.bytes(request.hash.data(), request.hash.size());
+            writer.signers(request.signers);
+        } break;
+        default: throw std::invalid_argument("Unknown signing request type " + std::to_string(static_cast<int>(request.type)));
+    }
+    return writer.frame();
+}
+
+Request decodeRequest(std::string_view body) {
+    Reader  reader(body);
+    Request result = {};
+    result.type    = static_cast<RequestType>(reader.u8());
+    result.id      = reader.u32();
+    switch (result.type) {
+        case RequestType::ProofOfPossession: {
+            result.serviceNodeID     = reader.u64();
+            result.chainID           = reader.u32();
+            result.contractAddress   = reader.hex(ADDRESS_SIZE);
+            result.senderAddress     = reader.hex(ADDRESS_SIZE);
+            result.serviceNodePubkey = std::string(reader.bytes(reader.u16()));
+        } break;
+        case RequestType::Reward: {
+            result.chainID         = reader.u32();
+            result.contractAddress = reader.hex(ADDRESS_SIZE);
+            result.recipient       = reader.hex(ADDRESS_SIZE);
+            result.amount          = reader.u64();
+            result.signers         = reader.signers();
+        } break;
+        case RequestType::Removal:
+        case RequestType::Liquidation: {
+            result.serviceNodeID   = reader.u64();
+            result.chainID         = reader.u32();
+            result.contractAddress = reader.hex(ADDRESS_SIZE);
+            result.signers         = reader.signers();
+        } break;
+        case RequestType::Aggregate: {
+            std::string_view hash = reader.bytes(result.hash.size());
+            std::copy(hash.begin(), hash.end(), result.hash.begin());
+            result.signers = reader.signers();
+        } break;
+        default: {
+            std::stringstream stream;
+            stream << "Unknown signing request type " << static_cast<int>(result.type) << " in request " << result.id;
+            throw std::runtime_error(stream.str());
+        }
+    }
+    reader.finish();
+    return result;
+}
+
+std::string encodeResponse(const Response& response) {
+    Writer writer;
+    writer.u8(response.ok() ? 0 : 1);
+    writer.u32(response.id);
+    if (response.ok()) {
+        writer.u8(response.publicKey.empty() ? 0 : 1);
+        if (response.publicKey.size())
+            writer.hex(response.publicKey, PUBLIC_KEY_SIZE, "public key");
+        writer.hex(response.signature, SIGNATURE_SIZE, "signature");
+    } else {
+        const std::string_view error = std::string_view(response.error).substr(0, UINT16_MAX);
+        writer.u16(static_cast<uint16_t>(error.size()));
+        writer.bytes(error.data(), error.size());
+    }
+    return writer.frame();
+}
+
+Response decodeResponse(std::string_view body) {
+    Reader   reader(body);
+    Response result = {};
+    const uint8_t status = reader.u8();
+    result.id            = reader.u32();
+    if (status == 0) {
+        // NOTE: Hex without "0x" like utils::SignatureToHex and BLSPublicKeyToHex
+        if (reader.u8())
+            result.publicKey = utils::toHexString(reader.bytes(PUBLIC_KEY_SIZE));
+        result.signature = utils::toHexString(reader.bytes(SIGNATURE_SIZE));
+    } else {
+        result.error = std::string(reader.bytes(reader.u16()));
+        if (result.error.empty())
+            result.error = "Signing daemon returned an error without a message";
+    }
+    reader.finish();
+    return result;
+}
+
+} // namespace signing_daemon
+
+using signing_daemon::Request;
+using signing_daemon::RequestType;
+using signing_daemon::Response;
+
+SigningService::SigningService(ServiceNodeList _snl, size_t _keyCacheSize) : snl(std::move(_snl)), keyCacheSize(_keyCacheSize) {
+    TRACE_SPAN("signing_daemon", "load");
+    if (snl.nodes.empty())
+        throw std::invalid_argument("Signing service needs at least one service node");
+    publicKeys.reserve(snl.nodes.size());
+    std::vector<uint64_t> ids;
+    ids.reserve(snl.nodes.size());
+    for (size_t index = 0; index < snl.nodes.size(); index++) {
+        indexByID.emplace(snl.nodes[index].service_node_id, index);
+        publicKeys.push_back(snl.nodes[index].getPublicKeyHex());
+        ids.push_back(snl.nodes[index].service_node_id);
+    }
+
+    // NOTE: Requests with no signers are signed by every node, sum their keys
+    // up front
+    auto all       = std::make_shared<SignerSet>();
+    all->secretKey = snl.aggregateSecretKey(ids);
+    all->publicKey = utils::BLSPublicKeyToHex(utils::DerivePublicKey(all->secretKey));
+    everyNode      = std::move(all);
+}
+
+size_t SigningService::nodeIndex(uint64_t serviceNodeID) const {
+    auto it = indexByID.find(serviceNodeID);
+    if (it == indexByID.end())
+        throw std::invalid_argument("Service node " + std::to_string(serviceNodeID) + " is not in the signing daemon's list");
+    return it->second;
+}
+
+static std::string signerSetKey(std::vector<uint64_t> signers) {
+    // NOTE: The summed key doesn't depend on the order of the signers, a
+    // repeated signer is counted twice like in ServiceNodeList
+    std::sort(signers.begin(), signers.end());
+    return std::string(reinterpret_cast<const char*>(signers.data()), signers.size() * sizeof(uint64_t));
+}
+
+std::shared_ptr<const SigningService::SignerSet> SigningService::signerSet(const std::vector<uint64_t>& signers) {
+    if (signers.empty())
+        return everyNode;
+
+    const std::string key = signerSetKey(signers);
+    {
+        std::lock_guard lock{keyCacheMutex};
+        auto it = keyCache.find(key);
+        if (it != keyCache.end())
+            return it->second;
+    }
+
+    TRACE_SPAN("signing_daemon", "aggregate signer keys");
+    for (uint64_t id : signers)
+        nodeIndex(id);
+    auto result       = std::make_shared<SignerSet>();
+    result->secretKey = snl.aggregateSecretKey(signers);
+    result->publicKey = utils::BLSPublicKeyToHex(utils::DerivePublicKey(result->secretKey));
+
+    std::lock_guard lock{keyCacheMutex};
+    // NOTE: Signer sets change rarely, start over rather than track recency
+    if (keyCache.size() >= keyCacheSize)
+        keyCache.clear();
+    if (keyCacheSize)
+        keyCache.emplace(key, result);
+    return result;
+}
+
+void SigningService::setSignHook(std::function<void()> hook) {
+    std::lock_guard lock{signHookMutex};
+    signHook = std::move(hook);
+}
+
+SigningService::Signed SigningService::sign(const std::string& key, const std::array<unsigned char, 32>& hash, const std::vector<uint64_t>& signers) {
+    return signing.run(key, [&] {
+        std::function<void()> hook;
+        {
+            std::lock_guard lock{signHookMutex};
+            hook = signHook;
+        }
+        if (hook)
+            hook();
+
+        TRACE_SPAN("signing_daemon", "sign");
+        std::shared_ptr<const SignerSet> set = signerSet(signers);
+        bls::Signature                   sig;
+        CRYPTO_COUNT(HashToG2);
+        CRYPTO_COUNT(G2ScalarMul);
+        set->secretKey.signHash(sig, hash.data(), hash.size());
+        signatures++;
+        return Signed{set->publicKey, utils::SignatureToHex(sig)};
+    });
+}
+
+Response SigningService::handle(const Request& request) {
+    TRACE_SPAN("signing_daemon", "handle");
+    Response result = {};
+    result.id       = request.id;
+    try {
+        // NOTE: Requests coalesce on the message and the signer set, the same
+        // message signed by different signers is a different signature
+        std::string key(1, static_cast<char>(request.type));
+        switch (request.type) {
+            case RequestType::ProofOfPossession: {
+                ServiceNode& node = snl.nodes[nodeIndex(request.serviceNodeID)];
+                key += std::to_string(request.serviceNodeID) + ":" + std::to_string(request.chainID) + ":" + request.contractAddress + ":" + request.senderAddress + ":" + request.serviceNodePubkey;
+                result.signature = signing.run(key, [&] {
+                    signatures++;
+                    return Signed{"", node.proofOfPossession(request.chainID, request.contractAddress, request.senderAddress, request.serviceNodePubkey)};
+                }).signature;
+            } break;
+            case RequestType::Reward: {
+                const std::array<unsigned char, 32> hash = ServiceNodeList::rewardMessageHash(request.recipient, request.amount, request.chainID, request.contractAddress);
+                key.append(reinterpret_cast<const char*>(hash.data()), hash.size());
+                result.signature = sign(key + signerSetKey(request.signers), hash, request.signers).signature;
+            } break;
+            case RequestType::Removal:
+            case RequestType::Liquidation: {
+                const std::string&                  pubkey = publicKeys[nodeIndex(request.serviceNodeID)];
+                const std::array<unsigned char, 32> hash   = request.type == RequestType::Removal
+                                                                 ? ServiceNodeList::removalMessageHash(pubkey, request.chainID, request.contractAddress)
+                                                                 : ServiceNodeList::liquidationMessageHash(pubkey, request.chainID, request.contractAddress);
+                key.append(reinterpret_cast<const char*>(hash.data()), hash.size());
+                result.publicKey = pubkey;
+                result.signature = sign(key + signerSetKey(request.signers), hash, request.signers).signature;
+            } break;
+            case RequestType::Aggregate: {
+                key.append(reinterpret_cast<const char*>(request.hash.data()), request.hash.size());
+                Signed signed_   = sign(key + signerSetKey(request.signers), request.hash, request.signers);
+                result.publicKey = std::move(signed_.publicKey);
+                result.signature = std::move(signed_.signature);
+            } break;
+            default: throw std::invalid_argument("Unknown signing request type " + std::to_string(static_cast<int>(request.type)));
+        }
+    } catch (const std::exception& e) {
+        result.publicKey.clear();
+        result.signature.clear();
+        result.error = e.what();
+    }
+    return result;
+}
+
+static void writeAll(int fd, std::string_view data) {
+    while (data.size()) {
+        const ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("Failed to write to the signing daemon socket: ") + std::strerror(errno));
+        }
+        data.remove_prefix(static_cast<size_t>(sent));
+    }
+}
+
+// Fill `buffer`, false if the other end closed the connection before sending
+// anything
+static bool readAll(int fd, char* buffer, size_t size) {
+    size_t received = 0;
+    while (received < size) {
+        const ssize_t count = ::recv(fd, buffer + received, size - received, 0);
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error(std::string("Failed to read from the signing daemon socket: ") + std::strerror(errno));
+        }
+        if (count == 0) {
+            if (received == 0)
+                return false;
+            throw std::runtime_error("Signing daemon socket closed in the middle of a message");
+        }
+        received += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+// Body of the next frame, false once the other end has closed the connection
+static bool readFrame(int fd, std::string& body) {
+    unsigned char header[4];
+    if (!readAll(fd, reinterpret_cast<char*>(header), sizeof(header)))
+        return false;
+    const uint32_t size = (uint32_t(header[0]) << 24) | (uint32_t(header[1]) << 16) | (uint32_t(header[2]) << 8) | uint32_t(header[3]);
+    if (size > signing_daemon::MAX_FRAME_SIZE)
+        throw std::runtime_error("Signing daemon frame of " + std::to_string(size) + " bytes is larger than the limit");
+    body.resize(size);
+    if (size && !readAll(fd, body.data(), size))
+        throw std::runtime_error("Signing daemon socket closed in the middle of a message");
+    return true;
+}
+
+static sockaddr_un socketAddress(const std::string& socketPath) {
+    sockaddr_un result = {};
+    result.sun_family  = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(result.sun_path))
+        throw std::invalid_argument("Signing daemon socket path '" + socketPath + "' must be 1 to " + std::to_string(sizeof(result.sun_path) - 1) + " characters");
+    std::memcpy(result.sun_path, socketPath.data(), socketPath.size());
+    return result;
+}
+
+SigningDaemon::SigningDaemon(SigningService& _service, std::string _socketPath) : service(_service), socketPath(std::move(_socketPath)) {
+    const sockaddr_un address = socketAddress(socketPath);
+
+    // NOTE: Only clear away a socket left behind, anything else at the path
+    // (say `--socket keys.json`) is not ours to delete
+    struct stat existing = {};
+    if (::lstat(socketPath.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode))
+            throw std::runtime_error("Failed to listen on '" + socketPath + "': the path exists and is not a socket");
+        ::unlink(socketPath.c_str());
+    }
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0)
+        throw std::runtime_error(std::string("Failed to create the signing daemon socket: ") + std::strerror(errno));
+    // NOTE: The socket hands out signatures from every key, keep other users
+    // off it. Nobody can connect before the listen, so the chmod in between
+    // leaves no window.
+    if (::bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::chmod(socketPath.c_str(), 0600) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0) {
+        std::stringstream stream;
+        stream << "Failed to listen on '" << socketPath << "': " << std::strerror(errno);
+        ::close(listenFd);
+        throw std::runtime_error(stream.str());
+    }
+    acceptThread = std::thread([this] { acceptLoop(); });
+}
+
+SigningDaemon::~SigningDaemon() {
+    stop();
+}
+
+void SigningDaemon::stop() {
+    if (stopping.exchange(true))
+        return;
+
+    // NOTE: Shutting the sockets down wakes the threads blocked in accept and
+    // recv on them
+    ::shutdown(listenFd, SHUT_RDWR);
+    if (acceptThread.joinable())
+        acceptThread.join();
+    ::close(listenFd);
+
+    std::vector<std::unique_ptr<Connection>> remaining;
+    {
+        std::lock_guard lock{connectionsMutex};
+        remaining.swap(connections);
+    }
+    for (auto& connection : remaining)
+        ::shutdown(connection->fd, SHUT_RDWR);
+    for (auto& connection : remaining) {
+        connection->thread.join();
+        ::close(connection->fd);
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove(socketPath, ignored);
+}
+
+void SigningDaemon::acceptLoop() {
+    while (!stopping) {
+        const int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            break; // NOTE: Shut down by `stop`
+        }
+
+        std::lock_guard lock{connectionsMutex};
+        if (stopping) {
+            ::close(fd);
+            break;
+        }
+
+        // NOTE: Reap the connections that have closed since the last one
+        for (auto it = connections.begin(); it != connections.end();) {
+            if ((*it)->done) {
+                (*it)->thread.join();
+                ::close((*it)->fd);
+                it = connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        auto connection    = std::make_unique<Connection>();
+        connection->fd     = fd;
+        Connection* raw    = connection.get();
+        connection->thread = std::thread([this, raw] { serve(*raw); });
+        connections.push_back(std::move(connection));
+    }
+}
+
+void SigningDaemon::serve(Connection& connection) {
+    std::string body;
+    try {
+        while (readFrame(connection.fd, body)) {
+            Response response = {};
+            try {
+                response = service.handle(signing_daemon::decodeRequest(body));
+            } catch (const std::exception& e) {
+                // NOTE: Undecodable, answer with whatever ID it carries if any
+                if (body.size() >= 5)
+                    response.id = (uint32_t(uint8_t(body[1])) << 24) | (uint32_t(uint8_t(body[2])) << 16) | (uint32_t(uint8_t(body[3])) << 8) | uint32_t(uint8_t(body[4]));
+                response.error = e.what();
+            }
+            writeAll(connection.fd, signing_daemon::encodeResponse(response));
+        }
+    } catch (const std::exception&) {
+        // NOTE: The client went away mid message or the daemon is stopping,
+        // either way the connection is done
+    }
+    connection.done = true;
+}
+
+SigningDaemonClient::SigningDaemonClient(const std::string& socketPath) {
+    const sockaddr_un address = socketAddress(socketPath);
+    fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw std::runtime_error(std::string("Failed to create a signing daemon client socket: ") + std::strerror(errno));
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::stringstream stream;
+        stream << "Failed to connect to the signing daemon at '" << socketPath << "': " << std::strerror(errno);
+        ::close(fd);
+        throw std::runtime_error(stream.str());
+    }
+}
+
+SigningDaemonClient::~SigningDaemonClient() {
+    ::close(fd);
+}
+
+Response SigningDaemonClient::call(Request request) {
+    std::lock_guard lock{mutex};
+    request.id = nextID++;
+    writeAll(fd, signing_daemon::encodeRequest(request));
+
+    std::string body;
+    if (!readFrame(fd, body))
+        throw std::runtime_error("Signing daemon closed the connection before answering");
+    Response result = signing_daemon::decodeResponse(body);
+    if (result.id != request.id) {
+        std::stringstream stream;
+        stream << "Signing daemon answered request " << result.id << ", expected " << request.id;
+        throw std::runtime_error(stream.str());
+    }
+    return result;
+}
+
+static Response check(Response response) {
+    if (!response.ok())
+        throw std::runtime_error("Signing daemon failed the request: " + response.error);
+    return response;
+}
+
+std::string SigningDaemonClient::proofOfPossession(uint64_t serviceNodeID, uint32_t chainID, const std::string& contractAddress, const std::string& senderEthAddress, const std::string& serviceNodePubkey) {
+    Request request           = {};
+    request.type              = RequestType::ProofOfPossession;
+    request.serviceNodeID     = serviceNodeID;
+    request.chainID           = chainID;
+    request.contractAddress   = contractAddress;
+    request.senderAddress     = senderEthAddress;
+    request.serviceNodePubkey = serviceNodePubkey;
+    return check(call(std::move(request))).signature;
+}
+
+std::string SigningDaemonClient::updateRewardsBalance(const std::string& address, uint64_t amount, uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids) {
+    Request request         = {};
+    request.type            = RequestType::Reward;
+    request.chainID         = chainID;
+    request.contractAddress = contractAddress;
+    request.recipient       = address;
+    request.amount          = amount;
+    request.signers         = service_node_ids;
+    return check(call(std::move(request))).signature;
+}
+
+std::pair<std::string, std::string> SigningDaemonClient::removeNodeFromIndices(uint64_t nodeID, uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids) {
+    Request request         = {};
+    request.type            = RequestType::Removal;
+    request.serviceNodeID   = nodeID;
+    request.chainID         = chainID;
+    request.contractAddress = contractAddress;
+    request.signers         = service_node_ids;
+    Response response       = check(call(std::move(request)));
+    return std::make_pair(std::move(response.publicKey), std::move(response.signature));
+}
+
+std::pair<std::string, std::string> SigningDaemonClient::liquidateNodeFromIndices(uint64_t nodeID, uint32_t chainID, const std::string& contractAddress, const std::vector<uint64_t>& service_node_ids) {
+    Request request         = {};
+    request.type            = RequestType::Liquidation;
+    request.serviceNodeID   = nodeID;
+    request.chainID         = chainID;
+    request.contractAddress = contractAddress;
+    request.signers         = service_node_ids;
+    Response response       = check(call(std::move(request)));
+    return std::make_pair(std::move(response.publicKey), std::move(response.signature));
+}
+
+std::pair<std::string, std::string> SigningDaemonClient::aggregate(const std::array<unsigned char, 32>& hash, const std::vector<uint64_t>& service_node_ids) {
+    Request request   = {};
+    request.type      = RequestType::Aggregate;
+    request.hash      = hash;
+    request.signers   = service_node_ids;
+    Response response = check(call(std::move(request)));
+    return std::make_pair(std::move(response.publicKey), std::move(response.signature));
+}
@@ -0,0 +1,109 @@
+#include "service_node_rewards/tracing.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    struct Event {
+        const char* category;
+        const char* name;
+        uint64_t    startNs;
+        uint64_t    endNs;
+    };
+
+    // NOTE: Only the owning thread writes, `written` is published with
+    // release so `json` sees complete events up to it.
+    struct ThreadBuffer {
+        uint64_t              tid;
+        uint64_t              generation;
+        std::vector<Event>    events;
+        std::atomic<uint64_t> written = 0;
+    };
+
+    const auto epoch = std::chrono::steady_clock::now();
+
+    std::mutex                                 registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    size_t                                     capacity   = 0;
+    std::atomic<uint64_t>                      generation = 0;
+    uint64_t                                   nextTid    = 1;
+
+    thread_local std::shared_ptr<ThreadBuffer> localBuffer;
+
+    ThreadBuffer* threadBuffer() {
+        // NOTE: A thread re-registers after every `start`, its old buffer was dropped
+        const uint64_t currentGeneration = generation.load(std::memory_order_acquire);
+        if (!localBuffer || localBuffer->generation != currentGeneration) {
+            std::lock_guard lock{registryMutex};
+            auto buffer        = std::make_shared<ThreadBuffer>();
+            buffer->tid        = nextTid++;
+            buffer->generation = generation.load(std::memory_order_relaxed);
+            buffer->events.resize(capacity);
+            buffers.push_back(buffer);
+            localBuffer = std::move(buffer);
+        }
+        return localBuffer->events.empty() ? nullptr : localBuffer.get();
+    }
+}
+
+void tracing::start(size_t eventsPerThread) {
+    std::lock_guard lock{registryMutex};
+    buffers.clear();
+    capacity = eventsPerThread;
+    generation.fetch_add(1, std::memory_order_release);
+    recording.store(true, std::memory_order_relaxed);
+}
+
+void tracing::stop() {
+    recording.store(false, std::memory_order_relaxed);
+}
+
+uint64_t tracing::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+void tracing::record(const char* category, const char* name, uint64_t startNs, uint64_t endNs) {
+    ThreadBuffer* buffer = threadBuffer();
+    if (!buffer)
+        return;
+    const uint64_t index                          = buffer->written.load(std::memory_order_relaxed);
+    buffer->events[index % buffer->events.size()] = Event{category, name, startNs, endNs};
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+std::string tracing::json() {
+    std::lock_guard   lock{registryMutex};
+    std::stringstream stream;
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"service_node_rewards\"}}";
+
+    char timing[64];
+    for (const auto& buffer : buffers) {
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        const uint64_t count   = std::min<uint64_t>(written, buffer->events.size());
+        for (uint64_t index = written - count; index < written; index++) {
+            const Event& event = buffer->events[index % buffer->events.size()];
+            // NOTE: trace_event timestamps are in microseconds
+            std::snprintf(timing, sizeof(timing), "\"ts\":%.3f,\"dur\":%.3f", static_cast<double>(event.startNs) / 1e3, static_cast<double>(event.endNs - event.startNs) / 1e3);
+            stream << ",{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category << "\",\"ph\":\"X\"," << timing << ",\"pid\":1,\"tid\":" << buffer->tid << "}";
+        }
+    }
+    stream << "]}";
+    return stream.str();
+}
+
+void tracing::write(const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        std::stringstream stream;
+        stream << "Failed to write trace to '" << path << "': the file could not be opened";
+        throw std::runtime_error(stream.str());
+    }
+    file << json();
+}
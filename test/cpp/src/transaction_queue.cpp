@@ -0,0 +1,214 @@
+#include "service_node_rewards/transaction_queue.hpp"
+#include "service_node_rewards/tracing.hpp"
+
+#include <algorithm>
+#include <thread>
+
+TransactionQueue::TransactionQueue(std::shared_ptr<Provider> _provider, Signer& _signer)
+        : provider(_provider), signer(_signer) {}
+
+TransactionQueue::Sender& TransactionQueue::sender(const std::string& address) {
+    auto it = senders.find(address);
+    if (it == senders.end()) {
+        Sender result    = {};
+        result.nextNonce = provider->getTransactionCount(address, "pending");
+        it               = senders.emplace(address, std::move(result)).first;
+    }
+    return it->second;
+}
+
+void TransactionQueue::populate(Transaction& tx) {
+    if (!chainId)
+        chainId = provider->getNetworkChainId();
+    if (!feeData)
+        feeData = provider->getFeeData();
+    tx.chainId              = *chainId;
+    tx.maxFeePerGas         = feeData->maxFeePerGas;
+    tx.maxPriorityFeePerGas = feeData->maxPriorityFeePerGas;
+}
+
+std::string TransactionQueue::broadcast(Transaction& tx, const std::vector<unsigned char>& seckey) {
+    {
+        TRACE_SPAN("transaction_queue", "signTransaction");
+        signer.signTransaction(tx, seckey);
+    }
+    TRACE_SPAN("transaction_queue", "eth_sendRawTransaction");
+    return provider->sendUncheckedTransaction(tx);
+}
+
+TransactionFuture TransactionQueue::submit(Transaction tx, const std::vector<unsigned char>& seckey) {
+    std::unique_lock  lock{mutex};
+    const std::string address = signer.secretKeyToAddressString(seckey);
+    Sender&           from    = sender(address);
+    populate(tx);
+
+    // NOTE: Fill the lowest gap left by a failed broadcast first, otherwise
+    // every transaction after it is stuck in the mempool.
+    if (from.gaps.empty()) {
+        tx.nonce = from.nextNonce++;
+    } else {
+        tx.nonce = from.gaps.front();
+        from.gaps.erase(from.gaps.begin());
+    }
+
+    // NOTE: The nonce is ours now, broadcast without the lock so a slow node
+    // doesn't hold up other submissions and `poll`
+    Transaction noop(address, 0, 21000);
+    populate(noop);
+    noop.nonce = tx.nonce;
+    MethodCall call(metrics, "sendTransaction");
+    lock.unlock();
+
+    std::string hash;
+    try {
+        hash = call.network(tx.data, [&] { return broadcast(tx, seckey); });
+    } catch (const std::exception& e) {
+        // NOTE: The node is past our nonces, start over from its count
+        if (std::string_view(e.what()).find("nonce too low") != std::string_view::npos) {
+            lock.lock();
+            senders.erase(address);
+            throw;
+        }
+
+        lock.lock();
+        auto it = senders.find(address);
+        if (it == senders.end()) // NOTE: Resynced while we were broadcasting
+            throw;
+        if (tx.nonce + 1 == it->second.nextNonce) {
+            it->second.nextNonce--;
+            throw;
+        }
+
+        // NOTE: Later nonces are already in flight, plug the hole with a
+        // no-op transfer to ourselves. If that fails too, leave it for the
+        // next submission.
+        lock.unlock();
+        bool plugged = true;
+        try {
+            broadcast(noop, seckey);
+        } catch (const std::exception&) {
+            plugged = false;
+        }
+
+        lock.lock();
+        it = senders.find(address);
+        if (!plugged && it != senders.end())
+            it->second.gaps.insert(std::upper_bound(it->second.gaps.begin(), it->second.gaps.end(), tx.nonce), tx.nonce);
+        throw;
+    }
+
+    lock.lock();
+    const uint64_t ticket = nextTicket++;
+    InFlight&      entry  = inflight.emplace(ticket, InFlight{tx, address, {hash}, {}, std::chrono::steady_clock::now()}).first->second;
+    hashToTicket[hash]    = ticket;
+    return entry.promise.get_future().share();
+}
+
+std::string TransactionQueue::replace(const std::string& hash, const std::vector<unsigned char>& seckey, uint64_t feeBumpPercent) {
+    std::lock_guard lock{mutex};
+    auto ticketIt = hashToTicket.find(hash);
+    if (ticketIt == hashToTicket.end())
+        throw std::invalid_argument("Transaction '" + hash + "' is not in flight, it can not be replaced");
+
+    InFlight&   entry = inflight.at(ticketIt->second);
+    Transaction tx    = entry.tx;
+    tx.maxFeePerGas         += std::max<uint64_t>(tx.maxFeePerGas * feeBumpPercent / 100, 1);
+    tx.maxPriorityFeePerGas += std::max<uint64_t>(tx.maxPriorityFeePerGas * feeBumpPercent / 100, 1);
+
+    std::string replacement = broadcast(tx, seckey);
+    entry.tx                = tx;
+    entry.hashes.push_back(replacement);
+    hashToTicket[replacement] = ticketIt->second;
+    return replacement;
+}
+
+size_t TransactionQueue::poll() {
+    TRACE_SPAN("transaction_queue", "poll receipts");
+    std::vector<std::pair<uint64_t, std::vector<std::string>>> pending;
+    std::shared_ptr<ReceiptTracker>                            tracker;
+    {
+        std::lock_guard lock{mutex};
+        tracker = receiptTracker;
+        pending.reserve(inflight.size());
+        for (const auto& [ticket, entry] : inflight)
+            pending.emplace_back(ticket, entry.hashes);
+
+        // NOTE: Pick up the current fees for the next batch of submissions
+        feeData.reset();
+    }
+
+    // NOTE: Query receipts without holding the lock so submissions can continue
+    std::vector<std::pair<uint64_t, TransactionResult>> mined;
+    if (tracker) {
+        std::vector<std::string> hashes;
+        std::vector<uint64_t>    tickets;
+        for (const auto& [ticket, ticketHashes] : pending) {
+            hashes.insert(hashes.end(), ticketHashes.begin(), ticketHashes.end());
+            tickets.insert(tickets.end(), ticketHashes.size(), ticket);
+        }
+
+        std::vector<std::optional<TransactionResult>> receipts = tracker->fetchReceipts(hashes);
+        for (size_t index = 0; index < receipts.size(); index++) {
+            if (receipts[index])
+                mined.emplace_back(tickets[index], std::move(*receipts[index]));
+        }
+    } else {
+        for (const auto& [ticket, hashes] : pending) {
+            for (const std::string& hash : hashes) {
+                std::optional<nlohmann::json> receipt = provider->getTransactionReceipt(hash);
+                if (!receipt)
+                    continue;
+                if (std::optional<TransactionResult> result = transactionResultFromReceipt(*receipt)) {
+                    result->hash = hash;
+                    mined.emplace_back(ticket, std::move(*result));
+                    break;
+                }
+            }
+        }
+    }
+
+    std::lock_guard lock{mutex};
+    for (auto& [ticket, result] : mined) {
+        auto it = inflight.find(ticket);
+        if (it == inflight.end()) // NOTE: Original and replacement both mined in the batch
+            continue;
+        result.nonce = it->second.tx.nonce;
+        for (const std::string& hash : it->second.hashes)
+            hashToTicket.erase(hash);
+        if (metrics)
+            metrics->method("sendTransaction").receipt.record(std::chrono::steady_clock::now() - it->second.submitted);
+        it->second.promise.set_value(std::move(result));
+        inflight.erase(it);
+    }
+    return inflight.size();
+}
+
+bool TransactionQueue::waitAll(std::chrono::milliseconds timeout, std::chrono::milliseconds interval) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (poll() > 0) {
+        if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+        std::this_thread::sleep_for(interval);
+    }
+    return true;
+}
+
+void TransactionQueue::setReceiptTracker(std::shared_ptr<ReceiptTracker> tracker) {
+    std::lock_guard lock{mutex};
+    receiptTracker = std::move(tracker);
+}
+
+void TransactionQueue::setMetrics(std::shared_ptr<ContractMetrics> _metrics) {
+    std::lock_guard lock{mutex};
+    metrics = std::move(_metrics);
+}
+
+void TransactionQueue::resyncNonce(const std::string& senderAddress) {
+    std::lock_guard lock{mutex};
+    senders.erase(senderAddress);
+}
+
+size_t TransactionQueue::inFlight() const {
+    std::lock_guard lock{mutex};
+    return inflight.size();
+}
@@ -0,0 +1,280 @@
+#include "service_node_rewards/uint256.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    // Full 64x64 -> 128 bit product without relying on a 128 bit integer type
+    void mul64(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo) {
+        const uint64_t a0 = a & 0xFFFFFFFF, a1 = a >> 32;
+        const uint64_t b0 = b & 0xFFFFFFFF, b1 = b >> 32;
+        const uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        const uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+        lo = (mid << 32) | (p00 & 0xFFFFFFFF);
+        hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    }
+
+    // Add `value` into `limbs` at `index`, rippling the carry upwards. Returns
+    // the carry out of the most significant limb.
+    template <size_t N>
+    uint64_t addAt(std::array<uint64_t, N>& limbs, size_t index, uint64_t value) {
+        for (; value && index < N; index++) {
+            limbs[index] += value;
+            value = limbs[index] < value ? 1 : 0;
+        }
+        return value;
+    }
+
+    void subUnchecked(std::array<uint64_t, 4>& lhs, const std::array<uint64_t, 4>& rhs) {
+        uint64_t borrow = 0;
+        for (size_t index = 0; index < lhs.size(); index++) {
+            const uint64_t subtrahend = rhs[index] + borrow;
+            const bool     wrapped    = subtrahend < borrow; // rhs limb was all ones and borrow 1
+            borrow                    = (wrapped || lhs[index] < subtrahend) ? 1 : 0;
+            lhs[index]               -= subtrahend;
+        }
+    }
+
+    size_t countTrailingZeros(uint64_t value) {
+        size_t result = 0;
+        while (value && (value & 1) == 0) {
+            value >>= 1;
+            result++;
+        }
+        return result;
+    }
+
+    int hexDigit(char ch) {
+        if (ch >= '0' && ch <= '9') return ch - '0';
+        if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+        if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+        return -1;
+    }
+}
+
+Uint256 Uint256::fromHex(std::string_view hex) {
+    if (hex.substr(0, 2) == "0x" || hex.substr(0, 2) == "0X")
+        hex.remove_prefix(2);
+    if (hex.empty())
+        throw std::runtime_error("Failed to parse uint256 from hex: no hex characters were given");
+    while (hex.size() > 1 && hex.front() == '0')
+        hex.remove_prefix(1);
+
+    if (hex.size() > 64) {
+        std::stringstream stream;
+        stream << "Failed to parse uint256 from hex '" << hex << "': value has " << hex.size() << " significant hex characters, the maximum is 64";
+        throw std::runtime_error(stream.str());
+    }
+
+    Uint256 result;
+    for (size_t index = 0; index < hex.size(); index++) {
+        const int digit = hexDigit(hex[hex.size() - 1 - index]);
+        if (digit < 0) {
+            std::stringstream stream;
+            stream << "Failed to parse uint256 from hex '" << hex << "': '" << hex[hex.size() - 1 - index] << "' is not a hex character";
+            throw std::runtime_error(stream.str());
+        }
+        result.limbs[index / 16] |= static_cast<uint64_t>(digit) << ((index % 16) * 4);
+    }
+    return result;
+}
+
+std::string Uint256::toHex() const {
+    static const char HEX[] = "0123456789abcdef";
+    std::string       result(64, '0');
+    for (size_t index = 0; index < 64; index++) {
+        const uint64_t digit      = (limbs[index / 16] >> ((index % 16) * 4)) & 0xF;
+        result[63 - index] = HEX[digit];
+    }
+    return result;
+}
+
+std::string Uint256::toString() const {
+    if (isZero())
+        return "0";
+
+    // NOTE: Peel off 9 decimal digits at a time, 10^9 fits the fast 32 bit division
+    const uint64_t CHUNK = 1'000'000'000;
+    std::string    result;
+    Uint256        value = *this;
+    while (!value.isZero()) {
+        Uint256  quotient = value / CHUNK;
+        uint64_t chunk    = (value - quotient * CHUNK).low64();
+        for (int digit = 0; digit < 9 && (chunk || !quotient.isZero()); digit++) {
+            result += static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+        value = quotient;
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+size_t Uint256::bitWidth() const {
+    for (size_t index = limbs.size(); index-- > 0;) {
+        if (limbs[index]) {
+            size_t   bits  = 0;
+            uint64_t value = limbs[index];
+            while (value) {
+                value >>= 1;
+                bits++;
+            }
+            return index * 64 + bits;
+        }
+    }
+    return 0;
+}
+
+Uint256& Uint256::operator+=(const Uint256& rhs) {
+    uint64_t carry = 0;
+    for (size_t index = 0; index < limbs.size(); index++) {
+        const uint64_t sum = limbs[index] + rhs.limbs[index];
+        const uint64_t out = (sum < limbs[index] ? 1 : 0);
+        limbs[index]       = sum + carry;
+        carry              = out + (limbs[index] < carry ? 1 : 0);
+    }
+    if (carry)
+        throw std::overflow_error("uint256 addition overflowed");
+    return *this;
+}
+
+Uint256& Uint256::operator-=(const Uint256& rhs) {
+    if (*this < rhs)
+        throw std::overflow_error("uint256 subtraction underflowed");
+    subUnchecked(limbs, rhs.limbs);
+    return *this;
+}
+
+Uint256& Uint256::operator*=(const Uint256& rhs) {
+    std::array<uint64_t, 8> product = {};
+    for (size_t i = 0; i < limbs.size(); i++) {
+        if (limbs[i] == 0)
+            continue;
+        for (size_t j = 0; j < rhs.limbs.size(); j++) {
+            uint64_t hi = 0, lo = 0;
+            mul64(limbs[i], rhs.limbs[j], hi, lo);
+            addAt(product, i + j, lo);
+            addAt(product, i + j + 1, hi);
+        }
+    }
+    if (product[4] | product[5] | product[6] | product[7])
+        throw std::overflow_error("uint256 multiplication overflowed");
+    std::copy(product.begin(), product.begin() + 4, limbs.begin());
+    return *this;
+}
+
+Uint256& Uint256::operator*=(uint64_t rhs) {
+    uint64_t carry = 0;
+    for (uint64_t& limb : limbs) {
+        uint64_t hi = 0, lo = 0;
+        mul64(limb, rhs, hi, lo);
+        limb  = lo + carry;
+        carry = hi + (limb < carry ? 1 : 0);
+    }
+    if (carry)
+        throw std::overflow_error("uint256 multiplication overflowed");
+    return *this;
+}
+
+void Uint256::divmod(const Uint256& numerator, const Uint256& denominator, Uint256& quotient, Uint256& remainder) {
+    if (denominator.isZero())
+        throw std::domain_error("uint256 division by zero");
+
+    // NOTE: Copy the inputs first, the outputs may alias them
+    const Uint256 n = numerator;
+    const Uint256 d = denominator;
+    quotient        = Uint256{};
+    remainder       = n;
+    if (n < d)
+        return;
+
+    // NOTE: Shift-subtract long division, only over the bits where the
+    // quotient can be non-zero.
+    const size_t shift   = n.bitWidth() - d.bitWidth();
+    Uint256      divisor = d << shift;
+    for (size_t bit = shift + 1; bit-- > 0;) {
+        if (remainder >= divisor) {
+            subUnchecked(remainder.limbs, divisor.limbs);
+            quotient.limbs[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+        divisor >>= 1;
+    }
+}
+
+Uint256& Uint256::operator/=(const Uint256& rhs) {
+    if (rhs.fitsUint64())
+        return *this /= rhs.low64();
+    Uint256 remainder;
+    divmod(*this, rhs, *this, remainder);
+    return *this;
+}
+
+Uint256& Uint256::operator/=(uint64_t rhs) {
+    if (rhs == 0)
+        throw std::domain_error("uint256 division by zero");
+
+    // NOTE: floor(n / (2^k * m)) == floor(floor(n / 2^k) / m), strip the power
+    // of two with a shift so more divisors fit the 32 bit short division.
+    const size_t trailingZeros = countTrailingZeros(rhs);
+    *this >>= trailingZeros;
+    rhs >>= trailingZeros;
+    if (rhs == 1)
+        return *this;
+
+    if (rhs > 0xFFFFFFFF) {
+        Uint256 quotient, remainder;
+        divmod(*this, Uint256(rhs), quotient, remainder);
+        return *this = quotient;
+    }
+
+    uint64_t remainder = 0;
+    for (size_t index = limbs.size(); index-- > 0;) {
+        const uint64_t high = (remainder << 32) | (limbs[index] >> 32);
+        const uint64_t qHigh = high / rhs;
+        remainder            = high % rhs;
+        const uint64_t low   = (remainder << 32) | (limbs[index] & 0xFFFFFFFF);
+        const uint64_t qLow  = low / rhs;
+        remainder            = low % rhs;
+        limbs[index]         = (qHigh << 32) | qLow;
+    }
+    return *this;
+}
+
+Uint256& Uint256::operator%=(const Uint256& rhs) {
+    Uint256 quotient;
+    divmod(*this, rhs, quotient, *this);
+    return *this;
+}
+
+Uint256& Uint256::operator<<=(size_t shift) {
+    if (shift >= 256) {
+        limbs = {};
+        return *this;
+    }
+    const size_t limbShift = shift / 64;
+    const size_t bitShift  = shift % 64;
+    for (size_t index = limbs.size(); index-- > 0;) {
+        uint64_t value = index >= limbShift ? limbs[index - limbShift] << bitShift : 0;
+        if (bitShift && index >= limbShift + 1)
+            value |= limbs[index - limbShift - 1] >> (64 - bitShift);
+        limbs[index] = value;
+    }
+    return *this;
+}
+
+Uint256& Uint256::operator>>=(size_t shift) {
+    if (shift >= 256) {
+        limbs = {};
+        return *this;
+    }
+    const size_t limbShift = shift / 64;
+    const size_t bitShift  = shift % 64;
+    for (size_t index = 0; index < limbs.size(); index++) {
+        uint64_t value = index + limbShift < limbs.size() ? limbs[index + limbShift] >> bitShift : 0;
+        if (bitShift && index + limbShift + 1 < limbs.size())
+            value |= limbs[index + limbShift + 1] << (64 - bitShift);
+        limbs[index] = value;
+    }
+    return *this;
+}
@@ -0,0 +1,140 @@
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ethyl/provider.hpp"
+#include "ethyl/signer.hpp"
+#include "service_node_rewards/async_rpc.hpp"
+#include "service_node_rewards/config.hpp"
+#include "service_node_rewards/erc20_contract.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+static Task<int> add(EventLoop& loop, int lhs, int rhs, std::chrono::milliseconds delay) {
+    co_await loop.sleep(delay);
+    co_return lhs + rhs;
+}
+
+static Task<int> sum(EventLoop& loop, int count) {
+    int result = 0;
+    for (int index = 0; index < count; index++)
+        result += co_await add(loop, index, 1, std::chrono::milliseconds(0));
+    co_return result;
+}
+
+static Task<int> fail(EventLoop& loop) {
+    co_await loop.sleep(std::chrono::milliseconds(1));
+    throw std::runtime_error("failed");
+}
+
+// NOTE: Coroutine lambdas below take what they use as parameters, captures
+// live in the closure which is gone by the time the task runs.
+
+TEST_CASE( "Tasks chain, interleave on the event loop and propagate exceptions", "[async_rpc]" ) {
+    EventLoop loop;
+
+    REQUIRE(loop.run(sum(loop, 10'000)) == 50'005'000);
+    REQUIRE_THROWS_AS(loop.run(fail(loop)), std::runtime_error);
+
+    SECTION( "Spawned tasks wake in deadline order, not spawn order" ) {
+        std::vector<int> order;
+        auto wake = [](EventLoop& loop, std::vector<int>& order, int id, std::chrono::milliseconds delay) -> Task<void> {
+            co_await loop.sleep(delay);
+            order.push_back(id);
+        };
+        const auto start = std::chrono::steady_clock::now();
+        for (int id = 0; id < 100; id++)
+            loop.spawn(wake(loop, order, id, std::chrono::milliseconds(50 - id % 50)));
+        loop.run();
+
+        // NOTE: 100 sleeps of up to 50ms overlap instead of running back to back
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+        REQUIRE(order.size() == 100);
+        REQUIRE(order.front() == 49);
+        REQUIRE(order.back() == 50);
+    }
+
+    SECTION( "An exception escaping a spawned task is rethrown from run" ) {
+        loop.spawn([](EventLoop& loop) -> Task<void> { co_await fail(loop); }(loop));
+        REQUIRE_THROWS_AS(loop.run(), std::runtime_error);
+    }
+
+    SECTION( "Transport errors throw from the co_await" ) {
+        // NOTE: Nothing listens on port 1
+        AsyncJsonRpcClient client(loop, "http://127.0.0.1:1");
+        REQUIRE_THROWS_AS(loop.run(client.call("eth_blockNumber", nlohmann::json::array())), std::runtime_error);
+        REQUIRE(loop.transfersInFlight() == 0);
+    }
+}
+
+TEST_CASE( "Async reads and submissions agree with the blocking API", "[ethereum]" ) {
+    const auto& config   = ethbls::get_config(ethbls::network_type::LOCAL);
+    auto        provider = std::make_shared<Provider>("Client", std::string(config.RPC_URL));
+
+    const std::string          contract_address = provider->getContractDeployedInLatestBlock();
+    ServiceNodeRewardsContract rewards_contract(contract_address, provider);
+    ERC20Contract              erc20_contract(utils::trimAddress(rewards_contract.designatedToken()), provider);
+    Signer                     signer(provider);
+
+    const std::vector<unsigned char> seckey        = utils::fromHexString(std::string(config.PRIVATE_KEY));
+    const std::string                senderAddress = signer.secretKeyToAddressString(seckey);
+    const std::string                snapshot      = provider->evm_snapshot();
+    Transaction                      start         = rewards_contract.start();
+    REQUIRE(provider->transactionSuccessful(signer.sendTransaction(start, seckey)));
+
+    EventLoop              loop;
+    auto                   client = std::make_shared<AsyncJsonRpcClient>(loop, std::string(config.RPC_URL));
+    AsyncTransactionSender sender(client, signer);
+    rewards_contract.setAsyncClient(client);
+    erc20_contract.setAsyncClient(client);
+
+    // NOTE: The approval takes the lowest nonce so it is mined before the
+    // registrations that depend on it, which are then all in flight at once.
+    REQUIRE(loop.run(sender.submitAndWait(erc20_contract.approve(contract_address, std::numeric_limits<std::uint64_t>::max()), seckey)).success);
+
+    ServiceNodeList snl(16);
+    size_t          registered = 0;
+    auto register_node = [](AsyncTransactionSender& sender, Transaction tx, std::vector<unsigned char> seckey, size_t& registered) -> Task<void> {
+        TransactionResult result = co_await sender.submitAndWait(std::move(tx), std::move(seckey));
+        registered += result.success;
+    };
+    for (ServiceNode& node : snl.nodes) {
+        const std::string proof = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+        loop.spawn(register_node(sender, rewards_contract.addBLSPublicKey(node.getPublicKeyHex(), proof, "pubkey", "sig", 0), seckey, registered));
+    }
+    loop.run();
+    REQUIRE(registered == snl.nodes.size());
+    REQUIRE(loop.run(rewards_contract.serviceNodesLengthAsync()) == snl.nodes.size());
+
+    // NOTE: Every node's ID then the node itself, all nodes in flight at once
+    std::vector<uint64_t>            ids(snl.nodes.size());
+    std::vector<ContractServiceNode> nodes(snl.nodes.size());
+    auto read_node = [](ServiceNodeRewardsContract& contract, bls::PublicKey pubkey, uint64_t& id, ContractServiceNode& node) -> Task<void> {
+        id   = co_await contract.serviceNodeIDsAsync(pubkey);
+        node = co_await contract.serviceNodesAsync(id);
+    };
+    for (size_t index = 0; index < snl.nodes.size(); index++)
+        loop.spawn(read_node(rewards_contract, snl.nodes[index].getPublicKey(), ids[index], nodes[index]));
+    loop.run();
+    for (size_t index = 0; index < snl.nodes.size(); index++) {
+        REQUIRE(ids[index] == rewards_contract.serviceNodeIDs(snl.nodes[index].getPublicKey()));
+        ContractServiceNode expected = rewards_contract.serviceNodes(ids[index]);
+        REQUIRE(nodes[index].next == expected.next);
+        REQUIRE(nodes[index].prev == expected.prev);
+        REQUIRE(nodes[index].recipient == expected.recipient);
+        REQUIRE(nodes[index].pubkey == expected.pubkey);
+        REQUIRE(nodes[index].deposit == expected.deposit);
+    }
+
+    REQUIRE(loop.run(rewards_contract.aggregatePubkeyAsync()) == rewards_contract.aggregatePubkey());
+    REQUIRE(loop.run(erc20_contract.balanceOfAsync(senderAddress)) == erc20_contract.balanceOf(senderAddress));
+    Recipient recipient = loop.run(rewards_contract.viewRecipientDataAsync(senderAddress));
+    REQUIRE(recipient.rewards == rewards_contract.viewRecipientData(senderAddress).rewards);
+
+    REQUIRE(provider->evm_revert(snapshot));
+}
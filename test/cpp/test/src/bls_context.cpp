@@ -0,0 +1,45 @@
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/bls_context.hpp"
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+TEST_CASE( "Service node lists can be built from several threads at once", "[bls_context]" ) {
+    // NOTE: Nothing may have set up bls yet, every thread races to do it
+    const size_t THREADS = 8;
+    std::vector<std::unique_ptr<ServiceNodeList>> lists(THREADS);
+    std::vector<const BLSContext*>                contexts(THREADS);
+    std::vector<std::thread>                      workers;
+    for (size_t index = 0; index < THREADS; index++) {
+        workers.emplace_back([&lists, &contexts, index] {
+            lists[index]    = std::make_unique<ServiceNodeList>(16);
+            contexts[index] = &BLSContext::get();
+        });
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+
+    bls::PublicKey installed;
+    blsGetGeneratorOfPublicKey(const_cast<blsPublicKey*>(installed.getPtr()));
+    REQUIRE(BLSContext::get().generator() == installed);
+
+    std::set<std::string>               pubkeys;
+    const std::array<unsigned char, 32> hash = utils::hash("message");
+    for (size_t index = 0; index < THREADS; index++) {
+        REQUIRE(contexts[index] == &BLSContext::get());
+        for (const ServiceNode& node : lists[index]->nodes) {
+            pubkeys.insert(node.getPublicKeyHex());
+            bls::Signature sig = node.signHash(hash);
+            REQUIRE(sig.verifyHash(node.getPublicKey(), hash.data(), hash.size()));
+        }
+    }
+    REQUIRE(pubkeys.size() == THREADS * 16);
+}
@@ -0,0 +1,36 @@
+#include <string>
+
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/contract_read_cache.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+static const std::string CONTRACT_ADDRESS = "0x5FbDB2315678afecb367f032d93F642f64180aa3";
+
+TEST_CASE( "Read cache only carries reads with known invalidating events to later blocks", "[contract_read_cache]" ) {
+    const std::string stakingRequirement = utils::getFunctionSignature("stakingRequirement()");
+    const std::string isActive           = utils::getFunctionSignature("IsActive()");
+
+    ContractReadCache cache(CONTRACT_ADDRESS);
+    cache.advance(10, {});
+    cache.put(stakingRequirement, 10, "0x01");
+    cache.put(isActive, 10, "0x00");
+    REQUIRE(cache.get(stakingRequirement, 10) == "0x01");
+    REQUIRE(cache.get(isActive, 10) == "0x00");
+
+    // NOTE: No events in between, the staking requirement can't have changed
+    // but IsActive() can (start() emits nothing)
+    cache.advance(11, {});
+    REQUIRE(cache.get(stakingRequirement, 11) == "0x01");
+    REQUIRE_FALSE(cache.get(isActive, 11).has_value());
+    REQUIRE(cache.size() == 1);
+
+    cache.put(isActive, 11, "0x01");
+    REQUIRE(cache.get(isActive, 11) == "0x01");
+
+    // NOTE: Reads are only stored at the head
+    cache.put(isActive, 9, "0x00");
+    REQUIRE(cache.get(isActive, 11) == "0x01");
+    REQUIRE_FALSE(cache.get(stakingRequirement, 12).has_value());
+}
@@ -0,0 +1,118 @@
+#include <string>
+#include <vector>
+
+#include "service_node_rewards/bls_context.hpp"
+#include "service_node_rewards/crypto_counters.hpp"
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+using crypto_counters::Op;
+
+static const uint32_t    CHAIN_ID         = 31337;
+static const std::string CONTRACT_ADDRESS = "0x5FbDB2315678afecb367f032d93F642f64180aa3";
+static const std::string RECIPIENT        = "0x70997970C51812dc3A010C7d01b50e0d17dc79C8";
+
+TEST_CASE( "Service node list operations have a fixed elliptic curve cost", "[crypto_counters]" ) {
+    const size_t NODES = 16;
+
+    // NOTE: Build the generator table up front, it is normalized through the
+    // same counted path the first time anything touches the context
+    BLSContext::get();
+
+    crypto_counters::Capture creation;
+    ServiceNodeList          snl(NODES);
+    if constexpr (!crypto_counters::enabled) {
+        // NOTE: Built without the counters, nothing is counted
+        REQUIRE(creation.counts().toString() == crypto_counters::Counts{}.toString());
+        return;
+    }
+
+    // NOTE: One fixed-base multiplication per key, normalized as one batch
+    crypto_counters::Counts counts = creation.counts();
+    INFO(counts.toString());
+    REQUIRE(counts[Op::G1ScalarMul] == NODES);
+    REQUIRE(counts[Op::Normalize] == NODES);
+    REQUIRE(counts[Op::Inversion] == 1);
+
+    std::vector<uint64_t> signers;
+    for (const ServiceNode& node : snl.nodes)
+        signers.push_back(node.service_node_id);
+
+    SECTION( "Keys are derived once, reading them back does no curve work" ) {
+        crypto_counters::Capture capture;
+        for (const ServiceNode& node : snl.nodes) {
+            node.getPublicKey();
+            node.getPublicKeyHex();
+        }
+        counts = capture.counts();
+        INFO(counts.toString());
+        REQUIRE(counts.toString() == crypto_counters::Counts{}.toString());
+    }
+
+    SECTION( "Normalizing points that are already affine does no inversion" ) {
+        mcl::bn::Fr scalar;
+        mcl::bn::G1 base;
+        scalar.setByCSPRNG();
+        BLSContext::get().multiplyGenerator(base, scalar);
+        base.normalize();
+        std::vector<mcl::bn::G1> points(4, base);
+        points[2].clear(); // NOTE: At infinity
+
+        crypto_counters::Capture capture;
+        utils::NormalizeG1(points.data(), points.size());
+        counts = capture.counts();
+        INFO(counts.toString());
+        REQUIRE(counts.toString() == crypto_counters::Counts{}.toString());
+
+        // NOTE: A single projective point pays for the one inversion
+        mcl::bn::G1::dbl(points[1], points[1]);
+        crypto_counters::Capture single;
+        utils::NormalizeG1(points.data(), points.size());
+        counts = single.counts();
+        INFO(counts.toString());
+        REQUIRE(counts[Op::Inversion] == 1);
+        REQUIRE(counts[Op::Normalize] == 1);
+        REQUIRE(points[1].z.isOne());
+    }
+
+    SECTION( "Aggregating the keys is an addition per node" ) {
+        crypto_counters::Capture capture;
+        snl.aggregatePubkeyHex();
+        counts = capture.counts();
+        INFO(counts.toString());
+        REQUIRE(counts[Op::G1Add] == NODES);
+        REQUIRE(counts[Op::G1ScalarMul] == 0);
+        REQUIRE(counts[Op::Normalize] <= 1);
+    }
+
+    SECTION( "A reward is signed by every signer and the signatures summed" ) {
+        crypto_counters::Capture capture;
+        snl.updateRewardsBalance(RECIPIENT, 1'000, CHAIN_ID, CONTRACT_ADDRESS, signers);
+        counts = capture.counts();
+        INFO(counts.toString());
+        REQUIRE(counts[Op::HashToG2] == NODES);
+        REQUIRE(counts[Op::G2ScalarMul] == NODES);
+        REQUIRE(counts[Op::G2Add] == NODES);
+        REQUIRE(counts[Op::G1ScalarMul] == 0);
+        REQUIRE(counts[Op::Normalize] == 1);
+    }
+
+    SECTION( "Batched rewards sign each message once with the aggregate key" ) {
+        std::vector<RewardUpdate> updates;
+        for (uint64_t index = 0; index < 10; index++)
+            updates.push_back(RewardUpdate{RECIPIENT, 1'000 + index});
+
+        // NOTE: The workers count on their own threads, the capture sums them
+        crypto_counters::Capture capture;
+        snl.updateRewardsBalances(updates, CHAIN_ID, CONTRACT_ADDRESS, signers, 4);
+        counts = capture.counts();
+        INFO(counts.toString());
+        REQUIRE(counts[Op::HashToG2] == updates.size());
+        REQUIRE(counts[Op::G2ScalarMul] == updates.size());
+        REQUIRE(counts[Op::G2Add] == 0);
+        REQUIRE(counts[Op::G1ScalarMul] == 0);
+    }
+}
@@ -0,0 +1,46 @@
+#include "service_node_rewards/bls_context.hpp"
+#include "service_node_rewards/ec_utils.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+TEST_CASE( "Fixed-base public key derivation matches the generic scalar multiplication", "[ec_utils]" ) {
+    BLSContext::get();
+
+    std::vector<bls::SecretKey> secretKeys(64);
+    for (bls::SecretKey& secretKey : secretKeys)
+        secretKey.init();
+    const std::vector<bls::PublicKey> derived = utils::DerivePublicKeys(secretKeys);
+    REQUIRE(derived.size() == secretKeys.size());
+
+    for (size_t index = 0; index < secretKeys.size(); index++) {
+        bls::PublicKey expected;
+        secretKeys[index].getPublicKey(expected);
+        REQUIRE(derived[index] == expected);
+        REQUIRE(utils::DerivePublicKey(secretKeys[index]) == expected);
+        REQUIRE(utils::BLSPublicKeyToHex(derived[index]) == utils::BLSPublicKeyToHex(expected));
+    }
+
+    SECTION( "Derivation is linear in the secret key" ) {
+        bls::SecretKey sum = secretKeys[0];
+        sum.add(secretKeys[1]);
+        bls::PublicKey expected = utils::DerivePublicKey(secretKeys[0]);
+        expected.add(utils::DerivePublicKey(secretKeys[1]));
+        REQUIRE(utils::DerivePublicKey(sum) == expected);
+    }
+
+    SECTION( "Batch normalization keeps every point" ) {
+        // NOTE: Sums of two keys are left in projective coordinates by `add`
+        std::vector<bls::PublicKey> sums;
+        for (size_t index = 0; index + 1 < derived.size(); index++) {
+            sums.push_back(derived[index]);
+            sums.back().add(derived[index + 1]);
+        }
+        std::vector<bls::PublicKey> normalized = sums;
+        utils::NormalizePublicKeys(normalized);
+        for (size_t index = 0; index < sums.size(); index++) {
+            REQUIRE(normalized[index] == sums[index]);
+            REQUIRE(utils::BLSPublicKeyToHex(normalized[index]) == utils::BLSPublicKeyToHex(sums[index]));
+        }
+    }
+}
@@ -0,0 +1,212 @@
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+#include "ethyl/provider.hpp"
+#include "service_node_rewards/config.hpp"
+#include "service_node_rewards/hedged_provider_backend.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+// Stand in for an RPC endpoint: answers every read with its name after
+// `delay(request number)`, or throws while `failing` is set (a revert while
+// `rejecting` is, a rate limit while `rateLimited` is)
+class StubEndpoint : public ProviderBackend {
+public:
+    StubEndpoint(std::string _name, std::function<std::chrono::milliseconds(uint64_t)> _delay) : name(std::move(_name)), delay(std::move(_delay)) {}
+
+    std::string callReadFunction(const ReadCallData&, std::string_view) override { return respond(); }
+    std::string callReadFunction(const ReadCallData&, uint64_t) override { return respond(); }
+    std::vector<LogEntry> getLogs(uint64_t, uint64_t, const std::string&) override { return (void)respond(), std::vector<LogEntry>{}; }
+    uint64_t getLatestHeight() override { return (void)respond(), 1; }
+
+    std::atomic<bool>     failing   = false;
+    std::atomic<bool>     rejecting   = false;
+    std::atomic<bool>     rateLimited = false;
+    std::atomic<uint64_t> requests    = 0;
+
+private:
+    std::string respond() {
+        std::this_thread::sleep_for(delay(requests++));
+        if (failing)
+            throw std::runtime_error(name + " is down");
+        if (rejecting)
+            throw JsonRpcError(name + " says execution reverted", {{"code", 3}, {"message", "execution reverted"}});
+        if (rateLimited)
+            throw JsonRpcError(name + " is rate limiting", {{"code", -32005}, {"message", "rate limit exceeded"}});
+        return name;
+    }
+
+    std::string                                          name;
+    std::function<std::chrono::milliseconds(uint64_t)> delay;
+};
+
+static std::string hedgedRead(HedgedProviderBackend& backend) {
+    return backend.callReadFunction(ReadCallData{"0x0", "0x0"});
+}
+
+TEST_CASE( "JSON-RPC errors are picked out of the messages that quote them", "[hedged_provider_backend]" ) {
+    std::optional<JsonRpcError> error = JsonRpcError::fromMessage(R"(Error in response: {"code":-32000,"message":"header not found"} for "{" )");
+    REQUIRE(error);
+    REQUIRE(error->code() == -32000);
+    REQUIRE(error->errorMessage() == "header not found");
+
+    error = JsonRpcError::fromMessage(R"(eth_call failed: {"code":3,"message":"execution reverted: {}","data":"0x08c379a0"})");
+    REQUIRE(error);
+    REQUIRE(error->code() == 3);
+    REQUIRE(error->errorMessage() == "execution reverted: {}");
+
+    // NOTE: A transport failure that echoes a whole response isn't the node's answer
+    REQUIRE_FALSE(JsonRpcError::fromMessage(R"(HTTP status 502: {"jsonrpc":"2.0","error":{"code":-32000,"message":"bad gateway"}})"));
+    REQUIRE_FALSE(JsonRpcError::fromMessage(R"(Connection refused, "code" 7)"));
+    REQUIRE_FALSE(JsonRpcError::fromMessage(R"(Truncated: {"code":-32000,"message":"header)"));
+
+    // NOTE: Only what every node would answer the same is final
+    REQUIRE(JsonRpcError("", {{"code", 3}, {"message", "execution reverted"}}).isFinal());
+    REQUIRE(JsonRpcError("", {{"code", -32000}, {"message", "execution reverted"}}).isFinal());
+    REQUIRE(JsonRpcError("", {{"code", -32005}, {"message", "query returned more than 10000 results"}}).isFinal());
+    REQUIRE(JsonRpcError("", {{"code", -32602}, {"message", "Exceed maximum block range: 5000"}}).isFinal());
+    REQUIRE_FALSE(JsonRpcError("", {{"code", -32005}, {"message", "rate limit exceeded"}}).isFinal());
+    REQUIRE_FALSE(JsonRpcError("", {{"code", -32000}, {"message", "header not found"}}).isFinal());
+    REQUIRE_FALSE(JsonRpcError("", {{"code", -32000}, {"message", "unknown block"}}).isFinal());
+}
+
+TEST_CASE( "Hedged reads take the first answer from a set of endpoints", "[hedged_provider_backend]" ) {
+    HedgedProviderOptions options = {};
+    options.initialHedgeDelay     = std::chrono::milliseconds(50);
+    options.ejectionTime          = std::chrono::milliseconds(200);
+
+    SECTION( "A slow primary's tail is cut to about its p95 without doubling the load" ) {
+        // NOTE: 1 in 25 reads (4%, past the p95) stalls on the primary
+        auto primary   = std::make_shared<StubEndpoint>("primary", [](uint64_t request) { return std::chrono::milliseconds(request % 25 == 24 ? 400 : 2); });
+        auto secondary = std::make_shared<StubEndpoint>("secondary", [](uint64_t) { return std::chrono::milliseconds(2); });
+        HedgedProviderBackend backend({primary, secondary}, options);
+
+        for (int index = 0; index < 250; index++)
+            hedgedRead(backend);
+
+        // NOTE: The 8 stalls after the warm up are answered by the hedge
+        const auto maxHedges = static_cast<uint64_t>(250 * options.hedgeBudget + options.hedgeBurst);
+        std::vector<HedgedEndpointStats> stats = backend.stats();
+        REQUIRE(stats[0].requests == 250);
+        REQUIRE(stats[0].hedgeDelay < std::chrono::milliseconds(50));
+        REQUIRE(stats[1].hedges == stats[1].requests);
+        REQUIRE(stats[1].requests <= maxHedges);
+        REQUIRE(stats[1].wins >= 8);
+    }
+
+    SECTION( "The hedge budget caps the extra load when every endpoint is slow" ) {
+        auto primary   = std::make_shared<StubEndpoint>("primary", [](uint64_t request) { return std::chrono::milliseconds(request % 2 ? 20 : 1); });
+        auto secondary = std::make_shared<StubEndpoint>("secondary", [](uint64_t) { return std::chrono::milliseconds(20); });
+        options.minSamples = 1'000; // NOTE: Hedge everything after the initial delay
+        options.initialHedgeDelay = std::chrono::milliseconds(5);
+        HedgedProviderBackend backend({primary, secondary}, options);
+
+        for (int index = 0; index < 100; index++)
+            hedgedRead(backend);
+        REQUIRE(backend.stats()[1].requests <= static_cast<uint64_t>(100 * options.hedgeBudget + options.hedgeBurst));
+    }
+
+    SECTION( "Hedges don't queue behind the primaries they overtake" ) {
+        // NOTE: The primary holds the only worker until the read has returned
+        std::atomic<bool> released = false;
+        auto primary   = std::make_shared<StubEndpoint>("primary", [&](uint64_t) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (!released && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return std::chrono::milliseconds(0);
+        });
+        auto secondary = std::make_shared<StubEndpoint>("secondary", [](uint64_t) { return std::chrono::milliseconds(0); });
+        options.workerThreads = 1;
+        options.hedgeThreads  = 1;
+        HedgedProviderBackend backend({primary, secondary}, options);
+
+        const std::string answer = hedgedRead(backend);
+        released = true;
+        REQUIRE(answer == "secondary");
+        REQUIRE(backend.stats()[1].wins == 1);
+    }
+
+    SECTION( "Rejected reads are thrown without failing over" ) {
+        auto primary   = std::make_shared<StubEndpoint>("primary", [](uint64_t) { return std::chrono::milliseconds(0); });
+        auto secondary = std::make_shared<StubEndpoint>("secondary", [](uint64_t) { return std::chrono::milliseconds(0); });
+        primary->rejecting = true;
+        HedgedProviderBackend backend({primary, secondary}, options);
+
+        for (uint64_t index = 0; index < options.ejectAfterFailures + 1; index++)
+            REQUIRE_THROWS_AS(hedgedRead(backend), JsonRpcError);
+        REQUIRE(secondary->requests == 0);
+        REQUIRE(backend.stats()[0].failures == 0);
+        REQUIRE_FALSE(backend.stats()[0].ejected);
+
+        primary->rejecting = false;
+        REQUIRE(hedgedRead(backend) == "primary");
+    }
+
+    SECTION( "Rate limited and lagging endpoints fail over" ) {
+        auto primary   = std::make_shared<StubEndpoint>("primary", [](uint64_t) { return std::chrono::milliseconds(0); });
+        auto secondary = std::make_shared<StubEndpoint>("secondary", [](uint64_t) { return std::chrono::milliseconds(0); });
+        primary->rateLimited = true;
+        HedgedProviderBackend backend({primary, secondary}, options);
+
+        REQUIRE(hedgedRead(backend) == "secondary");
+        REQUIRE(primary->requests == 1);
+        REQUIRE(backend.stats()[0].failures == 1);
+
+        // NOTE: With nowhere left to go the node's own error is thrown
+        secondary->rateLimited = true;
+        REQUIRE_THROWS_AS(hedgedRead(backend), JsonRpcError);
+    }
+
+    SECTION( "Failing endpoints fail over straight away and are ejected" ) {
+        auto primary   = std::make_shared<StubEndpoint>("primary", [](uint64_t) { return std::chrono::milliseconds(0); });
+        auto secondary = std::make_shared<StubEndpoint>("secondary", [](uint64_t) { return std::chrono::milliseconds(0); });
+        primary->failing = true;
+        HedgedProviderBackend backend({primary, secondary}, options);
+
+        for (uint64_t index = 0; index < 10; index++)
+            REQUIRE(hedgedRead(backend) == "secondary");
+        REQUIRE(primary->requests == options.ejectAfterFailures);
+        REQUIRE(backend.stats()[0].ejected);
+
+        // NOTE: Back from the ejection the primary gets one probe, failing it
+        // sends it straight back out
+        std::this_thread::sleep_for(options.ejectionTime + std::chrono::milliseconds(50));
+        REQUIRE(hedgedRead(backend) == "secondary");
+        REQUIRE(primary->requests == options.ejectAfterFailures + 1);
+        REQUIRE(backend.stats()[0].ejected);
+
+        // NOTE: An ejected endpoint is still the last resort
+        secondary->failing = true;
+        primary->failing   = false;
+        REQUIRE(hedgedRead(backend) == "primary");
+
+        primary->failing = true;
+        REQUIRE_THROWS_AS(hedgedRead(backend), std::runtime_error);
+    }
+}
+
+TEST_CASE( "Hedged reads agree with a single endpoint", "[ethereum]" ) {
+    const auto& config   = ethbls::get_config(ethbls::network_type::LOCAL);
+    auto        provider = std::make_shared<Provider>("Client", std::string(config.RPC_URL));
+
+    const std::string contract_address = provider->getContractDeployedInLatestBlock();
+    auto              backend          = HedgedProviderBackend::fromUrls({std::string(config.RPC_URL), std::string(config.RPC_URL)});
+
+    ServiceNodeRewardsContract direct(contract_address, provider);
+    ServiceNodeRewardsContract hedged(contract_address, backend);
+    for (int index = 0; index < 50; index++) {
+        REQUIRE(hedged.serviceNodesLength() == direct.serviceNodesLength());
+        REQUIRE(hedged.stakingRequirement() == direct.stakingRequirement());
+    }
+    REQUIRE(backend->getLatestHeight() >= provider->getLatestHeight());
+
+    std::vector<HedgedEndpointStats> stats = backend->stats();
+    REQUIRE(stats[0].failures == 0);
+    REQUIRE(stats[0].wins + stats[1].wins == 101);
+}
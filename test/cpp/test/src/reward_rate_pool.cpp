@@ -0,0 +1,98 @@
+#include <chrono>
+
+#include "ethyl/provider.hpp"
+#include "service_node_rewards/config.hpp"
+#include "service_node_rewards/reward_rate_pool.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+// NOTE: 40,000,000 SENT with 9 decimals, the principal scripts/deploy-local-test.js funds the pool with
+static const Uint256 PRINCIPAL = Uint256(40'000'000) * Uint256(1'000'000'000);
+
+TEST_CASE( "Uint256 arithmetic matches Solidity checked math", "[reward_rate_pool]" ) {
+    REQUIRE(PRINCIPAL.toString() == "40000000000000000");
+    REQUIRE(Uint256::fromHex("0x" + PRINCIPAL.toHex()) == PRINCIPAL);
+
+    const Uint256 big = Uint256(1) << 200;
+    REQUIRE((big * 145 * 7 / 31'536'000'000).toString() == "51720006180963823239316702299793253474125952520596611");
+    REQUIRE((big + big - big) == big);
+    REQUIRE(big % Uint256(1'000'000'007) == big - big / Uint256(1'000'000'007) * Uint256(1'000'000'007));
+
+    REQUIRE_THROWS_AS(Uint256(1) - Uint256(2), std::overflow_error);
+    REQUIRE_THROWS_AS(big * big, std::overflow_error);
+    REQUIRE_THROWS_AS(Uint256::fromHex(std::string(64, 'f')) + Uint256(1), std::overflow_error);
+    REQUIRE_THROWS_AS(big / Uint256(0), std::domain_error);
+    REQUIRE_THROWS_AS(Uint256::fromHex("0x"), std::runtime_error);
+    REQUIRE_THROWS_AS(Uint256::fromHex(""), std::runtime_error);
+    REQUIRE(Uint256::fromHex("0x0").isZero());
+}
+
+TEST_CASE( "RewardRatePool model reproduces the contract's emission math", "[reward_rate_pool]" ) {
+    RewardRatePoolState state = {};
+    state.balance             = PRINCIPAL;
+    state.lastPaidOutTime     = 1'700'000'000;
+    RewardRatePool pool(state);
+
+    // NOTE: Expected values computed independently with arbitrary precision integers
+    REQUIRE(pool.calculateReleasedAmount(state.lastPaidOutTime + RewardRatePool::SECONDS_PER_YEAR).toString() == "5800000000000000");
+    REQUIRE(pool.calculateReleasedAmount(state.lastPaidOutTime + 86'400).toString() == "15890410958904");
+    REQUIRE(pool.rewardRate(state.lastPaidOutTime + 86'400).toString() == "22061247680");
+    REQUIRE_THROWS_AS(pool.calculateReleasedAmount(state.lastPaidOutTime - 1), std::overflow_error);
+
+    SECTION( "Batch evaluation matches the scalar functions" ) {
+        std::vector<uint64_t> timestamps;
+        for (uint64_t offset = 0; offset <= RewardRatePool::SECONDS_PER_YEAR; offset += 3'600)
+            timestamps.push_back(state.lastPaidOutTime + offset);
+
+        std::vector<Uint256> released = pool.calculateReleasedAmounts(timestamps);
+        std::vector<Uint256> rates    = pool.rewardRates(timestamps);
+        REQUIRE(released.size() == timestamps.size());
+        REQUIRE(rates.size() == timestamps.size());
+        for (size_t index = 0; index < timestamps.size(); index += 97) {
+            REQUIRE(released[index] == pool.calculateReleasedAmount(timestamps[index]));
+            REQUIRE(rates[index] == pool.rewardRate(timestamps[index]));
+        }
+
+        std::vector<Uint256> balances = {Uint256(0), PRINCIPAL, PRINCIPAL * 3, Uint256(1) << 180};
+        std::vector<Uint256> interest = RewardRatePool::calculateInterestAmounts(balances, 86'400);
+        for (size_t index = 0; index < balances.size(); index++)
+            REQUIRE(interest[index] == RewardRatePool::calculateInterestAmount(balances[index], 86'400));
+    }
+
+    SECTION( "Payouts move the released amount into the paid out total" ) {
+        const Uint256 deposited = pool.calculateTotalDeposited();
+        const Uint256 released  = pool.payoutReleased(state.lastPaidOutTime + 86'400);
+        REQUIRE(released.toString() == "15890410958904");
+        REQUIRE(pool.state().totalPaidOut == released);
+        REQUIRE(pool.state().balance == PRINCIPAL - released);
+        REQUIRE(pool.calculateTotalDeposited() == deposited);
+        REQUIRE(pool.calculateReleasedAmount(pool.state().lastPaidOutTime) == released);
+    }
+}
+
+TEST_CASE( "RewardRatePool model agrees with the deployed contract", "[ethereum]" ) {
+    const auto& config   = ethbls::get_config(ethbls::network_type::LOCAL);
+    auto        provider = std::make_shared<Provider>("Client", std::string(config.RPC_URL));
+
+    ServiceNodeRewardsContract rewards_contract(provider->getContractDeployedInLatestBlock(), provider);
+    RewardRatePoolContract     pool_contract(utils::trimAddress(rewards_contract.foundationPool()), provider);
+    RewardRatePool             pool(pool_contract.state());
+    REQUIRE(pool.calculateTotalDeposited() == pool_contract.calculateTotalDeposited());
+
+    const uint64_t start = pool.state().lastPaidOutTime;
+    std::vector<uint64_t> timestamps;
+    for (uint64_t offset = 0; offset <= RewardRatePool::SECONDS_PER_YEAR * 2; offset += RewardRatePool::SECONDS_PER_YEAR / 16 + 7)
+        timestamps.push_back(start + offset);
+
+    std::vector<Uint256> released = pool.calculateReleasedAmounts(timestamps);
+    std::vector<Uint256> rates    = pool.rewardRates(timestamps);
+    for (size_t index = 0; index < timestamps.size(); index++) {
+        REQUIRE(released[index] == pool_contract.calculateReleasedAmount(timestamps[index]));
+        REQUIRE(rates[index] == pool_contract.rewardRate(timestamps[index]));
+    }
+
+    for (const Uint256& balance : {Uint256(1), PRINCIPAL, Uint256(1) << 160})
+        REQUIRE(RewardRatePool::calculateInterestAmount(balance, 12'345) == pool_contract.calculateInterestAmount(balance, 12'345));
+}
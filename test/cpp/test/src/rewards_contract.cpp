@@ -1,6 +1,10 @@
+#include <atomic>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <map>
 #include <chrono>
+#include <thread>
 
 #include "ethyl/provider.hpp"
 #include "ethyl/signer.hpp"
@@ -8,6 +12,11 @@
 #include "service_node_rewards/service_node_rewards_contract.hpp"
 #include "service_node_rewards/erc20_contract.hpp"
 #include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/service_node_rewards_indexer.hpp"
+#include "service_node_rewards/provider_backend.hpp"
+#include "service_node_rewards/rewards_ledger.hpp"
+#include "service_node_rewards/tracing.hpp"
+#include "service_node_rewards/transaction_queue.hpp"
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_all.hpp>
@@ -98,6 +107,43 @@ static void verifyEVMServiceNodesAgainstCPPState(const ServiceNodeList& snl)
     }
 }
 
+// Forwards to `inner`, holding the n-th read (from 1) until `open(n)` is true
+// so a test can keep a read in flight until other callers have joined it
+class GatedProviderBackend : public ProviderBackend {
+public:
+    GatedProviderBackend(std::shared_ptr<ProviderBackend> _inner, std::function<bool(size_t)> _open) : inner(std::move(_inner)), open(std::move(_open)) {}
+
+    std::string callReadFunction(const ReadCallData& callData, std::string_view blockNumber = "latest") override {
+        wait();
+        return inner->callReadFunction(callData, blockNumber);
+    }
+    std::string callReadFunction(const ReadCallData& callData, uint64_t blockNumber) override {
+        wait();
+        return inner->callReadFunction(callData, blockNumber);
+    }
+    std::vector<LogEntry> getLogs(uint64_t fromBlock, uint64_t toBlock, const std::string& address) override { return inner->getLogs(fromBlock, toBlock, address); }
+    uint64_t              getLatestHeight() override { return inner->getLatestHeight(); }
+
+    size_t size() const { return reads; }
+
+private:
+    void wait() {
+        // NOTE: The deadline only turns a broken gate into a failure instead
+        // of a hang, it is never reached when the callers join as expected
+        const size_t read     = ++reads;
+        const auto   deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+        while (!open(read)) {
+            if (std::chrono::steady_clock::now() > deadline)
+                throw std::runtime_error("Read " + std::to_string(read) + " was never let through the gate");
+            std::this_thread::yield();
+        }
+    }
+
+    std::shared_ptr<ProviderBackend> inner;
+    std::function<bool(size_t)>      open;
+    std::atomic<size_t>              reads = 0;
+};
+
 TEST_CASE( "Rewards Contract", "[ethereum]" ) {
     bool success_resetting_to_snapshot = provider->evm_revert(snapshot_id);
     snapshot_id = provider->evm_snapshot();
@@ -462,6 +508,463 @@ TEST_CASE( "Rewards Contract", "[ethereum]" ) {
         resetContractToSnapshot();
     }
 
+    SECTION( "Mirror the service node list and recipients from the contract events" ) {
+        ServiceNodeRewardsIndexer indexer(contract_address, provider, provider->getLatestHeight(), 0 /*confirmations*/);
+        ServiceNodeList snl(3);
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            tx = rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0);
+            hash = signer.sendTransaction(tx, seckey);
+            REQUIRE(provider->transactionSuccessful(hash));
+        }
+        const uint64_t service_node_to_remove = snl.randomServiceNodeID();
+        const auto signers = snl.randomSigners(snl.nodes.size());
+        const auto [pubkey, sig] = snl.removeNodeFromIndices(service_node_to_remove, config.CHAIN_ID, contract_address, signers);
+        tx = rewards_contract.removeBLSPublicKeyWithSignature(service_node_to_remove, pubkey, sig, {});
+        hash = signer.sendTransaction(tx, seckey);
+        REQUIRE(provider->transactionSuccessful(hash));
+        snl.deleteNode(service_node_to_remove);
+
+        const uint64_t recipientAmount = 1;
+        const auto rewardSigners = snl.randomSigners(snl.nodes.size());
+        const auto rewardSig = snl.updateRewardsBalance(senderAddress, recipientAmount, config.CHAIN_ID, contract_address, rewardSigners);
+        tx = rewards_contract.updateRewardsBalance(senderAddress, recipientAmount, rewardSig, {});
+        hash = signer.sendTransaction(tx, seckey);
+        REQUIRE(provider->transactionSuccessful(hash));
+
+        const auto result = indexer.sync();
+        REQUIRE_FALSE(result.reorged);
+        const ServiceNodeRewardsMirror& mirror = indexer.confirmed();
+        REQUIRE(mirror.size() == rewards_contract.serviceNodesLength());
+        REQUIRE(mirror.aggregatePubkey() == rewards_contract.aggregatePubkey());
+        for (uint64_t service_node_id : mirror.serviceNodeIDs()) {
+            const ContractServiceNode& mirrored = mirror.nodes.at(service_node_id);
+            const ContractServiceNode  onchain  = rewards_contract.serviceNodes(service_node_id);
+            REQUIRE(mirrored.next == onchain.next);
+            REQUIRE(mirrored.prev == onchain.prev);
+            REQUIRE(mirrored.recipient == onchain.recipient);
+            REQUIRE(mirrored.pubkey == onchain.pubkey);
+            REQUIRE(mirrored.deposit == onchain.deposit);
+        }
+
+        const Recipient& recipient = mirror.recipients.at(utils::toHexString(signer.secretKeyToAddress(seckey)));
+        REQUIRE(recipient.rewards == recipientAmount);
+        REQUIRE(recipient.claimed == 0);
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Serve reads from the block-versioned cache and invalidate them from events" ) {
+        const std::string cache_path = "rewards_contract_read_cache.txt";
+        auto cache = std::make_shared<ContractReadCache>(contract_address, cache_path);
+        ServiceNodeRewardsIndexer indexer(contract_address, provider, provider->getLatestHeight(), 0 /*confirmations*/);
+        ServiceNodeRewardsContract cached_contract(contract_address, provider);
+        cached_contract.setCache(cache);
+
+        // NOTE: Until it is first advanced the cache has no block to pin to
+        REQUIRE(cached_contract.designatedToken() == rewards_contract.designatedToken());
+        REQUIRE(cache->size() == 0);
+
+        cache->advance(indexer.sync());
+        REQUIRE(cached_contract.serviceNodesLength() == 0);
+        REQUIRE(cached_contract.designatedToken() == rewards_contract.designatedToken());
+        REQUIRE(cached_contract.stakingRequirement() == ServiceNodeRewardsContract::STAKING_REQUIREMENT);
+        const size_t cached_reads = cache->size();
+        REQUIRE(cached_reads == 3);
+
+        ServiceNodeList snl(2);
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            tx = rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0);
+            hash = signer.sendTransaction(tx, seckey);
+            REQUIRE(provider->transactionSuccessful(hash));
+        }
+
+        // NOTE: Adding nodes only invalidates the node list reads
+        cache->advance(indexer.sync());
+        REQUIRE(cache->size() == cached_reads - 1);
+        REQUIRE(cached_contract.serviceNodesLength() == 2);
+        REQUIRE(cached_contract.aggregatePubkeyString() == "0x" + snl.aggregatePubkeyHex());
+
+        // NOTE: A restarted process picks up where the store left off
+        cache->save();
+        auto restored = std::make_shared<ContractReadCache>(contract_address, cache_path);
+        REQUIRE(restored->load());
+        REQUIRE(restored->blockNumber() == cache->blockNumber());
+        REQUIRE(restored->size() == cache->size());
+        std::remove(cache_path.c_str());
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Read whether the contract is active past the cache" ) {
+        // NOTE: Go back to before the contract was started
+        resetContractToSnapshot();
+        snapshot_id = provider->evm_snapshot();
+
+        auto cache = std::make_shared<ContractReadCache>(contract_address);
+        ServiceNodeRewardsContract cached_contract(contract_address, provider);
+        cached_contract.setCache(cache);
+        cache->advance(provider->getLatestHeight());
+        REQUIRE_FALSE(cached_contract.isActive());
+
+        // NOTE: start() emits no event, the cache is not advanced past it
+        tx = rewards_contract.start();
+        hash = signer.sendTransaction(tx, seckey);
+        REQUIRE(provider->transactionSuccessful(hash));
+        REQUIRE(cached_contract.isActive());
+        REQUIRE(cache->size() == 0);
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Add several public keys pipelined through the transaction queue" ) {
+        TransactionQueue queue(provider, signer);
+        ServiceNodeList snl(20);
+        std::vector<TransactionFuture> results;
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            results.push_back(queue.submit(rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0), seckey));
+        }
+        REQUIRE(queue.waitAll());
+        for (size_t index = 0; index < results.size(); index++) {
+            const TransactionResult& result = results[index].get();
+            REQUIRE(result.success);
+            if (index > 0)
+                REQUIRE(result.nonce == results[index - 1].get().nonce + 1);
+        }
+        REQUIRE(rewards_contract.serviceNodesLength() == snl.nodes.size());
+        REQUIRE(rewards_contract.aggregatePubkeyString() == "0x" + snl.aggregatePubkeyHex());
+
+        verifyEVMServiceNodesAgainstCPPState(snl);
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Start over from the node's nonce when the queue's falls behind" ) {
+        TransactionQueue queue(provider, signer);
+        TransactionFuture first = queue.submit(Transaction(senderAddress, 0, 21000), seckey);
+        REQUIRE(queue.waitAll());
+
+        // NOTE: Sent around the queue, the node is now a nonce ahead of it
+        tx = Transaction(senderAddress, 0, 21000);
+        hash = signer.sendTransaction(tx, seckey);
+        REQUIRE(provider->transactionSuccessful(hash));
+
+        REQUIRE_THROWS(queue.submit(Transaction(senderAddress, 0, 21000), seckey));
+        TransactionFuture retried = queue.submit(Transaction(senderAddress, 0, 21000), seckey);
+        REQUIRE(queue.waitAll());
+        REQUIRE(retried.get().success);
+        REQUIRE(retried.get().nonce == first.get().nonce + 2);
+        REQUIRE(queue.inFlight() == 0);
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Track the receipts of pipelined transactions in batches from new heads" ) {
+        auto tracker = std::make_shared<ReceiptTracker>(std::string(config.RPC_URL), "ws://" + std::string(config.RPC_URL), std::chrono::milliseconds(100));
+        TransactionQueue queue(provider, signer);
+        queue.setReceiptTracker(tracker);
+        ServiceNodeList snl(10);
+        std::vector<std::string> hashes;
+        std::vector<TransactionFuture> results;
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            tx = rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0);
+            results.push_back(queue.submit(tx, seckey));
+        }
+        REQUIRE(queue.waitAll());
+        for (const auto& result : results)
+            hashes.push_back(result.get().hash);
+
+        std::vector<TransactionFuture> tracked;
+        for (const auto& submitted : hashes)
+            tracked.push_back(tracker->track(submitted));
+        for (size_t index = 0; index < tracked.size(); index++) {
+            REQUIRE(tracked[index].wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+            REQUIRE(tracked[index].get().success);
+            REQUIRE(tracked[index].get().blockNumber == results[index].get().blockNumber);
+        }
+        REQUIRE(tracker->pending() == 0);
+        // NOTE: The node acknowledged the subscription and an idle automining
+        // chain doesn't drop it for polling
+        REQUIRE(tracker->subscribed());
+
+        auto receipts = tracker->fetchReceipts({hashes.front(), "0x" + std::string(64, '0')});
+        REQUIRE(receipts.size() == 2);
+        REQUIRE(receipts[0].has_value());
+        REQUIRE_FALSE(receipts[1].has_value());
+        REQUIRE(rewards_contract.serviceNodesLength() == snl.nodes.size());
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Seed a large service node list in gas sized chunks" ) {
+        TransactionQueue queue(provider, signer);
+        ServiceNodeList snl(500);
+        // NOTE: A low gas limit forces the list to be split over several calls
+        const size_t transactions = rewards_contract.seedServiceNodeList(queue, seckey, snl, ServiceNodeRewardsContract::STAKING_REQUIREMENT, 10'000'000);
+        REQUIRE(transactions > 1);
+        REQUIRE(rewards_contract.serviceNodesLength() == snl.nodes.size());
+        REQUIRE(rewards_contract.aggregatePubkeyString() == "0x" + snl.aggregatePubkeyHex());
+
+        std::string const STAKING_REQUIREMENT_HEX = utils::padTo32Bytes(utils::decimalToHex(ServiceNodeRewardsContract::STAKING_REQUIREMENT));
+        for (size_t index : {size_t(0), snl.nodes.size() / 2, snl.nodes.size() - 1}) {
+            uint64_t snID = rewards_contract.serviceNodeIDs(snl.nodes[index].getPublicKey());
+            REQUIRE(snID == snl.nodes[index].service_node_id);
+            ContractServiceNode node = rewards_contract.serviceNodes(snID);
+            REQUIRE(utils::BLSPublicKeyToHex(node.pubkey) == snl.nodes[index].getPublicKeyHex());
+            REQUIRE(node.deposit == STAKING_REQUIREMENT_HEX);
+        }
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Record a session against the node and replay it offline" ) {
+        ServiceNodeList snl(3);
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            tx = rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0);
+            hash = signer.sendTransaction(tx, seckey);
+            REQUIRE(hash != "");
+            REQUIRE(provider->transactionSuccessful(hash));
+        }
+
+        const std::string recording_path = "rewards_contract_rpc_recording.txt";
+        uint64_t recorded_balance = 0;
+        auto recorder = std::make_shared<RecordingProviderBackend>(std::make_shared<LiveProviderBackend>(provider));
+        {
+            ServiceNodeRewardsContract recorded_contract(contract_address, recorder);
+            ERC20Contract recorded_erc20(erc20_address, recorder);
+            ServiceNodeRewardsIndexer indexer(contract_address, recorder, 0 /*startBlock*/, 0 /*confirmations*/);
+            indexer.sync();
+            REQUIRE(recorded_contract.serviceNodesLength() == snl.nodes.size());
+            REQUIRE(recorded_contract.aggregatePubkeyString() == "0x" + snl.aggregatePubkeyHex());
+            recorded_balance = recorded_erc20.balanceOf(senderAddress);
+            recorder->save(recording_path);
+        }
+
+        auto replay = std::make_shared<ReplayProviderBackend>(recording_path, std::chrono::microseconds(100));
+        resetContractToSnapshot();
+        {
+            ServiceNodeRewardsContract replayed_contract(contract_address, replay);
+            ERC20Contract replayed_erc20(erc20_address, replay);
+            ServiceNodeRewardsIndexer indexer(contract_address, replay, 0 /*startBlock*/, 0 /*confirmations*/);
+            indexer.sync();
+            REQUIRE(indexer.latest().size() == snl.nodes.size());
+            REQUIRE(replayed_contract.serviceNodesLength() == snl.nodes.size());
+            REQUIRE(replayed_contract.aggregatePubkeyString() == "0x" + snl.aggregatePubkeyHex());
+            REQUIRE(replayed_erc20.balanceOf(senderAddress) == recorded_balance);
+            REQUIRE_THROWS(replayed_contract.designatedToken());
+        }
+        std::remove(recording_path.c_str());
+    }
+
+    SECTION( "Coalesce identical reads made concurrently from several threads" ) {
+        ServiceNodeList snl(3);
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            tx = rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0);
+            hash = signer.sendTransaction(tx, seckey);
+            REQUIRE(hash != "");
+            REQUIRE(provider->transactionSuccessful(hash));
+        }
+
+        const std::string recording_path = "rewards_contract_coalesce_recording.txt";
+        {
+            auto recorder = std::make_shared<RecordingProviderBackend>(std::make_shared<LiveProviderBackend>(provider));
+            ServiceNodeRewardsContract recorded_contract(contract_address, recorder);
+            recorded_contract.aggregatePubkey();
+            recorded_contract.serviceNodes(1);
+            recorder->save(recording_path);
+        }
+
+        // NOTE: The gate holds each distinct read at the node until every
+        // other thread has joined it, so each one reaches the node once.
+        const size_t THREADS = 16;
+        std::unique_ptr<ServiceNodeRewardsContract> shared_contract;
+        auto gated = std::make_shared<GatedProviderBackend>(std::make_shared<ReplayProviderBackend>(recording_path), [&](size_t read) {
+            return shared_contract->coalescedReads() >= read * (THREADS - 1);
+        });
+        shared_contract = std::make_unique<ServiceNodeRewardsContract>(contract_address, gated);
+        std::vector<std::thread> threads;
+        std::vector<std::string> aggregates(THREADS);
+        std::vector<std::string> pubkeys(THREADS);
+        for (size_t index = 0; index < aggregates.size(); index++) {
+            threads.emplace_back([&, index] {
+                aggregates[index] = utils::BLSPublicKeyToHex(shared_contract->aggregatePubkey());
+                pubkeys[index] = utils::BLSPublicKeyToHex(shared_contract->serviceNodes(1).pubkey);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(gated->size() == 2);
+        REQUIRE(shared_contract->coalescedReads() == 2 * (THREADS - 1));
+        for (size_t index = 0; index < aggregates.size(); index++) {
+            REQUIRE(aggregates[index] == snl.aggregatePubkeyHex());
+            REQUIRE(pubkeys[index] == snl.nodes[0].getPublicKeyHex());
+        }
+        std::remove(recording_path.c_str());
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Sign and submit a batch of reward updates for many recipients" ) {
+        ServiceNodeList snl(10);
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            tx = rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0);
+            hash = signer.sendTransaction(tx, seckey);
+            REQUIRE(provider->transactionSuccessful(hash));
+        }
+
+        std::vector<RewardUpdate> updates;
+        for (uint64_t index = 0; index < 24; index++) {
+            std::string address = utils::padToNBytes(utils::decimalToHex(0xA000 + index), 20, utils::PaddingDirection::LEFT);
+            updates.push_back(RewardUpdate{"0x" + address, 1'000 + index * 37});
+        }
+
+        const auto signers = snl.randomSigners(snl.nodes.size() - 2);
+        const auto sigs = snl.updateRewardsBalances(updates, config.CHAIN_ID, contract_address, signers, 4);
+        REQUIRE(sigs.size() == updates.size());
+        REQUIRE(sigs.front() == snl.updateRewardsBalance(updates.front().address, updates.front().amount, config.CHAIN_ID, contract_address, signers));
+        REQUIRE(sigs.back() == snl.updateRewardsBalance(updates.back().address, updates.back().amount, config.CHAIN_ID, contract_address, signers));
+
+        TransactionQueue queue(provider, signer);
+        std::vector<TransactionFuture> results;
+        for (auto& update_tx : rewards_contract.updateRewardsBalances(snl, updates, config.CHAIN_ID, signers))
+            results.push_back(queue.submit(update_tx, seckey));
+        REQUIRE(queue.waitAll());
+        for (auto& result : results)
+            REQUIRE(result.get().success);
+        for (auto& update : updates)
+            REQUIRE(rewards_contract.viewRecipientData(update.address).rewards == update.amount);
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Reconcile the rewards ledger and only resend the totals that changed" ) {
+        ServiceNodeList snl(5);
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            tx = rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0);
+            hash = signer.sendTransaction(tx, seckey);
+            REQUIRE(provider->transactionSuccessful(hash));
+        }
+
+        std::vector<std::string> addresses;
+        std::vector<std::pair<std::string, Uint256>> totals;
+        for (uint64_t index = 0; index < 8; index++) {
+            addresses.push_back("0x" + utils::padToNBytes(utils::decimalToHex(0xB000 + index), 20, utils::PaddingDirection::LEFT));
+            totals.emplace_back(addresses.back(), Uint256(2'000 + index));
+        }
+
+        const auto signers = snl.randomSigners(snl.nodes.size());
+        RewardsLedger ledger;
+        JsonRpcClient rpc(std::string(config.RPC_URL));
+        REQUIRE(ledger.reconcile(rpc, contract_address, addresses, "latest", 3).empty());
+
+        // NOTE: Pay half of them outside the ledger, reconcile picks them up
+        std::vector<RewardUpdate> paid;
+        for (size_t index = 0; index < addresses.size(); index += 2)
+            paid.push_back(RewardUpdate{addresses[index], totals[index].second.low64()});
+        for (auto& update_tx : rewards_contract.updateRewardsBalances(snl, paid, config.CHAIN_ID, signers)) {
+            hash = signer.sendTransaction(update_tx, seckey);
+            REQUIRE(provider->transactionSuccessful(hash));
+        }
+        REQUIRE(ledger.reconcile(rpc, contract_address, addresses, "latest", 3).size() == paid.size());
+        for (const std::string& address : addresses)
+            REQUIRE(ledger.balance(address).rewards == rewards_contract.viewRecipientBalance(address).rewards);
+
+        RewardsLedgerDiff diff = ledger.diff(totals);
+        REQUIRE(diff.unchanged == paid.size());
+        REQUIRE(diff.updates.size() == addresses.size() - paid.size());
+        for (auto& update_tx : rewards_contract.updateRewardsBalances(snl, diff.rewardUpdates(), config.CHAIN_ID, signers)) {
+            hash = signer.sendTransaction(update_tx, seckey);
+            REQUIRE(provider->transactionSuccessful(hash));
+        }
+        for (const RewardsLedgerUpdate& update : diff.updates)
+            ledger.confirm(update.address, update.amount);
+
+        REQUIRE(ledger.reconcile(rpc, contract_address, addresses).empty());
+        REQUIRE(ledger.diff(totals).updates.empty());
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Record per-method call counts and latencies of contract reads and transactions" ) {
+        auto metrics = std::make_shared<ContractMetrics>();
+        rewards_contract.setMetrics(metrics);
+        TransactionQueue queue(provider, signer);
+        queue.setMetrics(metrics);
+
+        ServiceNodeList snl(3);
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            queue.submit(rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0), seckey);
+        }
+        REQUIRE(queue.waitAll());
+        for (int index = 0; index < 5; index++)
+            REQUIRE(rewards_contract.serviceNodesLength() == snl.nodes.size());
+        REQUIRE(rewards_contract.serviceNodes(1).next != 0);
+        rewards_contract.setMetrics(nullptr);
+        REQUIRE(rewards_contract.serviceNodesLength() == snl.nodes.size());
+
+        std::map<std::string, MethodMetricsSnapshot> methods;
+        for (auto& item : metrics->snapshot())
+            methods.emplace(item.method, item);
+
+        const MethodMetricsSnapshot& length = methods.at("serviceNodesLength");
+        REQUIRE(length.calls == 5);
+        REQUIRE(length.errors == 0);
+        REQUIRE(length.network.count == 5);
+        REQUIRE(length.decode.count == 5);
+        REQUIRE(length.bytesSent == 5 * 4);
+        REQUIRE(length.bytesReceived == 5 * 32);
+        REQUIRE(length.network.percentile(0.99) <= length.network.maxNs);
+        REQUIRE(methods.at("serviceNodes").decode.count == 1);
+
+        const MethodMetricsSnapshot& sends = methods.at("sendTransaction");
+        REQUIRE(sends.calls == snl.nodes.size());
+        REQUIRE(sends.receipt.count == snl.nodes.size());
+
+        const std::string text = metrics->prometheus();
+        REQUIRE(text.find("service_node_rewards_calls_total{method=\"serviceNodesLength\"} 5") != std::string::npos);
+        REQUIRE(text.find("service_node_rewards_latency_seconds_count{method=\"sendTransaction\",phase=\"receipt\"} 3") != std::string::npos);
+        REQUIRE(metrics->json().find("\"method\":\"serviceNodesLength\"") != std::string::npos);
+        resetContractToSnapshot();
+    }
+
+    SECTION( "Trace a rewards round from signing to the receipt" ) {
+        ServiceNodeList snl(4);
+        TransactionQueue queue(provider, signer);
+        for(auto& node : snl.nodes) {
+            const auto pubkey = node.getPublicKeyHex();
+            const auto proof_of_possession = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+            queue.submit(rewards_contract.addBLSPublicKey(pubkey, proof_of_possession, "pubkey", "sig", 0), seckey);
+        }
+        REQUIRE(queue.waitAll());
+
+        tracing::start();
+        {
+            tracing::Span round("test", "rewards round");
+            const auto signers = snl.randomSigners(snl.nodes.size() - 1);
+            const auto sig = snl.updateRewardsBalance(senderAddress, 1, config.CHAIN_ID, contract_address, signers);
+            TransactionFuture result = queue.submit(rewards_contract.updateRewardsBalance(senderAddress, 1, sig, snl.findNonSigners(signers)), seckey);
+            REQUIRE(queue.waitAll());
+            REQUIRE(result.get().success);
+        }
+        tracing::stop();
+
+        const std::string trace = tracing::json();
+        REQUIRE(trace.find("\"name\":\"rewards round\"") != std::string::npos);
+#if defined(SERVICE_NODE_REWARDS_TRACING)
+        for (const char* span : {"buildTag", "signHash", "SignatureToHex", "encode updateRewardsBalance", "eth_sendRawTransaction", "poll receipts"})
+            REQUIRE(trace.find("\"name\":\"" + std::string(span) + "\"") != std::string::npos);
+#endif
+        resetContractToSnapshot();
+    }
+
     SECTION( "Add LOTS of public keys to the smart contract and update the rewards of one of them and successfully claim the rewards" ) {
         SUCCEED("Complex test case runs too long on github worker");
         return;
@@ -0,0 +1,89 @@
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "service_node_rewards/rewards_ledger.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+static std::string address(uint64_t index) {
+    std::string hex = std::to_string(index);
+    return "0x" + std::string(40 - hex.size(), '0') + hex;
+}
+
+TEST_CASE( "Rewards ledger sends only the recipients the contract is behind on", "[rewards_ledger]" ) {
+    RewardsLedger ledger;
+    for (uint64_t index = 0; index < 10; index++)
+        ledger.set(address(index), RecipientBalance{Uint256(1'000 * index), Uint256(0)});
+
+    std::vector<std::pair<std::string, Uint256>> totals;
+    for (uint64_t index = 0; index < 10; index++)
+        totals.emplace_back(address(index), Uint256(1'000 * index));
+    totals[3].second = 3'500; // Owed 500
+    totals[7].second = 9'000; // Owed 2'000
+    totals[5].second = 4'000; // Below the contract
+    totals.emplace_back(address(42), Uint256(10)); // Never paid, owed 10
+
+    RewardsLedgerDiff diff = ledger.diff(totals);
+    REQUIRE(diff.unchanged == 7);
+    REQUIRE(diff.updates.size() == 3);
+    REQUIRE(diff.updates[0].address == address(7));
+    REQUIRE(diff.updates[0].onChain == Uint256(7'000));
+    REQUIRE(diff.updates[1].address == address(3));
+    REQUIRE(diff.updates[2].address == address(42));
+    REQUIRE(diff.updates[2].onChain.isZero());
+    REQUIRE(diff.regressed.size() == 1);
+    REQUIRE(diff.regressed[0].address == address(5));
+
+    std::vector<RewardUpdate> updates = diff.rewardUpdates();
+    REQUIRE(updates.size() == 3);
+    REQUIRE(updates[0].amount == 9'000);
+
+    // NOTE: The limit keeps the ones owed the most
+    RewardsLedgerDiff limited = ledger.diff(totals, 2);
+    REQUIRE(limited.updates.size() == 2);
+    REQUIRE(limited.updates[1].address == address(3));
+
+    SECTION( "Confirmed updates drop out of the next diff" ) {
+        for (const RewardsLedgerUpdate& update : diff.updates)
+            ledger.confirm(update.address, update.amount);
+        ledger.confirm(address(7), Uint256(1)); // NOTE: Totals never go down
+        REQUIRE(ledger.balance(address(7)).rewards == Uint256(9'000));
+
+        diff = ledger.diff(totals);
+        REQUIRE(diff.updates.empty());
+        REQUIRE(diff.unchanged == totals.size() - 1);
+    }
+
+    SECTION( "Addresses are matched regardless of case and prefix" ) {
+        const std::string upper = "0xABCDEF0000000000000000000000000000000001";
+        ledger.set(upper, RecipientBalance{Uint256(5), Uint256(1)});
+        REQUIRE(ledger.balance("abcdef0000000000000000000000000000000001").claimed == Uint256(1));
+        REQUIRE(ledger.diff({{"0xabcdef0000000000000000000000000000000001", Uint256(5)}}).unchanged == 1);
+
+        REQUIRE_THROWS_AS(ledger.diff({{upper, Uint256(6)}, {"0xabcdef0000000000000000000000000000000001", Uint256(6)}}), std::invalid_argument);
+        REQUIRE_THROWS_AS(ledger.set("0x1234", RecipientBalance{}), std::invalid_argument);
+    }
+
+    SECTION( "Totals past 64 bits are kept whole" ) {
+        const Uint256 huge = Uint256(1) << 200;
+        ledger.set(address(1), RecipientBalance{huge, Uint256(0)});
+        diff = ledger.diff({{address(1), huge + Uint256(1)}});
+        REQUIRE(diff.updates.size() == 1);
+        REQUIRE(diff.updates[0].onChain == huge);
+        REQUIRE_THROWS_AS(diff.rewardUpdates(), std::overflow_error);
+    }
+}
+
+TEST_CASE( "Recipient balances decode both uint256 words", "[rewards_ledger]" ) {
+    const std::string rewards = "00000000000000000000000000000000000000000000000100000000000000ff";
+    const std::string claimed = std::string(62, '0') + "2a";
+    RecipientBalance  balance = ServiceNodeRewardsContract::decodeRecipientBalance("0x" + rewards + claimed);
+    REQUIRE(balance.rewards == Uint256::fromHex(rewards));
+    REQUIRE_FALSE(balance.rewards.fitsUint64());
+    REQUIRE(balance.claimed == Uint256(42));
+    REQUIRE_THROWS_AS(ServiceNodeRewardsContract::decodeRecipientBalance("0x" + rewards), std::runtime_error);
+}
@@ -0,0 +1,452 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <variant>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "service_node_rewards/service_node_contribution_contract.hpp"
+#include "service_node_rewards/service_node_contribution_events.hpp"
+#include "service_node_rewards/service_node_contribution_scanner.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+static const std::string CONTRACT    = "0x5fbdb2315678afecb367f032d93f642f64180aa3";
+static const std::string CONTRIBUTOR = "f39fd6e51aad88f6f4ce6ab8827279cfffb92266";
+
+static std::string word(const std::string& hex) {
+    return utils::padTo32Bytes(hex, utils::PaddingDirection::LEFT);
+}
+
+static LogEntry makeLog(const std::string& address, std::vector<std::string> topics, std::string data) {
+    LogEntry log    = {};
+    log.address     = address;
+    log.topics      = std::move(topics);
+    log.data        = "0x" + data;
+    log.blockNumber = 7;
+    log.logIndex    = 2;
+    log.removed     = false;
+    return log;
+}
+
+TEST_CASE( "Contribution events decode into typed records", "[service_node_contribution]" ) {
+    SECTION( "NewContribution and StakeWithdrawn carry the emitting contract, contributor and full amount" ) {
+        // NOTE: 2^64 + 1, more than a uint64_t holds
+        const std::string amount = word("10000000000000001");
+        std::optional<ServiceNodeContributionEvent> contributed = contribution_events::decode(makeLog(CONTRACT, {contribution_events::newContributionTopic(), "0x" + word(CONTRIBUTOR)}, amount));
+        REQUIRE(contribution_events::location(*contributed).blockNumber == 7);
+        REQUIRE(contribution_events::location(*contributed).logIndex == 2);
+        const NewContributionEvent& contribution = std::get<NewContributionEvent>(*contributed);
+        REQUIRE(utils::toHexString(contribution.contract) == CONTRACT.substr(2));
+        REQUIRE(utils::toHexString(contribution.contributor) == CONTRIBUTOR);
+        REQUIRE(contribution.amount == (Uint256(1) << 64) + 1);
+
+        std::optional<ServiceNodeContributionEvent> withdrawn = contribution_events::decode(makeLog(CONTRACT, {contribution_events::stakeWithdrawnTopic(), "0x" + word(CONTRIBUTOR)}, amount));
+        const StakeWithdrawnEvent& withdrawal = std::get<StakeWithdrawnEvent>(*withdrawn);
+        REQUIRE(utils::toHexString(withdrawal.contributor) == CONTRIBUTOR);
+        REQUIRE(withdrawal.amount == (Uint256(1) << 64) + 1);
+    }
+
+    SECTION( "Factory deployments, Finalized and Cancelled carry the service node key" ) {
+        const std::string pubkey = word("abcdef");
+        std::optional<ServiceNodeContributionEvent> deployed = contribution_events::decode(
+                makeLog(CONTRACT, {contribution_events::newServiceNodeContributionContractTopic(), "0x" + word(CONTRIBUTOR)}, pubkey));
+        REQUIRE(std::holds_alternative<NewServiceNodeContributionContractEvent>(*deployed));
+        REQUIRE(utils::toHexString(std::get<NewServiceNodeContributionContractEvent>(*deployed).contributionContract) == CONTRIBUTOR);
+        REQUIRE(std::get<NewServiceNodeContributionContractEvent>(*deployed).serviceNodePubkey == pubkey);
+
+        std::optional<ServiceNodeContributionEvent> finalized = contribution_events::decode(makeLog(CONTRACT, {contribution_events::finalizedTopic(), "0x" + pubkey}, ""));
+        REQUIRE(std::get<ContributionFinalizedEvent>(*finalized).serviceNodePubkey == pubkey);
+
+        std::optional<ServiceNodeContributionEvent> cancelled = contribution_events::decode(makeLog(CONTRACT, {contribution_events::cancelledTopic(), "0x" + pubkey}, ""));
+        REQUIRE(std::get<ContributionCancelledEvent>(*cancelled).serviceNodePubkey == pubkey);
+    }
+
+    SECTION( "Unknown topics are skipped and malformed logs throw" ) {
+        REQUIRE_FALSE(contribution_events::decode(makeLog(CONTRACT, {"0x" + word("1")}, "")).has_value());
+        REQUIRE_THROWS_AS(contribution_events::decode(makeLog(CONTRACT, {contribution_events::newContributionTopic(), "0x" + word(CONTRIBUTOR)}, "")), std::runtime_error);
+        REQUIRE_THROWS_AS(contribution_events::decode(makeLog(CONTRACT, {contribution_events::finalizedTopic()}, "")), std::runtime_error);
+    }
+}
+
+TEST_CASE( "Contribution contract calls are ABI encoded", "[service_node_contribution]" ) {
+    ServiceNodeContributionContract contract(CONTRACT, std::shared_ptr<ProviderBackend>{});
+
+    Transaction contribute = contract.contributeFunds(Uint256(1'000));
+    REQUIRE(contribute.data == utils::getFunctionSignature("contributeFunds(uint256)") + word("3e8"));
+
+    Transaction withdraw = contract.withdrawStake();
+    REQUIRE(withdraw.data == utils::getFunctionSignature("withdrawStake()"));
+
+    REQUIRE(contract.contributionsCall("0x" + CONTRIBUTOR).data == utils::getFunctionSignature("contributions(address)") + word(CONTRIBUTOR));
+    REQUIRE(contract.contributionTimestampCall(CONTRIBUTOR).data == utils::getFunctionSignature("contributionTimestamp(address)") + word(CONTRIBUTOR));
+
+    REQUIRE(ServiceNodeContributionContract::decodeAddress("0x" + word(CONTRIBUTOR)) == CONTRIBUTOR);
+    REQUIRE(ServiceNodeContributionContract::decodeUint256("0x" + word("3e8")) == Uint256(1'000));
+    REQUIRE_THROWS_AS(ServiceNodeContributionContract::decodeUint256("0x"), std::runtime_error);
+}
+
+TEST_CASE( "Contribution scanner parses eth_getLogs results", "[service_node_contribution]" ) {
+    nlohmann::json log = {
+        {"address", CONTRACT},
+        {"topics", {contribution_events::newContributionTopic(), "0x" + word(CONTRIBUTOR)}},
+        {"data", "0x" + word("3e8")},
+        {"blockNumber", "0x1b"},
+        {"logIndex", "0x3"},
+        {"blockHash", "0x" + word("1")},
+        {"transactionHash", "0x" + word("2")},
+        {"removed", false},
+    };
+
+    LogEntry entry = ServiceNodeContributionScanner::logFromJson(log);
+    REQUIRE(entry.blockNumber == 27);
+    REQUIRE(entry.logIndex == 3);
+    REQUIRE(entry.topics.size() == 2);
+    REQUIRE_FALSE(entry.removed);
+
+    std::optional<ServiceNodeContributionEvent> event = contribution_events::decode(entry);
+    REQUIRE(std::get<NewContributionEvent>(*event).amount == Uint256(1'000));
+
+    REQUIRE_THROWS_AS(ServiceNodeContributionScanner("http://127.0.0.1:1", CONTRACT, 0, 12, 0), std::invalid_argument);
+}
+
+// Serves JSON-RPC over HTTP on a loopback port from `handler`, one request
+// per connection. A request `handler` throws for is answered with an error.
+class StubRpcServer {
+public:
+    using Handler = std::function<nlohmann::json(const std::string& method, const nlohmann::json& params)>;
+
+    explicit StubRpcServer(Handler _handler) : handler(std::move(_handler)) {
+        sockaddr_in address     = {};
+        address.sin_family      = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t size          = sizeof(address);
+        listenFd                = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<const sockaddr*>(&address), size) != 0 || ::listen(listenFd, SOMAXCONN) != 0 ||
+            ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &size) != 0)
+            throw std::runtime_error("Failed to listen for the stub RPC server");
+        endpoint = "http://127.0.0.1:" + std::to_string(ntohs(address.sin_port));
+        thread   = std::thread([this] { serve(); });
+    }
+
+    ~StubRpcServer() {
+        // NOTE: Shutting the socket down wakes the thread blocked in accept
+        ::shutdown(listenFd, SHUT_RDWR);
+        thread.join();
+        ::close(listenFd);
+    }
+
+    const std::string& url() const { return endpoint; }
+
+private:
+    void serve() {
+        for (;;) {
+            const int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED)
+                    continue;
+                return;
+            }
+            respond(fd);
+            ::close(fd);
+        }
+    }
+
+    void respond(int fd) {
+        std::string request;
+        char        buffer[4096];
+        size_t      headerEnd = std::string::npos;
+        size_t      length    = 0;
+        for (;;) {
+            if (headerEnd == std::string::npos && (headerEnd = request.find("\r\n\r\n")) != std::string::npos) {
+                std::string headers = request.substr(0, headerEnd);
+                std::transform(headers.begin(), headers.end(), headers.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+                const size_t field = headers.find("content-length:");
+                length             = field == std::string::npos ? 0 : std::stoull(headers.substr(field + 15));
+                if (headers.find("expect: 100-continue") != std::string::npos)
+                    send(fd, "HTTP/1.1 100 Continue\r\n\r\n");
+            }
+            if (headerEnd != std::string::npos && request.size() >= headerEnd + 4 + length)
+                break;
+            const ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+                return;
+            request.append(buffer, static_cast<size_t>(received));
+        }
+
+        const nlohmann::json body = nlohmann::json::parse(request.substr(headerEnd + 4, length));
+        nlohmann::json       answer;
+        if (body.is_array()) {
+            answer = nlohmann::json::array();
+            for (const nlohmann::json& item : body)
+                answer.push_back(call(item));
+        } else {
+            answer = call(body);
+        }
+
+        const std::string text = answer.dump();
+        send(fd, "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nConnection: close\r\nContent-Length: " + std::to_string(text.size()) + "\r\n\r\n" + text);
+    }
+
+    nlohmann::json call(const nlohmann::json& request) {
+        nlohmann::json result = {{"jsonrpc", "2.0"}, {"id", request.at("id")}};
+        try {
+            result["result"] = handler(request.at("method").get<std::string>(), request.at("params"));
+        } catch (const std::exception& e) {
+            result["error"] = {{"code", -32000}, {"message", e.what()}};
+        }
+        return result;
+    }
+
+    static void send(int fd, const std::string& data) {
+        for (size_t sent = 0; sent < data.size();) {
+            const ssize_t count = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (count <= 0)
+                return;
+            sent += static_cast<size_t>(count);
+        }
+    }
+
+    Handler     handler;
+    int         listenFd = -1;
+    std::string endpoint;
+    std::thread thread;
+};
+
+// A factory and its contribution contracts as the stub RPC server sees them.
+// Every change is mined in a block of its own with the log it emits, block N
+// has timestamp 1'000 + N. Reads answer the latest state whatever the block.
+class StubContributionChain {
+public:
+    struct Contract {
+        std::string                                        pubkey; // 32 byte hex
+        std::string                                        operatorAddress;
+        bool                                               finalized = false;
+        bool                                               cancelled = false;
+        Uint256                                            stakingRequirement = 100;
+        Uint256                                            operatorContribution;
+        Uint256                                            totalContribution;
+        uint64_t                                           numberContributors = 0;
+        std::map<std::string, std::pair<Uint256, uint64_t>> contributions; // Amount and timestamp
+    };
+
+    static constexpr inline const char* FACTORY = "fac7000000000000000000000000000000000001";
+
+    uint64_t                        head = 0;
+    std::map<std::string, Contract> contracts;
+    std::atomic<int>                failCalls = 0; // eth_calls to answer with an error
+
+    std::string deploy(const std::string& operatorAddress, bool viaFactory = true) {
+        const std::string address = word(std::to_string(contracts.size() + 1)).substr(24);
+        Contract&         contract = contracts[address];
+        contract.pubkey            = word("abc" + std::to_string(contracts.size()));
+        contract.operatorAddress   = operatorAddress;
+        if (viaFactory)
+            emit(FACTORY, {contribution_events::newServiceNodeContributionContractTopic(), "0x" + word(address)}, contract.pubkey);
+        else
+            head++;
+        return address;
+    }
+
+    void contribute(const std::string& address, const std::string& contributor, uint64_t amount) {
+        Contract& contract = contracts.at(address);
+        if (contributor == contract.operatorAddress)
+            contract.operatorContribution = amount;
+        auto& [balance, timestamp] = contract.contributions[contributor];
+        if (balance.isZero())
+            contract.numberContributors++;
+        balance                    += amount;
+        contract.totalContribution += amount;
+        emit(address, {contribution_events::newContributionTopic(), "0x" + word(contributor)}, Uint256(amount).toHex());
+        timestamp = 1'000 + head;
+    }
+
+    void withdraw(const std::string& address, const std::string& contributor) {
+        Contract& contract         = contracts.at(address);
+        Uint256&  balance          = contract.contributions.at(contributor).first;
+        contract.totalContribution -= balance;
+        contract.numberContributors--;
+        emit(address, {contribution_events::stakeWithdrawnTopic(), "0x" + word(contributor)}, balance.toHex());
+        balance = 0;
+    }
+
+    // NOTE: Like the contract, the operator is refunded without an event
+    void cancel(const std::string& address) {
+        Contract& contract = contracts.at(address);
+        contract.cancelled = true;
+        contract.totalContribution -= contract.operatorContribution;
+        contract.contributions.at(contract.operatorAddress).first = 0;
+        emit(address, {contribution_events::cancelledTopic(), "0x" + contract.pubkey}, "");
+    }
+
+    void mine(uint64_t blocks) { head += blocks; }
+
+    nlohmann::json answer(const std::string& method, const nlohmann::json& params) {
+        if (method == "eth_blockNumber")
+            return quantity(head);
+        if (method == "eth_getLogs")
+            return logs(params.at(0));
+        if (method == "eth_call")
+            return call(params.at(0));
+        throw std::runtime_error("Method '" + method + "' is not stubbed");
+    }
+
+private:
+    static std::string quantity(uint64_t value) { return "0x" + utils::decimalToHex(value); }
+    static uint64_t    fromQuantity(const nlohmann::json& value) { return utils::fromHexStringToUint64(utils::trimPrefix(value.get<std::string>(), "0x")); }
+
+    void emit(const std::string& address, std::vector<std::string> topics, const std::string& data) {
+        head++;
+        emitted.push_back({{"address", "0x" + address}, {"topics", std::move(topics)}, {"data", "0x" + data}, {"blockNumber", quantity(head)}, {"logIndex", "0x0"}, {"removed", false}});
+    }
+
+    nlohmann::json logs(const nlohmann::json& filter) {
+        const uint64_t from = fromQuantity(filter.at("fromBlock"));
+        const uint64_t to   = fromQuantity(filter.at("toBlock"));
+        nlohmann::json result = nlohmann::json::array();
+        for (const nlohmann::json& log : emitted) {
+            const uint64_t block    = fromQuantity(log["blockNumber"]);
+            const auto&    accepts  = filter.at("address");
+            if (block >= from && block <= to && std::find(accepts.begin(), accepts.end(), log["address"]) != accepts.end())
+                result.push_back(log);
+        }
+        return result;
+    }
+
+    nlohmann::json call(const nlohmann::json& request) {
+        if (failCalls > 0 && failCalls-- > 0)
+            throw std::runtime_error("eth_call failed");
+
+        const std::string               address = std::string(utils::trimPrefix(request.at("to").get<std::string>(), "0x"));
+        const std::string               data    = request.at("data").get<std::string>();
+        const Contract&                 state   = contracts.at(address);
+        ServiceNodeContributionContract binding(address, std::shared_ptr<ProviderBackend>{});
+
+        auto flag = [](bool value) { return Uint256(value ? 1 : 0).toHex(); };
+        const std::vector<std::pair<std::string, std::string>> fields = {
+            {"operator()", word(state.operatorAddress)},
+            {"serviceNodeParams()", state.pubkey},
+            {"finalized()", flag(state.finalized)},
+            {"cancelled()", flag(state.cancelled)},
+            {"stakingRequirement()", state.stakingRequirement.toHex()},
+            {"operatorContribution()", state.operatorContribution.toHex()},
+            {"totalContribution()", state.totalContribution.toHex()},
+            {"numberContributors()", Uint256(state.numberContributors).toHex()},
+        };
+        for (const auto& [signature, result] : fields) {
+            if (data == binding.readCall(signature).data)
+                return "0x" + result;
+        }
+        for (const auto& [contributor, balance] : state.contributions) {
+            if (data == binding.contributionsCall(contributor).data)
+                return "0x" + balance.first.toHex();
+            if (data == binding.contributionTimestampCall(contributor).data)
+                return "0x" + Uint256(balance.second).toHex();
+        }
+        return "0x" + Uint256().toHex(); // NOTE: Mappings read zero for anyone else
+    }
+
+    std::vector<nlohmann::json> emitted;
+};
+
+TEST_CASE( "Contribution scanner follows contracts deployed by the factory", "[service_node_contribution]" ) {
+    const std::string OPERATOR = "0000000000000000000000000000000000000a01";
+    const std::string ALICE    = "0000000000000000000000000000000000000a02";
+    const std::string BOB      = "0000000000000000000000000000000000000a03";
+
+    StubContributionChain chain;
+    StubRpcServer         server([&](const std::string& method, const nlohmann::json& params) { return chain.answer(method, params); });
+
+    // NOTE: Small chunks and batches so every scan is split over several
+    ServiceNodeContributionScanner scanner(server.url(), StubContributionChain::FACTORY, 0, 2 /*confirmations*/, 3 /*chunkSize*/, 4 /*batchSize*/);
+
+    // NOTE: Discover a contract and the contributions made to it
+    const std::string first = chain.deploy(OPERATOR);
+    chain.contribute(first, OPERATOR, 40);
+    chain.contribute(first, ALICE, 20);
+    chain.contribute(first, BOB, 25);
+    chain.mine(2);
+
+    ContributionScanResult result = scanner.sync();
+    REQUIRE(result.height == chain.head - 2);
+    REQUIRE(scanner.height() == result.height);
+    REQUIRE(result.discovered == std::vector<std::string>{first});
+    REQUIRE(result.events.size() == 4);
+    REQUIRE(result.refreshed == std::vector<std::string>{first});
+    {
+        const ContributionContractState& state = scanner.contracts().at(first);
+        REQUIRE(state.operatorAddress == OPERATOR);
+        REQUIRE(state.serviceNodePubkey == chain.contracts.at(first).pubkey);
+        REQUIRE(state.deployedBlock == 1);
+        REQUIRE(state.totalContribution == Uint256(85));
+        REQUIRE(state.numberContributors == 3);
+        REQUIRE(state.contributors.size() == 3);
+        REQUIRE(state.contributors[1].address == ALICE);
+        REQUIRE(state.contributors[1].amount == Uint256(20));
+        REQUIRE(state.contributors[1].timestamp == 1'003);
+    }
+
+    // NOTE: A scan that fails to refresh leaves the scanner where it was, the
+    // next scans the same blocks and reports the same changes
+    const uint64_t before = scanner.height();
+    chain.withdraw(first, ALICE);
+    const std::string second = chain.deploy(OPERATOR);
+    chain.contribute(second, OPERATOR, 50);
+    chain.cancel(second);
+    chain.mine(2);
+    chain.failCalls = 1;
+    REQUIRE_THROWS_AS(scanner.sync(), std::runtime_error);
+    REQUIRE(scanner.height() == before);
+
+    result = scanner.sync();
+    REQUIRE(scanner.height() == chain.head - 2);
+    REQUIRE(result.discovered == std::vector<std::string>{second});
+    REQUIRE(result.events.size() == 4);
+    REQUIRE(std::holds_alternative<StakeWithdrawnEvent>(result.events[0]));
+    REQUIRE(std::holds_alternative<ContributionCancelledEvent>(result.events[3]));
+    REQUIRE(result.refreshed.size() == 2);
+    {
+        const ContributionContractState& state = scanner.contracts().at(first);
+        REQUIRE(state.totalContribution == Uint256(65));
+        REQUIRE(state.contributors.size() == 2);
+        REQUIRE(state.contributors[1].address == BOB);
+    }
+    {
+        // NOTE: The operator's refund on cancel has no event, it is read back
+        const ContributionContractState& state = scanner.contracts().at(second);
+        REQUIRE(state.cancelled);
+        REQUIRE(state.totalContribution.isZero());
+        REQUIRE(state.contributors.empty());
+    }
+
+    // NOTE: Nothing new, nothing re-read
+    REQUIRE(scanner.sync().refreshed.empty());
+
+    // NOTE: A contract not from the factory catches up on the blocks already
+    // scanned once tracked
+    const std::string direct = chain.deploy(OPERATOR, false /*viaFactory*/);
+    chain.contribute(direct, OPERATOR, 30);
+    chain.contribute(direct, BOB, 30);
+    REQUIRE(scanner.syncTo(chain.head).refreshed.empty());
+    scanner.track("0x" + direct);
+    chain.mine(3);
+    result = scanner.sync();
+    REQUIRE(result.discovered.empty());
+    REQUIRE(result.events.size() == 2);
+    REQUIRE(result.refreshed == std::vector<std::string>{direct});
+    REQUIRE(scanner.contracts().at(direct).deployedBlock == 0);
+    REQUIRE(scanner.contracts().at(direct).contributors.size() == 2);
+
+    result = scanner.refreshAll(scanner.height());
+    REQUIRE(result.refreshed.size() == 3);
+    REQUIRE(result.events.empty());
+    REQUIRE(scanner.contracts().at(first).blockNumber == scanner.height());
+}
@@ -0,0 +1,43 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+TEST_CASE( "Service node list round trips through its secret keys", "[service_node_list]" ) {
+    ServiceNodeList                snl(5);
+    const std::vector<std::string> keys = snl.secretKeys();
+    REQUIRE(keys.size() == snl.nodes.size());
+
+    ServiceNodeList restored(keys);
+    REQUIRE(restored.secretKeys() == keys);
+    REQUIRE(restored.nodes.size() == snl.nodes.size());
+    REQUIRE(restored.next_service_node_id == snl.next_service_node_id);
+    for (size_t index = 0; index < snl.nodes.size(); index++) {
+        REQUIRE(restored.nodes[index].service_node_id == snl.nodes[index].service_node_id);
+        REQUIRE(restored.nodes[index].getPublicKeyHex() == snl.nodes[index].getPublicKeyHex());
+    }
+    REQUIRE(restored.aggregatePubkeyHex() == snl.aggregatePubkeyHex());
+
+    const std::array<unsigned char, 32> hash = utils::hash("0x1234");
+    REQUIRE(utils::SignatureToHex(restored.nodes[2].signHash(hash)) == utils::SignatureToHex(snl.nodes[2].signHash(hash)));
+
+    SECTION( "Restored nodes are numbered from 1 in list order" ) {
+        snl.deleteNode(snl.nodes[1].service_node_id);
+        ServiceNodeList shrunk(snl.secretKeys());
+        REQUIRE(shrunk.nodes.size() == 4);
+        REQUIRE(shrunk.nodes[1].service_node_id == 2);
+        REQUIRE(shrunk.nodes[1].getPublicKeyHex() == snl.nodes[1].getPublicKeyHex());
+        REQUIRE(shrunk.next_service_node_id == 5);
+    }
+
+    SECTION( "An empty list restores empty and a bad key throws" ) {
+        REQUIRE(ServiceNodeList(std::vector<std::string>{}).nodes.empty());
+        REQUIRE_THROWS_AS(ServiceNodeList(std::vector<std::string>{keys[0], "not hex"}), std::invalid_argument);
+    }
+}
@@ -0,0 +1,252 @@
+#include <chrono>
+#include <limits>
+#include <random>
+
+#include "ethyl/provider.hpp"
+#include "ethyl/signer.hpp"
+#include "service_node_rewards/config.hpp"
+#include "service_node_rewards/erc20_contract.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+#include "service_node_rewards/service_node_rewards_model.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+static const std::string OPERATOR_ADDRESS = "0xf39Fd6e51aad88F6F4ce6aB8827279cffFb92266";
+static const std::string OTHER_ADDRESS    = "0x70997970C51812dc3A010C7d01b50e0d17dc79C8";
+
+TEST_CASE( "ServiceNodeRewards model follows the contract's state machine", "[service_node_rewards_model]" ) {
+    ServiceNodeList         snl(6);
+    ServiceNodeRewardsModel model;
+    REQUIRE(model.addBLSPublicKey(OPERATOR_ADDRESS, snl.nodes[0].getPublicKeyHex()).error == ServiceNodeRewardsError::ContractNotActive);
+
+    model.start();
+    for (const ServiceNode& node : snl.nodes) {
+        const ServiceNodeRewardsOutcome outcome = model.addBLSPublicKey(OPERATOR_ADDRESS, node.getPublicKeyHex());
+        REQUIRE(outcome);
+        REQUIRE(outcome.serviceNodeID == node.service_node_id);
+    }
+    REQUIRE(model.serviceNodesLength() == 6);
+    REQUIRE(model.blsNonSignerThreshold() == 2);
+    REQUIRE(utils::BLSPublicKeyToHex(model.aggregatePubkey()) == snl.aggregatePubkeyHex());
+    REQUIRE(model.addBLSPublicKey(OTHER_ADDRESS, snl.nodes[3].getPublicKeyHex()).error == ServiceNodeRewardsError::BLSPubkeyAlreadyExists);
+
+    SECTION( "Reward balances only increase and claims pay out the difference" ) {
+        REQUIRE(model.updateRewardsBalance(OTHER_ADDRESS, 10, {1, 2, 3}).error == ServiceNodeRewardsError::InsufficientBLSSignatures);
+        REQUIRE(model.updateRewardsBalance("0x" + std::string(40, '0'), 10, {}).error == ServiceNodeRewardsError::NullRecipient);
+        REQUIRE(model.updateRewardsBalance(OTHER_ADDRESS, 10, {1, 2}));
+        REQUIRE(model.updateRewardsBalance(OTHER_ADDRESS, 10, {}).error == ServiceNodeRewardsError::RecipientRewardsTooLow);
+        REQUIRE(model.claimRewards(OTHER_ADDRESS).amount == 10);
+
+        REQUIRE(model.updateRewardsBalance(OTHER_ADDRESS, 25, {}));
+        REQUIRE(model.claimRewards(OTHER_ADDRESS).amount == 15);
+        REQUIRE(model.claimRewards(OTHER_ADDRESS).amount == 0);
+        REQUIRE(model.viewRecipientData(OTHER_ADDRESS).rewards == 25);
+        REQUIRE(model.viewRecipientData(OTHER_ADDRESS).claimed == 25);
+    }
+
+    SECTION( "Removal after the wait time needs a leave request older than the wait" ) {
+        const uint64_t id        = snl.nodes[2].service_node_id;
+        const uint64_t timestamp = 1'700'000'000;
+        REQUIRE(model.removeBLSPublicKeyAfterWaitTime(id, timestamp).error == ServiceNodeRewardsError::LeaveRequestTooEarly);
+        REQUIRE(model.initiateRemoveBLSPublicKey(OTHER_ADDRESS, id, timestamp).error == ServiceNodeRewardsError::RecipientAddressDoesNotMatch);
+        REQUIRE(model.initiateRemoveBLSPublicKey(OPERATOR_ADDRESS, id, timestamp));
+        REQUIRE(model.initiateRemoveBLSPublicKey(OPERATOR_ADDRESS, id, timestamp + 1).error == ServiceNodeRewardsError::EarlierLeaveRequestMade);
+        REQUIRE(model.removeBLSPublicKeyAfterWaitTime(id, timestamp + ServiceNodeRewardsModel::MAX_SERVICE_NODE_REMOVAL_WAIT_TIME).error == ServiceNodeRewardsError::LeaveRequestTooEarly);
+
+        const ServiceNodeRewardsOutcome removed = model.removeBLSPublicKeyAfterWaitTime(id, timestamp + ServiceNodeRewardsModel::MAX_SERVICE_NODE_REMOVAL_WAIT_TIME + 1);
+        REQUIRE(removed);
+        REQUIRE(removed.amount == ServiceNodeRewardsContract::STAKING_REQUIREMENT);
+        REQUIRE(model.serviceNodesLength() == 5);
+        REQUIRE(model.blsNonSignerThreshold() == 1);
+        REQUIRE(model.serviceNodeIDsInOrder() == std::vector<uint64_t>{1, 2, 4, 5, 6});
+        REQUIRE(model.serviceNodeIDs(snl.nodes[2].getPublicKeyHex()) == 0);
+
+        snl.deleteNode(id);
+        REQUIRE(utils::BLSPublicKeyToHex(model.aggregatePubkey()) == snl.aggregatePubkeyHex());
+    }
+
+    SECTION( "Signed removals and liquidations check the key and the non-signer threshold" ) {
+        const uint64_t    id     = snl.nodes[0].service_node_id;
+        const std::string pubkey = snl.nodes[0].getPublicKeyHex();
+        REQUIRE(model.removeBLSPublicKeyWithSignature(id, snl.nodes[1].getPublicKeyHex(), {}).error == ServiceNodeRewardsError::BLSPubkeyDoesNotMatch);
+        REQUIRE(model.liquidateBLSPublicKeyWithSignature(ServiceNodeRewardsModel::LIST_SENTINEL, pubkey, {}).error == ServiceNodeRewardsError::BLSPubkeyDoesNotMatch);
+        REQUIRE(model.liquidateBLSPublicKeyWithSignature(id, pubkey, {2, 3, 4}).error == ServiceNodeRewardsError::InsufficientBLSSignatures);
+
+        REQUIRE(model.liquidateBLSPublicKeyWithSignature(id, pubkey, {2, 3}));
+        REQUIRE(model.removeBLSPublicKeyWithSignature(id, pubkey, {}).error == ServiceNodeRewardsError::BLSPubkeyDoesNotMatch);
+        REQUIRE(model.serviceNodeIDsInOrder() == std::vector<uint64_t>{2, 3, 4, 5, 6});
+
+        // NOTE: The freed key can be added again, under a new ID
+        const ServiceNodeRewardsOutcome readded = model.addBLSPublicKey(OPERATOR_ADDRESS, pubkey);
+        REQUIRE(readded);
+        REQUIRE(readded.serviceNodeID == 7);
+    }
+
+    SECTION( "Liquidations split the deposit by the contract's ratios" ) {
+        ServiceNodeRewardsParams params    = {};
+        params.liquidatorRewardRatio       = 1;
+        params.poolShareOfLiquidationRatio = 1;
+        params.recipientRatio              = 8;
+        ServiceNodeRewardsModel ratios(params);
+        ratios.start();
+        REQUIRE(ratios.seedPublicKeyList({snl.nodes[0].getPublicKeyHex()}, {}).error == ServiceNodeRewardsError::ArrayLengthMismatch);
+        REQUIRE(ratios.seedPublicKeyList({snl.nodes[0].getPublicKeyHex(), snl.nodes[0].getPublicKeyHex()}, {1, 1}).error == ServiceNodeRewardsError::BLSPubkeyAlreadyExists);
+        REQUIRE(ratios.seedPublicKeyList({snl.nodes[0].getPublicKeyHex()}, {100'000'000'000}));
+
+        // NOTE: A tenth to the liquidator and, as the contract computes it, 1 to the pool
+        const ServiceNodeRewardsOutcome liquidated = ratios.liquidateBLSPublicKeyWithSignature(1, snl.nodes[0].getPublicKeyHex(), {});
+        REQUIRE(liquidated);
+        REQUIRE(liquidated.amount == 89'999'999'999);
+    }
+}
+
+TEST_CASE( "ServiceNodeRewards model agrees with the deployed contract", "[ethereum]" ) {
+    const auto& config   = ethbls::get_config(ethbls::network_type::LOCAL);
+    auto        provider = std::make_shared<Provider>("Client", std::string(config.RPC_URL));
+
+    const std::string          contract_address = provider->getContractDeployedInLatestBlock();
+    ServiceNodeRewardsContract rewards_contract(contract_address, provider);
+    ERC20Contract              erc20_contract(utils::trimAddress(rewards_contract.designatedToken()), provider);
+    Signer                     signer(provider);
+
+    const std::vector<unsigned char> seckey        = utils::fromHexString(std::string(config.PRIVATE_KEY));
+    const std::vector<unsigned char> otherSeckey   = utils::fromHexString(std::string(config.ADDITIONAL_PRIVATE_KEY1));
+    const std::string                senderAddress = signer.secretKeyToAddressString(seckey);
+    const std::string                otherAddress  = signer.secretKeyToAddressString(otherSeckey);
+    const std::string                snapshot      = provider->evm_snapshot();
+    REQUIRE(rewards_contract.serviceNodesLength() == 0);
+
+    // NOTE: A transaction that reverts fails gas estimation and throws
+    auto send = [&](Transaction tx, const std::vector<unsigned char>& key) {
+        try {
+            return provider->transactionSuccessful(signer.sendTransaction(tx, key));
+        } catch (const std::exception&) {
+            return false;
+        }
+    };
+    REQUIRE(send(erc20_contract.approve(contract_address, std::numeric_limits<std::uint64_t>::max()), seckey));
+
+    ServiceNodeRewardsModel model = ServiceNodeRewardsModel::fromContract(rewards_contract);
+    REQUIRE_FALSE(model.isActive());
+    REQUIRE(model.params().stakingRequirement == ServiceNodeRewardsContract::STAKING_REQUIREMENT);
+    REQUIRE(model.nextServiceNodeID() == rewards_contract.nextServiceNodeID());
+    REQUIRE(send(rewards_contract.start(), seckey));
+    REQUIRE(model.start());
+
+    ServiceNodeList snl(0);
+    std::mt19937_64 rng(1234);
+    auto pick = [&](size_t count) { return std::uniform_int_distribution<size_t>(0, count - 1)(rng); };
+
+    // NOTE: The block time of the last leave request plus the time skipped since
+    uint64_t clock = 0;
+
+    // Signers are every node but the first `nonSignerCount`, which may be more
+    // than the contract allows
+    auto splitSigners = [&](size_t nonSignerCount, std::vector<uint64_t>& signers, std::vector<uint64_t>& nonSigners) {
+        for (size_t index = 0; index < snl.nodes.size(); index++)
+            (index < nonSignerCount ? nonSigners : signers).push_back(snl.nodes[index].service_node_id);
+    };
+
+    for (size_t step = 0; step < 80; step++) {
+        const size_t operation = snl.nodes.size() < 4 ? 0 : pick(7);
+        INFO("step " << step << " operation " << operation);
+
+        bool                      chain   = false;
+        ServiceNodeRewardsOutcome outcome = {};
+        switch (operation) {
+            case 0: { // Add a node, or every so often a key that is already in the list
+                const bool duplicate = !snl.nodes.empty() && pick(5) == 0;
+                if (!duplicate)
+                    snl.addNode();
+                ServiceNode&      node  = duplicate ? snl.nodes[pick(snl.nodes.size())] : snl.nodes.back();
+                const std::string proof = node.proofOfPossession(config.CHAIN_ID, contract_address, senderAddress, "pubkey");
+                chain   = send(rewards_contract.addBLSPublicKey(node.getPublicKeyHex(), proof, "pubkey", "sig", 0), seckey);
+                outcome = model.addBLSPublicKey(senderAddress, node.getPublicKeyHex());
+            } break;
+
+            case 1: { // Reward update, possibly lower than the balance or with too many non-signers
+                const std::string     recipient = pick(2) ? otherAddress : senderAddress;
+                const uint64_t        amount    = model.viewRecipientData(recipient).rewards + pick(8);
+                std::vector<uint64_t> signers, nonSigners;
+                splitSigners(pick(model.blsNonSignerThreshold() + 2), signers, nonSigners);
+                const std::string sig = snl.updateRewardsBalance(recipient, amount, config.CHAIN_ID, contract_address, signers);
+                chain   = send(rewards_contract.updateRewardsBalance(recipient, amount, sig, nonSigners), seckey);
+                outcome = model.updateRewardsBalance(recipient, amount, nonSigners);
+            } break;
+
+            case 2: { // Claim
+                const bool other = pick(2);
+                chain   = send(rewards_contract.claimRewards(), other ? otherSeckey : seckey);
+                outcome = model.claimRewards(other ? otherAddress : senderAddress);
+            } break;
+
+            case 3: { // Leave request, from the operator or someone else
+                const uint64_t id    = snl.nodes[pick(snl.nodes.size())].service_node_id;
+                const bool     other = pick(4) == 0;
+                chain = send(rewards_contract.initiateRemoveBLSPublicKey(id), other ? otherSeckey : seckey);
+                if (chain)
+                    clock = rewards_contract.serviceNodes(id).leaveRequestTimestamp;
+                outcome = model.initiateRemoveBLSPublicKey(other ? otherAddress : senderAddress, id, clock);
+            } break;
+
+            case 4: { // Removal after the wait, skipping past it half the time
+                if (pick(2)) {
+                    provider->evm_increaseTime(std::chrono::hours(31 * 24));
+                    clock += 31 * 24 * 60 * 60;
+                }
+                const uint64_t id = snl.nodes[pick(snl.nodes.size())].service_node_id;
+                chain   = send(rewards_contract.removeBLSPublicKeyAfterWaitTime(id), seckey);
+                outcome = model.removeBLSPublicKeyAfterWaitTime(id, clock + 1);
+            } break;
+
+            case 5:   // Signed removal or liquidation, sometimes of the wrong key
+            case 6: {
+                const uint64_t        id = snl.nodes[pick(snl.nodes.size())].service_node_id;
+                std::vector<uint64_t> signers, nonSigners;
+                splitSigners(pick(model.blsNonSignerThreshold() + 2), signers, nonSigners);
+                auto [pubkey, sig] = operation == 5 ? snl.removeNodeFromIndices(id, config.CHAIN_ID, contract_address, signers)
+                                                    : snl.liquidateNodeFromIndices(id, config.CHAIN_ID, contract_address, signers);
+                if (pick(5) == 0)
+                    pubkey = snl.nodes[pick(snl.nodes.size())].getPublicKeyHex();
+
+                if (operation == 5) {
+                    chain   = send(rewards_contract.removeBLSPublicKeyWithSignature(id, pubkey, sig, nonSigners), seckey);
+                    outcome = model.removeBLSPublicKeyWithSignature(id, pubkey, nonSigners);
+                } else {
+                    chain   = send(rewards_contract.liquidateBLSPublicKeyWithSignature(id, pubkey, sig, nonSigners), seckey);
+                    outcome = model.liquidateBLSPublicKeyWithSignature(id, pubkey, nonSigners);
+                }
+            } break;
+        }
+
+        INFO("model " << toString(outcome.error));
+        REQUIRE(static_cast<bool>(outcome) == chain);
+        if (outcome && operation >= 4)
+            snl.deleteNode(outcome.serviceNodeID);
+
+        REQUIRE(model.serviceNodesLength() == rewards_contract.serviceNodesLength());
+        REQUIRE(model.blsNonSignerThreshold() == rewards_contract.blsNonSignerThreshold());
+        REQUIRE(model.aggregatePubkey() == rewards_contract.aggregatePubkey());
+    }
+
+    // NOTE: The model loaded fresh from the chain must match the one that was driven
+    const ServiceNodeRewardsModel loaded = ServiceNodeRewardsModel::fromContract(rewards_contract, {senderAddress, otherAddress});
+    REQUIRE(loaded.serviceNodeIDsInOrder() == model.serviceNodeIDsInOrder());
+    REQUIRE(loaded.nextServiceNodeID() == model.nextServiceNodeID());
+    for (uint64_t id : model.serviceNodeIDsInOrder()) {
+        const ServiceNodeRewardsModelNode& expected = *model.serviceNodes(id);
+        const ServiceNodeRewardsModelNode& actual   = *loaded.serviceNodes(id);
+        REQUIRE(actual.pubkey == expected.pubkey);
+        REQUIRE(actual.recipient == expected.recipient);
+        REQUIRE(actual.leaveRequestTimestamp == expected.leaveRequestTimestamp);
+        REQUIRE(actual.deposit == expected.deposit);
+    }
+    for (const std::string& address : {senderAddress, otherAddress}) {
+        REQUIRE(loaded.viewRecipientData(address).rewards == model.viewRecipientData(address).rewards);
+        REQUIRE(loaded.viewRecipientData(address).claimed == model.viewRecipientData(address).claimed);
+    }
+
+    REQUIRE(provider->evm_revert(snapshot));
+}
@@ -0,0 +1,106 @@
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/service_node_table.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+// The contract's view of `snl`: nodes linked in list order, every third one
+// paid to a second recipient
+static std::unordered_map<uint64_t, ContractServiceNode> contractNodes(ServiceNodeList& snl) {
+    std::unordered_map<uint64_t, ContractServiceNode> result;
+    ContractServiceNode sentinel = {};
+    sentinel.next                = snl.nodes.front().service_node_id;
+    sentinel.prev                = snl.nodes.back().service_node_id;
+    sentinel.pubkey.clear();
+    result[SERVICE_NODE_LIST_SENTINEL] = sentinel;
+
+    for (size_t index = 0; index < snl.nodes.size(); index++) {
+        ContractServiceNode node   = {};
+        node.next                  = index + 1 < snl.nodes.size() ? snl.nodes[index + 1].service_node_id : SERVICE_NODE_LIST_SENTINEL;
+        node.prev                  = index > 0 ? snl.nodes[index - 1].service_node_id : SERVICE_NODE_LIST_SENTINEL;
+        node.recipient.fill(index % 3 == 0 ? 0xbb : 0xaa);
+        node.pubkey                = snl.nodes[index].getPublicKey();
+        node.leaveRequestTimestamp = index;
+        node.deposit               = utils::padTo32Bytes(utils::decimalToHex(ServiceNodeRewardsContract::STAKING_REQUIREMENT + index));
+        result[snl.nodes[index].service_node_id] = node;
+    }
+    return result;
+}
+
+TEST_CASE( "Service node table mirrors the contract's nodes column by column", "[service_node_table]" ) {
+    const size_t    NODES = 100;
+    ServiceNodeList snl(NODES);
+    const auto      nodes = contractNodes(snl);
+    ServiceNodeTable table = ServiceNodeTable::fromNodes(nodes);
+
+    REQUIRE(table.size() == NODES);
+    REQUIRE_FALSE(table.contains(SERVICE_NODE_LIST_SENTINEL));
+    REQUIRE(utils::BLSPublicKeyToHex(table.aggregatePubkey()) == snl.aggregatePubkeyHex());
+    REQUIRE(table.totalDeposit() == Uint256(ServiceNodeRewardsContract::STAKING_REQUIREMENT * NODES + NODES * (NODES - 1) / 2));
+
+    std::vector<uint64_t> expectedOrder;
+    for (const ServiceNode& node : snl.nodes)
+        expectedOrder.push_back(node.service_node_id);
+    REQUIRE(table.serviceNodeIDsInOrder() == expectedOrder);
+
+    // NOTE: Every node reads back the same as it went in
+    for (const auto& [serviceNodeID, expected] : nodes) {
+        std::optional<ContractServiceNode> node = table.serviceNodes(serviceNodeID);
+        REQUIRE(node);
+        REQUIRE(node->next == expected.next);
+        REQUIRE(node->prev == expected.prev);
+        REQUIRE(node->recipient == expected.recipient);
+        REQUIRE(node->pubkey == expected.pubkey);
+        if (serviceNodeID != SERVICE_NODE_LIST_SENTINEL) {
+            REQUIRE(node->leaveRequestTimestamp == expected.leaveRequestTimestamp);
+            REQUIRE(Uint256::fromHex(node->deposit) == Uint256::fromHex(expected.deposit));
+        }
+    }
+    REQUIRE_FALSE(table.serviceNodes(NODES + 1));
+
+    std::array<unsigned char, 20> recipient;
+    recipient.fill(0xbb);
+    std::vector<uint64_t> paid = table.serviceNodeIDsForRecipient(recipient);
+    REQUIRE(paid.size() == (NODES + 2) / 3);
+    for (uint64_t serviceNodeID : paid)
+        REQUIRE(nodes.at(serviceNodeID).recipient == recipient);
+
+    // NOTE: Bar the vectors' slack a node is its columns plus an index entry
+    REQUIRE(table.memoryUsage() <= NODES * 2 * (sizeof(G1Affine) + sizeof(Uint256) + 4 * sizeof(uint64_t) + 20 + sizeof(uint32_t)));
+
+    SECTION( "Erasing a node moves the last row into its place" ) {
+        const uint64_t erased = snl.nodes[10].service_node_id;
+        const uint64_t moved  = table.serviceNodeIDs().back();
+        const uint32_t hole   = table.row(erased);
+        table.erase(erased);
+
+        REQUIRE(table.size() == NODES - 1);
+        REQUIRE_FALSE(table.contains(erased));
+        REQUIRE(table.row(moved) == hole);
+        REQUIRE(table.serviceNodes(moved)->pubkey == nodes.at(moved).pubkey);
+        REQUIRE_THROWS_AS(table.erase(erased), std::invalid_argument);
+
+        snl.deleteNode(erased);
+        REQUIRE(utils::BLSPublicKeyToHex(table.aggregatePubkey()) == snl.aggregatePubkeyHex());
+
+        table.insert(erased, nodes.at(erased));
+        REQUIRE(table.size() == NODES);
+        REQUIRE(table.row(erased) == NODES - 1);
+        REQUIRE_THROWS_AS(table.insert(erased, nodes.at(erased)), std::invalid_argument);
+    }
+
+    SECTION( "Nodes inserted one at a time match the bulk load" ) {
+        ServiceNodeTable incremental;
+        for (const auto& [serviceNodeID, node] : nodes)
+            incremental.insert(serviceNodeID, node);
+        REQUIRE(incremental.size() == table.size());
+        REQUIRE(incremental.aggregatePubkey() == table.aggregatePubkey());
+        REQUIRE(incremental.serviceNodeIDsInOrder() == table.serviceNodeIDsInOrder());
+    }
+}
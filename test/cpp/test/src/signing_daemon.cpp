@@ -0,0 +1,211 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/signing_daemon.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_all.hpp>
+
+using signing_daemon::Request;
+using signing_daemon::RequestType;
+using signing_daemon::Response;
+
+static const uint32_t    CHAIN_ID         = 31337;
+static const std::string CONTRACT_ADDRESS = "0x5FbDB2315678afecb367f032d93F642f64180aa3";
+static const std::string SENDER           = "0xf39fd6e51aad88f6f4ce6ab8827279cfffb92266";
+static const std::string RECIPIENT        = "0x70997970c51812dc3a010c7d01b50e0d17dc79c8";
+
+static std::string body(const std::string& frame) {
+    REQUIRE(frame.size() >= 4);
+    return frame.substr(4);
+}
+
+TEST_CASE( "Signing daemon messages round trip through the wire format", "[signing_daemon]" ) {
+    Request reward         = {};
+    reward.type            = RequestType::Reward;
+    reward.id              = 7;
+    reward.chainID         = CHAIN_ID;
+    reward.contractAddress = CONTRACT_ADDRESS;
+    reward.recipient       = RECIPIENT;
+    reward.amount          = 123'456'789;
+    reward.signers         = {3, 1, 2};
+
+    const std::string frame = signing_daemon::encodeRequest(reward);
+    REQUIRE(frame.size() == 4 + 1 + 4 + 4 + 20 + 20 + 8 + 4 + 3 * 8);
+
+    Request decoded = signing_daemon::decodeRequest(body(frame));
+    REQUIRE(decoded.type == RequestType::Reward);
+    REQUIRE(decoded.id == 7);
+    REQUIRE(decoded.chainID == CHAIN_ID);
+    REQUIRE(decoded.contractAddress == "0x5fbdb2315678afecb367f032d93f642f64180aa3");
+    REQUIRE(decoded.recipient == RECIPIENT);
+    REQUIRE(decoded.amount == 123'456'789);
+    REQUIRE(decoded.signers == reward.signers);
+
+    Request pop           = {};
+    pop.type              = RequestType::ProofOfPossession;
+    pop.serviceNodeID     = 4;
+    pop.chainID           = CHAIN_ID;
+    pop.contractAddress   = CONTRACT_ADDRESS;
+    pop.senderAddress     = SENDER;
+    pop.serviceNodePubkey = "pubkey";
+    decoded = signing_daemon::decodeRequest(body(signing_daemon::encodeRequest(pop)));
+    REQUIRE(decoded.serviceNodeID == 4);
+    REQUIRE(decoded.senderAddress == SENDER);
+    REQUIRE(decoded.serviceNodePubkey == "pubkey");
+
+    Response response  = {};
+    response.id        = 9;
+    response.publicKey = std::string(128, 'a');
+    response.signature = std::string(256, 'b');
+    Response answer    = signing_daemon::decodeResponse(body(signing_daemon::encodeResponse(response)));
+    REQUIRE(answer.ok());
+    REQUIRE(answer.id == 9);
+    REQUIRE(answer.publicKey == response.publicKey);
+    REQUIRE(answer.signature == response.signature);
+
+    response.error = "Service node 99 is not in the signing daemon's list";
+    answer         = signing_daemon::decodeResponse(body(signing_daemon::encodeResponse(response)));
+    REQUIRE_FALSE(answer.ok());
+    REQUIRE(answer.error == response.error);
+
+    // NOTE: Truncated or padded bodies and malformed fields are rejected
+    std::string truncated = body(frame);
+    truncated.pop_back();
+    REQUIRE_THROWS_AS(signing_daemon::decodeRequest(truncated), std::runtime_error);
+    REQUIRE_THROWS_AS(signing_daemon::decodeRequest(body(frame) + '\0'), std::runtime_error);
+    REQUIRE_THROWS_AS(signing_daemon::decodeRequest(std::string("\x09\0\0\0\1", 5)), std::runtime_error);
+    reward.recipient = "0x" + std::string(42, '1');
+    REQUIRE_THROWS_AS(signing_daemon::encodeRequest(reward), std::invalid_argument);
+    reward.recipient = "0xA000"; // NOTE: Truncated addresses are not zero padded
+    REQUIRE_THROWS_AS(signing_daemon::encodeRequest(reward), std::invalid_argument);
+    reward.recipient       = RECIPIENT;
+    reward.contractAddress = CONTRACT_ADDRESS.substr(0, 40);
+    REQUIRE_THROWS_AS(signing_daemon::encodeRequest(reward), std::invalid_argument);
+}
+
+TEST_CASE( "Signing service signs the same as the service node list", "[signing_daemon]" ) {
+    ServiceNodeList       snl(8);
+    std::vector<uint64_t> signers = {snl.nodes[5].service_node_id, snl.nodes[1].service_node_id, snl.nodes[2].service_node_id};
+    SigningService        service(ServiceNodeList(snl.secretKeys()));
+    REQUIRE(service.size() == snl.nodes.size());
+
+    Request reward         = {};
+    reward.type            = RequestType::Reward;
+    reward.chainID         = CHAIN_ID;
+    reward.contractAddress = CONTRACT_ADDRESS;
+    reward.recipient       = RECIPIENT;
+    reward.amount          = 1'000;
+    reward.signers         = signers;
+    Response response      = service.handle(reward);
+    REQUIRE(response.ok());
+    REQUIRE(response.signature == snl.updateRewardsBalance(RECIPIENT, 1'000, CHAIN_ID, CONTRACT_ADDRESS, signers));
+
+    Request removal         = {};
+    removal.type            = RequestType::Removal;
+    removal.serviceNodeID   = snl.nodes[3].service_node_id;
+    removal.chainID         = CHAIN_ID;
+    removal.contractAddress = CONTRACT_ADDRESS;
+    removal.signers         = signers;
+    response                = service.handle(removal);
+    auto [pubkey, sig]      = snl.removeNodeFromIndices(removal.serviceNodeID, CHAIN_ID, CONTRACT_ADDRESS, signers);
+    REQUIRE(response.publicKey == pubkey);
+    REQUIRE(response.signature == sig);
+
+    removal.type = RequestType::Liquidation;
+    response     = service.handle(removal);
+    REQUIRE(response.signature == snl.liquidateNodeFromIndices(removal.serviceNodeID, CHAIN_ID, CONTRACT_ADDRESS, signers).second);
+
+    Request pop           = {};
+    pop.type              = RequestType::ProofOfPossession;
+    pop.serviceNodeID     = snl.nodes[0].service_node_id;
+    pop.chainID           = CHAIN_ID;
+    pop.contractAddress   = CONTRACT_ADDRESS;
+    pop.senderAddress     = SENDER;
+    pop.serviceNodePubkey = "pubkey";
+    REQUIRE(service.handle(pop).signature == snl.nodes[0].proofOfPossession(CHAIN_ID, CONTRACT_ADDRESS, SENDER, "pubkey"));
+
+    // NOTE: No signers is every node
+    Request aggregate = {};
+    aggregate.type    = RequestType::Aggregate;
+    aggregate.hash    = utils::hash("0x1234");
+    response          = service.handle(aggregate);
+    REQUIRE(response.publicKey == snl.aggregatePubkeyHex());
+    REQUIRE(response.signature == snl.aggregateSignatures("0x1234"));
+
+    removal.serviceNodeID = 999;
+    response              = service.handle(removal);
+    REQUIRE_FALSE(response.ok());
+    REQUIRE(response.signature.empty());
+    reward.signers = {999};
+    REQUIRE_FALSE(service.handle(reward).ok());
+}
+
+TEST_CASE( "Signing daemon serves clients over a Unix socket", "[signing_daemon]" ) {
+    const std::string path = (std::filesystem::temp_directory_path() / ("sn-signer-test-" + std::to_string(::getpid()) + ".sock")).string();
+
+    ServiceNodeList       snl(6);
+    std::vector<uint64_t> signers = snl.randomSigners(4);
+    SigningService        service(ServiceNodeList(snl.secretKeys()));
+
+    // NOTE: Anything but a stale socket at the path is left alone
+    {
+        std::ofstream file(path);
+        file << "{}\n";
+    }
+    REQUIRE_THROWS_AS(SigningDaemon(service, path), std::runtime_error);
+    REQUIRE(std::filesystem::is_regular_file(path));
+    std::filesystem::remove(path);
+
+    SigningDaemon daemon(service, path);
+    REQUIRE(std::filesystem::exists(path));
+    REQUIRE((std::filesystem::status(path).permissions() & (std::filesystem::perms::group_all | std::filesystem::perms::others_all)) == std::filesystem::perms::none);
+
+    SigningDaemonClient client(path);
+    REQUIRE(client.updateRewardsBalance(RECIPIENT, 42, CHAIN_ID, CONTRACT_ADDRESS, signers) == snl.updateRewardsBalance(RECIPIENT, 42, CHAIN_ID, CONTRACT_ADDRESS, signers));
+    REQUIRE(client.removeNodeFromIndices(snl.nodes[0].service_node_id, CHAIN_ID, CONTRACT_ADDRESS, signers) == snl.removeNodeFromIndices(snl.nodes[0].service_node_id, CHAIN_ID, CONTRACT_ADDRESS, signers));
+    REQUIRE(client.proofOfPossession(snl.nodes[1].service_node_id, CHAIN_ID, CONTRACT_ADDRESS, SENDER, "pubkey") == snl.nodes[1].proofOfPossession(CHAIN_ID, CONTRACT_ADDRESS, SENDER, "pubkey"));
+    REQUIRE_THROWS_AS(client.liquidateNodeFromIndices(999, CHAIN_ID, CONTRACT_ADDRESS, signers), std::runtime_error);
+
+    SECTION( "Concurrent requests for the same message are signed once" ) {
+        const size_t   CLIENTS   = 8;
+        const uint64_t before    = service.signaturesComputed();
+        const uint64_t coalesced = service.coalescedRequests();
+
+        // NOTE: The first signer holds on until every other client has joined it
+        service.setSignHook([&] {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+            while (service.coalescedRequests() - coalesced < CLIENTS - 1 && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+
+        std::vector<std::future<std::string>> results;
+        for (size_t index = 0; index < CLIENTS; index++) {
+            results.push_back(std::async(std::launch::async, [&] {
+                SigningDaemonClient connection(path);
+                return connection.updateRewardsBalance(RECIPIENT, 1'000, CHAIN_ID, CONTRACT_ADDRESS, signers);
+            }));
+        }
+
+        const std::string expected = snl.updateRewardsBalance(RECIPIENT, 1'000, CHAIN_ID, CONTRACT_ADDRESS, signers);
+        for (auto& result : results)
+            REQUIRE(result.get() == expected);
+        service.setSignHook(nullptr);
+
+        REQUIRE(service.signaturesComputed() - before == 1);
+        REQUIRE(service.coalescedRequests() - coalesced == CLIENTS - 1);
+    }
+
+    daemon.stop();
+    REQUIRE_FALSE(std::filesystem::exists(path));
+    REQUIRE_THROWS_AS(client.updateRewardsBalance(RECIPIENT, 43, CHAIN_ID, CONTRACT_ADDRESS, signers), std::runtime_error);
+}
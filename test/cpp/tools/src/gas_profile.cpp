@@ -0,0 +1,238 @@
+// Measures the gas of the ServiceNodeRewards operations against a local node
+// as the service node list and the number of non-signers grow.
+//
+//   anvil &
+//   npx hardhat run scripts/deploy-local-test.js --network localhost
+//   ./gas_profile --sizes 10,100,1000 --non-signers 0,1,10,50,100 --csv gas.csv --json gas.json
+//
+// The contract is reverted to the state it was found in between every
+// measurement, each one starts from a freshly seeded list of the given size.
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ethyl/provider.hpp"
+#include "ethyl/signer.hpp"
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/config.hpp"
+#include "service_node_rewards/erc20_contract.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+#include "service_node_rewards/transaction_queue.hpp"
+
+struct Options {
+    ethbls::network_type  network     = ethbls::network_type::LOCAL;
+    std::string           contract;    // Empty to use the contract deployed in the latest block
+    std::vector<size_t>   sizes       = {10, 100, 1'000};
+    std::vector<size_t>   nonSigners  = {0, 1, 5, 10, 50, 100};
+    std::string           csvPath     = "gas_profile.csv";
+    std::string           jsonPath    = "gas_profile.json";
+};
+
+struct Measurement {
+    std::string operation;
+    size_t      nodes;         // Length of the list when the operation ran
+    size_t      nonSigners;
+    size_t      calldataBytes;
+    uint64_t    gasUsed;
+    bool        success;       // False if the transaction reverted, e.g. too many non-signers
+};
+
+static std::vector<size_t> parseSizes(const std::string& arg) {
+    std::vector<size_t> result;
+    std::stringstream   stream(arg);
+    for (std::string item; std::getline(stream, item, ',');)
+        result.push_back(std::stoull(item));
+    return result;
+}
+
+static Options parseOptions(int argc, char* argv[]) {
+    Options result = {};
+    for (int index = 1; index < argc; index++) {
+        const std::string arg = argv[index];
+        if (arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " [--network local] [--contract <address>] [--sizes 10,100] [--non-signers 0,1,10] [--csv <path>] [--json <path>]\n";
+            std::exit(0);
+        }
+        if (index + 1 >= argc)
+            throw std::invalid_argument("Missing value for '" + arg + "'");
+
+        const std::string value = argv[++index];
+        if (arg == "--network") {
+            result.network = ethbls::network_type_from_string(value);
+            if (result.network == ethbls::network_type::UNDEFINED)
+                throw std::invalid_argument("Unknown network '" + value + "'");
+        } else if (arg == "--contract") {
+            result.contract = value;
+        } else if (arg == "--sizes") {
+            result.sizes = parseSizes(value);
+        } else if (arg == "--non-signers") {
+            result.nonSigners = parseSizes(value);
+        } else if (arg == "--csv") {
+            result.csvPath = value;
+        } else if (arg == "--json") {
+            result.jsonPath = value;
+        } else {
+            throw std::invalid_argument("Unknown option '" + arg + "'");
+        }
+    }
+    return result;
+}
+
+class GasProfiler {
+public:
+    GasProfiler(const Options& options)
+            : config(ethbls::get_config(options.network)),
+              provider(std::make_shared<Provider>("Client", std::string(config.RPC_URL))),
+              signer(provider),
+              queue(provider, signer),
+              seckey(utils::fromHexString(std::string(config.PRIVATE_KEY))),
+              recipientSeckey(utils::fromHexString(std::string(config.ADDITIONAL_PRIVATE_KEY1))),
+              contractAddress(options.contract.empty() ? provider->getContractDeployedInLatestBlock() : options.contract),
+              rewardsContract(contractAddress, provider),
+              erc20Contract(utils::trimAddress(rewardsContract.designatedToken()), provider),
+              baseSnapshot(provider->evm_snapshot()) {}
+
+    // Seed a list of `size` nodes then measure every operation against it for
+    // each non-signer count that leaves at least one signer.
+    void profile(size_t size, const std::vector<size_t>& nonSignerCounts) {
+        if (size == 0)
+            return;
+        reset(baseSnapshot);
+
+        send(erc20Contract.approve(contractAddress, std::numeric_limits<std::uint64_t>::max()), seckey);
+        send(rewardsContract.start(), seckey);
+
+        // NOTE: Seed all but the last node, adding the last is measured
+        ServiceNodeList snl(size - 1);
+        if (!snl.nodes.empty())
+            rewardsContract.seedServiceNodeList(queue, seckey, snl);
+        snl.addNode();
+        {
+            ServiceNode&      node  = snl.nodes.back();
+            const std::string proof = node.proofOfPossession(config.CHAIN_ID, contractAddress, signer.secretKeyToAddressString(seckey), "pubkey");
+            measure("addBLSPublicKey", size - 1, 0, rewardsContract.addBLSPublicKey(node.getPublicKeyHex(), proof, "pubkey", "sig", 0), seckey);
+        }
+
+        std::string       listSnapshot     = provider->evm_snapshot();
+        const std::string recipientAddress = signer.secretKeyToAddressString(recipientSeckey);
+        for (size_t nonSignerCount : nonSignerCounts) {
+            if (nonSignerCount >= size)
+                continue;
+
+            const uint64_t              target     = snl.nodes.front().service_node_id;
+            const std::vector<uint64_t> signers    = signersExcluding(snl, nonSignerCount);
+            const std::vector<uint64_t> nonSigners = snl.findNonSigners(signers);
+
+            const std::string rewardSig = snl.updateRewardsBalance(recipientAddress, 1, config.CHAIN_ID, contractAddress, signers);
+            const bool rewarded = measure("updateRewardsBalance", size, nonSigners.size(), rewardsContract.updateRewardsBalance(recipientAddress, 1, rewardSig, nonSigners), seckey);
+            if (rewarded)
+                measure("claimRewards", size, nonSigners.size(), rewardsContract.claimRewards(), recipientSeckey);
+            reset(listSnapshot);
+
+            const auto [liquidatePubkey, liquidateSig] = snl.liquidateNodeFromIndices(target, config.CHAIN_ID, contractAddress, signers);
+            measure("liquidateBLSPublicKeyWithSignature", size, nonSigners.size(), rewardsContract.liquidateBLSPublicKeyWithSignature(target, liquidatePubkey, liquidateSig, nonSigners), seckey);
+            reset(listSnapshot);
+
+            const auto [removePubkey, removeSig] = snl.removeNodeFromIndices(target, config.CHAIN_ID, contractAddress, signers);
+            measure("removeBLSPublicKeyWithSignature", size, nonSigners.size(), rewardsContract.removeBLSPublicKeyWithSignature(target, removePubkey, removeSig, nonSigners), seckey);
+            reset(listSnapshot);
+        }
+        reset(baseSnapshot);
+    }
+
+    void writeCsv(const std::string& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        file << "operation,nodes,non_signers,calldata_bytes,gas_used,success\n";
+        for (const Measurement& item : measurements)
+            file << item.operation << "," << item.nodes << "," << item.nonSigners << "," << item.calldataBytes << "," << item.gasUsed << "," << (item.success ? "true" : "false") << "\n";
+    }
+
+    void writeJson(const std::string& path) const {
+        nlohmann::json result = nlohmann::json::array();
+        for (const Measurement& item : measurements) {
+            result.push_back({
+                {"operation", item.operation},
+                {"nodes", item.nodes},
+                {"non_signers", item.nonSigners},
+                {"calldata_bytes", item.calldataBytes},
+                {"gas_used", item.gasUsed},
+                {"success", item.success},
+            });
+        }
+        std::ofstream file(path, std::ios::trunc);
+        file << result.dump(2) << "\n";
+    }
+
+private:
+    // NOTE: anvil drops a snapshot once it is reverted to, take it again so
+    // it can be reused. The revert also rewinds the senders' nonces.
+    void reset(std::string& snapshot) {
+        if (!provider->evm_revert(snapshot))
+            throw std::runtime_error("Failed to revert the node to snapshot " + snapshot);
+        snapshot = provider->evm_snapshot();
+        queue.resyncNonce(signer.secretKeyToAddressString(seckey));
+        queue.resyncNonce(signer.secretKeyToAddressString(recipientSeckey));
+    }
+
+    // NOTE: The first node is the target of the liquidations/removals, it is
+    // the first to stop signing followed by nodes from the back of the list.
+    static std::vector<uint64_t> signersExcluding(const ServiceNodeList& snl, size_t nonSignerCount) {
+        std::vector<uint64_t> result;
+        for (size_t index = 0; index < snl.nodes.size(); index++) {
+            const bool excluded = nonSignerCount > 0 && (index == 0 || index + nonSignerCount > snl.nodes.size());
+            if (!excluded)
+                result.push_back(snl.nodes[index].service_node_id);
+        }
+        return result;
+    }
+
+    TransactionResult send(Transaction tx, const std::vector<unsigned char>& key) {
+        TransactionFuture result = queue.submit(std::move(tx), key);
+        if (!queue.waitAll())
+            throw std::runtime_error("Timed out waiting for a transaction to be mined");
+        return result.get();
+    }
+
+    bool measure(const std::string& operation, size_t nodes, size_t nonSigners, Transaction tx, const std::vector<unsigned char>& key) {
+        const size_t            calldataBytes = utils::trimPrefix(tx.data, "0x").size() / 2;
+        const TransactionResult result        = send(std::move(tx), key);
+        measurements.push_back(Measurement{operation, nodes, nonSigners, calldataBytes, result.gasUsed, result.success});
+        std::cout << operation << " nodes=" << nodes << " non_signers=" << nonSigners << " gas=" << result.gasUsed << (result.success ? "" : " (reverted)") << std::endl;
+        return result.success;
+    }
+
+    const ethbls::network_config& config;
+    std::shared_ptr<Provider>     provider;
+    Signer                        signer;
+    TransactionQueue              queue;
+    std::vector<unsigned char>    seckey;
+    std::vector<unsigned char>    recipientSeckey;
+    std::string                   contractAddress;
+    ServiceNodeRewardsContract    rewardsContract;
+    ERC20Contract                 erc20Contract;
+    std::string                   baseSnapshot;
+    std::vector<Measurement>      measurements;
+};
+
+int main(int argc, char* argv[]) {
+    try {
+        const Options options = parseOptions(argc, argv);
+        GasProfiler   profiler(options);
+        for (size_t size : options.sizes)
+            profiler.profile(size, options.nonSigners);
+        profiler.writeCsv(options.csvPath);
+        profiler.writeJson(options.jsonPath);
+    } catch (const std::exception& e) {
+        std::cerr << "gas_profile: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
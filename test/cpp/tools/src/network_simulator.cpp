@@ -0,0 +1,464 @@
+// Simulates a service node network signing for the rewards contract and
+// reports the sustained signing and transaction throughput.
+//
+//   anvil &
+//   npx hardhat run scripts/deploy-local-test.js --network localhost
+//   ./network_simulator --nodes 10000 --rounds 50 --rewards-per-round 20
+//   ./network_simulator --nodes 10000 --rounds 50 --dry-run   # signing only, no node needed
+//
+// Each round every online node signs the round's messages (reward updates,
+// plus the removal of nodes leaving and the liquidation of nodes offline for
+// too long) as one task on a work-stealing pool. A node's reply arrives after
+// a latency drawn from a log-normal distribution, replies later than the
+// round deadline (and offline nodes) count as non-signers. The coordinator
+// aggregates what arrived in time and submits the transactions. The latency
+// is simulated on the clock of the round, not slept, so the measured
+// throughput is what the signing and the node can sustain.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ethyl/provider.hpp"
+#include "ethyl/signer.hpp"
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/config.hpp"
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/erc20_contract.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+#include "service_node_rewards/transaction_queue.hpp"
+
+struct Options {
+    ethbls::network_type network              = ethbls::network_type::LOCAL;
+    std::string          contract;             // Empty to use the contract deployed in the latest block
+    size_t               nodes                = 1'000;
+    size_t               rounds               = 20;
+    size_t               rewardsPerRound      = 10;
+    size_t               threads              = 0;     // 0 for one per hardware thread
+    double               joinsPerRound        = 1.0;   // Mean of a Poisson distribution
+    double               leavesPerRound       = 1.0;   // Mean of a Poisson distribution
+    double               offlineProbability   = 0.002; // Chance an online node drops out each round
+    double               recoverProbability   = 0.2;   // Chance an offline node comes back each round
+    size_t               liquidateAfterRounds = 5;     // Offline this long gets a node liquidated
+    double               latencyMedianMs      = 80;
+    double               latencySigma         = 0.6;   // Of the log-normal latency
+    double               deadlineMs           = 500;
+    uint64_t             seed                 = 1;
+    bool                 dryRun               = false;
+};
+
+static Options parseOptions(int argc, char* argv[]) {
+    Options result = {};
+    for (int index = 1; index < argc; index++) {
+        const std::string arg = argv[index];
+        if (arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " [--network local] [--contract <address>] [--nodes N] [--rounds N] [--rewards-per-round N]\n"
+                      << "    [--threads N] [--joins-per-round X] [--leaves-per-round X] [--offline-probability P] [--recover-probability P]\n"
+                      << "    [--liquidate-after-rounds N] [--latency-median-ms X] [--latency-sigma X] [--deadline-ms X] [--seed N] [--dry-run]\n";
+            std::exit(0);
+        }
+        if (arg == "--dry-run") {
+            result.dryRun = true;
+            continue;
+        }
+        if (index + 1 >= argc)
+            throw std::invalid_argument("Missing value for '" + arg + "'");
+
+        const std::string value = argv[++index];
+        if (arg == "--network") {
+            result.network = ethbls::network_type_from_string(value);
+            if (result.network == ethbls::network_type::UNDEFINED)
+                throw std::invalid_argument("Unknown network '" + value + "'");
+        }
+        else if (arg == "--contract")               result.contract             = value;
+        else if (arg == "--nodes")                  result.nodes                = std::stoull(value);
+        else if (arg == "--rounds")                 result.rounds               = std::stoull(value);
+        else if (arg == "--rewards-per-round")      result.rewardsPerRound      = std::stoull(value);
+        else if (arg == "--threads")                result.threads              = std::stoull(value);
+        else if (arg == "--joins-per-round")        result.joinsPerRound        = std::stod(value);
+        else if (arg == "--leaves-per-round")       result.leavesPerRound       = std::stod(value);
+        else if (arg == "--offline-probability")    result.offlineProbability   = std::stod(value);
+        else if (arg == "--recover-probability")    result.recoverProbability   = std::stod(value);
+        else if (arg == "--liquidate-after-rounds") result.liquidateAfterRounds = std::stoull(value);
+        else if (arg == "--latency-median-ms")      result.latencyMedianMs      = std::stod(value);
+        else if (arg == "--latency-sigma")          result.latencySigma         = std::stod(value);
+        else if (arg == "--deadline-ms")            result.deadlineMs           = std::stod(value);
+        else if (arg == "--seed")                   result.seed                 = std::stoull(value);
+        else throw std::invalid_argument("Unknown option '" + arg + "'");
+    }
+    return result;
+}
+
+// Fixed pool of workers with a task deque each. Tasks are handed out round
+// robin, a worker runs its own newest task first and when it runs dry steals
+// the oldest task from another worker.
+class WorkStealingPool {
+public:
+    WorkStealingPool(size_t threads) {
+        if (threads == 0)
+            threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        for (size_t index = 0; index < threads; index++)
+            queues.push_back(std::make_unique<Queue>());
+        for (size_t index = 0; index < threads; index++)
+            workers.emplace_back([this, index] { run(index); });
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lock{mutex};
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    void submit(std::function<void()> task) {
+        Queue& queue = *queues[nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size()];
+        {
+            std::lock_guard lock{queue.mutex};
+            queue.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard lock{mutex};
+            queued++;
+            pending++;
+        }
+        wake.notify_one();
+    }
+
+    // Block until every submitted task has finished
+    void wait() {
+        std::unique_lock lock{mutex};
+        finished.wait(lock, [this] { return pending == 0; });
+    }
+
+    size_t size() const { return workers.size(); }
+
+private:
+    struct Queue {
+        std::mutex                        mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::optional<std::function<void()>> take(size_t worker) {
+        for (size_t offset = 0; offset < queues.size(); offset++) {
+            Queue&          queue = *queues[(worker + offset) % queues.size()];
+            std::lock_guard lock{queue.mutex};
+            if (queue.tasks.empty())
+                continue;
+            std::function<void()> task;
+            if (offset == 0) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            } else {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            return task;
+        }
+        return std::nullopt;
+    }
+
+    void run(size_t worker) {
+        for (;;) {
+            {
+                std::unique_lock lock{mutex};
+                wake.wait(lock, [this] { return stopping || queued > 0; });
+                if (stopping)
+                    return;
+                queued--;
+            }
+
+            // NOTE: `queued` was reserved above so a task is guaranteed to be in some queue
+            std::optional<std::function<void()>> task;
+            while (!task)
+                task = take(worker);
+            (*task)();
+
+            bool done = false;
+            {
+                std::lock_guard lock{mutex};
+                done = --pending == 0;
+            }
+            if (done)
+                finished.notify_all();
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread>            workers;
+    std::atomic<size_t>                 nextQueue = 0;
+    std::mutex                          mutex;
+    std::condition_variable             wake;
+    std::condition_variable             finished;
+    size_t                              queued   = 0; // Tasks in a queue not yet claimed by a worker
+    size_t                              pending  = 0; // Tasks submitted and not yet finished
+    bool                                stopping = false;
+};
+
+// What the contract should do with a message once it is signed
+struct Message {
+    enum class Kind { Reward, Removal, Liquidation };
+    Kind                          kind;
+    std::array<unsigned char, 32> hash;
+    std::string                   address;  // Reward recipient
+    uint64_t                      amount;   // Reward amount
+    uint64_t                      target;   // Node being removed or liquidated
+    std::string                   pubkey;   // Of the target
+};
+
+struct NodeState {
+    bool   online        = true;
+    size_t offlineRounds = 0;
+    bool   leaving       = false;
+};
+
+class NetworkSimulator {
+public:
+    NetworkSimulator(const Options& _options)
+            : options(_options),
+              config(ethbls::get_config(options.network)),
+              rng(options.seed),
+              pool(options.threads),
+              snl(options.nodes) {
+        for (const ServiceNode& node : snl.nodes)
+            states[node.service_node_id] = NodeState{};
+        // NOTE: A dry run only signs, the contract address just goes into the message tags
+        contractAddress = options.contract.empty() ? std::string("0x5FbDB2315678afecb367f032d93F642f64180aa3") : options.contract;
+        if (!options.dryRun)
+            connect();
+    }
+
+    void run() {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < options.rounds; round++)
+            runRound(round);
+        if (queue && !queue->waitAll())
+            std::cerr << "Timed out waiting for the last transactions to be mined\n";
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "\nnodes=" << snl.nodes.size() << " rounds=" << options.rounds << " threads=" << pool.size() << " seconds=" << seconds << "\n"
+                  << "signatures=" << signatures << " (" << static_cast<double>(signatures) / seconds << "/s)\n"
+                  << "transactions=" << submitted << " mined=" << mined << " reverted=" << reverted << " (" << static_cast<double>(mined) / seconds << "/s)\n";
+    }
+
+private:
+    void connect() {
+        provider        = std::make_shared<Provider>("Client", std::string(config.RPC_URL));
+        signer          = std::make_unique<Signer>(provider);
+        queue           = std::make_unique<TransactionQueue>(provider, *signer);
+        seckey          = utils::fromHexString(std::string(config.PRIVATE_KEY));
+        if (options.contract.empty())
+            contractAddress = provider->getContractDeployedInLatestBlock();
+        rewardsContract = std::make_unique<ServiceNodeRewardsContract>(contractAddress, provider);
+
+        // NOTE: The simulated IDs only line up with the contract's if both start empty
+        if (rewardsContract->serviceNodesLength() != 0)
+            throw std::runtime_error("The contract at " + contractAddress + " already has service nodes, deploy a fresh one");
+
+        ERC20Contract erc20(utils::trimAddress(rewardsContract->designatedToken()), provider);
+        queue->submit(erc20.approve(contractAddress, std::numeric_limits<std::uint64_t>::max()), seckey);
+        queue->submit(rewardsContract->start(), seckey);
+        rewardsContract->seedServiceNodeList(*queue, seckey, snl);
+    }
+
+    void churn(std::vector<Message>& messages) {
+        std::poisson_distribution<size_t>      joins(options.joinsPerRound);
+        std::poisson_distribution<size_t>      leaves(options.leavesPerRound);
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+        for (size_t count = joins(rng); count > 0; count--) {
+            snl.addNode();
+            ServiceNode& node = snl.nodes.back();
+            states[node.service_node_id] = NodeState{};
+            if (queue) {
+                const std::string proof = node.proofOfPossession(config.CHAIN_ID, contractAddress, signer->secretKeyToAddressString(seckey), "pubkey");
+                track(queue->submit(rewardsContract->addBLSPublicKey(node.getPublicKeyHex(), proof, "pubkey", "sig", 0), seckey));
+            }
+        }
+
+        for (size_t count = leaves(rng); count > 0 && snl.nodes.size() > 1; count--) {
+            const ServiceNode& node = snl.nodes[std::uniform_int_distribution<size_t>(0, snl.nodes.size() - 1)(rng)];
+            NodeState&         state = states[node.service_node_id];
+            if (state.leaving)
+                continue;
+            state.leaving = true;
+            const std::string pubkey = node.getPublicKeyHex();
+            messages.push_back(Message{Message::Kind::Removal, ServiceNodeList::removalMessageHash(pubkey, config.CHAIN_ID, contractAddress), "", 0, node.service_node_id, pubkey});
+        }
+
+        for (const ServiceNode& node : snl.nodes) {
+            NodeState& state = states[node.service_node_id];
+            if (state.online) {
+                state.online        = chance(rng) >= options.offlineProbability;
+                state.offlineRounds = state.online ? 0 : 1; // NOTE: The round it drops out counts
+            } else {
+                state.online = chance(rng) < options.recoverProbability;
+                state.offlineRounds = state.online ? 0 : state.offlineRounds + 1;
+            }
+
+            if (!state.online && !state.leaving && state.offlineRounds >= options.liquidateAfterRounds) {
+                state.leaving = true;
+                const std::string pubkey = node.getPublicKeyHex();
+                messages.push_back(Message{Message::Kind::Liquidation, ServiceNodeList::liquidationMessageHash(pubkey, config.CHAIN_ID, contractAddress), "", 0, node.service_node_id, pubkey});
+            }
+        }
+    }
+
+    void runRound(size_t round) {
+        // NOTE: Rewards go first, every removal or liquidation changes the
+        // signer set of the messages after it
+        std::vector<Message> messages;
+        for (size_t index = 0; index < options.rewardsPerRound; index++) {
+            const std::string address = "0x" + utils::padToNBytes(utils::decimalToHex(0xA000 + index), 20, utils::PaddingDirection::LEFT);
+            const uint64_t    amount  = (round + 1) * 1'000'000;
+            messages.push_back(Message{Message::Kind::Reward, ServiceNodeList::rewardMessageHash(address, amount, config.CHAIN_ID, contractAddress), address, amount, 0, ""});
+        }
+        churn(messages);
+
+        // NOTE: Draw who replies in time up front so the tasks don't share the RNG
+        std::lognormal_distribution<double> latency(std::log(options.latencyMedianMs), options.latencySigma);
+        std::vector<char>                   replied(snl.nodes.size());
+        for (size_t index = 0; index < snl.nodes.size(); index++)
+            replied[index] = states[snl.nodes[index].service_node_id].online && latency(rng) <= options.deadlineMs;
+
+        const auto                               start = std::chrono::steady_clock::now();
+        std::vector<std::vector<bls::Signature>> nodeSignatures(snl.nodes.size());
+        for (size_t index = 0; index < snl.nodes.size(); index++) {
+            if (!replied[index])
+                continue;
+            pool.submit([&, index] {
+                std::vector<bls::Signature>& result = nodeSignatures[index];
+                result.reserve(messages.size());
+                for (const Message& message : messages)
+                    result.push_back(snl.nodes[index].signHash(message.hash));
+            });
+        }
+        pool.wait();
+
+        const size_t          nodeCount       = snl.nodes.size();
+        size_t                roundSignatures = 0;
+        std::vector<uint64_t> nonSigners;
+        for (size_t index = 0; index < snl.nodes.size(); index++) {
+            roundSignatures += nodeSignatures[index].size();
+            if (!replied[index])
+                nonSigners.push_back(snl.nodes[index].service_node_id);
+        }
+        signatures += roundSignatures;
+        const size_t roundNonSigners = nonSigners.size();
+
+        // NOTE: The contract drops a node as soon as its removal is mined, so the
+        // messages after it are aggregated over and checked against the nodes left
+        std::vector<char> removed(snl.nodes.size());
+        for (size_t messageIndex = 0; messageIndex < messages.size(); messageIndex++) {
+            const Message& message = messages[messageIndex];
+            bls::Signature aggregate;
+            aggregate.clear();
+            for (size_t index = 0; index < snl.nodes.size(); index++) {
+                if (replied[index] && !removed[index])
+                    aggregate.add(nodeSignatures[index][messageIndex]);
+            }
+            submit(message, utils::SignatureToHex(aggregate), nonSigners);
+
+            if (message.kind == Message::Kind::Reward)
+                continue;
+            const size_t target = static_cast<size_t>(snl.findNodeIndex(message.target));
+            removed[target]     = true;
+            if (!replied[target])
+                nonSigners.erase(std::find(nonSigners.begin(), nonSigners.end(), message.target));
+        }
+
+        for (const Message& message : messages) {
+            if (message.kind != Message::Kind::Reward) {
+                snl.deleteNode(message.target);
+                states.erase(message.target);
+            }
+        }
+        if (queue)
+            queue->poll();
+        collect();
+
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "round=" << round << " nodes=" << nodeCount << " signers=" << nodeCount - roundNonSigners
+                  << " messages=" << messages.size() << " signatures=" << roundSignatures << " ms=" << ms << " mined=" << mined << std::endl;
+    }
+
+    void submit(const Message& message, const std::string& signature, const std::vector<uint64_t>& nonSigners) {
+        if (!queue)
+            return;
+        switch (message.kind) {
+            case Message::Kind::Reward:
+                track(queue->submit(rewardsContract->updateRewardsBalance(message.address, message.amount, signature, nonSigners), seckey));
+                break;
+            case Message::Kind::Removal:
+                track(queue->submit(rewardsContract->removeBLSPublicKeyWithSignature(message.target, message.pubkey, signature, nonSigners), seckey));
+                break;
+            case Message::Kind::Liquidation:
+                track(queue->submit(rewardsContract->liquidateBLSPublicKeyWithSignature(message.target, message.pubkey, signature, nonSigners), seckey));
+                break;
+        }
+    }
+
+    void track(TransactionFuture future) {
+        submitted++;
+        inflight.push_back(std::move(future));
+    }
+
+    void collect() {
+        for (auto it = inflight.begin(); it != inflight.end();) {
+            if (it->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                ++it;
+                continue;
+            }
+            (it->get().success ? mined : reverted)++;
+            it = inflight.erase(it);
+        }
+    }
+
+    Options                        options;
+    const ethbls::network_config&  config;
+    std::mt19937_64                rng;
+    WorkStealingPool               pool;
+    ServiceNodeList                snl;
+    std::unordered_map<uint64_t, NodeState> states;
+
+    std::shared_ptr<Provider>                   provider;
+    std::unique_ptr<Signer>                     signer;
+    std::unique_ptr<TransactionQueue>           queue;
+    std::vector<unsigned char>                  seckey;
+    std::string                                 contractAddress;
+    std::unique_ptr<ServiceNodeRewardsContract> rewardsContract;
+    std::deque<TransactionFuture>               inflight;
+
+    uint64_t signatures = 0;
+    uint64_t submitted  = 0;
+    uint64_t mined      = 0;
+    uint64_t reverted   = 0;
+};
+
+int main(int argc, char* argv[]) {
+    try {
+        NetworkSimulator simulator(parseOptions(argc, argv));
+        simulator.run();
+    } catch (const std::exception& e) {
+        std::cerr << "network_simulator: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,554 @@
+// Streams a reward epoch, a file of (address, amount) records, through the
+// rewards contract as `updateRewardsBalance` transactions.
+//
+//   anvil &
+//   npx hardhat run scripts/deploy-local-test.js --network localhost
+//   ./reward_epoch_pipeline --epoch epoch.csv --checkpoint epoch.checkpoint
+//   ./reward_epoch_pipeline --epoch epoch.jsonl --dry-run   # parse, sign and encode only, no node needed
+//
+// CSV lines are `address,amount` (a header line is skipped), JSONL lines are
+// `{"address": "0x...", "amount": 123}`. Amounts are the recipient's new
+// total rewards, so records for the same address must increase.
+//
+// The records flow through a stage per thread (or pool of threads) joined by
+// bounded queues:
+//
+//   read -> sign (one thread per core) -> submit -> confirm
+//
+// Each stage blocks once the queue in front of it is full, so a slow chain
+// holds back the signing and the signing holds back the reading without
+// anything buffering the whole epoch. Signing uses the aggregate secret key of
+// the service nodes, one hash-to-G2 and scalar multiply per record. The
+// submitter puts the signed records back in file order (the contract rejects
+// a balance that does not increase) and sends them back to back with locally
+// allocated nonces, up to `--max-in-flight` unconfirmed at a time, while the
+// confirmer fetches the receipts of everything in flight in one batch.
+//
+// The checkpoint file holds the service node keys, the number of records
+// confirmed from the start of the epoch and the ones among them that
+// reverted. Running again with the same checkpoint resubmits the reverted
+// records, skips the rest of the confirmed ones and carries on with the same
+// keys. A reverted record whose amount the recipient's total on chain has
+// since reached (a later record for them mined, or it did itself before a
+// crash) is dropped rather than resubmitted to revert again. The checkpoint
+// is also written when a stage fails.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ethyl/provider.hpp"
+#include "ethyl/signer.hpp"
+#include "ethyl/utils.hpp"
+#include "service_node_rewards/config.hpp"
+#include "service_node_rewards/ec_utils.hpp"
+#include "service_node_rewards/erc20_contract.hpp"
+#include "service_node_rewards/receipt_tracker.hpp"
+#include "service_node_rewards/service_node_list.hpp"
+#include "service_node_rewards/service_node_rewards_contract.hpp"
+#include "service_node_rewards/transaction_queue.hpp"
+
+struct Options {
+    ethbls::network_type network            = ethbls::network_type::LOCAL;
+    std::string          contract;           // Empty to use the contract deployed in the latest block
+    std::string          epoch;              // Path of the records
+    std::string          format;             // "csv" or "jsonl", empty to go by the extension
+    std::string          checkpoint;         // Empty to not checkpoint
+    size_t               nodes              = 100;   // Service nodes to seed when starting without a checkpoint
+    size_t               threads            = 0;     // Signing threads, 0 for one per hardware thread
+    size_t               queueSize          = 4'096; // Records between each pair of stages
+    size_t               maxInFlight        = 512;   // Submitted and not yet confirmed
+    uint64_t             checkpointInterval = 1'000; // Confirmed records between checkpoint writes
+    bool                 dryRun             = false;
+};
+
+static Options parseOptions(int argc, char* argv[]) {
+    Options result = {};
+    for (int index = 1; index < argc; index++) {
+        const std::string arg = argv[index];
+        if (arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " --epoch <path> [--format csv|jsonl] [--checkpoint <path>] [--network local] [--contract <address>]\n"
+                      << "    [--nodes N] [--threads N] [--queue-size N] [--max-in-flight N] [--checkpoint-interval N] [--dry-run]\n";
+            std::exit(0);
+        }
+        if (arg == "--dry-run") {
+            result.dryRun = true;
+            continue;
+        }
+        if (index + 1 >= argc)
+            throw std::invalid_argument("Missing value for '" + arg + "'");
+
+        const std::string value = argv[++index];
+        if (arg == "--network") {
+            result.network = ethbls::network_type_from_string(value);
+            if (result.network == ethbls::network_type::UNDEFINED)
+                throw std::invalid_argument("Unknown network '" + value + "'");
+        }
+        else if (arg == "--contract")            result.contract           = value;
+        else if (arg == "--epoch")               result.epoch              = value;
+        else if (arg == "--format")              result.format             = value;
+        else if (arg == "--checkpoint")          result.checkpoint         = value;
+        else if (arg == "--nodes")               result.nodes              = std::stoull(value);
+        else if (arg == "--threads")             result.threads            = std::stoull(value);
+        else if (arg == "--queue-size")          result.queueSize          = std::stoull(value);
+        else if (arg == "--max-in-flight")       result.maxInFlight        = std::stoull(value);
+        else if (arg == "--checkpoint-interval") result.checkpointInterval = std::stoull(value);
+        else throw std::invalid_argument("Unknown option '" + arg + "'");
+    }
+
+    if (result.epoch.empty())
+        throw std::invalid_argument("No epoch given, see --help");
+    if (result.format.empty()) {
+        const std::string extension = std::filesystem::path(result.epoch).extension().string();
+        result.format               = extension == ".jsonl" || extension == ".json" ? "jsonl" : "csv";
+    }
+    if (result.format != "csv" && result.format != "jsonl")
+        throw std::invalid_argument("Unknown format '" + result.format + "', expected csv or jsonl");
+    if (result.queueSize == 0 || result.maxInFlight == 0)
+        throw std::invalid_argument("--queue-size and --max-in-flight must be at least 1");
+    if (result.threads == 0)
+        result.threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    return result;
+}
+
+// Queue between two stages. `push` blocks while the queue is full, `pop`
+// while it is empty. Once closed `push` drops the item and returns false and
+// `pop` drains what is left and then returns nullopt.
+template <typename T>
+class BoundedQueue {
+public:
+    BoundedQueue(size_t _capacity) : capacity(_capacity) {}
+
+    bool push(T item) {
+        std::unique_lock lock{mutex};
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed)
+            return false;
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock lock{mutex};
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty())
+            return std::nullopt;
+        T result = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return result;
+    }
+
+    void close() {
+        {
+            std::lock_guard lock{mutex};
+            closed = true;
+        }
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+private:
+    size_t                  capacity;
+    std::deque<T>           items;
+    bool                    closed = false;
+    std::mutex              mutex;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+};
+
+struct Record {
+    uint64_t    sequence; // Index of the record in the epoch
+    uint64_t    order;    // Index of the record in this run, retries included
+    uint64_t    line;     // Line in the file, for error messages
+    std::string address;
+    uint64_t    amount;
+};
+
+struct SignedRecord {
+    uint64_t    sequence;
+    uint64_t    order;
+    uint64_t    line;
+    std::string address;
+    uint64_t    amount;
+    Transaction tx;
+};
+
+struct PendingRecord {
+    uint64_t                         sequence;
+    uint64_t                         line;
+    std::string                      address;
+    uint64_t                         amount;
+    std::optional<TransactionFuture> result; // Empty on a dry run
+};
+
+// Parse one line of the epoch, nullopt for blank lines and a CSV header
+static std::optional<Record> parseRecord(const std::string& format, const std::string& text, uint64_t line) {
+    const size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos)
+        return std::nullopt;
+
+    Record result = {};
+    result.line   = line;
+    try {
+        if (format == "jsonl") {
+            const nlohmann::json record = nlohmann::json::parse(text);
+            result.address              = record.at("address").get<std::string>();
+            const nlohmann::json& amount = record.at("amount");
+            result.amount               = amount.is_string() ? std::stoull(amount.get<std::string>()) : amount.get<uint64_t>();
+        } else {
+            const size_t comma = text.find(',');
+            if (comma == std::string::npos)
+                throw std::invalid_argument("expected 'address,amount'");
+            result.address                = text.substr(begin, comma - begin);
+            const std::string amount      = text.substr(comma + 1);
+            if (line == 1 && result.address.rfind("0x", 0) != 0)
+                return std::nullopt; // NOTE: Header
+            size_t parsed = 0;
+            result.amount = std::stoull(amount, &parsed);
+            if (amount.find_first_not_of(" \t\r", parsed) != std::string::npos)
+                throw std::invalid_argument("trailing characters after the amount");
+        }
+    } catch (const std::exception& e) {
+        std::stringstream stream;
+        stream << "Failed to parse line " << line << " of the epoch '" << text << "': " << e.what();
+        throw std::runtime_error(stream.str());
+    }
+
+    const std::string_view address = utils::trimPrefix(result.address, "0x");
+    if (address.size() != 40 || address.find_first_not_of("0123456789abcdefABCDEF") != std::string_view::npos) {
+        std::stringstream stream;
+        stream << "Failed to parse line " << line << " of the epoch: '" << result.address << "' is not a 20 byte hex address";
+        throw std::runtime_error(stream.str());
+    }
+    return result;
+}
+
+class RewardEpochPipeline {
+public:
+    RewardEpochPipeline(const Options& _options)
+            : options(_options),
+              config(ethbls::get_config(options.network)),
+              records(options.queueSize),
+              signedRecords(options.queueSize),
+              pending(options.maxInFlight) {
+        // NOTE: A dry run only signs, the contract address just goes into the message tags
+        contractAddress = options.contract.empty() ? std::string("0x5FbDB2315678afecb367f032d93F642f64180aa3") : options.contract;
+        if (!options.dryRun)
+            connect();
+        else
+            snl = std::make_unique<ServiceNodeList>(options.nodes);
+
+        // NOTE: Every node signs, the signature is the aggregate of all of them
+        std::vector<uint64_t> signers;
+        for (const ServiceNode& node : snl->nodes)
+            signers.push_back(node.service_node_id);
+        aggregateKey = snl->aggregateSecretKey(signers);
+        if (!rewardsContract)
+            rewardsContract = std::make_unique<ServiceNodeRewardsContract>(contractAddress, std::shared_ptr<ProviderBackend>{});
+    }
+
+    void run() {
+        const auto start = std::chrono::steady_clock::now();
+        std::cout << "Starting at record " << confirmed << " with " << snl->nodes.size() << " service nodes and " << options.threads << " signing threads" << std::endl;
+
+        resumeFrom = confirmed;
+        retry      = revertedRecords;
+        if (!retry.empty())
+            std::cout << "Retrying " << retry.size() << " records that reverted in an earlier run" << std::endl;
+        std::vector<std::thread> threads;
+        std::atomic<size_t>      signing = options.threads;
+        threads.emplace_back([this] { stage([this] { read(); }, [this] { records.close(); }); });
+        for (size_t index = 0; index < options.threads; index++) {
+            // NOTE: The last signer to finish closes the queue behind them all
+            threads.emplace_back([this, &signing] { stage([this] { sign(); }, [this, &signing] { if (--signing == 0) signedRecords.close(); }); });
+        }
+        threads.emplace_back([this] { stage([this] { submit(); }, [this] { pending.close(); }); });
+        threads.emplace_back([this] { stage([this] { confirm(); }); });
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (uint64_t sequence : covered)
+            revertedRecords.erase(sequence);
+        if (!covered.empty())
+            std::cout << "Dropped " << covered.size() << " reverted records the recipients already have the amounts of" << std::endl;
+
+        // NOTE: Keep what was confirmed before a stage failed
+        if (!options.dryRun)
+            saveCheckpoint();
+        if (failure)
+            std::rethrow_exception(failure);
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "\nrecords=" << processed << " seconds=" << seconds << " (" << static_cast<double>(processed) / seconds << "/s)\n"
+                  << "mined=" << mined << " reverted=" << reverted << " confirmed=" << confirmed << "\n";
+        if (!revertedRecords.empty())
+            std::cout << revertedRecords.size() << " records reverted, run again with the same checkpoint to retry them\n";
+    }
+
+private:
+    void connect() {
+        provider = std::make_shared<Provider>("Client", std::string(config.RPC_URL));
+        signer   = std::make_unique<Signer>(provider);
+        queue    = std::make_unique<TransactionQueue>(provider, *signer);
+        queue->setReceiptTracker(std::make_shared<ReceiptTracker>(std::string(config.RPC_URL)));
+        seckey   = utils::fromHexString(std::string(config.PRIVATE_KEY));
+
+        std::optional<nlohmann::json> checkpoint = loadCheckpoint();
+        if (checkpoint)
+            contractAddress = checkpoint->at("contract").get<std::string>();
+        else if (options.contract.empty())
+            contractAddress = provider->getContractDeployedInLatestBlock();
+        rewardsContract = std::make_unique<ServiceNodeRewardsContract>(contractAddress, provider);
+
+        if (checkpoint) {
+            snl       = std::make_unique<ServiceNodeList>(checkpoint->at("keys").get<std::vector<std::string>>());
+            confirmed = checkpoint->at("confirmed").get<uint64_t>();
+            if (checkpoint->contains("reverted"))
+                revertedRecords = checkpoint->at("reverted").get<std::set<uint64_t>>();
+            if (rewardsContract->serviceNodesLength() != snl->nodes.size())
+                throw std::runtime_error("The contract at " + contractAddress + " no longer has the service nodes of the checkpoint");
+            return;
+        }
+
+        // NOTE: The restored IDs only line up with the contract's if the
+        // nodes were seeded into an empty list
+        if (rewardsContract->serviceNodesLength() != 0)
+            throw std::runtime_error("The contract at " + contractAddress + " already has service nodes, resume from its checkpoint or deploy a fresh one");
+
+        snl = std::make_unique<ServiceNodeList>(options.nodes);
+        if (!rewardsContract->isActive()) {
+            ERC20Contract erc20(utils::trimAddress(rewardsContract->designatedToken()), provider);
+            queue->submit(erc20.approve(contractAddress, std::numeric_limits<std::uint64_t>::max()), seckey);
+            queue->submit(rewardsContract->start(), seckey);
+        }
+        rewardsContract->seedServiceNodeList(*queue, seckey, *snl);
+        saveCheckpoint();
+    }
+
+    std::optional<nlohmann::json> loadCheckpoint() const {
+        if (options.checkpoint.empty() || !std::filesystem::exists(options.checkpoint))
+            return std::nullopt;
+        std::ifstream file(options.checkpoint);
+        try {
+            return nlohmann::json::parse(file);
+        } catch (const std::exception& e) {
+            throw std::runtime_error("Failed to read the checkpoint '" + options.checkpoint + "': " + e.what());
+        }
+    }
+
+    // Written to a temporary file first and renamed over the old one so a
+    // crash leaves either the old or the new checkpoint, never half of one
+    void saveCheckpoint() const {
+        if (options.checkpoint.empty())
+            return;
+        nlohmann::json checkpoint = {
+            {"contract", contractAddress},
+            {"confirmed", confirmed},
+            {"reverted", revertedRecords},
+            {"keys", snl->secretKeys()},
+        };
+        const std::string temporary = options.checkpoint + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::trunc);
+            file << checkpoint.dump() << "\n";
+            if (!file.flush())
+                throw std::runtime_error("Failed to write the checkpoint '" + temporary + "'");
+        }
+        std::filesystem::rename(temporary, options.checkpoint);
+    }
+
+    // Whether the recipient's total on chain has reached `amount`, resending
+    // it would only revert
+    bool delivered(const std::string& address, uint64_t amount) {
+        return rewardsContract->viewRecipientBalance(address).rewards >= Uint256(amount);
+    }
+
+    // Run a stage, stopping the whole pipeline if it throws, then `done` (to
+    // close the queue it feeds so the next stage finishes too)
+    void stage(const std::function<void()>& body, const std::function<void()>& done = {}) {
+        try {
+            body();
+        } catch (...) {
+            fail(std::current_exception());
+        }
+        if (done)
+            done();
+    }
+
+    void fail(std::exception_ptr error) {
+        {
+            std::lock_guard lock{failureMutex};
+            if (!failure)
+                failure = error;
+        }
+        records.close();
+        signedRecords.close();
+        pending.close();
+    }
+
+    void read() {
+        std::ifstream file(options.epoch);
+        if (!file)
+            throw std::runtime_error("Failed to open the epoch '" + options.epoch + "'");
+
+        std::string text;
+        uint64_t    sequence = 0;
+        uint64_t    order    = 0;
+        for (uint64_t line = 1; std::getline(file, text); line++) {
+            std::optional<Record> record = parseRecord(options.format, text, line);
+            if (!record)
+                continue;
+            record->sequence = sequence++;
+            if (record->sequence < resumeFrom) {
+                if (!retry.count(record->sequence))
+                    continue;
+                if (delivered(record->address, record->amount)) {
+                    covered.insert(record->sequence);
+                    continue;
+                }
+            }
+            record->order = order++;
+            if (!records.push(std::move(*record)))
+                return;
+        }
+    }
+
+    void sign() {
+        while (std::optional<Record> record = records.pop()) {
+            const std::array<unsigned char, 32> hash = ServiceNodeList::rewardMessageHash(record->address, record->amount, config.CHAIN_ID, contractAddress);
+            bls::Signature                      sig;
+            aggregateKey.signHash(sig, hash.data(), hash.size());
+
+            Transaction  tx     = rewardsContract->updateRewardsBalance(record->address, record->amount, utils::SignatureToHex(sig), {});
+            SignedRecord result = {record->sequence, record->order, record->line, std::move(record->address), record->amount, std::move(tx)};
+            if (!signedRecords.push(std::move(result)))
+                return;
+        }
+    }
+
+    void submit() {
+        // NOTE: The signers finish out of order, hold records back until
+        // every one before them has been submitted
+        auto later = [](const SignedRecord& lhs, const SignedRecord& rhs) { return lhs.order > rhs.order; };
+        std::priority_queue<SignedRecord, std::vector<SignedRecord>, decltype(later)> reorder(later);
+        uint64_t next = 0;
+
+        while (std::optional<SignedRecord> record = signedRecords.pop()) {
+            reorder.push(std::move(*record));
+            while (!reorder.empty() && reorder.top().order == next) {
+                SignedRecord  top    = reorder.top();
+                PendingRecord result = {top.sequence, top.line, top.address, top.amount, std::nullopt};
+                reorder.pop();
+                if (queue)
+                    result.result = queue->submit(std::move(top.tx), seckey);
+                if (!pending.push(std::move(result)))
+                    return;
+                next++;
+            }
+        }
+    }
+
+    void confirm() {
+        auto lastReport     = std::chrono::steady_clock::now();
+        auto lastCheckpoint = confirmed;
+        while (std::optional<PendingRecord> record = pending.pop()) {
+            if (record->result) {
+                // NOTE: Every poll fetches the receipts of everything in
+                // flight, not just this record's
+                while (record->result->wait_for(std::chrono::milliseconds(0)) != std::future_status::ready) {
+                    queue->poll();
+                    record->result->wait_for(std::chrono::milliseconds(100));
+                }
+                // NOTE: A reverted record is done with but not delivered,
+                // the checkpoint keeps it to be retried on the next run
+                if (record->result->get().success) {
+                    mined++;
+                    revertedRecords.erase(record->sequence);
+                } else if (delivered(record->address, record->amount)) {
+                    reverted++;
+                    revertedRecords.erase(record->sequence);
+                    std::cerr << "Record on line " << record->line << " reverted in " << record->result->get().hash << ", the recipient already has its amount\n";
+                } else {
+                    reverted++;
+                    revertedRecords.insert(record->sequence);
+                    std::cerr << "Record on line " << record->line << " reverted in " << record->result->get().hash << "\n";
+                }
+            }
+
+            processed++;
+            confirmed = std::max(confirmed, record->sequence + 1);
+            if (!options.dryRun && confirmed - lastCheckpoint >= options.checkpointInterval) {
+                saveCheckpoint();
+                lastCheckpoint = confirmed;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (now - lastReport >= std::chrono::seconds(5)) {
+                std::cout << "confirmed=" << confirmed << " mined=" << mined << " reverted=" << reverted << " in-flight=" << (queue ? queue->inFlight() : 0) << std::endl;
+                lastReport = now;
+            }
+        }
+    }
+
+    Options                       options;
+    const ethbls::network_config& config;
+
+    std::shared_ptr<Provider>                   provider;
+    std::unique_ptr<Signer>                     signer;
+    std::unique_ptr<TransactionQueue>           queue;
+    std::vector<unsigned char>                  seckey;
+    std::string                                 contractAddress;
+    std::unique_ptr<ServiceNodeRewardsContract> rewardsContract;
+    std::unique_ptr<ServiceNodeList>            snl;
+    bls::SecretKey                              aggregateKey;
+
+    BoundedQueue<Record>        records;
+    BoundedQueue<SignedRecord>  signedRecords;
+    BoundedQueue<PendingRecord> pending;
+
+    std::mutex         failureMutex;
+    std::exception_ptr failure;
+
+    uint64_t           resumeFrom = 0; // First record not confirmed by an earlier run
+    std::set<uint64_t> retry;          // Records before `resumeFrom` to submit again
+    std::set<uint64_t> covered;        // Of `retry`, the ones already delivered. Owned by the reader
+
+    // Owned by the confirmer once the stages are running
+    uint64_t           confirmed = 0; // Records from the start of the epoch that are done
+    std::set<uint64_t> revertedRecords; // Of the confirmed, the ones to retry
+    uint64_t           processed = 0;
+    uint64_t           mined     = 0;
+    uint64_t           reverted  = 0;
+};
+
+int main(int argc, char* argv[]) {
+    try {
+        RewardEpochPipeline pipeline(parseOptions(argc, argv));
+        pipeline.run();
+    } catch (const std::exception& e) {
+        std::cerr << "reward_epoch_pipeline: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
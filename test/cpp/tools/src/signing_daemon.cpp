@@ -0,0 +1,107 @@
+// Keeps the service node keys in memory and signs for other processes over a
+// Unix domain socket, see SigningDaemonClient in signing_daemon.hpp.
+//
+//   ./signing_daemon --keys keys.json                  # Keys of an existing list
+//   ./signing_daemon --keys keys.json --nodes 100      # Generate 100 keys into keys.json if it doesn't exist
+//   ./signing_daemon --keys epoch.checkpoint --socket /run/sn-signer.sock
+//
+// The keys file is JSON with the secret keys in hex under "keys", the same as
+// the checkpoint of reward_epoch_pipeline, and the nodes get IDs from 1 in
+// that order. The keys file it generates and the socket are created readable
+// by the daemon's user only. The daemon runs until SIGINT or SIGTERM and
+// removes its socket on the way out.
+
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include <nlohmann/json.hpp>
+
+#include "service_node_rewards/signing_daemon.hpp"
+
+struct Options {
+    std::string keys;                                          // Path of the keys file
+    std::string socket       = "/tmp/service-node-signer.sock";
+    size_t      nodes        = 0;                              // Keys to generate when `keys` does not exist, 0 to require it
+    size_t      keyCacheSize = 64;                             // Signer sets whose summed key is kept
+};
+
+static Options parseOptions(int argc, char* argv[]) {
+    Options result = {};
+    for (int index = 1; index < argc; index++) {
+        const std::string arg = argv[index];
+        if (arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " --keys <path> [--nodes N] [--socket <path>] [--key-cache N]\n";
+            std::exit(0);
+        }
+        if (index + 1 >= argc)
+            throw std::invalid_argument("Missing value for '" + arg + "'");
+
+        const std::string value = argv[++index];
+        if (arg == "--keys")           result.keys         = value;
+        else if (arg == "--socket")    result.socket       = value;
+        else if (arg == "--nodes")     result.nodes        = std::stoull(value);
+        else if (arg == "--key-cache") result.keyCacheSize = std::stoull(value);
+        else throw std::invalid_argument("Unknown option '" + arg + "'");
+    }
+
+    if (result.keys.empty())
+        throw std::invalid_argument("No keys file given, see --help");
+    return result;
+}
+
+static std::unique_ptr<ServiceNodeList> loadKeys(const Options& options) {
+    if (!std::filesystem::exists(options.keys)) {
+        if (options.nodes == 0)
+            throw std::runtime_error("Keys file '" + options.keys + "' does not exist, pass --nodes to generate one");
+
+        auto          result = std::make_unique<ServiceNodeList>(options.nodes);
+        std::ofstream file(options.keys);
+        file << nlohmann::json{{"keys", result->secretKeys()}}.dump() << "\n";
+        if (!file)
+            throw std::runtime_error("Failed to write the keys to '" + options.keys + "'");
+        std::cout << "Generated " << options.nodes << " service node keys into " << options.keys << "\n";
+        return result;
+    }
+
+    std::ifstream  file(options.keys);
+    nlohmann::json json = nlohmann::json::parse(file);
+    return std::make_unique<ServiceNodeList>(json.at("keys").get<std::vector<std::string>>());
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        const Options options = parseOptions(argc, argv);
+
+        // NOTE: The generated keys file and the socket are for our user only
+        ::umask(077);
+
+        // NOTE: Block the signals before any thread starts so they all inherit
+        // the mask and only `sigwait` below receives them
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        SigningService service(std::move(*loadKeys(options)), options.keyCacheSize);
+        SigningDaemon  daemon(service, options.socket);
+        std::cout << "Signing for " << service.size() << " service nodes on " << daemon.path() << "\n";
+
+        int signal = 0;
+        sigwait(&signals, &signal);
+        daemon.stop();
+        std::cout << "Stopped after " << service.signaturesComputed() << " signatures\n";
+    } catch (const std::exception& e) {
+        std::cerr << "signing_daemon: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}